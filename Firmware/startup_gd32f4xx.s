@@ -136,6 +136,12 @@ g_pfnVectors:
     .weak  Reset_Handler
     .type  Reset_Handler, %function
 Reset_Handler:
+    /* enable the TCMSRAM clock, RCU_AHB1EN bit 20, before the TCM is touched */
+    ldr r0, =0x40023830
+    ldr r1, [r0]
+    orr r1, r1, #0x00100000
+    str r1, [r0]
+
     ldr r1, =_sidata
     ldr r2, =_sdata
     ldr r3, =_edata
@@ -154,13 +160,39 @@ fill_bss_start:
     ldr r2, =__bss_end
     movs r0, 0
     subs r2, r1
-    ble startup_enter
+    ble copy_tcm_data_start
 
 loop_fill_bss:
     subs r2, #4
     str r0, [r1, r2]
     bgt loop_fill_bss
 
+copy_tcm_data_start:
+    ldr r1, =_sitcm_data
+    ldr r2, =_stcm_data
+    ldr r3, =_etcm_data
+
+    subs r3, r2
+    ble fill_tcm_bss_start
+
+loop_copy_tcm_data:
+    subs r3, #4
+    ldr r0, [r1,r3]
+    str r0, [r2,r3]
+    bgt loop_copy_tcm_data
+
+fill_tcm_bss_start:
+    ldr r1, =_stcm_bss
+    ldr r2, =_etcm_bss
+    movs r0, 0
+    subs r2, r1
+    ble startup_enter
+
+loop_fill_tcm_bss:
+    subs r2, #4
+    str r0, [r1, r2]
+    bgt loop_fill_tcm_bss
+
 startup_enter:
     bl SystemInit
     bl main
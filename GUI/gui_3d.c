@@ -0,0 +1,728 @@
+/*!
+    \file    gui_3d.c
+    \brief   fixed-point software 3D pipeline
+
+    Vertices are transformed with Q16 matrices, clipped against the view
+    volume and rasterized with edge functions on a 1/16 pixel grid. Depth
+    is interpolated linearly in screen space, texture coordinates are
+    interpolated as u/w, v/w and 1/w and divided per pixel. Attribute
+    planes are stepped in 64-bit modular arithmetic, their values are
+    only read inside the triangle where they are known to fit.
+
+    The pipeline keeps its work buffers in static memory, the stack of
+    this project is small. It is not reentrant.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "gui_3d.h"
+#include "gui_widget.h"
+#include "mem_section.h"
+
+#define CLIP_PLANES                 5
+#define CLIP_MAX                    (3 + CLIP_PLANES)
+#define SUBPIXEL_SHIFT              4
+#define SUBPIXEL_ONE                (1 << SUBPIXEL_SHIFT)
+/* 1/w of the nearest vertex is scaled to this, which keeps u/w and v/w in 32 bits */
+#define Q_NORM                      4096
+
+/* vertex in clip space, all Q16 */
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    int32_t w;
+    int32_t u;
+    int32_t v;
+} clip_vertex_struct;
+
+/* vertex in viewport space */
+typedef struct {
+    int32_t x;                                          /*!< 1/16 pixel */
+    int32_t y;
+    int32_t z;                                          /*!< depth 0..65535 */
+    int64_t q;                                          /*!< 1/w, 2^40 is 1.0 */
+    int32_t u;
+    int32_t v;
+} screen_vertex_struct;
+
+/* edge function stepped across the bounding box */
+typedef struct {
+    int32_t row;
+    int32_t step_x;
+    int32_t step_y;
+} edge_struct;
+
+/* attribute plane in Q16, modular */
+typedef struct {
+    uint64_t row;
+    uint64_t step_x;
+    uint64_t step_y;
+} plane_struct;
+
+/* only the CPU touches these, keep them in the TCM */
+static clip_vertex_struct vertex_cache[GUI_3D_VERTEX_CACHE] TCM_BSS;
+static clip_vertex_struct clip_buf[2][CLIP_MAX] TCM_BSS;
+static screen_vertex_struct screen_buf[CLIP_MAX] TCM_BSS;
+
+static void triangle_process(gui_3d_struct *ctx, const clip_vertex_struct *a, const clip_vertex_struct *b,
+                             const clip_vertex_struct *c, const gui_3d_texture_struct *texture, uint16_t color);
+
+/*!
+    \brief      set the identity matrix
+    \param[in]  none
+    \param[out] m: matrix
+    \retval     none
+*/
+void gui_mat4_identity(gui_mat4_struct *m)
+{
+    uint32_t i, j;
+
+    for(i = 0; i < 4U; i++){
+        for(j = 0; j < 4U; j++){
+            m->m[i][j] = (i == j) ? GUI_3D_ONE : 0;
+        }
+    }
+}
+
+/*!
+    \brief      multiply two matrices
+    \param[in]  a: left matrix
+    \param[in]  b: right matrix, applied first
+    \param[out] out: a * b, may be a or b
+    \retval     none
+*/
+void gui_mat4_mul(gui_mat4_struct *out, const gui_mat4_struct *a, const gui_mat4_struct *b)
+{
+    gui_mat4_struct r;
+    uint32_t i, j, k;
+    int64_t sum;
+
+    for(i = 0; i < 4U; i++){
+        for(j = 0; j < 4U; j++){
+            sum = 0;
+            for(k = 0; k < 4U; k++){
+                sum += (int64_t)a->m[i][k] * b->m[k][j];
+            }
+            r.m[i][j] = (int32_t)(sum >> 16);
+        }
+    }
+    *out = r;
+}
+
+/*!
+    \brief      set a translation matrix
+    \param[in]  x, y, z: offset in Q16
+    \param[out] m: matrix
+    \retval     none
+*/
+void gui_mat4_translation(gui_mat4_struct *m, int32_t x, int32_t y, int32_t z)
+{
+    gui_mat4_identity(m);
+    m->m[0][3] = x;
+    m->m[1][3] = y;
+    m->m[2][3] = z;
+}
+
+/*!
+    \brief      set a scale matrix
+    \param[in]  x, y, z: factors in Q16
+    \param[out] m: matrix
+    \retval     none
+*/
+void gui_mat4_scaling(gui_mat4_struct *m, int32_t x, int32_t y, int32_t z)
+{
+    gui_mat4_identity(m);
+    m->m[0][0] = x;
+    m->m[1][1] = y;
+    m->m[2][2] = z;
+}
+
+/*!
+    \brief      set a rotation about the x axis
+    \param[in]  degree: angle, positive turns y towards z
+    \param[out] m: matrix
+    \retval     none
+*/
+void gui_mat4_rotation_x(gui_mat4_struct *m, int32_t degree)
+{
+    int32_t s = gui_sin_q15(degree) * 2;
+    int32_t c = gui_sin_q15(degree + 90) * 2;
+
+    gui_mat4_identity(m);
+    m->m[1][1] = c;
+    m->m[1][2] = -s;
+    m->m[2][1] = s;
+    m->m[2][2] = c;
+}
+
+/*!
+    \brief      set a rotation about the y axis
+    \param[in]  degree: angle, positive turns z towards x
+    \param[out] m: matrix
+    \retval     none
+*/
+void gui_mat4_rotation_y(gui_mat4_struct *m, int32_t degree)
+{
+    int32_t s = gui_sin_q15(degree) * 2;
+    int32_t c = gui_sin_q15(degree + 90) * 2;
+
+    gui_mat4_identity(m);
+    m->m[0][0] = c;
+    m->m[0][2] = s;
+    m->m[2][0] = -s;
+    m->m[2][2] = c;
+}
+
+/*!
+    \brief      set a rotation about the z axis
+    \param[in]  degree: angle, positive turns x towards y
+    \param[out] m: matrix
+    \retval     none
+*/
+void gui_mat4_rotation_z(gui_mat4_struct *m, int32_t degree)
+{
+    int32_t s = gui_sin_q15(degree) * 2;
+    int32_t c = gui_sin_q15(degree + 90) * 2;
+
+    gui_mat4_identity(m);
+    m->m[0][0] = c;
+    m->m[0][1] = -s;
+    m->m[1][0] = s;
+    m->m[1][1] = c;
+}
+
+/*!
+    \brief      set a perspective projection, the camera looks down -z
+    \param[in]  fov_degree: vertical field of view
+    \param[in]  aspect: width / height in Q16
+    \param[in]  z_near, z_far: clip distances in Q16, 0 < z_near < z_far
+    \param[out] m: matrix
+    \retval     none
+*/
+void gui_mat4_perspective(gui_mat4_struct *m, int32_t fov_degree, int32_t aspect, int32_t z_near, int32_t z_far)
+{
+    int32_t s = gui_sin_q15(fov_degree / 2);
+    int32_t c = gui_sin_q15(fov_degree / 2 + 90);
+    int32_t f = (int32_t)(((int64_t)c << 16) / s);
+    int64_t range = (int64_t)z_near - z_far;
+
+    gui_mat4_identity(m);
+    m->m[0][0] = (int32_t)(((int64_t)f << 16) / aspect);
+    m->m[1][1] = f;
+    m->m[2][2] = (int32_t)((((int64_t)z_far + z_near) << 16) / range);
+    m->m[2][3] = (int32_t)((2 * (int64_t)z_far * z_near) / range);
+    m->m[3][2] = -GUI_3D_ONE;
+    m->m[3][3] = 0;
+}
+
+/*!
+    \brief      bind a render target
+    \param[in]  ctx: pipeline context
+    \param[in]  color: top left pixel of the viewport
+    \param[in]  color_stride: pixels from one line to the next
+    \param[in]  depth: z-buffer with at least width x height entries
+    \param[in]  depth_stride: entries from one line to the next
+    \param[in]  width, height: viewport size in pixels
+    \param[out] none
+    \retval     none
+*/
+void gui_3d_init(gui_3d_struct *ctx, uint16_t *color, uint16_t color_stride, uint16_t *depth, uint16_t depth_stride,
+                 uint16_t width, uint16_t height)
+{
+    ctx->color = color;
+    ctx->color_stride = color_stride;
+    ctx->depth = depth;
+    ctx->depth_stride = depth_stride;
+    ctx->width = width;
+    ctx->height = height;
+    ctx->depth_clear = NULL;
+    ctx->cull_back = 1;
+    gui_mat4_identity(&ctx->view_proj);
+    ctx->stats.triangles = 0;
+    ctx->stats.culled = 0;
+    ctx->stats.rejected = 0;
+    ctx->stats.clipped = 0;
+    ctx->stats.drawn = 0;
+    ctx->stats.pixels = 0;
+}
+
+/*!
+    \brief      set the combined view and projection matrix
+    \param[in]  ctx: pipeline context
+    \param[in]  view_proj: projection * view
+    \param[out] none
+    \retval     none
+*/
+void gui_3d_set_camera(gui_3d_struct *ctx, const gui_mat4_struct *view_proj)
+{
+    ctx->view_proj = *view_proj;
+}
+
+/*!
+    \brief      reset the z-buffer to the far plane
+    \param[in]  ctx: pipeline context
+    \param[out] none
+    \retval     none
+*/
+void gui_3d_clear_depth(gui_3d_struct *ctx)
+{
+    uint16_t *line = ctx->depth;
+    uint32_t i, j;
+
+    if(NULL != ctx->depth_clear){
+        ctx->depth_clear(ctx->depth, ctx->depth_stride, ctx->width, ctx->height, GUI_3D_DEPTH_FAR);
+        return;
+    }
+    for(j = 0; j < ctx->height; j++){
+        for(i = 0; i < ctx->width; i++){
+            line[i] = GUI_3D_DEPTH_FAR;
+        }
+        line += ctx->depth_stride;
+    }
+}
+
+/*!
+    \brief      transform a vertex to clip space
+    \param[in]  m: model view projection matrix
+    \param[in]  in: vertex
+    \param[out] out: transformed vertex
+    \retval     none
+*/
+static void vertex_transform(const gui_mat4_struct *m, const gui_3d_vertex_struct *in, clip_vertex_struct *out)
+{
+    out->x = (int32_t)(((int64_t)m->m[0][0] * in->x + (int64_t)m->m[0][1] * in->y + (int64_t)m->m[0][2] * in->z) >> 16) + m->m[0][3];
+    out->y = (int32_t)(((int64_t)m->m[1][0] * in->x + (int64_t)m->m[1][1] * in->y + (int64_t)m->m[1][2] * in->z) >> 16) + m->m[1][3];
+    out->z = (int32_t)(((int64_t)m->m[2][0] * in->x + (int64_t)m->m[2][1] * in->y + (int64_t)m->m[2][2] * in->z) >> 16) + m->m[2][3];
+    out->w = (int32_t)(((int64_t)m->m[3][0] * in->x + (int64_t)m->m[3][1] * in->y + (int64_t)m->m[3][2] * in->z) >> 16) + m->m[3][3];
+    out->u = in->u;
+    out->v = in->v;
+}
+
+/*!
+    \brief      signed distance of a vertex to a clip plane, negative is outside
+    \param[in]  v: vertex
+    \param[in]  plane: left, right, bottom, top, near
+    \param[out] none
+    \retval     distance
+*/
+static int64_t clip_distance(const clip_vertex_struct *v, uint32_t plane)
+{
+    switch(plane){
+    case 0:
+        return (int64_t)v->w + v->x;
+    case 1:
+        return (int64_t)v->w - v->x;
+    case 2:
+        return (int64_t)v->w + v->y;
+    case 3:
+        return (int64_t)v->w - v->y;
+    default:
+        return (int64_t)v->w + v->z;
+    }
+}
+
+/*!
+    \brief      get the clip planes a vertex is outside of
+    \param[in]  v: vertex
+    \param[out] none
+    \retval     one bit per plane
+*/
+static uint32_t clip_outcode(const clip_vertex_struct *v)
+{
+    uint32_t plane, code = 0;
+
+    for(plane = 0; plane < CLIP_PLANES; plane++){
+        if(clip_distance(v, plane) < 0){
+            code |= 1U << plane;
+        }
+    }
+    return code;
+}
+
+/*!
+    \brief      clip a polygon held in clip_buf[0] against some planes
+    \param[in]  count: number of vertices
+    \param[in]  planes: planes to clip against, one bit each
+    \param[out] poly: receives the clipped polygon
+    \retval     number of vertices left, less than 3 when nothing is left
+*/
+static uint32_t clip_polygon(uint32_t count, uint32_t planes, clip_vertex_struct **poly)
+{
+    clip_vertex_struct *in = clip_buf[0], *out, *a, *b, *o;
+    uint32_t plane, i, n;
+    int64_t da, db, t;
+
+    for(plane = 0; (plane < CLIP_PLANES) && (count >= 3U); plane++){
+        if(0U == (planes & (1U << plane))){
+            continue;
+        }
+        out = (clip_buf[0] == in) ? clip_buf[1] : clip_buf[0];
+        n = 0;
+        for(i = 0; i < count; i++){
+            a = &in[i];
+            b = &in[(i + 1U == count) ? 0U : (i + 1U)];
+            da = clip_distance(a, plane);
+            db = clip_distance(b, plane);
+            if(da >= 0){
+                out[n++] = *a;
+            }
+            if((da >= 0) != (db >= 0)){
+                t = (da * 65536) / (da - db);
+                o = &out[n++];
+                o->x = a->x + (int32_t)(((int64_t)(b->x - a->x) * t) >> 16);
+                o->y = a->y + (int32_t)(((int64_t)(b->y - a->y) * t) >> 16);
+                o->z = a->z + (int32_t)(((int64_t)(b->z - a->z) * t) >> 16);
+                o->w = a->w + (int32_t)(((int64_t)(b->w - a->w) * t) >> 16);
+                o->u = a->u + (int32_t)(((int64_t)(b->u - a->u) * t) >> 16);
+                o->v = a->v + (int32_t)(((int64_t)(b->v - a->v) * t) >> 16);
+            }
+        }
+        in = out;
+        count = n;
+    }
+    *poly = in;
+
+    return count;
+}
+
+/*!
+    \brief      project a clipped vertex to the viewport
+    \param[in]  ctx: pipeline context
+    \param[in]  in: vertex inside the view volume
+    \param[out] out: viewport vertex
+    \retval     0 when w is not positive
+*/
+static int vertex_project(const gui_3d_struct *ctx, const clip_vertex_struct *in, screen_vertex_struct *out)
+{
+    int32_t half_w = (int32_t)ctx->width << (SUBPIXEL_SHIFT - 1);
+    int32_t half_h = (int32_t)ctx->height << (SUBPIXEL_SHIFT - 1);
+    int32_t z;
+
+    if(in->w <= 0){
+        return 0;
+    }
+    out->x = half_w + (int32_t)(((int64_t)in->x * half_w) / in->w);
+    out->y = half_h - (int32_t)(((int64_t)in->y * half_h) / in->w);
+    z = 32768 + (int32_t)(((int64_t)in->z * 32767) / in->w);
+    out->z = (z < 0) ? 0 : ((z > 65535) ? 65535 : z);
+    out->q = ((int64_t)1 << 40) / in->w;
+    out->u = in->u;
+    out->v = in->v;
+
+    return 1;
+}
+
+/*!
+    \brief      set up an edge function, pixels with a non-negative value are inside
+    \param[in]  a, b: edge from a to b, the triangle lies on its left in screen space
+    \param[in]  px, py: first sample point in 1/16 pixel
+    \param[out] e: edge
+    \retval     none
+*/
+static void edge_setup(edge_struct *e, const screen_vertex_struct *a, const screen_vertex_struct *b, int32_t px, int32_t py)
+{
+    int32_t dx = b->x - a->x;
+    int32_t dy = b->y - a->y;
+
+    e->row = dx * (py - a->y) - dy * (px - a->x);
+    e->step_x = -dy * SUBPIXEL_ONE;
+    e->step_y = dx * SUBPIXEL_ONE;
+    /* top-left rule: pixels exactly on other edges belong to the neighbour */
+    if(!((dy < 0) || ((0 == dy) && (dx > 0)))){
+        e->row -= 1;
+    }
+}
+
+/*!
+    \brief      set up an attribute plane through the three vertices
+    \param[in]  a0, a1, a2: attribute at the vertices
+    \param[in]  a, b, c: vertices
+    \param[in]  area: twice the triangle area in 1/256 pixel, positive
+    \param[in]  px, py: first sample point in 1/16 pixel
+    \param[out] p: plane
+    \retval     none
+*/
+static void plane_setup(plane_struct *p, int64_t a0, int64_t a1, int64_t a2, const screen_vertex_struct *a,
+                        const screen_vertex_struct *b, const screen_vertex_struct *c, int64_t area, int32_t px, int32_t py)
+{
+    int64_t dx1 = b->x - a->x, dy1 = b->y - a->y;
+    int64_t dx2 = c->x - a->x, dy2 = c->y - a->y;
+    int64_t gx = (((a1 - a0) * dy2 - (a2 - a0) * dy1) * 65536) / area;
+    int64_t gy = (((a2 - a0) * dx1 - (a1 - a0) * dx2) * 65536) / area;
+
+    /* the start value may overflow outside the triangle, the wrap cancels inside it */
+    p->row = (uint64_t)a0 * 65536U + (uint64_t)gx * (uint64_t)(int64_t)(px - a->x) +
+             (uint64_t)gy * (uint64_t)(int64_t)(py - a->y);
+    p->step_x = (uint64_t)gx * SUBPIXEL_ONE;
+    p->step_y = (uint64_t)gy * SUBPIXEL_ONE;
+}
+
+/*!
+    \brief      rasterize one triangle with depth test
+    \param[in]  ctx: pipeline context
+    \param[in]  a, b, c: viewport vertices
+    \param[in]  texture: texture, NULL for a flat colour
+    \param[in]  color: flat colour
+    \param[out] none
+    \retval     1 when rasterized, 0 when culled
+*/
+static int triangle_raster(gui_3d_struct *ctx, const screen_vertex_struct *a, const screen_vertex_struct *b,
+                           const screen_vertex_struct *c, const gui_3d_texture_struct *texture, uint16_t color)
+{
+    const screen_vertex_struct *t;
+    edge_struct e0, e1, e2;
+    plane_struct pz, pq, pu, pv;
+    int64_t area, qa, qb, qc, qmax;
+    int32_t x0, x1, y0, y1, px, py, w0, w1, w2, q, u, v;
+    int32_t ua, ub, uc, va, vb, vc;
+    uint32_t shift = 0, up = 0, umask = 0, vmask = 0;
+    uint64_t z, zq, zu, zv;
+    uint16_t *zline, *cline;
+
+    area = (int64_t)(b->x - a->x) * (c->y - a->y) - (int64_t)(b->y - a->y) * (c->x - a->x);
+    if(0 == area){
+        return 0;
+    }
+    if(area > 0){
+        /* counter-clockwise in view space turns clockwise on the y-down screen */
+        if(ctx->cull_back){
+            return 0;
+        }
+    }else{
+        t = b;
+        b = c;
+        c = t;
+        area = -area;
+    }
+
+    /* pixel centres inside the bounding box, clamped to the viewport */
+    x0 = a->x < b->x ? a->x : b->x;
+    x0 = x0 < c->x ? x0 : c->x;
+    x1 = a->x > b->x ? a->x : b->x;
+    x1 = x1 > c->x ? x1 : c->x;
+    y0 = a->y < b->y ? a->y : b->y;
+    y0 = y0 < c->y ? y0 : c->y;
+    y1 = a->y > b->y ? a->y : b->y;
+    y1 = y1 > c->y ? y1 : c->y;
+    x0 = (x0 - SUBPIXEL_ONE / 2 + SUBPIXEL_ONE - 1) >> SUBPIXEL_SHIFT;
+    y0 = (y0 - SUBPIXEL_ONE / 2 + SUBPIXEL_ONE - 1) >> SUBPIXEL_SHIFT;
+    x1 = (x1 - SUBPIXEL_ONE / 2) >> SUBPIXEL_SHIFT;
+    y1 = (y1 - SUBPIXEL_ONE / 2) >> SUBPIXEL_SHIFT;
+    x0 = (x0 < 0) ? 0 : x0;
+    y0 = (y0 < 0) ? 0 : y0;
+    x1 = (x1 >= ctx->width) ? (ctx->width - 1) : x1;
+    y1 = (y1 >= ctx->height) ? (ctx->height - 1) : y1;
+    if((x0 > x1) || (y0 > y1)){
+        return 1;
+    }
+
+    px = (x0 << SUBPIXEL_SHIFT) + SUBPIXEL_ONE / 2;
+    py = (y0 << SUBPIXEL_SHIFT) + SUBPIXEL_ONE / 2;
+    edge_setup(&e0, b, c, px, py);
+    edge_setup(&e1, c, a, px, py);
+    edge_setup(&e2, a, b, px, py);
+    plane_setup(&pz, a->z, b->z, c->z, a, b, c, area, px, py);
+
+    if(NULL != texture){
+        /* scale 1/w so the nearest vertex gets Q_NORM */
+        qmax = a->q > b->q ? a->q : b->q;
+        qmax = qmax > c->q ? qmax : c->q;
+        while((qmax >> shift) > Q_NORM){
+            shift++;
+        }
+        while((up < 30U) && ((qmax << (up + 1U)) <= Q_NORM)){
+            up++;
+        }
+        qa = ((a->q << up) >> shift) | 1;
+        qb = ((b->q << up) >> shift) | 1;
+        qc = ((c->q << up) >> shift) | 1;
+
+        /* texel coordinates with 8 fractional bits */
+        ua = (int32_t)(((int64_t)a->u << texture->width_shift) >> 8);
+        ub = (int32_t)(((int64_t)b->u << texture->width_shift) >> 8);
+        uc = (int32_t)(((int64_t)c->u << texture->width_shift) >> 8);
+        va = (int32_t)(((int64_t)a->v << texture->height_shift) >> 8);
+        vb = (int32_t)(((int64_t)b->v << texture->height_shift) >> 8);
+        vc = (int32_t)(((int64_t)c->v << texture->height_shift) >> 8);
+
+        plane_setup(&pq, qa, qb, qc, a, b, c, area, px, py);
+        plane_setup(&pu, ua * qa, ub * qb, uc * qc, a, b, c, area, px, py);
+        plane_setup(&pv, va * qa, vb * qb, vc * qc, a, b, c, area, px, py);
+        umask = (1U << texture->width_shift) - 1U;
+        vmask = (1U << texture->height_shift) - 1U;
+    }else{
+        pq.row = pu.row = pv.row = 0;
+        pq.step_x = pu.step_x = pv.step_x = 0;
+        pq.step_y = pu.step_y = pv.step_y = 0;
+    }
+
+    zline = ctx->depth + (uint32_t)y0 * ctx->depth_stride;
+    cline = ctx->color + (uint32_t)y0 * ctx->color_stride;
+    for(py = y0; py <= y1; py++){
+        w0 = e0.row;
+        w1 = e1.row;
+        w2 = e2.row;
+        z = pz.row;
+        zq = pq.row;
+        zu = pu.row;
+        zv = pv.row;
+        for(px = x0; px <= x1; px++){
+            if((w0 | w1 | w2) >= 0){
+                if((uint32_t)((int64_t)z >> 16) < zline[px]){
+                    zline[px] = (uint16_t)((int64_t)z >> 16);
+                    if(NULL != texture){
+                        q = (int32_t)((int64_t)zq >> 16);
+                        q = (q < 1) ? 1 : q;
+                        u = (int32_t)((int64_t)zu >> 16) / q;
+                        v = (int32_t)((int64_t)zv >> 16) / q;
+                        cline[px] = texture->pixels[((((uint32_t)(v >> 8)) & vmask) << texture->width_shift) |
+                                                    (((uint32_t)(u >> 8)) & umask)];
+                    }else{
+                        cline[px] = color;
+                    }
+                    ctx->stats.pixels++;
+                }
+            }
+            w0 += e0.step_x;
+            w1 += e1.step_x;
+            w2 += e2.step_x;
+            z += pz.step_x;
+            if(NULL != texture){
+                zq += pq.step_x;
+                zu += pu.step_x;
+                zv += pv.step_x;
+            }
+        }
+        e0.row += e0.step_y;
+        e1.row += e1.step_y;
+        e2.row += e2.step_y;
+        pz.row += pz.step_y;
+        if(NULL != texture){
+            pq.row += pq.step_y;
+            pu.row += pu.step_y;
+            pv.row += pv.step_y;
+        }
+        zline += ctx->depth_stride;
+        cline += ctx->color_stride;
+    }
+
+    return 1;
+}
+
+/*!
+    \brief      clip, project and rasterize a triangle in clip space
+    \param[in]  ctx: pipeline context
+    \param[in]  a, b, c: vertices in clip space
+    \param[in]  texture: texture, NULL for a flat colour
+    \param[in]  color: flat colour
+    \param[out] none
+    \retval     none
+*/
+static void triangle_process(gui_3d_struct *ctx, const clip_vertex_struct *a, const clip_vertex_struct *b,
+                             const clip_vertex_struct *c, const gui_3d_texture_struct *texture, uint16_t color)
+{
+    clip_vertex_struct *poly;
+    uint32_t ca, cb, cc, count, i;
+    int drawn = 0;
+
+    ctx->stats.triangles++;
+    ca = clip_outcode(a);
+    cb = clip_outcode(b);
+    cc = clip_outcode(c);
+    if(0U != (ca & cb & cc)){
+        ctx->stats.rejected++;
+        return;
+    }
+
+    if(0U == (ca | cb | cc)){
+        if(vertex_project(ctx, a, &screen_buf[0]) && vertex_project(ctx, b, &screen_buf[1]) &&
+           vertex_project(ctx, c, &screen_buf[2])){
+            drawn = triangle_raster(ctx, &screen_buf[0], &screen_buf[1], &screen_buf[2], texture, color);
+        }
+    }else{
+        ctx->stats.clipped++;
+        clip_buf[0][0] = *a;
+        clip_buf[0][1] = *b;
+        clip_buf[0][2] = *c;
+        count = clip_polygon(3, ca | cb | cc, &poly);
+        if(count < 3U){
+            ctx->stats.rejected++;
+            return;
+        }
+        for(i = 0; i < count; i++){
+            if(!vertex_project(ctx, &poly[i], &screen_buf[i])){
+                ctx->stats.rejected++;
+                return;
+            }
+        }
+        /* the polygon is convex and planar, every fan triangle faces the same way */
+        for(i = 1; i + 1U < count; i++){
+            drawn |= triangle_raster(ctx, &screen_buf[0], &screen_buf[i], &screen_buf[i + 1U], texture, color);
+        }
+    }
+
+    if(drawn){
+        ctx->stats.drawn++;
+    }else{
+        ctx->stats.culled++;
+    }
+}
+
+/*!
+    \brief      draw one triangle given in world space
+    \param[in]  ctx: pipeline context
+    \param[in]  v0, v1, v2: vertices, counter-clockwise for a front face
+    \param[in]  texture: texture, NULL for a flat colour
+    \param[in]  color: flat colour
+    \param[out] none
+    \retval     none
+*/
+void gui_3d_draw_triangle(gui_3d_struct *ctx, const gui_3d_vertex_struct *v0, const gui_3d_vertex_struct *v1,
+                          const gui_3d_vertex_struct *v2, const gui_3d_texture_struct *texture, uint16_t color)
+{
+    vertex_transform(&ctx->view_proj, v0, &vertex_cache[0]);
+    vertex_transform(&ctx->view_proj, v1, &vertex_cache[1]);
+    vertex_transform(&ctx->view_proj, v2, &vertex_cache[2]);
+    triangle_process(ctx, &vertex_cache[0], &vertex_cache[1], &vertex_cache[2], texture, color);
+}
+
+/*!
+    \brief      draw a mesh placed by a model matrix
+    \param[in]  ctx: pipeline context
+    \param[in]  mesh: indexed triangle list
+    \param[in]  model: model to world matrix, NULL for the identity
+    \param[out] none
+    \retval     none
+*/
+void gui_3d_draw_mesh(gui_3d_struct *ctx, const gui_3d_mesh_struct *mesh, const gui_mat4_struct *model)
+{
+    gui_mat4_struct mvp;
+    const uint16_t *index = mesh->indices;
+    uint32_t i;
+
+    if(NULL != model){
+        gui_mat4_mul(&mvp, &ctx->view_proj, model);
+    }else{
+        mvp = ctx->view_proj;
+    }
+
+    if(mesh->vertex_count <= GUI_3D_VERTEX_CACHE){
+        /* shared vertices are transformed once */
+        for(i = 0; i < mesh->vertex_count; i++){
+            vertex_transform(&mvp, &mesh->vertices[i], &vertex_cache[i]);
+        }
+        for(i = 0; i < mesh->triangle_count; i++, index += 3){
+            triangle_process(ctx, &vertex_cache[index[0]], &vertex_cache[index[1]], &vertex_cache[index[2]],
+                             mesh->texture, mesh->color);
+        }
+    }else{
+        for(i = 0; i < mesh->triangle_count; i++, index += 3){
+            vertex_transform(&mvp, &mesh->vertices[index[0]], &vertex_cache[0]);
+            vertex_transform(&mvp, &mesh->vertices[index[1]], &vertex_cache[1]);
+            vertex_transform(&mvp, &mesh->vertices[index[2]], &vertex_cache[2]);
+            triangle_process(ctx, &vertex_cache[0], &vertex_cache[1], &vertex_cache[2], mesh->texture, mesh->color);
+        }
+    }
+}
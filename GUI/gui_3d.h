@@ -0,0 +1,107 @@
+/*!
+    \file    gui_3d.h
+    \brief   the header file of the fixed-point software 3D pipeline
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef GUI_3D_H
+#define GUI_3D_H
+
+#include <stdint.h>
+
+#define GUI_3D_ONE                  65536               /*!< 1.0 in Q16 */
+#define GUI_3D_DEPTH_FAR            0xFFFFU             /*!< z-buffer clear value */
+/* meshes with more vertices are transformed per triangle instead of once per vertex */
+#define GUI_3D_VERTEX_CACHE         256
+
+/* 4x4 matrix in Q16, applied to column vectors */
+typedef struct {
+    int32_t m[4][4];
+} gui_mat4_struct;
+
+/* mesh vertex, position in Q16 model units, texture coordinate in Q16 where 1.0 spans the texture */
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    int32_t u;
+    int32_t v;
+} gui_3d_vertex_struct;
+
+/* RGB565 texture, the size is a power of two and coordinates wrap around */
+typedef struct {
+    const uint16_t *pixels;
+    uint8_t width_shift;
+    uint8_t height_shift;
+} gui_3d_texture_struct;
+
+/* indexed triangle list, front faces are counter-clockwise */
+typedef struct {
+    const gui_3d_vertex_struct *vertices;
+    const uint16_t *indices;                            /*!< three per triangle */
+    uint16_t vertex_count;
+    uint16_t triangle_count;
+    const gui_3d_texture_struct *texture;               /*!< NULL for a flat colour */
+    uint16_t color;
+} gui_3d_mesh_struct;
+
+/* fill a z-buffer rectangle, lets the port use a 2D accelerator */
+typedef void (*gui_3d_depth_clear_func)(uint16_t *depth, uint16_t stride, uint16_t width, uint16_t height, uint16_t value);
+
+typedef struct {
+    uint32_t triangles;                                 /*!< triangles submitted */
+    uint32_t culled;                                    /*!< back faces and degenerate triangles */
+    uint32_t rejected;                                  /*!< completely outside the view volume */
+    uint32_t clipped;                                   /*!< crossing a clip plane */
+    uint32_t drawn;                                     /*!< triangles passed to the rasterizer */
+    uint32_t pixels;                                    /*!< pixels that passed the depth test */
+} gui_3d_stats_struct;
+
+/* render target and camera */
+typedef struct {
+    uint16_t *color;                                    /*!< top left pixel of the viewport */
+    uint16_t *depth;                                    /*!< z-buffer of the viewport */
+    uint16_t width;
+    uint16_t height;
+    uint16_t color_stride;                              /*!< pixels from one line to the next */
+    uint16_t depth_stride;
+    gui_3d_depth_clear_func depth_clear;                /*!< NULL clears with the CPU */
+    gui_mat4_struct view_proj;
+    uint8_t cull_back;                                  /*!< skip triangles facing away */
+    gui_3d_stats_struct stats;
+} gui_3d_struct;
+
+/* matrix functions */
+/* set the identity matrix */
+void gui_mat4_identity(gui_mat4_struct *m);
+/* out = a * b, out may be a or b */
+void gui_mat4_mul(gui_mat4_struct *out, const gui_mat4_struct *a, const gui_mat4_struct *b);
+/* set a translation matrix */
+void gui_mat4_translation(gui_mat4_struct *m, int32_t x, int32_t y, int32_t z);
+/* set a scale matrix */
+void gui_mat4_scaling(gui_mat4_struct *m, int32_t x, int32_t y, int32_t z);
+/* set a rotation about the x axis, angle in degrees */
+void gui_mat4_rotation_x(gui_mat4_struct *m, int32_t degree);
+/* set a rotation about the y axis, angle in degrees */
+void gui_mat4_rotation_y(gui_mat4_struct *m, int32_t degree);
+/* set a rotation about the z axis, angle in degrees */
+void gui_mat4_rotation_z(gui_mat4_struct *m, int32_t degree);
+/* set a perspective projection, the camera looks down -z */
+void gui_mat4_perspective(gui_mat4_struct *m, int32_t fov_degree, int32_t aspect, int32_t z_near, int32_t z_far);
+
+/* pipeline functions */
+/* bind a render target, the camera starts as the identity */
+void gui_3d_init(gui_3d_struct *ctx, uint16_t *color, uint16_t color_stride, uint16_t *depth, uint16_t depth_stride,
+                 uint16_t width, uint16_t height);
+/* set the combined view and projection matrix */
+void gui_3d_set_camera(gui_3d_struct *ctx, const gui_mat4_struct *view_proj);
+/* reset the z-buffer to the far plane */
+void gui_3d_clear_depth(gui_3d_struct *ctx);
+/* draw one triangle given in world space */
+void gui_3d_draw_triangle(gui_3d_struct *ctx, const gui_3d_vertex_struct *v0, const gui_3d_vertex_struct *v1,
+                          const gui_3d_vertex_struct *v2, const gui_3d_texture_struct *texture, uint16_t color);
+/* draw a mesh placed by a model matrix */
+void gui_3d_draw_mesh(gui_3d_struct *ctx, const gui_3d_mesh_struct *mesh, const gui_mat4_struct *model);
+
+#endif /* GUI_3D_H */
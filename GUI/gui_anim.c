@@ -0,0 +1,420 @@
+/*!
+    \file    gui_anim.c
+    \brief   frame-time based widget animation engine
+
+    Every animation is evaluated against the clock, not against a frame
+    counter, so a late frame shows the value the property should have at
+    that time and the missed frames are simply dropped.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "gui_anim.h"
+
+/* 1.70158 and 2.70158 in Q16, the usual back overshoot */
+#define EASE_BACK_C1                111514
+#define EASE_BACK_C3                177050
+
+static gui_anim_clock_func anim_clock;
+static gui_anim_struct *anim_list;
+
+static uint32_t frame_period = GUI_FRAME_PERIOD_MS;
+static uint32_t frame_next;
+static uint8_t frame_started;
+static gui_frame_stats_struct frame_stats;
+
+/*!
+    \brief      set the clock source used by animations and frame pacing
+    \param[in]  clock: monotonic millisecond clock
+    \param[out] none
+    \retval     none
+*/
+void gui_anim_set_clock(gui_anim_clock_func clock)
+{
+    anim_clock = clock;
+    frame_started = 0;
+}
+
+/*!
+    \brief      read the animation clock
+    \param[in]  none
+    \param[out] none
+    \retval     milliseconds, 0 when no clock is set
+*/
+uint32_t gui_anim_now(void)
+{
+    return (NULL != anim_clock) ? anim_clock() : 0U;
+}
+
+/* multiply two Q16 numbers */
+static int32_t q16_mul(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b) >> 16);
+}
+
+/* sine of an angle given in Q16 degrees, Q16 result */
+static int32_t sin_q16_deg(int32_t degree_q16)
+{
+    int32_t whole = degree_q16 >> 16;
+    int32_t frac = degree_q16 & 0xFFFF;
+    int32_t s0 = gui_sin_q15(whole);
+    int32_t s1 = gui_sin_q15(whole + 1);
+
+    return (s0 + (int32_t)(((int64_t)(s1 - s0) * frac) >> 16)) * 2;
+}
+
+/* bounce out curve on Q16 */
+static int32_t ease_out_bounce(int32_t t)
+{
+    /* n1 = 7.5625, d1 = 2.75 */
+    const int32_t n1 = 495616;
+
+    if(t < 23831){
+        return q16_mul(n1, q16_mul(t, t));
+    }else if(t < 47663){
+        t -= 35747;
+        return q16_mul(n1, q16_mul(t, t)) + 49152;
+    }else if(t < 59578){
+        t -= 53620;
+        return q16_mul(n1, q16_mul(t, t)) + 61440;
+    }else{
+        t -= 62557;
+        return q16_mul(n1, q16_mul(t, t)) + 64512;
+    }
+}
+
+/*!
+    \brief      evaluate an easing curve
+    \param[in]  ease: curve to evaluate
+    \param[in]  t: progress in Q16, clamped to 0..1
+    \param[out] none
+    \retval     eased progress in Q16, may overshoot for GUI_EASE_OUT_BACK
+*/
+int32_t gui_ease(gui_ease_enum ease, int32_t t)
+{
+    int32_t u;
+
+    if(t <= 0){
+        return 0;
+    }
+    if(t >= GUI_Q16_ONE){
+        return GUI_Q16_ONE;
+    }
+
+    switch(ease){
+    case GUI_EASE_IN_QUAD:
+        return q16_mul(t, t);
+    case GUI_EASE_OUT_QUAD:
+        u = GUI_Q16_ONE - t;
+        return GUI_Q16_ONE - q16_mul(u, u);
+    case GUI_EASE_IN_OUT_QUAD:
+        if(t < GUI_Q16_ONE / 2){
+            return 2 * q16_mul(t, t);
+        }
+        u = GUI_Q16_ONE - t;
+        return GUI_Q16_ONE - 2 * q16_mul(u, u);
+    case GUI_EASE_IN_CUBIC:
+        return q16_mul(q16_mul(t, t), t);
+    case GUI_EASE_OUT_CUBIC:
+        u = GUI_Q16_ONE - t;
+        return GUI_Q16_ONE - q16_mul(q16_mul(u, u), u);
+    case GUI_EASE_IN_OUT_CUBIC:
+        if(t < GUI_Q16_ONE / 2){
+            return 4 * q16_mul(q16_mul(t, t), t);
+        }
+        u = GUI_Q16_ONE - t;
+        return GUI_Q16_ONE - 4 * q16_mul(q16_mul(u, u), u);
+    case GUI_EASE_IN_OUT_SINE:
+        /* (1 - cos(pi * t)) / 2 with cos(x) = sin(90 - x) */
+        return (GUI_Q16_ONE - sin_q16_deg((90 << 16) - 180 * t)) / 2;
+    case GUI_EASE_OUT_BACK:
+        u = t - GUI_Q16_ONE;
+        return GUI_Q16_ONE + q16_mul(EASE_BACK_C3, q16_mul(q16_mul(u, u), u)) + q16_mul(EASE_BACK_C1, q16_mul(u, u));
+    case GUI_EASE_OUT_BOUNCE:
+        return ease_out_bounce(t);
+    case GUI_EASE_LINEAR:
+    default:
+        return t;
+    }
+}
+
+/*!
+    \brief      interpolate two RGB565 colours channel by channel
+    \param[in]  from, to: RGB565 end points
+    \param[in]  t: progress in Q16
+    \param[out] none
+    \retval     RGB565 colour
+*/
+uint16_t gui_color_mix(uint16_t from, uint16_t to, int32_t t)
+{
+    int32_t r0 = (from >> 11) & 0x1F, g0 = (from >> 5) & 0x3F, b0 = from & 0x1F;
+    int32_t r1 = (to >> 11) & 0x1F, g1 = (to >> 5) & 0x3F, b1 = to & 0x1F;
+    int32_t r, g, b;
+
+    if(t < 0){
+        t = 0;
+    }
+    if(t > GUI_Q16_ONE){
+        t = GUI_Q16_ONE;
+    }
+    /* rounded, a falling channel must not leave its start value at the first step */
+    r = r0 + (((r1 - r0) * t + 0x8000) >> 16);
+    g = g0 + (((g1 - g0) * t + 0x8000) >> 16);
+    b = b0 + (((b1 - b0) * t + 0x8000) >> 16);
+
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+/*!
+    \brief      prepare an animation
+    \param[in]  anim: animation storage, owned by the caller
+    \param[in]  widget: animated widget
+    \param[in]  prop: animated property
+    \param[in]  from, to: end values
+    \param[in]  duration: length in milliseconds
+    \param[in]  ease: easing curve
+    \param[out] none
+    \retval     none
+*/
+void gui_anim_init(gui_anim_struct *anim, gui_widget_struct *widget, gui_anim_prop_enum prop,
+                   int32_t from, int32_t to, uint32_t duration, gui_ease_enum ease)
+{
+    memset(anim, 0, sizeof(*anim));
+    anim->widget = widget;
+    anim->prop = (uint8_t)prop;
+    anim->from = from;
+    anim->to = to;
+    anim->duration = duration;
+    anim->ease = (uint8_t)ease;
+}
+
+/*!
+    \brief      start or restart an animation from the current clock value
+    \param[in]  anim: prepared animation
+    \param[out] none
+    \retval     none
+*/
+void gui_anim_start(gui_anim_struct *anim)
+{
+    anim->start = gui_anim_now() + anim->delay;
+    if(!anim->active){
+        anim->active = 1;
+        anim->next = anim_list;
+        anim_list = anim;
+    }
+}
+
+/*!
+    \brief      stop an animation, the property keeps its current value
+    \param[in]  anim: animation to stop
+    \param[out] none
+    \retval     none
+*/
+void gui_anim_stop(gui_anim_struct *anim)
+{
+    gui_anim_struct **link;
+
+    for(link = &anim_list; NULL != *link; link = &(*link)->next){
+        if(anim == *link){
+            *link = anim->next;
+            break;
+        }
+    }
+    anim->active = 0;
+    anim->next = NULL;
+}
+
+/*!
+    \brief      stop every animation of a widget
+    \param[in]  widget: widget whose animations are stopped
+    \param[out] none
+    \retval     none
+*/
+void gui_anim_stop_widget(gui_widget_struct *widget)
+{
+    gui_anim_struct **link = &anim_list;
+    gui_anim_struct *anim;
+
+    while(NULL != *link){
+        anim = *link;
+        if(widget == anim->widget){
+            *link = anim->next;
+            anim->active = 0;
+            anim->next = NULL;
+        }else{
+            link = &anim->next;
+        }
+    }
+}
+
+/*!
+    \brief      write an animated value into its widget property
+    \param[in]  anim: animation
+    \param[in]  t: eased progress in Q16
+    \param[out] none
+    \retval     none
+*/
+static void anim_apply(gui_anim_struct *anim, int32_t t)
+{
+    gui_widget_struct *w = anim->widget;
+    int32_t value = anim->from + (int32_t)(((int64_t)(anim->to - anim->from) * t + 0x8000) >> 16);
+
+    switch(anim->prop){
+    case GUI_ANIM_PROP_X:
+        gui_widget_set_pos(w, (int16_t)value, w->y);
+        break;
+    case GUI_ANIM_PROP_Y:
+        gui_widget_set_pos(w, w->x, (int16_t)value);
+        break;
+    case GUI_ANIM_PROP_ALPHA:
+        if(value < 0){
+            value = 0;
+        }
+        if(value > 255){
+            value = 255;
+        }
+        gui_widget_set_alpha(w, (uint8_t)value);
+        break;
+    case GUI_ANIM_PROP_BG_COLOR:
+        gui_widget_set_color(w, gui_color_mix((uint16_t)anim->from, (uint16_t)anim->to, t), w->fg_color);
+        break;
+    case GUI_ANIM_PROP_FG_COLOR:
+        gui_widget_set_color(w, w->bg_color, gui_color_mix((uint16_t)anim->from, (uint16_t)anim->to, t));
+        break;
+    case GUI_ANIM_PROP_VALUE:
+        gui_widget_set_value(w, value);
+        break;
+    default:
+        break;
+    }
+}
+
+/*!
+    \brief      apply every running animation at the current clock value
+    \param[in]  none
+    \param[out] none
+    \retval     number of animations still running
+*/
+uint32_t gui_anim_update(void)
+{
+    uint32_t now = gui_anim_now();
+    uint32_t running = 0;
+    int32_t elapsed, t;
+    gui_anim_struct **link = &anim_list;
+    gui_anim_struct *anim, *finished = NULL;
+
+    while(NULL != *link){
+        anim = *link;
+        /* signed difference keeps working across clock wrap */
+        elapsed = (int32_t)(now - anim->start);
+        if(elapsed < 0){
+            link = &anim->next;
+            running++;
+            continue;
+        }
+
+        if((uint32_t)elapsed >= anim->duration){
+            anim_apply(anim, GUI_Q16_ONE);
+            *link = anim->next;
+            anim->active = 0;
+            anim->next = finished;
+            finished = anim;
+            continue;
+        }
+
+        t = (int32_t)(((uint64_t)(uint32_t)elapsed << 16) / anim->duration);
+        anim_apply(anim, gui_ease((gui_ease_enum)anim->ease, t));
+        link = &anim->next;
+        running++;
+    }
+
+    /* callbacks run last so that a restarted animation waits for the next update */
+    while(NULL != finished){
+        anim = finished;
+        finished = anim->next;
+        anim->next = NULL;
+        if(NULL != anim->done){
+            anim->done(anim);
+        }
+    }
+
+    return running;
+}
+
+/*!
+    \brief      set the frame period
+    \param[in]  period_ms: milliseconds between frames, 0 renders on every call
+    \param[out] none
+    \retval     none
+*/
+void gui_frame_set_period(uint32_t period_ms)
+{
+    frame_period = period_ms;
+    frame_started = 0;
+}
+
+/*!
+    \brief      check whether a new frame is due
+    \param[in]  none
+    \param[out] none
+    \retval     1 when a frame should be rendered now, 0 otherwise
+*/
+int gui_frame_due(void)
+{
+    uint32_t now = gui_anim_now();
+    uint32_t late;
+
+    if(!frame_started || (0U == frame_period)){
+        frame_started = 1;
+        frame_next = now + frame_period;
+        return 1;
+    }
+    if((int32_t)(now - frame_next) < 0){
+        return 0;
+    }
+
+    /* drop every slot that passed while the previous frame was rendering */
+    late = (now - frame_next) / frame_period;
+    frame_stats.skipped += late;
+    frame_next += (late + 1U) * frame_period;
+
+    return 1;
+}
+
+/*!
+    \brief      update animations and redraw when a frame is due
+    \param[in]  none
+    \param[out] none
+    \retval     1 when a frame was rendered, 0 otherwise
+*/
+int gui_frame_task(void)
+{
+    uint32_t begin;
+
+    if(!gui_frame_due()){
+        return 0;
+    }
+    begin = gui_anim_now();
+    gui_anim_update();
+    gui_refresh();
+
+    frame_stats.frames++;
+    frame_stats.last_frame_ms = gui_anim_now() - begin;
+    if(frame_stats.last_frame_ms > frame_stats.max_frame_ms){
+        frame_stats.max_frame_ms = frame_stats.last_frame_ms;
+    }
+    return 1;
+}
+
+/*!
+    \brief      get the frame pacing statistics
+    \param[in]  none
+    \param[out] none
+    \retval     statistics
+*/
+const gui_frame_stats_struct *gui_frame_stats_get(void)
+{
+    return &frame_stats;
+}
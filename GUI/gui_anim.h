@@ -0,0 +1,105 @@
+/*!
+    \file    gui_anim.h
+    \brief   the header file of the frame-time based widget animation engine
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef GUI_ANIM_H
+#define GUI_ANIM_H
+
+#include <stdint.h>
+#include "gui_widget.h"
+
+/* Q16 fixed point one */
+#define GUI_Q16_ONE                 65536
+
+/* default frame period, 60 Hz */
+#define GUI_FRAME_PERIOD_MS         16U
+
+/* monotonic millisecond clock, allowed to wrap */
+typedef uint32_t (*gui_anim_clock_func)(void);
+
+/* animated widget property */
+typedef enum {
+    GUI_ANIM_PROP_X = 0,                                /*!< x position relative to the parent */
+    GUI_ANIM_PROP_Y,                                    /*!< y position relative to the parent */
+    GUI_ANIM_PROP_ALPHA,                                /*!< opacity 0..255 */
+    GUI_ANIM_PROP_BG_COLOR,                             /*!< background colour, RGB565 end points */
+    GUI_ANIM_PROP_FG_COLOR,                             /*!< foreground colour, RGB565 end points */
+    GUI_ANIM_PROP_VALUE                                 /*!< bar or gauge value */
+} gui_anim_prop_enum;
+
+/* easing curve */
+typedef enum {
+    GUI_EASE_LINEAR = 0,
+    GUI_EASE_IN_QUAD,
+    GUI_EASE_OUT_QUAD,
+    GUI_EASE_IN_OUT_QUAD,
+    GUI_EASE_IN_CUBIC,
+    GUI_EASE_OUT_CUBIC,
+    GUI_EASE_IN_OUT_CUBIC,
+    GUI_EASE_IN_OUT_SINE,
+    GUI_EASE_OUT_BACK,
+    GUI_EASE_OUT_BOUNCE
+} gui_ease_enum;
+
+typedef struct gui_anim_struct gui_anim_struct;
+
+/* called from gui_anim_update() once the animation reached its end value */
+typedef void (*gui_anim_done_func)(gui_anim_struct *anim);
+
+struct gui_anim_struct {
+    gui_anim_struct *next;
+    gui_widget_struct *widget;
+    gui_anim_done_func done;                            /*!< optional, may restart the animation */
+    void *user;
+    int32_t from;
+    int32_t to;
+    uint32_t start;                                     /*!< clock value at which the tween begins */
+    uint32_t delay;                                     /*!< milliseconds between start and the first change */
+    uint32_t duration;
+    uint8_t prop;
+    uint8_t ease;
+    uint8_t active;
+};
+
+/* frame pacing statistics */
+typedef struct {
+    uint32_t frames;                                    /*!< frames rendered */
+    uint32_t skipped;                                   /*!< frame slots dropped because rendering fell behind */
+    uint32_t last_frame_ms;                             /*!< time spent in the last frame */
+    uint32_t max_frame_ms;                              /*!< longest frame */
+} gui_frame_stats_struct;
+
+/* set the clock source used by animations and frame pacing */
+void gui_anim_set_clock(gui_anim_clock_func clock);
+/* read the animation clock */
+uint32_t gui_anim_now(void);
+/* evaluate an easing curve, t and result are Q16 */
+int32_t gui_ease(gui_ease_enum ease, int32_t t);
+/* interpolate two RGB565 colours, t is Q16 */
+uint16_t gui_color_mix(uint16_t from, uint16_t to, int32_t t);
+
+/* prepare an animation, it is not running yet */
+void gui_anim_init(gui_anim_struct *anim, gui_widget_struct *widget, gui_anim_prop_enum prop,
+                   int32_t from, int32_t to, uint32_t duration, gui_ease_enum ease);
+/* start or restart an animation from the current clock value */
+void gui_anim_start(gui_anim_struct *anim);
+/* stop an animation, the property keeps its current value */
+void gui_anim_stop(gui_anim_struct *anim);
+/* stop every animation of a widget */
+void gui_anim_stop_widget(gui_widget_struct *widget);
+/* apply every running animation at the current clock value, return the number still running */
+uint32_t gui_anim_update(void);
+
+/* set the frame period in milliseconds */
+void gui_frame_set_period(uint32_t period_ms);
+/* check whether a new frame is due, dropping the slots that were missed */
+int gui_frame_due(void);
+/* update animations and redraw when a frame is due, return 1 when a frame was rendered */
+int gui_frame_task(void);
+/* get the frame pacing statistics */
+const gui_frame_stats_struct *gui_frame_stats_get(void);
+
+#endif /* GUI_ANIM_H */
@@ -0,0 +1,371 @@
+/*!
+    \file    gui_chart.c
+    \brief   decimating waveform chart widget
+
+    Samples are folded into a per-column min/max as they arrive, so the
+    cost of a frame depends on the chart width and not on the sample rate.
+    Each column is drawn as one vertical span.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "gui_chart.h"
+
+/* a column with min > max holds no data */
+#define COLUMN_EMPTY_MIN            INT16_MAX
+#define COLUMN_EMPTY_MAX            INT16_MIN
+
+static void chart_draw(gui_widget_struct *widget, const gui_rect_struct *clip);
+
+/*!
+    \brief      initialize a chart widget
+    \param[in]  chart: chart storage, owned by the caller
+    \param[in]  x, y: position relative to the parent
+    \param[in]  width, height: size in pixels, width is limited to GUI_CHART_MAX_COLUMNS
+    \param[in]  y_min, y_max: value range mapped to the chart height
+    \param[in]  samples_per_column: decimation factor of gui_chart_push()
+    \param[out] none
+    \retval     none
+*/
+void gui_chart_init(gui_chart_struct *chart, int16_t x, int16_t y, int16_t width, int16_t height,
+                    int32_t y_min, int32_t y_max, uint32_t samples_per_column)
+{
+    if(width > GUI_CHART_MAX_COLUMNS){
+        width = GUI_CHART_MAX_COLUMNS;
+    }
+    gui_widget_init(&chart->widget, x, y, width, height, chart_draw);
+    chart->widget.flags = GUI_FLAG_OPAQUE;
+    chart->widget.fg_color = GUI_RGB565(255, 255, 0);
+    chart->widget.u.ext = chart;
+    chart->columns = (uint16_t)width;
+    chart->samples_in = 0;
+    chart->columns_drawn = 0;
+    chart->samples_per_column = (0U == samples_per_column) ? 1U : samples_per_column;
+    gui_chart_set_range(chart, y_min, y_max);
+    gui_chart_clear(chart);
+}
+
+/*!
+    \brief      set the value range mapped to the chart height
+    \param[in]  chart: chart to change
+    \param[in]  y_min, y_max: values shown at the bottom and top edge
+    \param[out] none
+    \retval     none
+*/
+void gui_chart_set_range(gui_chart_struct *chart, int32_t y_min, int32_t y_max)
+{
+    if(y_max <= y_min){
+        y_max = y_min + 1;
+    }
+    chart->y_min = y_min;
+    chart->y_max = y_max;
+    chart->y_scale = (int32_t)(((int64_t)(chart->widget.height - 1) << 16) / (y_max - y_min));
+    gui_widget_invalidate(&chart->widget);
+}
+
+/*!
+    \brief      set how many pushed samples form one column
+    \param[in]  chart: chart to change
+    \param[in]  samples_per_column: decimation factor, at least 1
+    \param[out] none
+    \retval     none
+*/
+void gui_chart_set_decimation(gui_chart_struct *chart, uint32_t samples_per_column)
+{
+    chart->samples_per_column = (0U == samples_per_column) ? 1U : samples_per_column;
+    chart->acc_count = 0;
+}
+
+/*!
+    \brief      empty every column and restart the sweep at the left edge
+    \param[in]  chart: chart to clear
+    \param[out] none
+    \retval     none
+*/
+void gui_chart_clear(gui_chart_struct *chart)
+{
+    uint32_t i;
+
+    for(i = 0; i < chart->columns; i++){
+        chart->col_min[i] = COLUMN_EMPTY_MIN;
+        chart->col_max[i] = COLUMN_EMPTY_MAX;
+    }
+    chart->cursor = 0;
+    chart->acc_count = 0;
+    gui_widget_invalidate(&chart->widget);
+}
+
+/*!
+    \brief      damage columns first..last of a chart, both inclusive
+    \param[in]  chart: chart to redraw
+    \param[in]  first, last: column range, last may be smaller than first after a wrap
+    \param[out] none
+    \retval     none
+*/
+static void chart_invalidate_columns(gui_chart_struct *chart, uint32_t first, uint32_t last)
+{
+    gui_rect_struct r;
+    const gui_rect_struct *a = &chart->widget.area;
+
+    if(last < first){
+        /* wrapped around the right edge */
+        chart_invalidate_columns(chart, first, chart->columns - 1U);
+        first = 0;
+    }
+    gui_rect_set(&r, (int16_t)(a->x0 + first), a->y0, (int16_t)(last - first + 1U), chart->widget.height);
+    gui_widget_invalidate_rect(&chart->widget, &r);
+}
+
+/*!
+    \brief      fold a block of samples into the sweep
+    \param[in]  chart: chart to feed
+    \param[in]  samples: new samples, oldest first
+    \param[in]  count: number of samples
+    \param[out] none
+    \retval     none
+*/
+void gui_chart_push(gui_chart_struct *chart, const int16_t *samples, uint32_t count)
+{
+    uint32_t spc = chart->samples_per_column;
+    uint32_t acc = chart->acc_count;
+    uint32_t cursor = chart->cursor, first = chart->cursor, completed = 0;
+    int16_t lo = chart->acc_min, hi = chart->acc_max, v;
+
+    chart->samples_in += count;
+
+    while(0U != count){
+        if(0U == acc){
+            lo = COLUMN_EMPTY_MIN;
+            hi = COLUMN_EMPTY_MAX;
+        }
+
+        /* the inner loop only tracks min and max */
+        while((0U != count) && (acc < spc)){
+            v = *samples++;
+            if(v < lo){
+                lo = v;
+            }
+            if(v > hi){
+                hi = v;
+            }
+            acc++;
+            count--;
+        }
+        if(acc < spc){
+            break;
+        }
+
+        chart->col_min[cursor] = lo;
+        chart->col_max[cursor] = hi;
+        acc = 0;
+        completed++;
+        if(++cursor >= chart->columns){
+            cursor = 0;
+        }
+        /* the column ahead of the sweep is blanked to show where new data arrives */
+        chart->col_min[cursor] = COLUMN_EMPTY_MIN;
+        chart->col_max[cursor] = COLUMN_EMPTY_MAX;
+    }
+
+    chart->acc_count = acc;
+    chart->acc_min = lo;
+    chart->acc_max = hi;
+    chart->cursor = (uint16_t)cursor;
+
+    if(0U != completed){
+        if(completed >= chart->columns){
+            gui_widget_invalidate(&chart->widget);
+        }else{
+            /* the completed columns plus the blanked one ahead */
+            chart_invalidate_columns(chart, first, cursor);
+        }
+    }
+}
+
+/*!
+    \brief      replace the chart content with a whole sample buffer
+    \param[in]  chart: chart to fill
+    \param[in]  samples: sample buffer
+    \param[in]  count: number of samples
+    \param[in]  mode: GUI_CHART_MINMAX or GUI_CHART_LTTB
+    \param[out] none
+    \retval     none
+*/
+void gui_chart_load(gui_chart_struct *chart, const int16_t *samples, uint32_t count, gui_chart_mode_enum mode)
+{
+    static uint32_t index[GUI_CHART_MAX_COLUMNS];
+    uint32_t i, j, begin, end, n;
+    int16_t lo, hi, prev;
+
+    gui_chart_clear(chart);
+    if(0U == count){
+        return;
+    }
+
+    if(GUI_CHART_LTTB == mode){
+        n = gui_chart_lttb(samples, count, index, chart->columns);
+        prev = samples[index[0]];
+        for(i = 0; i < n; i++){
+            /* each column joins the previous point to this one */
+            lo = (samples[index[i]] < prev) ? samples[index[i]] : prev;
+            hi = (samples[index[i]] > prev) ? samples[index[i]] : prev;
+            chart->col_min[i] = lo;
+            chart->col_max[i] = hi;
+            prev = samples[index[i]];
+        }
+    }else{
+        n = (count < chart->columns) ? count : chart->columns;
+        for(i = 0; i < n; i++){
+            begin = (uint32_t)(((uint64_t)count * i) / n);
+            end = (uint32_t)(((uint64_t)count * (i + 1U)) / n);
+            lo = COLUMN_EMPTY_MIN;
+            hi = COLUMN_EMPTY_MAX;
+            for(j = begin; j < end; j++){
+                if(samples[j] < lo){
+                    lo = samples[j];
+                }
+                if(samples[j] > hi){
+                    hi = samples[j];
+                }
+            }
+            chart->col_min[i] = lo;
+            chart->col_max[i] = hi;
+        }
+    }
+    chart->samples_in += count;
+}
+
+/*!
+    \brief      select representative points with largest-triangle-three-buckets
+    \param[in]  samples: sample buffer, the x coordinate is the index
+    \param[in]  count: number of samples
+    \param[in]  out_count: number of points wanted
+    \param[out] out_index: indices of the selected samples, ascending
+    \retval     number of points selected
+*/
+uint32_t gui_chart_lttb(const int16_t *samples, uint32_t count, uint32_t *out_index, uint32_t out_count)
+{
+    uint32_t i, j, a = 0, pick, range_begin, range_end, avg_begin, avg_end, avg_n;
+    int64_t sum_x, sum_y, area, best, ax, ay;
+    uint64_t every;
+
+    if((out_count >= count) || (out_count < 3U)){
+        out_count = (out_count < count) ? out_count : count;
+        for(i = 0; i < out_count; i++){
+            out_index[i] = i;
+        }
+        return out_count;
+    }
+
+    /* bucket size in Q16, the first and last sample are always kept */
+    every = ((uint64_t)(count - 2U) << 16) / (out_count - 2U);
+    out_index[0] = 0;
+
+    for(i = 0; i < out_count - 2U; i++){
+        /* average of the next bucket */
+        avg_begin = (uint32_t)(((i + 1U) * every) >> 16) + 1U;
+        avg_end = (uint32_t)(((i + 2U) * every) >> 16) + 1U;
+        if(avg_end > count){
+            avg_end = count;
+        }
+        sum_x = 0;
+        sum_y = 0;
+        for(j = avg_begin; j < avg_end; j++){
+            sum_x += j;
+            sum_y += samples[j];
+        }
+        avg_n = avg_end - avg_begin;
+        if(0U == avg_n){
+            sum_x = count - 1U;
+            sum_y = samples[count - 1U];
+            avg_n = 1;
+        }
+
+        /* point of this bucket spanning the largest triangle, areas scaled by avg_n */
+        range_begin = (uint32_t)((i * every) >> 16) + 1U;
+        range_end = (uint32_t)(((i + 1U) * every) >> 16) + 1U;
+        ax = a;
+        ay = samples[a];
+        best = -1;
+        pick = range_begin;
+        for(j = range_begin; j < range_end; j++){
+            area = (ax * avg_n - sum_x) * (samples[j] - ay) - (ax - (int64_t)j) * (sum_y - ay * avg_n);
+            if(area < 0){
+                area = -area;
+            }
+            if(area > best){
+                best = area;
+                pick = j;
+            }
+        }
+        out_index[i + 1U] = pick;
+        a = pick;
+    }
+    out_index[out_count - 1U] = count - 1U;
+
+    return out_count;
+}
+
+/*!
+    \brief      map a sample value to a screen line of the chart
+    \param[in]  chart: chart
+    \param[in]  value: sample value
+    \param[out] none
+    \retval     screen y coordinate, clamped to the chart
+*/
+static int32_t chart_value_to_y(const gui_chart_struct *chart, int32_t value)
+{
+    int32_t offset = (int32_t)(((int64_t)(value - chart->y_min) * chart->y_scale) >> 16);
+
+    if(offset < 0){
+        offset = 0;
+    }
+    if(offset > chart->widget.height - 1){
+        offset = chart->widget.height - 1;
+    }
+    return chart->widget.area.y1 - 1 - offset;
+}
+
+static void chart_draw(gui_widget_struct *widget, const gui_rect_struct *clip)
+{
+    gui_chart_struct *chart = (gui_chart_struct *)widget->u.ext;
+    const gui_rect_struct *a = &widget->area;
+    gui_rect_struct span;
+    int32_t x, col, lo, hi, prev_lo, prev_hi;
+
+    /* background once for the whole damaged part, then one span per column */
+    gui_draw_fill(clip, a, widget->bg_color, widget->alpha);
+
+    for(x = clip->x0; x < clip->x1; x++){
+        col = x - a->x0;
+        if(col >= chart->columns){
+            break;
+        }
+        lo = chart->col_min[col];
+        hi = chart->col_max[col];
+        if(lo > hi){
+            continue;
+        }
+        /* stretch towards the previous column so the trace has no gaps */
+        if(col > 0){
+            prev_lo = chart->col_min[col - 1];
+            prev_hi = chart->col_max[col - 1];
+            if(prev_lo <= prev_hi){
+                if(lo > prev_hi){
+                    lo = prev_hi;
+                }
+                if(hi < prev_lo){
+                    hi = prev_lo;
+                }
+            }
+        }
+        span.x0 = (int16_t)x;
+        span.x1 = (int16_t)(x + 1);
+        span.y0 = (int16_t)chart_value_to_y(chart, hi);
+        span.y1 = (int16_t)(chart_value_to_y(chart, lo) + 1);
+        gui_draw_fill(clip, &span, widget->fg_color, widget->alpha);
+        chart->columns_drawn++;
+    }
+}
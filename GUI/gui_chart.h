@@ -0,0 +1,56 @@
+/*!
+    \file    gui_chart.h
+    \brief   the header file of the decimating waveform chart widget
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef GUI_CHART_H
+#define GUI_CHART_H
+
+#include <stdint.h>
+#include "gui_widget.h"
+
+#define GUI_CHART_MAX_COLUMNS       GUI_SCREEN_WIDTH
+
+/* how gui_chart_load() reduces a sample buffer to one entry per column */
+typedef enum {
+    GUI_CHART_MINMAX = 0,                               /*!< min and max of every bucket */
+    GUI_CHART_LTTB                                      /*!< largest-triangle-three-buckets point selection */
+} gui_chart_mode_enum;
+
+/* chart widget, the first member makes it usable wherever a widget is expected */
+typedef struct {
+    gui_widget_struct widget;
+    int32_t y_min;                                      /*!< value shown at the bottom edge */
+    int32_t y_max;                                      /*!< value shown at the top edge */
+    int32_t y_scale;                                    /*!< pixels per value in Q16 */
+    uint32_t samples_per_column;                        /*!< decimation factor of gui_chart_push() */
+    uint32_t acc_count;                                 /*!< samples folded into the open column */
+    int16_t acc_min;
+    int16_t acc_max;
+    uint16_t columns;                                   /*!< columns in use, the widget width */
+    uint16_t cursor;                                    /*!< column being filled, the sweep position */
+    uint32_t samples_in;                                /*!< samples ingested since init */
+    uint32_t columns_drawn;                             /*!< column spans drawn since init */
+    int16_t col_min[GUI_CHART_MAX_COLUMNS];
+    int16_t col_max[GUI_CHART_MAX_COLUMNS];
+} gui_chart_struct;
+
+/* initialize a chart widget */
+void gui_chart_init(gui_chart_struct *chart, int16_t x, int16_t y, int16_t width, int16_t height,
+                    int32_t y_min, int32_t y_max, uint32_t samples_per_column);
+/* set the value range mapped to the chart height */
+void gui_chart_set_range(gui_chart_struct *chart, int32_t y_min, int32_t y_max);
+/* set how many pushed samples form one column */
+void gui_chart_set_decimation(gui_chart_struct *chart, uint32_t samples_per_column);
+/* empty every column and restart the sweep at the left edge */
+void gui_chart_clear(gui_chart_struct *chart);
+/* fold a block of samples into the sweep, damaging only the columns completed */
+void gui_chart_push(gui_chart_struct *chart, const int16_t *samples, uint32_t count);
+/* replace the chart content with a whole sample buffer */
+void gui_chart_load(gui_chart_struct *chart, const int16_t *samples, uint32_t count, gui_chart_mode_enum mode);
+/* select out_count representative points of a buffer, return the number selected */
+uint32_t gui_chart_lttb(const int16_t *samples, uint32_t count, uint32_t *out_index, uint32_t out_count);
+
+#endif /* GUI_CHART_H */
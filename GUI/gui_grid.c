@@ -0,0 +1,387 @@
+/*!
+    \file    gui_grid.c
+    \brief   uniform-grid spatial index over the screen
+
+    Every item is linked into the cells its rectangle touches, so a point
+    query looks at one cell and a rectangle query at the cells it covers.
+    Cell lists are doubly linked and every item keeps the chain of its own
+    nodes, which makes removal independent of how crowded the cells are.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "gui_grid.h"
+
+#define ITEM_USED                   0x01U
+#define ITEM_BIG                    0x02U
+#define ITEM_OFFSCREEN              0x04U
+
+/*!
+    \brief      empty the index
+    \param[in]  grid: index to initialize
+    \param[out] none
+    \retval     none
+*/
+void gui_grid_init(gui_grid_struct *grid)
+{
+    uint32_t i;
+
+    for(i = 0; i < GUI_GRID_COLS * GUI_GRID_ROWS; i++){
+        grid->head[i] = GUI_GRID_NONE;
+    }
+    for(i = 0; i < GUI_GRID_MAX_NODES; i++){
+        grid->nodes[i].next = (uint16_t)((i + 1U < GUI_GRID_MAX_NODES) ? (i + 1U) : GUI_GRID_NONE);
+    }
+    for(i = 0; i < GUI_GRID_MAX_ITEMS; i++){
+        grid->items[i].flags = 0;
+        grid->items[i].stamp = 0;
+        grid->items[i].big_next = (uint16_t)((i + 1U < GUI_GRID_MAX_ITEMS) ? (i + 1U) : GUI_GRID_NONE);
+    }
+    grid->free_node = 0;
+    grid->free_item = 0;
+    grid->big_head = GUI_GRID_NONE;
+    grid->count = 0;
+    grid->stamp = 0;
+}
+
+/*!
+    \brief      compute the cell span of a rectangle
+    \param[in]  rect: rectangle in screen coordinates
+    \param[out] item: receives the span
+    \retval     number of cells, 0 when the rectangle is off screen
+*/
+static uint32_t grid_span(gui_grid_item_struct *item, const gui_rect_struct *rect)
+{
+    gui_rect_struct screen, r;
+
+    gui_rect_set(&screen, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT);
+    if(!gui_rect_intersect(&r, rect, &screen)){
+        return 0;
+    }
+    item->cx0 = (uint8_t)(r.x0 >> GUI_GRID_CELL_SHIFT);
+    item->cy0 = (uint8_t)(r.y0 >> GUI_GRID_CELL_SHIFT);
+    item->cx1 = (uint8_t)((r.x1 - 1) >> GUI_GRID_CELL_SHIFT);
+    item->cy1 = (uint8_t)((r.y1 - 1) >> GUI_GRID_CELL_SHIFT);
+
+    return (uint32_t)(item->cx1 - item->cx0 + 1) * (uint32_t)(item->cy1 - item->cy0 + 1);
+}
+
+/*!
+    \brief      release the cell nodes of an item and take it off the big list
+    \param[in]  grid: index
+    \param[in]  id: item id
+    \param[out] none
+    \retval     none
+*/
+static void grid_unlink(gui_grid_struct *grid, uint16_t id)
+{
+    gui_grid_item_struct *item = &grid->items[id];
+    gui_grid_node_struct *node;
+    uint16_t n, next;
+
+    if(item->flags & ITEM_BIG){
+        if(GUI_GRID_NONE != item->big_prev){
+            grid->items[item->big_prev].big_next = item->big_next;
+        }else{
+            grid->big_head = item->big_next;
+        }
+        if(GUI_GRID_NONE != item->big_next){
+            grid->items[item->big_next].big_prev = item->big_prev;
+        }
+    }
+
+    for(n = item->first_node; GUI_GRID_NONE != n; n = next){
+        node = &grid->nodes[n];
+        next = node->item_next;
+        if(GUI_GRID_NONE != node->prev){
+            grid->nodes[node->prev].next = node->next;
+        }else{
+            grid->head[node->cell] = node->next;
+        }
+        if(GUI_GRID_NONE != node->next){
+            grid->nodes[node->next].prev = node->prev;
+        }
+        node->next = grid->free_node;
+        grid->free_node = n;
+    }
+    item->first_node = GUI_GRID_NONE;
+    item->flags &= (uint8_t)~(ITEM_BIG | ITEM_OFFSCREEN);
+}
+
+/*!
+    \brief      put an item on the big list
+    \param[in]  grid: index
+    \param[in]  id: item id
+    \param[out] none
+    \retval     none
+*/
+static void grid_link_big(gui_grid_struct *grid, uint16_t id)
+{
+    gui_grid_item_struct *item = &grid->items[id];
+
+    item->flags |= ITEM_BIG;
+    item->big_prev = GUI_GRID_NONE;
+    item->big_next = grid->big_head;
+    if(GUI_GRID_NONE != grid->big_head){
+        grid->items[grid->big_head].big_prev = id;
+    }
+    grid->big_head = id;
+}
+
+/*!
+    \brief      link an item into the cells of its rectangle
+    \param[in]  grid: index
+    \param[in]  id: item id, currently unlinked
+    \param[out] none
+    \retval     none
+*/
+static void grid_link(gui_grid_struct *grid, uint16_t id)
+{
+    gui_grid_item_struct *item = &grid->items[id];
+    gui_grid_node_struct *node;
+    uint32_t cells, cx, cy, cell;
+    uint16_t n;
+
+    cells = grid_span(item, &item->rect);
+    if(0U == cells){
+        item->flags |= ITEM_OFFSCREEN;
+        return;
+    }
+    if(cells > GUI_GRID_BIG_CELLS){
+        grid_link_big(grid, id);
+        return;
+    }
+
+    for(cy = item->cy0; cy <= item->cy1; cy++){
+        for(cx = item->cx0; cx <= item->cx1; cx++){
+            n = grid->free_node;
+            if(GUI_GRID_NONE == n){
+                /* out of nodes: the big list is slower but still correct */
+                grid_unlink(grid, id);
+                grid_span(item, &item->rect);
+                grid_link_big(grid, id);
+                return;
+            }
+            node = &grid->nodes[n];
+            grid->free_node = node->next;
+
+            cell = cy * GUI_GRID_COLS + cx;
+            node->item = id;
+            node->cell = (uint16_t)cell;
+            node->prev = GUI_GRID_NONE;
+            node->next = grid->head[cell];
+            if(GUI_GRID_NONE != node->next){
+                grid->nodes[node->next].prev = n;
+            }
+            grid->head[cell] = n;
+
+            node->item_next = item->first_node;
+            item->first_node = n;
+        }
+    }
+}
+
+/*!
+    \brief      add an item
+    \param[in]  grid: index
+    \param[in]  rect: item bounds in screen coordinates
+    \param[in]  data: user pointer returned by queries
+    \param[out] none
+    \retval     item id, -1 when the index is full
+*/
+int32_t gui_grid_insert(gui_grid_struct *grid, const gui_rect_struct *rect, void *data)
+{
+    uint16_t id = grid->free_item;
+    gui_grid_item_struct *item;
+
+    if(GUI_GRID_NONE == id){
+        return -1;
+    }
+    item = &grid->items[id];
+    grid->free_item = item->big_next;
+
+    item->rect = *rect;
+    item->data = data;
+    item->flags = ITEM_USED;
+    item->first_node = GUI_GRID_NONE;
+    grid_link(grid, id);
+    grid->count++;
+
+    return id;
+}
+
+/*!
+    \brief      move or resize an item
+    \param[in]  grid: index
+    \param[in]  id: item id
+    \param[in]  rect: new bounds
+    \param[out] none
+    \retval     none
+*/
+void gui_grid_update(gui_grid_struct *grid, int32_t id, const gui_rect_struct *rect)
+{
+    gui_grid_item_struct *item, span;
+    uint32_t cells;
+
+    if(NULL == gui_grid_data(grid, id)){
+        return;
+    }
+    item = &grid->items[id];
+
+    /* relinking is only needed when the covered cells change */
+    cells = grid_span(&span, rect);
+    if((0U != cells) && !(item->flags & ITEM_OFFSCREEN) &&
+       (span.cx0 == item->cx0) && (span.cy0 == item->cy0) &&
+       (span.cx1 == item->cx1) && (span.cy1 == item->cy1)){
+        item->rect = *rect;
+        return;
+    }
+
+    grid_unlink(grid, (uint16_t)id);
+    item->rect = *rect;
+    grid_link(grid, (uint16_t)id);
+}
+
+/*!
+    \brief      remove an item
+    \param[in]  grid: index
+    \param[in]  id: item id
+    \param[out] none
+    \retval     none
+*/
+void gui_grid_remove(gui_grid_struct *grid, int32_t id)
+{
+    gui_grid_item_struct *item;
+
+    if(NULL == gui_grid_data(grid, id)){
+        return;
+    }
+    item = &grid->items[id];
+    grid_unlink(grid, (uint16_t)id);
+    item->flags = 0;
+    item->data = NULL;
+    item->big_next = grid->free_item;
+    grid->free_item = (uint16_t)id;
+    grid->count--;
+}
+
+/*!
+    \brief      get the data of an item
+    \param[in]  grid: index
+    \param[in]  id: item id
+    \param[out] none
+    \retval     user pointer, NULL when the id is not in use
+*/
+void *gui_grid_data(const gui_grid_struct *grid, int32_t id)
+{
+    if((id < 0) || (id >= GUI_GRID_MAX_ITEMS) || !(grid->items[id].flags & ITEM_USED)){
+        return NULL;
+    }
+    return grid->items[id].data;
+}
+
+/*!
+    \brief      start a new query, items carry the stamp of the last query that saw them
+    \param[in]  grid: index
+    \param[out] none
+    \retval     stamp of the new query
+*/
+static uint32_t grid_next_stamp(gui_grid_struct *grid)
+{
+    uint32_t i;
+
+    if(0U == ++grid->stamp){
+        for(i = 0; i < GUI_GRID_MAX_ITEMS; i++){
+            grid->items[i].stamp = 0;
+        }
+        grid->stamp = 1;
+    }
+    return grid->stamp;
+}
+
+/*!
+    \brief      collect the items containing a point
+    \param[in]  grid: index
+    \param[in]  x, y: point in screen coordinates
+    \param[in]  max: capacity of out
+    \param[out] out: data pointers of the items found
+    \retval     number of items stored
+*/
+uint32_t gui_grid_query_point(gui_grid_struct *grid, int16_t x, int16_t y, void **out, uint32_t max)
+{
+    uint32_t found = 0;
+    uint16_t n;
+    gui_grid_item_struct *item;
+
+    if((x < 0) || (y < 0) || (x >= GUI_SCREEN_WIDTH) || (y >= GUI_SCREEN_HEIGHT)){
+        return 0;
+    }
+
+    /* an item is linked only once per cell, no stamp needed */
+    n = grid->head[(y >> GUI_GRID_CELL_SHIFT) * GUI_GRID_COLS + (x >> GUI_GRID_CELL_SHIFT)];
+    for(; (GUI_GRID_NONE != n) && (found < max); n = grid->nodes[n].next){
+        item = &grid->items[grid->nodes[n].item];
+        if(gui_rect_contains_point(&item->rect, x, y)){
+            out[found++] = item->data;
+        }
+    }
+    for(n = grid->big_head; (GUI_GRID_NONE != n) && (found < max); n = grid->items[n].big_next){
+        item = &grid->items[n];
+        if(gui_rect_contains_point(&item->rect, x, y)){
+            out[found++] = item->data;
+        }
+    }
+
+    return found;
+}
+
+/*!
+    \brief      collect the items intersecting a rectangle
+    \param[in]  grid: index
+    \param[in]  rect: query rectangle in screen coordinates
+    \param[in]  max: capacity of out
+    \param[out] out: data pointers of the items found, each at most once
+    \retval     number of items stored
+*/
+uint32_t gui_grid_query_rect(gui_grid_struct *grid, const gui_rect_struct *rect, void **out, uint32_t max)
+{
+    gui_grid_item_struct span, *item;
+    gui_rect_struct overlap;
+    uint32_t found = 0, cx, cy, stamp;
+    uint16_t n;
+
+    if(0U == grid_span(&span, rect)){
+        return 0;
+    }
+    stamp = grid_next_stamp(grid);
+
+    for(cy = span.cy0; cy <= span.cy1; cy++){
+        for(cx = span.cx0; cx <= span.cx1; cx++){
+            for(n = grid->head[cy * GUI_GRID_COLS + cx]; GUI_GRID_NONE != n; n = grid->nodes[n].next){
+                item = &grid->items[grid->nodes[n].item];
+                if(stamp == item->stamp){
+                    continue;
+                }
+                item->stamp = stamp;
+                if(gui_rect_intersect(&overlap, &item->rect, rect)){
+                    if(found == max){
+                        return found;
+                    }
+                    out[found++] = item->data;
+                }
+            }
+        }
+    }
+    for(n = grid->big_head; GUI_GRID_NONE != n; n = grid->items[n].big_next){
+        item = &grid->items[n];
+        if(gui_rect_intersect(&overlap, &item->rect, rect)){
+            if(found == max){
+                return found;
+            }
+            out[found++] = item->data;
+        }
+    }
+
+    return found;
+}
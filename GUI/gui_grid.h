@@ -0,0 +1,76 @@
+/*!
+    \file    gui_grid.h
+    \brief   the header file of the uniform-grid spatial index over the screen
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef GUI_GRID_H
+#define GUI_GRID_H
+
+#include <stdint.h>
+#include "gui_widget.h"
+
+/* 32x32 pixel cells, 25x15 cells for 800x480 */
+#define GUI_GRID_CELL_SHIFT         5
+#define GUI_GRID_COLS               ((GUI_SCREEN_WIDTH + (1 << GUI_GRID_CELL_SHIFT) - 1) >> GUI_GRID_CELL_SHIFT)
+#define GUI_GRID_ROWS               ((GUI_SCREEN_HEIGHT + (1 << GUI_GRID_CELL_SHIFT) - 1) >> GUI_GRID_CELL_SHIFT)
+
+#define GUI_GRID_MAX_ITEMS          512
+#define GUI_GRID_MAX_NODES          2048
+/* items covering more cells than this go to a short list checked by every query */
+#define GUI_GRID_BIG_CELLS          16
+
+#define GUI_GRID_NONE               0xFFFFU
+
+/* one cell membership of an item */
+typedef struct {
+    uint16_t item;
+    uint16_t cell;
+    uint16_t prev;                                      /*!< previous node in the cell */
+    uint16_t next;                                      /*!< next node in the cell */
+    uint16_t item_next;                                 /*!< next node of the same item */
+} gui_grid_node_struct;
+
+typedef struct {
+    gui_rect_struct rect;
+    void *data;
+    uint32_t stamp;                                     /*!< last query that reported the item */
+    uint16_t first_node;                                /*!< node chain, GUI_GRID_NONE for big items */
+    uint16_t big_prev;
+    uint16_t big_next;                                  /*!< big list link, free list link when unused */
+    uint8_t cx0;                                        /*!< cell span, inclusive */
+    uint8_t cy0;
+    uint8_t cx1;
+    uint8_t cy1;
+    uint8_t flags;
+} gui_grid_item_struct;
+
+/* gui_grid_struct is declared in gui_widget.h, which takes one through gui_set_grid() */
+struct gui_grid_struct {
+    uint16_t head[GUI_GRID_COLS * GUI_GRID_ROWS];
+    gui_grid_node_struct nodes[GUI_GRID_MAX_NODES];
+    gui_grid_item_struct items[GUI_GRID_MAX_ITEMS];
+    uint16_t free_node;
+    uint16_t free_item;
+    uint16_t big_head;
+    uint16_t count;
+    uint32_t stamp;
+};
+
+/* empty the index */
+void gui_grid_init(gui_grid_struct *grid);
+/* add an item, return its id or -1 when the index is full */
+int32_t gui_grid_insert(gui_grid_struct *grid, const gui_rect_struct *rect, void *data);
+/* move or resize an item */
+void gui_grid_update(gui_grid_struct *grid, int32_t id, const gui_rect_struct *rect);
+/* remove an item */
+void gui_grid_remove(gui_grid_struct *grid, int32_t id);
+/* get the data of an item, NULL when the id is not in use */
+void *gui_grid_data(const gui_grid_struct *grid, int32_t id);
+/* collect the items containing a point, return the number stored */
+uint32_t gui_grid_query_point(gui_grid_struct *grid, int16_t x, int16_t y, void **out, uint32_t max);
+/* collect the items intersecting a rectangle, return the number stored */
+uint32_t gui_grid_query_rect(gui_grid_struct *grid, const gui_rect_struct *rect, void **out, uint32_t max);
+
+#endif /* GUI_GRID_H */
@@ -0,0 +1,92 @@
+/*!
+    \file    gui_port.c
+    \brief   GUI binding to the TLI frame buffer
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "lcd.h"
+#include "systick.h"
+#include "gui_port.h"
+#include "gui_anim.h"
+#include "gui_grid.h"
+#include "gui_3d.h"
+
+static void port_fill_rect(const gui_rect_struct *rect, uint16_t color, uint8_t alpha);
+static void port_depth_clear(uint16_t *depth, uint16_t stride, uint16_t width, uint16_t height, uint16_t value);
+
+/* glyph rendering is left to a font module, labels only draw their background for now */
+static const gui_disp_struct lcd_disp = {
+    port_fill_rect,
+    NULL,
+    NULL
+};
+
+static gui_grid_struct lcd_grid;
+/* z-buffer laid out like the frame buffer, so a viewport uses the same offsets in both */
+static uint16_t lcd_depth[LCD_HEIGHT * LCD_WIDTH] __attribute__((section(".sdram")));
+
+/*!
+    \brief      bind the widget tree to the LCD frame buffer, the spatial index and the SysTick clock
+    \param[in]  root: root of the widget tree
+    \param[out] none
+    \retval     none
+*/
+void gui_port_init(gui_widget_struct *root)
+{
+    gui_init(&lcd_disp, root);
+    gui_set_grid(&lcd_grid);
+    gui_anim_set_clock(systick_ms_get);
+}
+
+/*!
+    \brief      fill a clipped rectangle of the frame buffer
+    \param[in]  rect: rectangle inside the screen
+    \param[in]  color: RGB565 colour
+    \param[in]  alpha: opacity, 255 is opaque
+    \param[out] none
+    \retval     none
+*/
+static void port_fill_rect(const gui_rect_struct *rect, uint16_t color, uint8_t alpha)
+{
+    uint16_t width = (uint16_t)(rect->x1 - rect->x0);
+    uint16_t height = (uint16_t)(rect->y1 - rect->y0);
+
+    if(GUI_ALPHA_OPAQUE == alpha){
+        lcd_fill_rect((uint16_t)rect->x0, (uint16_t)rect->y0, width, height, color);
+    }else{
+        lcd_blend_rect((uint16_t)rect->x0, (uint16_t)rect->y0, width, height, color, alpha);
+    }
+}
+
+/*!
+    \brief      bind a 3D pipeline to a rectangle of the frame buffer
+    \param[in]  ctx: pipeline context
+    \param[in]  x, y: top left corner of the viewport
+    \param[in]  width, height: viewport size in pixels
+    \param[out] none
+    \retval     none
+*/
+void gui_port_3d_init(gui_3d_struct *ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+    uint32_t offset = (uint32_t)LCD_WIDTH * y + x;
+
+    gui_3d_init(ctx, ltdc_lcd_framebuf0[0] + offset, LCD_WIDTH, lcd_depth + offset, LCD_WIDTH, width, height);
+    ctx->depth_clear = port_depth_clear;
+}
+
+/*!
+    \brief      fill a z-buffer rectangle with the IPA
+    \param[in]  depth: top left entry
+    \param[in]  stride: entries from one line to the next
+    \param[in]  width, height: size in entries
+    \param[in]  value: depth to store
+    \param[out] none
+    \retval     none
+*/
+static void port_depth_clear(uint16_t *depth, uint16_t stride, uint16_t width, uint16_t height, uint16_t value)
+{
+    /* a 16-bit depth is written exactly like an RGB565 pixel */
+    lcd_ipa_fill((uint32_t)depth, (uint16_t)(stride - width), width, height, value);
+}
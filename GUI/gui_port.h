@@ -0,0 +1,19 @@
+/*!
+    \file    gui_port.h
+    \brief   the header file of the GUI binding to the TLI frame buffer
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef GUI_PORT_H
+#define GUI_PORT_H
+
+#include "gui_widget.h"
+#include "gui_3d.h"
+
+/* bind the widget tree to the LCD frame buffer, the spatial index and the SysTick clock */
+void gui_port_init(gui_widget_struct *root);
+/* bind a 3D pipeline to a rectangle of the frame buffer, the z-buffer lives in SDRAM */
+void gui_port_3d_init(gui_3d_struct *ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+#endif /* GUI_PORT_H */
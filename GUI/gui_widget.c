@@ -0,0 +1,1286 @@
+/*!
+    \file    gui_widget.c
+    \brief   retained-mode widget tree with invalidation-driven redraw
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "gui_widget.h"
+#include "gui_grid.h"
+#include "mem_section.h"
+
+/* one widget to draw into the current damaged rectangle */
+typedef struct {
+    gui_widget_struct *widget;
+    gui_rect_struct clip;
+} gui_draw_entry_struct;
+
+static struct {
+    const gui_disp_struct *disp;
+    gui_widget_struct *root;
+    gui_rect_struct dirty[GUI_DIRTY_MAX];
+    uint32_t dirty_count;
+    gui_stats_struct stats;
+    gui_grid_struct *grid;                              /*!< spatial index, NULL when not used */
+    uint8_t grid_full;                                  /*!< some widget did not fit, queries walk the tree */
+    uint8_t order_dirty;                                /*!< tree changed since paint orders were numbered */
+} gui;
+
+static gui_draw_entry_struct draw_list[GUI_DRAW_LIST_MAX] TCM_BSS;
+static uint32_t draw_count;
+static void *grid_hits[GUI_DRAW_LIST_MAX] TCM_BSS;
+
+/* sine of 0..90 degree, Q15 */
+static const int16_t sin_table[91] = {
+        0,   572,  1144,  1715,  2286,  2856,  3425,  3993,  4560,  5126,
+     5690,  6252,  6813,  7371,  7927,  8481,  9032,  9580, 10126, 10668,
+    11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+    16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+    21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+    25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+    28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+    30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+    32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+    32767
+};
+
+static void draw_list_flush(const gui_rect_struct *damage);
+static void widget_update_area(gui_widget_struct *widget);
+static void grid_register(gui_widget_struct *widget);
+static void grid_unregister(gui_widget_struct *widget);
+static void container_relayout(gui_widget_struct *widget);
+static void container_draw(gui_widget_struct *widget, const gui_rect_struct *clip);
+static void label_draw(gui_widget_struct *widget, const gui_rect_struct *clip);
+static void button_draw(gui_widget_struct *widget, const gui_rect_struct *clip);
+static void bar_draw(gui_widget_struct *widget, const gui_rect_struct *clip);
+static void gauge_draw(gui_widget_struct *widget, const gui_rect_struct *clip);
+
+/*!
+    \brief      set a rectangle from position and size
+    \param[in]  rect: rectangle to set
+    \param[in]  x, y: top left corner
+    \param[in]  width, height: size in pixels
+    \param[out] none
+    \retval     none
+*/
+void gui_rect_set(gui_rect_struct *rect, int16_t x, int16_t y, int16_t width, int16_t height)
+{
+    rect->x0 = x;
+    rect->y0 = y;
+    rect->x1 = (int16_t)(x + width);
+    rect->y1 = (int16_t)(y + height);
+}
+
+/*!
+    \brief      check whether a rectangle has no area
+    \param[in]  rect: rectangle to check
+    \param[out] none
+    \retval     1 when empty, 0 otherwise
+*/
+int gui_rect_is_empty(const gui_rect_struct *rect)
+{
+    return (rect->x0 >= rect->x1) || (rect->y0 >= rect->y1);
+}
+
+/*!
+    \brief      intersect two rectangles
+    \param[in]  a, b: rectangles to intersect
+    \param[out] out: intersection, may alias a or b
+    \retval     1 when the rectangles overlap, 0 otherwise
+*/
+int gui_rect_intersect(gui_rect_struct *out, const gui_rect_struct *a, const gui_rect_struct *b)
+{
+    gui_rect_struct r;
+
+    r.x0 = (a->x0 > b->x0) ? a->x0 : b->x0;
+    r.y0 = (a->y0 > b->y0) ? a->y0 : b->y0;
+    r.x1 = (a->x1 < b->x1) ? a->x1 : b->x1;
+    r.y1 = (a->y1 < b->y1) ? a->y1 : b->y1;
+    *out = r;
+
+    return !gui_rect_is_empty(&r);
+}
+
+/*!
+    \brief      bounding box of two rectangles
+    \param[in]  a, b: rectangles to join
+    \param[out] out: bounding box, may alias a or b
+    \retval     none
+*/
+void gui_rect_union(gui_rect_struct *out, const gui_rect_struct *a, const gui_rect_struct *b)
+{
+    gui_rect_struct r;
+
+    r.x0 = (a->x0 < b->x0) ? a->x0 : b->x0;
+    r.y0 = (a->y0 < b->y0) ? a->y0 : b->y0;
+    r.x1 = (a->x1 > b->x1) ? a->x1 : b->x1;
+    r.y1 = (a->y1 > b->y1) ? a->y1 : b->y1;
+    *out = r;
+}
+
+/*!
+    \brief      check whether inner lies completely inside outer
+    \param[in]  outer, inner: rectangles to compare
+    \param[out] none
+    \retval     1 when inner is covered by outer, 0 otherwise
+*/
+int gui_rect_contains(const gui_rect_struct *outer, const gui_rect_struct *inner)
+{
+    return (inner->x0 >= outer->x0) && (inner->y0 >= outer->y0) &&
+           (inner->x1 <= outer->x1) && (inner->y1 <= outer->y1);
+}
+
+/*!
+    \brief      check whether a point lies inside a rectangle
+    \param[in]  rect: rectangle to check
+    \param[in]  x, y: point in screen coordinates
+    \param[out] none
+    \retval     1 when inside, 0 otherwise
+*/
+int gui_rect_contains_point(const gui_rect_struct *rect, int16_t x, int16_t y)
+{
+    return (x >= rect->x0) && (x < rect->x1) && (y >= rect->y0) && (y < rect->y1);
+}
+
+/*!
+    \brief      sine of an angle in degrees
+    \param[in]  degree: angle, any value
+    \param[out] none
+    \retval     sine in Q15
+*/
+int32_t gui_sin_q15(int32_t degree)
+{
+    degree %= 360;
+    if(degree < 0){
+        degree += 360;
+    }
+    if(degree <= 90){
+        return sin_table[degree];
+    }else if(degree <= 180){
+        return sin_table[180 - degree];
+    }else if(degree <= 270){
+        return -sin_table[degree - 180];
+    }else{
+        return -sin_table[360 - degree];
+    }
+}
+
+/*!
+    \brief      bind the display driver and the root widget
+    \param[in]  disp: display driver
+    \param[in]  root: root of the widget tree, usually a full screen container
+    \param[out] none
+    \retval     none
+*/
+void gui_init(const gui_disp_struct *disp, gui_widget_struct *root)
+{
+    gui_rect_struct screen;
+
+    gui.disp = disp;
+    gui.root = root;
+    gui.dirty_count = 0;
+    memset(&gui.stats, 0, sizeof(gui.stats));
+
+    if(NULL != root){
+        root->parent = NULL;
+        widget_update_area(root);
+    }
+    gui_set_grid(gui.grid);
+    gui_rect_set(&screen, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT);
+    gui_invalidate_rect(&screen);
+}
+
+/*!
+    \brief      index the widget tree for hit testing and redraw
+    \param[in]  grid: spatial index to fill, NULL to go back to tree walks
+    \param[out] none
+    \retval     none
+*/
+void gui_set_grid(gui_grid_struct *grid)
+{
+    gui.grid = grid;
+    gui.grid_full = 0;
+    gui.order_dirty = 1;
+    if(NULL == grid){
+        return;
+    }
+    gui_grid_init(grid);
+    if(NULL != gui.root){
+        grid_register(gui.root);
+    }
+}
+
+/*!
+    \brief      add a subtree to the spatial index
+    \param[in]  widget: subtree root
+    \param[out] none
+    \retval     none
+*/
+static void grid_register(gui_widget_struct *widget)
+{
+    gui_widget_struct *child;
+    int32_t id;
+
+    if(NULL == gui.grid){
+        return;
+    }
+    /* ids left over from an earlier index are not trusted */
+    if(widget != gui_grid_data(gui.grid, widget->grid_id)){
+        id = gui_grid_insert(gui.grid, &widget->area, widget);
+        if(id < 0){
+            gui.grid_full = 1;
+        }
+        widget->grid_id = (int16_t)id;
+    }
+    for(child = widget->child; NULL != child; child = child->next){
+        grid_register(child);
+    }
+}
+
+/*!
+    \brief      remove a subtree from the spatial index
+    \param[in]  widget: subtree root
+    \param[out] none
+    \retval     none
+*/
+static void grid_unregister(gui_widget_struct *widget)
+{
+    gui_widget_struct *child;
+
+    if(NULL == gui.grid){
+        return;
+    }
+    if(widget == gui_grid_data(gui.grid, widget->grid_id)){
+        gui_grid_remove(gui.grid, widget->grid_id);
+    }
+    widget->grid_id = -1;
+    for(child = widget->child; NULL != child; child = child->next){
+        grid_unregister(child);
+    }
+}
+
+/*!
+    \brief      number a subtree in paint order
+    \param[in]  widget: subtree root
+    \param[in]  order: next number to hand out
+    \param[out] none
+    \retval     next number after the subtree
+*/
+static uint16_t order_assign(gui_widget_struct *widget, uint16_t order)
+{
+    gui_widget_struct *child;
+
+    widget->order = order++;
+    for(child = widget->child; NULL != child; child = child->next){
+        order = order_assign(child, order);
+    }
+    return order;
+}
+
+/*!
+    \brief      renumber the paint order after the tree changed
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void order_refresh(void)
+{
+    if(gui.order_dirty && (NULL != gui.root)){
+        order_assign(gui.root, 0);
+        gui.order_dirty = 0;
+    }
+}
+
+/*!
+    \brief      get the root widget
+    \param[in]  none
+    \param[out] none
+    \retval     root widget
+*/
+gui_widget_struct *gui_root_get(void)
+{
+    return gui.root;
+}
+
+/*!
+    \brief      mark a screen rectangle as damaged
+    \param[in]  rect: damaged rectangle in screen coordinates
+    \param[out] none
+    \retval     none
+*/
+void gui_invalidate_rect(const gui_rect_struct *rect)
+{
+    gui_rect_struct r, screen, merged;
+    uint32_t i, best = 0;
+    int32_t cost, best_cost = INT32_MAX;
+
+    gui_rect_set(&screen, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT);
+    if(!gui_rect_intersect(&r, rect, &screen)){
+        return;
+    }
+
+    /* already covered */
+    for(i = 0; i < gui.dirty_count; i++){
+        if(gui_rect_contains(&gui.dirty[i], &r)){
+            return;
+        }
+    }
+
+    /* merge with every rectangle it overlaps, the result may overlap others */
+    i = 0;
+    while(i < gui.dirty_count){
+        if(gui_rect_intersect(&merged, &gui.dirty[i], &r)){
+            gui_rect_union(&r, &gui.dirty[i], &r);
+            gui.dirty[i] = gui.dirty[--gui.dirty_count];
+            i = 0;
+        }else{
+            i++;
+        }
+    }
+
+    if(gui.dirty_count < GUI_DIRTY_MAX){
+        gui.dirty[gui.dirty_count++] = r;
+        return;
+    }
+
+    /* list full: grow the rectangle that needs the least extra area */
+    for(i = 0; i < gui.dirty_count; i++){
+        gui_rect_union(&merged, &gui.dirty[i], &r);
+        cost = (int32_t)(merged.x1 - merged.x0) * (merged.y1 - merged.y0) -
+               (int32_t)(gui.dirty[i].x1 - gui.dirty[i].x0) * (gui.dirty[i].y1 - gui.dirty[i].y0);
+        if(cost < best_cost){
+            best_cost = cost;
+            best = i;
+        }
+    }
+    gui_rect_union(&gui.dirty[best], &gui.dirty[best], &r);
+}
+
+/*!
+    \brief      check whether there is damage waiting for gui_refresh()
+    \param[in]  none
+    \param[out] none
+    \retval     1 when dirty, 0 otherwise
+*/
+int gui_is_dirty(void)
+{
+    return 0U != gui.dirty_count;
+}
+
+/*!
+    \brief      find the topmost visible widget of a subtree at a point
+    \param[in]  widget: subtree root
+    \param[in]  x, y: point in screen coordinates
+    \param[out] none
+    \retval     widget hit, NULL when the subtree is missed
+*/
+static gui_widget_struct *hit_test_walk(gui_widget_struct *widget, int16_t x, int16_t y)
+{
+    gui_widget_struct *child, *hit = NULL, *found;
+
+    /* children are clipped to their parent */
+    if((widget->flags & GUI_FLAG_HIDDEN) || !gui_rect_contains_point(&widget->area, x, y)){
+        return NULL;
+    }
+    for(child = widget->child; NULL != child; child = child->next){
+        found = hit_test_walk(child, x, y);
+        if(NULL != found){
+            hit = found;
+        }
+    }
+    return (NULL != hit) ? hit : widget;
+}
+
+/*!
+    \brief      get the topmost visible widget at a screen point
+    \param[in]  x, y: point in screen coordinates
+    \param[out] none
+    \retval     widget hit, NULL when there is none
+*/
+gui_widget_struct *gui_hit_test(int16_t x, int16_t y)
+{
+    gui_widget_struct *widget, *hit = NULL;
+    gui_rect_struct vis;
+    uint32_t i, count;
+
+    if(NULL == gui.root){
+        return NULL;
+    }
+    if((NULL != gui.grid) && !gui.grid_full){
+        count = gui_grid_query_point(gui.grid, x, y, grid_hits, GUI_DRAW_LIST_MAX);
+        if(count < GUI_DRAW_LIST_MAX){
+            order_refresh();
+            for(i = 0; i < count; i++){
+                widget = (gui_widget_struct *)grid_hits[i];
+                if(((NULL == hit) || (widget->order > hit->order)) &&
+                   gui_widget_visible_area(widget, &vis) && gui_rect_contains_point(&vis, x, y)){
+                    hit = widget;
+                }
+            }
+            return hit;
+        }
+    }
+    return hit_test_walk(gui.root, x, y);
+}
+
+/*!
+    \brief      collect the widgets of a subtree that intersect a damaged rectangle
+    \param[in]  widget: subtree root
+    \param[in]  damage: damaged rectangle
+    \param[in]  parent_clip: visible area of the parent
+    \param[out] none
+    \retval     none
+*/
+static void draw_list_collect(gui_widget_struct *widget, const gui_rect_struct *damage, const gui_rect_struct *parent_clip)
+{
+    gui_rect_struct clip, part;
+    gui_widget_struct *child;
+
+    if(widget->flags & GUI_FLAG_HIDDEN){
+        return;
+    }
+    /* children are clipped to their parent, so a miss prunes the whole subtree */
+    if(!gui_rect_intersect(&clip, &widget->area, parent_clip)){
+        return;
+    }
+    if(!gui_rect_intersect(&part, &clip, damage)){
+        return;
+    }
+
+    if(GUI_DRAW_LIST_MAX == draw_count){
+        draw_list_flush(damage);
+    }
+    draw_list[draw_count].widget = widget;
+    draw_list[draw_count].clip = part;
+    draw_count++;
+
+    for(child = widget->child; NULL != child; child = child->next){
+        draw_list_collect(child, damage, &clip);
+    }
+}
+
+/*!
+    \brief      collect the widgets that intersect a damaged rectangle through the spatial index
+    \param[in]  damage: damaged rectangle
+    \param[out] none
+    \retval     1 when the draw list is complete, 0 when the tree has to be walked instead
+*/
+static int draw_list_collect_grid(const gui_rect_struct *damage)
+{
+    gui_rect_struct vis, part;
+    gui_widget_struct *widget;
+    uint32_t i, j, count;
+
+    count = gui_grid_query_rect(gui.grid, damage, grid_hits, GUI_DRAW_LIST_MAX);
+    if(GUI_DRAW_LIST_MAX == count){
+        /* may be truncated, and overflowing needs the tree order anyway */
+        return 0;
+    }
+    order_refresh();
+
+    draw_count = 0;
+    for(i = 0; i < count; i++){
+        widget = (gui_widget_struct *)grid_hits[i];
+        if(!gui_widget_visible_area(widget, &vis) || !gui_rect_intersect(&part, &vis, damage)){
+            continue;
+        }
+        /* insertion sort by paint order, the candidates are few */
+        for(j = draw_count; (j > 0) && (draw_list[j - 1].widget->order > widget->order); j--){
+            draw_list[j] = draw_list[j - 1];
+        }
+        draw_list[j].widget = widget;
+        draw_list[j].clip = part;
+        draw_count++;
+    }
+    return 1;
+}
+
+/*!
+    \brief      draw the collected widgets bottom to top, skipping covered ones
+    \param[in]  damage: damaged rectangle
+    \param[out] none
+    \retval     none
+*/
+static void draw_list_flush(const gui_rect_struct *damage)
+{
+    uint32_t i, j, start = 0;
+    int covered;
+
+    /* everything below the topmost opaque widget covering the damage is hidden */
+    for(i = draw_count; i > 0; i--){
+        if(gui_widget_is_opaque(draw_list[i - 1].widget) && gui_rect_contains(&draw_list[i - 1].clip, damage)){
+            start = i - 1;
+            break;
+        }
+    }
+    gui.stats.culled += start;
+
+    for(i = start; i < draw_count; i++){
+        covered = 0;
+        for(j = i + 1; j < draw_count; j++){
+            if(gui_widget_is_opaque(draw_list[j].widget) && gui_rect_contains(&draw_list[j].clip, &draw_list[i].clip)){
+                covered = 1;
+                break;
+            }
+        }
+        if(covered){
+            gui.stats.culled++;
+            continue;
+        }
+        if(NULL != draw_list[i].widget->draw){
+            draw_list[i].widget->draw(draw_list[i].widget, &draw_list[i].clip);
+        }
+        gui.stats.drawn++;
+    }
+    draw_count = 0;
+}
+
+/*!
+    \brief      redraw every damaged rectangle
+    \param[in]  none
+    \param[out] none
+    \retval     number of rectangles redrawn
+*/
+uint32_t gui_refresh(void)
+{
+    gui_rect_struct damage[GUI_DIRTY_MAX];
+    gui_rect_struct screen;
+    uint32_t i, count;
+
+    if((NULL == gui.disp) || (NULL == gui.root) || (0U == gui.dirty_count)){
+        return 0;
+    }
+
+    /* take the list first, drawing must not invalidate but may do so safely */
+    count = gui.dirty_count;
+    memcpy(damage, gui.dirty, count * sizeof(gui_rect_struct));
+    gui.dirty_count = 0;
+
+    gui_rect_set(&screen, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT);
+    for(i = 0; i < count; i++){
+        if((NULL == gui.grid) || gui.grid_full || !draw_list_collect_grid(&damage[i])){
+            draw_count = 0;
+            draw_list_collect(gui.root, &damage[i], &screen);
+        }
+        draw_list_flush(&damage[i]);
+        if(NULL != gui.disp->flush){
+            gui.disp->flush(&damage[i]);
+        }
+    }
+    gui.stats.refreshes++;
+    gui.stats.rects += count;
+
+    return count;
+}
+
+/*!
+    \brief      fill part of a widget
+    \param[in]  clip: current draw clip
+    \param[in]  rect: rectangle to fill in screen coordinates
+    \param[in]  color: RGB565 colour
+    \param[in]  alpha: opacity, 255 is opaque
+    \param[out] none
+    \retval     none
+*/
+void gui_draw_fill(const gui_rect_struct *clip, const gui_rect_struct *rect, uint16_t color, uint8_t alpha)
+{
+    gui_rect_struct r;
+
+    if((0U == alpha) || !gui_rect_intersect(&r, rect, clip)){
+        return;
+    }
+    gui.stats.pixels += (uint32_t)(r.x1 - r.x0) * (uint32_t)(r.y1 - r.y0);
+    gui.disp->fill_rect(&r, color, alpha);
+}
+
+/*!
+    \brief      draw a string
+    \param[in]  clip: current draw clip
+    \param[in]  x, y: top left corner of the text
+    \param[in]  text: string to draw
+    \param[in]  color: RGB565 colour
+    \param[out] none
+    \retval     none
+*/
+void gui_draw_text(const gui_rect_struct *clip, int16_t x, int16_t y, const char *text, uint16_t color)
+{
+    if((NULL == text) || (NULL == gui.disp->draw_text)){
+        return;
+    }
+    gui.disp->draw_text(x, y, text, color, clip);
+}
+
+/*!
+    \brief      get the renderer statistics
+    \param[in]  none
+    \param[out] none
+    \retval     statistics
+*/
+const gui_stats_struct *gui_stats_get(void)
+{
+    return &gui.stats;
+}
+
+/*!
+    \brief      reset the renderer statistics
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void gui_stats_reset(void)
+{
+    memset(&gui.stats, 0, sizeof(gui.stats));
+}
+
+/*!
+    \brief      initialize the common part of a widget
+    \param[in]  widget: widget to initialize
+    \param[in]  x, y: position relative to the parent
+    \param[in]  width, height: size in pixels
+    \param[in]  draw: draw function
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, gui_draw_func draw)
+{
+    memset(widget, 0, sizeof(*widget));
+    widget->draw = draw;
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = height;
+    widget->alpha = GUI_ALPHA_OPAQUE;
+    widget->bg_color = GUI_RGB565(0, 0, 0);
+    widget->fg_color = GUI_RGB565(255, 255, 255);
+    widget->grid_id = -1;
+    gui_rect_set(&widget->area, x, y, width, height);
+}
+
+/*!
+    \brief      initialize a container widget
+    \param[in]  widget: widget to initialize
+    \param[in]  x, y: position relative to the parent
+    \param[in]  width, height: size in pixels
+    \param[in]  bg_color: fill colour
+    \param[out] none
+    \retval     none
+*/
+void gui_container_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, uint16_t bg_color)
+{
+    gui_widget_init(widget, x, y, width, height, container_draw);
+    widget->bg_color = bg_color;
+    widget->flags = GUI_FLAG_OPAQUE;
+}
+
+/*!
+    \brief      initialize a label widget, transparent by default
+    \param[in]  widget: widget to initialize
+    \param[in]  x, y: position relative to the parent
+    \param[in]  width, height: size in pixels
+    \param[in]  text: string to show, must stay valid
+    \param[out] none
+    \retval     none
+*/
+void gui_label_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, const char *text)
+{
+    gui_widget_init(widget, x, y, width, height, label_draw);
+    widget->u.label.text = text;
+}
+
+/*!
+    \brief      initialize a button widget
+    \param[in]  widget: widget to initialize
+    \param[in]  x, y: position relative to the parent
+    \param[in]  width, height: size in pixels
+    \param[in]  text: caption, must stay valid
+    \param[out] none
+    \retval     none
+*/
+void gui_button_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, const char *text)
+{
+    gui_widget_init(widget, x, y, width, height, button_draw);
+    widget->bg_color = GUI_RGB565(64, 64, 64);
+    widget->flags = GUI_FLAG_OPAQUE;
+    widget->u.button.text = text;
+}
+
+/*!
+    \brief      initialize a bar widget, vertical when higher than wide
+    \param[in]  widget: widget to initialize
+    \param[in]  x, y: position relative to the parent
+    \param[in]  width, height: size in pixels
+    \param[in]  min, max: value range
+    \param[out] none
+    \retval     none
+*/
+void gui_bar_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, int32_t min, int32_t max)
+{
+    gui_widget_init(widget, x, y, width, height, bar_draw);
+    widget->bg_color = GUI_RGB565(32, 32, 32);
+    widget->fg_color = GUI_RGB565(0, 200, 0);
+    widget->flags = GUI_FLAG_OPAQUE;
+    widget->u.bar.min = min;
+    widget->u.bar.max = max;
+    widget->u.bar.value = min;
+}
+
+/*!
+    \brief      initialize a gauge widget, a half dial with a needle
+    \param[in]  widget: widget to initialize
+    \param[in]  x, y: position relative to the parent
+    \param[in]  width, height: size in pixels
+    \param[in]  min, max: value range
+    \param[out] none
+    \retval     none
+*/
+void gui_gauge_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, int32_t min, int32_t max)
+{
+    gui_widget_init(widget, x, y, width, height, gauge_draw);
+    widget->bg_color = GUI_RGB565(32, 32, 32);
+    widget->fg_color = GUI_RGB565(255, 64, 0);
+    widget->flags = GUI_FLAG_OPAQUE;
+    widget->u.gauge.min = min;
+    widget->u.gauge.max = max;
+    widget->u.gauge.value = min;
+}
+
+/*!
+    \brief      recompute the screen area of a subtree
+    \param[in]  widget: subtree root
+    \param[out] none
+    \retval     none
+*/
+static void widget_update_area(gui_widget_struct *widget)
+{
+    gui_widget_struct *child;
+    int16_t ox = 0, oy = 0;
+
+    if(NULL != widget->parent){
+        ox = widget->parent->area.x0;
+        oy = widget->parent->area.y0;
+    }
+    gui_rect_set(&widget->area, (int16_t)(ox + widget->x), (int16_t)(oy + widget->y), widget->width, widget->height);
+    if((NULL != gui.grid) && (widget == gui_grid_data(gui.grid, widget->grid_id))){
+        gui_grid_update(gui.grid, widget->grid_id, &widget->area);
+    }
+
+    for(child = widget->child; NULL != child; child = child->next){
+        widget_update_area(child);
+    }
+}
+
+/*!
+    \brief      check whether a widget is part of the screen tree
+    \param[in]  widget: widget to check
+    \param[out] none
+    \retval     1 when attached, 0 otherwise
+*/
+static int widget_attached(const gui_widget_struct *widget)
+{
+    while(NULL != widget->parent){
+        widget = widget->parent;
+    }
+    return widget == gui.root;
+}
+
+/*!
+    \brief      append a widget on top of the children of parent
+    \param[in]  parent: new parent
+    \param[in]  widget: widget to add, must not be in a tree
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_add(gui_widget_struct *parent, gui_widget_struct *widget)
+{
+    gui_widget_struct **link = &parent->child;
+
+    while(NULL != *link){
+        link = &(*link)->next;
+    }
+    *link = widget;
+    widget->next = NULL;
+    widget->parent = parent;
+    gui.order_dirty = 1;
+
+    if((container_draw == parent->draw) && (GUI_LAYOUT_NONE != parent->u.container.layout)){
+        container_relayout(parent);
+        gui_widget_invalidate(parent);
+    }else{
+        widget_update_area(widget);
+        gui_widget_invalidate(widget);
+    }
+    if(widget_attached(parent)){
+        grid_register(widget);
+    }
+}
+
+/*!
+    \brief      detach a widget and its children from the tree
+    \param[in]  widget: widget to remove
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_remove(gui_widget_struct *widget)
+{
+    gui_widget_struct **link;
+
+    if(NULL == widget->parent){
+        return;
+    }
+    gui_widget_invalidate(widget);
+
+    for(link = &widget->parent->child; NULL != *link; link = &(*link)->next){
+        if(widget == *link){
+            *link = widget->next;
+            break;
+        }
+    }
+    widget->parent = NULL;
+    widget->next = NULL;
+    gui.order_dirty = 1;
+    grid_unregister(widget);
+}
+
+/*!
+    \brief      get the visible part of a widget
+    \param[in]  widget: widget to check
+    \param[out] out: visible area in screen coordinates
+    \retval     1 when something is visible, 0 otherwise
+*/
+int gui_widget_visible_area(const gui_widget_struct *widget, gui_rect_struct *out)
+{
+    const gui_widget_struct *w;
+
+    *out = widget->area;
+    for(w = widget; NULL != w; w = w->parent){
+        if(w->flags & GUI_FLAG_HIDDEN){
+            return 0;
+        }
+        if(!gui_rect_intersect(out, out, &w->area)){
+            return 0;
+        }
+        if(NULL == w->parent && w != gui.root){
+            /* not attached to the screen */
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*!
+    \brief      check whether a widget hides everything below it
+    \param[in]  widget: widget to check
+    \param[out] none
+    \retval     1 when opaque, 0 otherwise
+*/
+int gui_widget_is_opaque(const gui_widget_struct *widget)
+{
+    return (widget->flags & GUI_FLAG_OPAQUE) && (GUI_ALPHA_OPAQUE == widget->alpha);
+}
+
+/*!
+    \brief      damage the visible area of a widget
+    \param[in]  widget: widget to redraw
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_invalidate(gui_widget_struct *widget)
+{
+    gui_rect_struct r;
+
+    if(gui_widget_visible_area(widget, &r)){
+        gui_invalidate_rect(&r);
+    }
+}
+
+/*!
+    \brief      damage part of a widget
+    \param[in]  widget: widget to redraw
+    \param[in]  rect: part to redraw in screen coordinates
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_invalidate_rect(gui_widget_struct *widget, const gui_rect_struct *rect)
+{
+    gui_rect_struct r;
+
+    if(gui_widget_visible_area(widget, &r) && gui_rect_intersect(&r, &r, rect)){
+        gui_invalidate_rect(&r);
+    }
+}
+
+/*!
+    \brief      move a widget relative to its parent
+    \param[in]  widget: widget to move
+    \param[in]  x, y: new position
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_set_pos(gui_widget_struct *widget, int16_t x, int16_t y)
+{
+    if((x == widget->x) && (y == widget->y)){
+        return;
+    }
+    gui_widget_invalidate(widget);
+    widget->x = x;
+    widget->y = y;
+    widget_update_area(widget);
+    gui_widget_invalidate(widget);
+}
+
+/*!
+    \brief      resize a widget
+    \param[in]  widget: widget to resize
+    \param[in]  width, height: new size
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_set_size(gui_widget_struct *widget, int16_t width, int16_t height)
+{
+    gui_widget_struct *parent = widget->parent;
+
+    if((width == widget->width) && (height == widget->height)){
+        return;
+    }
+    gui_widget_invalidate(widget);
+    widget->width = width;
+    widget->height = height;
+
+    if((NULL != parent) && (container_draw == parent->draw) && (GUI_LAYOUT_NONE != parent->u.container.layout)){
+        /* siblings move as well */
+        gui_widget_invalidate(parent);
+        container_relayout(parent);
+    }else{
+        widget_update_area(widget);
+    }
+    gui_widget_invalidate(widget);
+}
+
+/*!
+    \brief      set the background and foreground colours
+    \param[in]  widget: widget to change
+    \param[in]  bg_color, fg_color: RGB565 colours
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_set_color(gui_widget_struct *widget, uint16_t bg_color, uint16_t fg_color)
+{
+    if((bg_color == widget->bg_color) && (fg_color == widget->fg_color)){
+        return;
+    }
+    widget->bg_color = bg_color;
+    widget->fg_color = fg_color;
+    gui_widget_invalidate(widget);
+}
+
+/*!
+    \brief      set the widget opacity
+    \param[in]  widget: widget to change
+    \param[in]  alpha: 0 is invisible, 255 is opaque
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_set_alpha(gui_widget_struct *widget, uint8_t alpha)
+{
+    if(alpha == widget->alpha){
+        return;
+    }
+    widget->alpha = alpha;
+    gui_widget_invalidate(widget);
+}
+
+/*!
+    \brief      show or hide a widget
+    \param[in]  widget: widget to change
+    \param[in]  hidden: non-zero to hide
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_set_hidden(gui_widget_struct *widget, int hidden)
+{
+    if(hidden){
+        if(!(widget->flags & GUI_FLAG_HIDDEN)){
+            gui_widget_invalidate(widget);
+            widget->flags |= GUI_FLAG_HIDDEN;
+        }
+    }else{
+        if(widget->flags & GUI_FLAG_HIDDEN){
+            widget->flags &= (uint8_t)~GUI_FLAG_HIDDEN;
+            gui_widget_invalidate(widget);
+        }
+    }
+}
+
+/*!
+    \brief      set the text of a label or button
+    \param[in]  widget: widget to change
+    \param[in]  text: new string, must stay valid
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_set_text(gui_widget_struct *widget, const char *text)
+{
+    if(label_draw == widget->draw){
+        widget->u.label.text = text;
+    }else if(button_draw == widget->draw){
+        widget->u.button.text = text;
+    }else{
+        return;
+    }
+    gui_widget_invalidate(widget);
+}
+
+/*!
+    \brief      set the value of a bar or gauge, clamped to its range
+    \param[in]  widget: widget to change
+    \param[in]  value: new value
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_set_value(gui_widget_struct *widget, int32_t value)
+{
+    int32_t *target;
+    int32_t min, max;
+
+    if(bar_draw == widget->draw){
+        target = &widget->u.bar.value;
+        min = widget->u.bar.min;
+        max = widget->u.bar.max;
+    }else if(gauge_draw == widget->draw){
+        target = &widget->u.gauge.value;
+        min = widget->u.gauge.min;
+        max = widget->u.gauge.max;
+    }else{
+        return;
+    }
+
+    if(value < min){
+        value = min;
+    }
+    if(value > max){
+        value = max;
+    }
+    if(value == *target){
+        return;
+    }
+    *target = value;
+    gui_widget_invalidate(widget);
+}
+
+/*!
+    \brief      set the pressed state of a button
+    \param[in]  widget: button to change
+    \param[in]  pressed: non-zero when pressed
+    \param[out] none
+    \retval     none
+*/
+void gui_widget_set_pressed(gui_widget_struct *widget, int pressed)
+{
+    uint8_t flags = widget->flags;
+
+    if(pressed){
+        flags |= GUI_FLAG_PRESSED;
+    }else{
+        flags &= (uint8_t)~GUI_FLAG_PRESSED;
+    }
+    if(flags != widget->flags){
+        widget->flags = flags;
+        gui_widget_invalidate(widget);
+    }
+}
+
+/*!
+    \brief      arrange the children of a container
+    \param[in]  widget: container
+    \param[in]  layout: GUI_LAYOUT_NONE, GUI_LAYOUT_ROW or GUI_LAYOUT_COLUMN
+    \param[in]  gap: spacing around children in pixels
+    \param[out] none
+    \retval     none
+*/
+void gui_container_set_layout(gui_widget_struct *widget, gui_layout_enum layout, uint8_t gap)
+{
+    if(container_draw != widget->draw){
+        return;
+    }
+    widget->u.container.layout = (uint8_t)layout;
+    widget->u.container.gap = gap;
+    container_relayout(widget);
+    gui_widget_invalidate(widget);
+}
+
+/*!
+    \brief      place the children of a container according to its layout
+    \param[in]  widget: container
+    \param[out] none
+    \retval     none
+*/
+static void container_relayout(gui_widget_struct *widget)
+{
+    gui_widget_struct *child;
+    int16_t cursor = widget->u.container.gap;
+
+    for(child = widget->child; NULL != child; child = child->next){
+        if(GUI_LAYOUT_ROW == widget->u.container.layout){
+            child->x = cursor;
+            child->y = widget->u.container.gap;
+            cursor = (int16_t)(cursor + child->width + widget->u.container.gap);
+        }else if(GUI_LAYOUT_COLUMN == widget->u.container.layout){
+            child->x = widget->u.container.gap;
+            child->y = cursor;
+            cursor = (int16_t)(cursor + child->height + widget->u.container.gap);
+        }
+    }
+    widget_update_area(widget);
+}
+
+static void container_draw(gui_widget_struct *widget, const gui_rect_struct *clip)
+{
+    gui_draw_fill(clip, &widget->area, widget->bg_color, widget->alpha);
+}
+
+static void label_draw(gui_widget_struct *widget, const gui_rect_struct *clip)
+{
+    int16_t y = (int16_t)(widget->area.y0 + (widget->height - GUI_FONT_HEIGHT) / 2);
+
+    if(widget->flags & GUI_FLAG_OPAQUE){
+        gui_draw_fill(clip, &widget->area, widget->bg_color, widget->alpha);
+    }
+    gui_draw_text(clip, widget->area.x0, y, widget->u.label.text, widget->fg_color);
+}
+
+static void button_draw(gui_widget_struct *widget, const gui_rect_struct *clip)
+{
+    const gui_rect_struct *a = &widget->area;
+    gui_rect_struct edge;
+    uint16_t face = widget->bg_color, ink = widget->fg_color;
+    int16_t tx, ty;
+
+    if(widget->flags & GUI_FLAG_PRESSED){
+        face = widget->fg_color;
+        ink = widget->bg_color;
+    }
+    gui_draw_fill(clip, a, face, widget->alpha);
+
+    /* one pixel border */
+    gui_rect_set(&edge, a->x0, a->y0, widget->width, 1);
+    gui_draw_fill(clip, &edge, widget->fg_color, widget->alpha);
+    gui_rect_set(&edge, a->x0, (int16_t)(a->y1 - 1), widget->width, 1);
+    gui_draw_fill(clip, &edge, widget->fg_color, widget->alpha);
+    gui_rect_set(&edge, a->x0, a->y0, 1, widget->height);
+    gui_draw_fill(clip, &edge, widget->fg_color, widget->alpha);
+    gui_rect_set(&edge, (int16_t)(a->x1 - 1), a->y0, 1, widget->height);
+    gui_draw_fill(clip, &edge, widget->fg_color, widget->alpha);
+
+    if(NULL != widget->u.button.text){
+        tx = (int16_t)(a->x0 + (widget->width - (int16_t)strlen(widget->u.button.text) * GUI_FONT_WIDTH) / 2);
+        ty = (int16_t)(a->y0 + (widget->height - GUI_FONT_HEIGHT) / 2);
+        gui_draw_text(clip, tx, ty, widget->u.button.text, ink);
+    }
+}
+
+static void bar_draw(gui_widget_struct *widget, const gui_rect_struct *clip)
+{
+    const gui_rect_struct *a = &widget->area;
+    gui_rect_struct fill = *a;
+    /* a range of int32_t values spans up to 2^32 - 1, the products up to 2^47 */
+    int64_t range = (int64_t)widget->u.bar.max - widget->u.bar.min;
+    int64_t pos = (int64_t)widget->u.bar.value - widget->u.bar.min;
+
+    gui_draw_fill(clip, a, widget->bg_color, widget->alpha);
+    if(range <= 0){
+        return;
+    }
+    if(pos < 0){
+        pos = 0;
+    }
+    if(pos > range){
+        pos = range;
+    }
+
+    if(widget->width >= widget->height){
+        fill.x1 = (int16_t)(a->x0 + widget->width * pos / range);
+    }else{
+        fill.y0 = (int16_t)(a->y1 - widget->height * pos / range);
+    }
+    if(!gui_rect_is_empty(&fill)){
+        gui_draw_fill(clip, &fill, widget->fg_color, widget->alpha);
+    }
+}
+
+/*!
+    \brief      draw a thick line with one small fill per step
+    \param[in]  clip: current draw clip
+    \param[in]  x0, y0, x1, y1: end points
+    \param[in]  size: pen size in pixels
+    \param[in]  color: RGB565 colour
+    \param[in]  alpha: opacity
+    \param[out] none
+    \retval     none
+*/
+static void draw_line(const gui_rect_struct *clip, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                      int16_t size, uint16_t color, uint8_t alpha)
+{
+    int32_t dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
+    int32_t dy = (y1 > y0) ? (y0 - y1) : (y1 - y0);
+    int32_t sx = (x0 < x1) ? 1 : -1;
+    int32_t sy = (y0 < y1) ? 1 : -1;
+    int32_t err = dx + dy, e2;
+    gui_rect_struct dot;
+
+    while(1){
+        gui_rect_set(&dot, (int16_t)(x0 - size / 2), (int16_t)(y0 - size / 2), size, size);
+        gui_draw_fill(clip, &dot, color, alpha);
+        if((x0 == x1) && (y0 == y1)){
+            break;
+        }
+        e2 = 2 * err;
+        if(e2 >= dy){
+            err += dy;
+            x0 += sx;
+        }
+        if(e2 <= dx){
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+static void gauge_draw(gui_widget_struct *widget, const gui_rect_struct *clip)
+{
+    const gui_rect_struct *a = &widget->area;
+    int32_t cx = (a->x0 + a->x1) / 2;
+    int32_t cy = a->y1 - 4;
+    int32_t radius = (widget->width / 2 < widget->height) ? (widget->width / 2) : widget->height;
+    int64_t range = (int64_t)widget->u.gauge.max - widget->u.gauge.min;
+    int64_t pos = (int64_t)widget->u.gauge.value - widget->u.gauge.min;
+    int32_t angle, tip_x, tip_y;
+    gui_rect_struct tick;
+
+    gui_draw_fill(clip, a, widget->bg_color, widget->alpha);
+    radius -= 6;
+    if((radius <= 0) || (range <= 0)){
+        return;
+    }
+    if(pos < 0){
+        pos = 0;
+    }
+    if(pos > range){
+        pos = range;
+    }
+
+    /* scale ticks every 18 degrees */
+    for(angle = 0; angle <= 180; angle += 18){
+        tip_x = cx + ((radius * gui_sin_q15(90 - angle)) >> 15);
+        tip_y = cy - ((radius * gui_sin_q15(angle)) >> 15);
+        gui_rect_set(&tick, (int16_t)(tip_x - 1), (int16_t)(tip_y - 1), 3, 3);
+        gui_draw_fill(clip, &tick, widget->fg_color, widget->alpha);
+    }
+
+    /* needle sweeps from the left (min) to the right (max) */
+    angle = 180 - (int32_t)(pos * 180 / range);
+    tip_x = cx + (((radius - 4) * gui_sin_q15(90 - angle)) >> 15);
+    tip_y = cy - (((radius - 4) * gui_sin_q15(angle)) >> 15);
+    draw_line(clip, cx, cy, tip_x, tip_y, 2, widget->fg_color, widget->alpha);
+}
@@ -0,0 +1,203 @@
+/*!
+    \file    gui_widget.h
+    \brief   the header file of the retained-mode widget tree
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef GUI_WIDGET_H
+#define GUI_WIDGET_H
+
+#include <stdint.h>
+
+#define GUI_SCREEN_WIDTH            800
+#define GUI_SCREEN_HEIGHT           480
+
+/* maximum number of damaged rectangles kept between two refreshes */
+#define GUI_DIRTY_MAX               16
+/* maximum number of widgets drawn into one damaged rectangle */
+#define GUI_DRAW_LIST_MAX           128
+
+/* fixed cell size used to lay out text, the glyphs come from the display driver */
+#define GUI_FONT_WIDTH              8
+#define GUI_FONT_HEIGHT             16
+
+/* widget flags */
+#define GUI_FLAG_HIDDEN             0x01U       /*!< widget and its children are not drawn */
+#define GUI_FLAG_OPAQUE             0x02U       /*!< widget covers its whole area, anything below is culled */
+#define GUI_FLAG_PRESSED            0x04U       /*!< button is pressed */
+
+#define GUI_ALPHA_OPAQUE            255U
+
+/* RGB565 colour helper */
+#define GUI_RGB565(r, g, b)         ((uint16_t)((((r) & 0xF8U) << 8) | (((g) & 0xFCU) << 3) | ((b) >> 3)))
+
+/* container child layout */
+typedef enum {
+    GUI_LAYOUT_NONE = 0,                                /*!< children keep their own position */
+    GUI_LAYOUT_ROW,                                     /*!< children are placed left to right */
+    GUI_LAYOUT_COLUMN                                   /*!< children are placed top to bottom */
+} gui_layout_enum;
+
+/* screen rectangle, x1/y1 are exclusive */
+typedef struct {
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+} gui_rect_struct;
+
+/* display driver used by the renderer */
+typedef struct {
+    /* fill a rectangle already clipped to the screen, alpha 255 is opaque */
+    void (*fill_rect)(const gui_rect_struct *rect, uint16_t color, uint8_t alpha);
+    /* draw a string with its top left corner at (x, y), optional */
+    void (*draw_text)(int16_t x, int16_t y, const char *text, uint16_t color, const gui_rect_struct *clip);
+    /* called once per damaged rectangle after it has been redrawn, optional */
+    void (*flush)(const gui_rect_struct *rect);
+} gui_disp_struct;
+
+typedef struct gui_widget_struct gui_widget_struct;
+/* spatial index of gui_grid.h */
+typedef struct gui_grid_struct gui_grid_struct;
+
+/* draw the part of a widget that lies inside clip */
+typedef void (*gui_draw_func)(gui_widget_struct *widget, const gui_rect_struct *clip);
+
+struct gui_widget_struct {
+    gui_widget_struct *parent;
+    gui_widget_struct *child;                           /*!< first child, drawn first (bottom) */
+    gui_widget_struct *next;                            /*!< next sibling, drawn above this one */
+    gui_draw_func draw;
+    int16_t x;                                          /*!< position relative to the parent */
+    int16_t y;
+    int16_t width;
+    int16_t height;
+    gui_rect_struct area;                               /*!< absolute screen area, kept up to date */
+    uint16_t bg_color;
+    uint16_t fg_color;
+    uint8_t alpha;
+    uint8_t flags;
+    uint16_t id;
+    int16_t grid_id;                                    /*!< spatial index item, -1 when not indexed */
+    uint16_t order;                                     /*!< paint order, higher is on top */
+    union {
+        struct {
+            uint8_t layout;
+            uint8_t gap;
+        } container;
+        struct {
+            const char *text;
+        } label;
+        struct {
+            const char *text;
+        } button;
+        struct {
+            int32_t min;
+            int32_t max;
+            int32_t value;
+        } bar;
+        struct {
+            int32_t min;
+            int32_t max;
+            int32_t value;
+        } gauge;
+        void *ext;                                      /*!< private data of custom widgets */
+    } u;
+};
+
+/* renderer statistics, reset with gui_stats_reset() */
+typedef struct {
+    uint32_t refreshes;                                 /*!< gui_refresh() calls that had damage */
+    uint32_t rects;                                     /*!< damaged rectangles processed */
+    uint32_t drawn;                                     /*!< widget draw calls */
+    uint32_t culled;                                    /*!< widgets skipped because they were covered */
+    uint32_t pixels;                                    /*!< pixels passed to fill_rect */
+} gui_stats_struct;
+
+/* rectangle helpers */
+/* set a rectangle from position and size */
+void gui_rect_set(gui_rect_struct *rect, int16_t x, int16_t y, int16_t width, int16_t height);
+/* check whether a rectangle has no area */
+int gui_rect_is_empty(const gui_rect_struct *rect);
+/* intersect two rectangles, return 0 when they do not overlap */
+int gui_rect_intersect(gui_rect_struct *out, const gui_rect_struct *a, const gui_rect_struct *b);
+/* bounding box of two rectangles */
+void gui_rect_union(gui_rect_struct *out, const gui_rect_struct *a, const gui_rect_struct *b);
+/* check whether inner lies completely inside outer */
+int gui_rect_contains(const gui_rect_struct *outer, const gui_rect_struct *inner);
+/* check whether a point lies inside a rectangle */
+int gui_rect_contains_point(const gui_rect_struct *rect, int16_t x, int16_t y);
+/* sine of an angle in degrees, Q15 */
+int32_t gui_sin_q15(int32_t degree);
+
+/* screen functions */
+/* bind the display driver and the root widget, the whole screen is damaged */
+void gui_init(const gui_disp_struct *disp, gui_widget_struct *root);
+/* index the widget tree in grid for hit testing and redraw, NULL goes back to tree walks */
+void gui_set_grid(gui_grid_struct *grid);
+/* get the root widget */
+gui_widget_struct *gui_root_get(void);
+/* mark a screen rectangle as damaged */
+void gui_invalidate_rect(const gui_rect_struct *rect);
+/* redraw every damaged rectangle, return the number of rectangles redrawn */
+uint32_t gui_refresh(void);
+/* check whether there is damage waiting for gui_refresh() */
+int gui_is_dirty(void);
+/* get the topmost visible widget at a screen point, NULL when there is none */
+gui_widget_struct *gui_hit_test(int16_t x, int16_t y);
+/* fill part of a widget, clipped to the current draw clip */
+void gui_draw_fill(const gui_rect_struct *clip, const gui_rect_struct *rect, uint16_t color, uint8_t alpha);
+/* draw a string, clipped to the current draw clip */
+void gui_draw_text(const gui_rect_struct *clip, int16_t x, int16_t y, const char *text, uint16_t color);
+/* get the renderer statistics */
+const gui_stats_struct *gui_stats_get(void);
+/* reset the renderer statistics */
+void gui_stats_reset(void);
+
+/* widget functions */
+/* initialize a container widget */
+void gui_container_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, uint16_t bg_color);
+/* initialize a label widget */
+void gui_label_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, const char *text);
+/* initialize a button widget */
+void gui_button_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, const char *text);
+/* initialize a bar widget */
+void gui_bar_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, int32_t min, int32_t max);
+/* initialize a gauge widget */
+void gui_gauge_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, int32_t min, int32_t max);
+/* initialize the common part of a custom widget */
+void gui_widget_init(gui_widget_struct *widget, int16_t x, int16_t y, int16_t width, int16_t height, gui_draw_func draw);
+
+/* append a widget on top of the children of parent */
+void gui_widget_add(gui_widget_struct *parent, gui_widget_struct *widget);
+/* detach a widget and its children from the tree */
+void gui_widget_remove(gui_widget_struct *widget);
+/* damage the visible area of a widget */
+void gui_widget_invalidate(gui_widget_struct *widget);
+/* damage part of a widget, rect is in screen coordinates */
+void gui_widget_invalidate_rect(gui_widget_struct *widget, const gui_rect_struct *rect);
+/* get the visible part of a widget, return 0 when nothing is visible */
+int gui_widget_visible_area(const gui_widget_struct *widget, gui_rect_struct *out);
+/* check whether a widget hides everything below it */
+int gui_widget_is_opaque(const gui_widget_struct *widget);
+/* move a widget relative to its parent */
+void gui_widget_set_pos(gui_widget_struct *widget, int16_t x, int16_t y);
+/* resize a widget */
+void gui_widget_set_size(gui_widget_struct *widget, int16_t width, int16_t height);
+/* set the background and foreground colours */
+void gui_widget_set_color(gui_widget_struct *widget, uint16_t bg_color, uint16_t fg_color);
+/* set the widget opacity */
+void gui_widget_set_alpha(gui_widget_struct *widget, uint8_t alpha);
+/* show or hide a widget */
+void gui_widget_set_hidden(gui_widget_struct *widget, int hidden);
+/* set the text of a label or button */
+void gui_widget_set_text(gui_widget_struct *widget, const char *text);
+/* set the value of a bar or gauge */
+void gui_widget_set_value(gui_widget_struct *widget, int32_t value);
+/* set the pressed state of a button */
+void gui_widget_set_pressed(gui_widget_struct *widget, int pressed);
+/* arrange the children of a container */
+void gui_container_set_layout(gui_widget_struct *widget, gui_layout_enum layout, uint8_t gap);
+
+#endif /* GUI_WIDGET_H */
@@ -16,19 +16,43 @@ static void lcd_disp_off(void);
 static void lcd_disp_on(void);
 
 void lcd_disp_config(void)
+{
+    lcd_tli_config();
+    lcd_disp_start();
+}
+
+/*!
+    \brief      configure the TLI and IPA without reading the frame buffer,
+                can run before the SDRAM is ready
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void lcd_tli_config(void)
 {
     lcd_disp_en_config();
     lcd_disp_off();
 
     /* configure the GPIO of TLI */
     tli_gpio_config();
-    lcd_disp_on();
 
     tli_config();
+    ipa_config();
+}
+
+/*!
+    \brief      start scanning out the frame buffer and turn the display on,
+                the SDRAM must be ready
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void lcd_disp_start(void)
+{
     tli_layer_enable(LAYER0);
     tli_reload_config(TLI_FRAME_BLANK_RELOAD_EN);
     tli_enable();
-    ipa_config();
+    lcd_disp_on();
 }
 
 static void tli_config(void)
@@ -116,6 +140,127 @@ static void ipa_config(void)
     nvic_irq_enable(IPA_IRQn, 0, 2);
 }
 
+/*!
+    \brief      fill a RGB565 area with the IPA and wait for the transfer to finish
+    \param[in]  addr: address of the first pixel
+    \param[in]  line_offset: pixels to skip at the end of each line
+    \param[in]  width: area width in pixels
+    \param[in]  height: area height in lines
+    \param[in]  color: RGB565 fill value
+    \param[out] none
+    \retval     none
+*/
+void lcd_ipa_fill(uint32_t addr, uint16_t line_offset, uint16_t width, uint16_t height, uint16_t color)
+{
+    lcd_ipa_fill_start(addr, line_offset, width, height, color);
+    while(lcd_ipa_busy()){
+    }
+}
+
+/*!
+    \brief      start filling a RGB565 area with the IPA
+    \param[in]  addr: address of the first pixel
+    \param[in]  line_offset: pixels to skip at the end of each line
+    \param[in]  width: area width in pixels
+    \param[in]  height: area height in lines
+    \param[in]  color: RGB565 fill value
+    \param[out] none
+    \retval     none
+*/
+void lcd_ipa_fill_start(uint32_t addr, uint16_t line_offset, uint16_t width, uint16_t height, uint16_t color)
+{
+    ipa_destination_parameter_struct ipa_destination_init_struct;
+
+    ipa_deinit();
+    ipa_pixel_format_convert_mode_set(IPA_FILL_UP_DE);
+
+    ipa_destination_struct_para_init(&ipa_destination_init_struct);
+    ipa_destination_init_struct.destination_pf = IPA_DPF_RGB565;
+    ipa_destination_init_struct.destination_memaddr = addr;
+    ipa_destination_init_struct.destination_lineoff = line_offset;
+    ipa_destination_init_struct.destination_prered = (color >> 11) & 0x1FU;
+    ipa_destination_init_struct.destination_pregreen = (color >> 5) & 0x3FU;
+    ipa_destination_init_struct.destination_preblue = color & 0x1FU;
+    ipa_destination_init_struct.image_width = width;
+    ipa_destination_init_struct.image_height = height;
+    ipa_destination_init(&ipa_destination_init_struct);
+
+    ipa_transfer_enable();
+}
+
+/*!
+    \brief      check whether the fill started by lcd_ipa_fill_start() still runs
+    \param[in]  none
+    \param[out] none
+    \retval     1 while the IPA transfers, 0 once it has finished
+*/
+int lcd_ipa_busy(void)
+{
+    if(RESET == ipa_flag_get(IPA_FLAG_FTF)){
+        return 1;
+    }
+    ipa_flag_clear(IPA_FLAG_FTF);
+    return 0;
+}
+
+/*!
+    \brief      fill a rectangle of the frame buffer
+    \param[in]  x, y: top left corner
+    \param[in]  width, height: size in pixels
+    \param[in]  color: RGB565 colour
+    \param[out] none
+    \retval     none
+*/
+void lcd_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color)
+{
+    uint16_t *line = ltdc_lcd_framebuf0[0] + (LCD_WIDTH * y + x);
+    uint16_t i, j;
+
+    /* the IPA start-up cost only pays off for larger areas */
+    if((uint32_t)width * height >= LCD_IPA_FILL_MIN){
+        lcd_ipa_fill((uint32_t)line, LCD_WIDTH - width, width, height, color);
+        return;
+    }
+
+    for(j = 0; j < height; j++){
+        for(i = 0; i < width; i++){
+            line[i] = color;
+        }
+        line += LCD_WIDTH;
+    }
+}
+
+/*!
+    \brief      blend a colour over a rectangle of the frame buffer
+    \param[in]  x, y: top left corner
+    \param[in]  width, height: size in pixels
+    \param[in]  color: RGB565 colour
+    \param[in]  alpha: opacity of color, 255 is opaque
+    \param[out] none
+    \retval     none
+*/
+void lcd_blend_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color, uint8_t alpha)
+{
+    uint16_t *line = ltdc_lcd_framebuf0[0] + (LCD_WIDTH * y + x);
+    int32_t fr = (color >> 11) & 0x1F, fg = (color >> 5) & 0x3F, fb = color & 0x1F;
+    int32_t r, g, b;
+    uint16_t i, j, pixel;
+
+    for(j = 0; j < height; j++){
+        for(i = 0; i < width; i++){
+            pixel = line[i];
+            r = (pixel >> 11) & 0x1F;
+            g = (pixel >> 5) & 0x3F;
+            b = pixel & 0x1F;
+            r += ((fr - r) * alpha) >> 8;
+            g += ((fg - g) * alpha) >> 8;
+            b += ((fb - b) * alpha) >> 8;
+            line[i] = (uint16_t)((r << 11) | (g << 5) | b);
+        }
+        line += LCD_WIDTH;
+    }
+}
+
 static void tli_gpio_config(void)
 {
     /* enable the periphral clock */
@@ -25,6 +25,9 @@
 
 #define LCD_FRAME_BUF_ADDR 0XC0000000
 
+/* fills of at least this many pixels are handed to the IPA */
+#define LCD_IPA_FILL_MIN 256
+
 
 extern uint16_t ltdc_lcd_framebuf0[800][480];
 // extern uint16_t (*ltdc_lcd_framebuf0)[LCD_HEIGHT];
@@ -38,6 +41,13 @@ extern "C" {
 #endif
 
 void lcd_disp_config(void);
+void lcd_tli_config(void);
+void lcd_disp_start(void);
+void lcd_ipa_fill(uint32_t addr, uint16_t line_offset, uint16_t width, uint16_t height, uint16_t color);
+void lcd_ipa_fill_start(uint32_t addr, uint16_t line_offset, uint16_t width, uint16_t height, uint16_t color);
+int lcd_ipa_busy(void);
+void lcd_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color);
+void lcd_blend_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color, uint8_t alpha);
 
 #if defined(__cplusplus)
 }
@@ -36,6 +36,9 @@ OF SUCH DAMAGE.
 #include "gd32f4xx.h"
 #include "systick.h"
 #include "exmc_sdram.h"
+#include "sdram_copy.h"
+#include "sdram_timing.h"
+#include "soft_timer.h"
 
 /* define mode register content */
 /* burst length */
@@ -59,22 +62,90 @@ OF SUCH DAMAGE.
 #define SDRAM_MODEREG_OPERATING_MODE_STANDARD    ((uint16_t)0x0000)
 
 #define SDRAM_TIMEOUT                            ((uint32_t)0x0000FFFF)
+/* ticks exmc_sdram_start_coro() waits for the controller to take a command */
+#define SDRAM_READY_TICKS                        2U
+/* milliseconds exmc_synchronous_dynamic_ram_init() gives the start sequence */
+#define SDRAM_START_TIMEOUT_MS                   100U
+
+/* SDRAM part on the board */
+#ifndef SDRAM_PART
+#define SDRAM_PART                               SDRAM_PART_MT48LC16M16A2_75
+#endif
+/* highest SDCLK the board is run at */
+#ifndef SDRAM_SDCLK_MAX_HZ
+#define SDRAM_SDCLK_MAX_HZ                       100000000U
+#endif
+
+/* timing computed by exmc_sdram_power_up(), used again by exmc_sdram_start_coro() */
+static sdram_timing_struct timing;
 
 /*!
-    \brief      sdram peripheral initialize
+    \brief      get the bank select of a SDRAM device
+    \param[in]  sdram_device: specify the SDRAM device
+    \param[out] none
+    \retval     command bank select
+*/
+static uint32_t sdram_bank_select(uint32_t sdram_device)
+{
+    return (EXMC_SDRAM_DEVICE0 == sdram_device) ? EXMC_SDRAM_DEVICE0_SELECT : EXMC_SDRAM_DEVICE1_SELECT;
+}
+
+/*!
+    \brief      sdram peripheral initialize, waits with the soft timers and runs their callbacks;
+                for the boot only, with SysTick running and before work_port_init() hands the
+                soft timers to the work thread, boot_port.c starts the SDRAM without blocking
     \param[in]  sdram_device: specifie the SDRAM device 
     \param[out] none
-    \retval     none
+    \retval     ERROR or SUCCESS, ERROR when the start takes over SDRAM_START_TIMEOUT_MS
 */
 ErrStatus exmc_synchronous_dynamic_ram_init(uint32_t sdram_device)
+{
+    coro_struct coro;
+    uint32_t start;
+
+    if(ERROR == exmc_sdram_power_up(sdram_device)){
+        return ERROR;
+    }
+    delay_1ms(SDRAM_POWER_UP_MS);
+
+    /* on the stack, coro_start() must not take it for a running coroutine */
+    coro.active = 0U;
+    start = systick_ms_get();
+    /* the waits of the coroutine are ticked by SysTick and run here */
+    coro_start(&coro, &soft_timers, exmc_sdram_start_coro, (void *)(uintptr_t)sdram_device, NULL);
+    while(coro_active(&coro)){
+        if(systick_ms_get() - start > SDRAM_START_TIMEOUT_MS){
+            /* the coroutine lives on this stack, its timer must leave the wheel */
+            coro_stop(&coro);
+            return ERROR;
+        }
+        soft_timer_run(&soft_timers);
+    }
+    return (0 == coro.result) ? SUCCESS : ERROR;
+}
+
+/*!
+    \brief      configure the pins and the controller and start the SDRAM clock,
+                the SDRAM needs SDRAM_POWER_UP_MS before exmc_sdram_start_coro()
+    \param[in]  sdram_device: specifie the SDRAM device
+    \param[out] none
+    \retval     ERROR or SUCCESS
+*/
+ErrStatus exmc_sdram_power_up(uint32_t sdram_device)
 {
     exmc_sdram_parameter_struct        sdram_init_struct;
     exmc_sdram_timing_parameter_struct  sdram_timing_init_struct;
     exmc_sdram_command_parameter_struct     sdram_command_init_struct;
+    const sdram_part_struct *part = &sdram_parts[SDRAM_PART];
 
-    uint32_t command_content = 0, bank_select;
+    uint32_t bank_select;
     uint32_t timeout = SDRAM_TIMEOUT;
 
+    /* timing of the part at the current AHB clock */
+    if(0 != sdram_timing_calc(part, rcu_clock_freq_get(CK_AHB), SDRAM_SDCLK_MAX_HZ, &timing)){
+        return ERROR;
+    }
+
     /* 使能时钟*/
     rcu_periph_clock_enable(RCU_EXMC);
     rcu_periph_clock_enable(RCU_GPIOB);
@@ -130,45 +201,41 @@ ErrStatus exmc_synchronous_dynamic_ram_init(uint32_t sdram_device)
                                                                      GPIO_PIN_5 | GPIO_PIN_8 | GPIO_PIN_15);
 
     /* specify which SDRAM to read and write */
-    if(EXMC_SDRAM_DEVICE0 == sdram_device){
-        bank_select = EXMC_SDRAM_DEVICE0_SELECT;
-    }else{
-        bank_select = EXMC_SDRAM_DEVICE1_SELECT;
-    }
+    bank_select = sdram_bank_select(sdram_device);
 
     /* EXMC SDRAM device initialization sequence --------------------------------*/
-    /* Step 1 : configure SDRAM timing registers --------------------------------*/
-    /* LMRD: 2 clock cycles 加载模式寄存器延迟 */
-    sdram_timing_init_struct.load_mode_register_delay = 2;
-    /* XSRD: min = 75ns 退出自刷新的延迟*/
-    sdram_timing_init_struct.exit_selfrefresh_delay = 8;  
-    /* RASD: min=44ns , max=120k (ns) 行地址选择延迟*/
-    sdram_timing_init_struct.row_address_select_delay = 5;  
-    /* ARFD: min=66ns 自动刷新延迟*/
-    sdram_timing_init_struct.auto_refresh_delay = 7;  
-    /* WRD:  min=1 Clock cycles +7.5ns 写恢复延迟*/
-    sdram_timing_init_struct.write_recovery_delay = 2;
-    /* RPD:  min=20ns 行预充电延迟*/
-    sdram_timing_init_struct.row_precharge_delay = 3; 
-    /* RCD:  min=20ns 行至列的延迟*/
-    sdram_timing_init_struct.row_to_column_delay = 3; 
+    /* Step 1 : configure SDRAM timing registers, SDCLK cycles from sdram_timing.c */
+    /* LMRD: tMRD 加载模式寄存器延迟 */
+    sdram_timing_init_struct.load_mode_register_delay = timing.load_mode_register_delay;
+    /* XSRD: tXSR 退出自刷新的延迟*/
+    sdram_timing_init_struct.exit_selfrefresh_delay = timing.exit_selfrefresh_delay;
+    /* RASD: tRAS 行地址选择延迟*/
+    sdram_timing_init_struct.row_address_select_delay = timing.row_address_select_delay;
+    /* ARFD: tRC 自动刷新延迟*/
+    sdram_timing_init_struct.auto_refresh_delay = timing.auto_refresh_delay;
+    /* WRD:  tWR 写恢复延迟*/
+    sdram_timing_init_struct.write_recovery_delay = timing.write_recovery_delay;
+    /* RPD:  tRP 行预充电延迟*/
+    sdram_timing_init_struct.row_precharge_delay = timing.row_precharge_delay;
+    /* RCD:  tRCD 行至列的延迟*/
+    sdram_timing_init_struct.row_to_column_delay = timing.row_to_column_delay;
 
     /* step 2 : configure SDRAM control registers ---------------------------------*/
     sdram_init_struct.sdram_device = sdram_device;
-    /*列地址位宽: 9bit*/
-    sdram_init_struct.column_address_width = EXMC_SDRAM_COW_ADDRESS_9;
-    /*行地址位宽: 13bit*/
-    sdram_init_struct.row_address_width = EXMC_SDRAM_ROW_ADDRESS_13;
+    /*列地址位宽: 8..11bit*/
+    sdram_init_struct.column_address_width = SDCTL_CAW(part->column_bits - 8U);
+    /*行地址位宽: 11..13bit*/
+    sdram_init_struct.row_address_width = SDCTL_RAW(part->row_bits - 11U);
     /*SDRAM数据总线宽度*/
-    sdram_init_struct.data_width = EXMC_SDRAM_DATABUS_WIDTH_16B;
+    sdram_init_struct.data_width = SDCTL_SDW(part->data_bits / 16U);
     /*内部Bank的个数*/
-    sdram_init_struct.internal_bank_number = EXMC_SDRAM_4_INTER_BANK;
+    sdram_init_struct.internal_bank_number = (4U == part->banks) ? EXMC_SDRAM_4_INTER_BANK : EXMC_SDRAM_2_INTER_BANK;
     /*配置CAS延迟*/
-    sdram_init_struct.cas_latency = EXMC_CAS_LATENCY_2_SDCLK;  
+    sdram_init_struct.cas_latency = SDCTL_CL(timing.cas_latency);
     /*配置写保护功能*/
     sdram_init_struct.write_protection = DISABLE;
     /*SDRAM时钟配置*/
-    sdram_init_struct.sdclock_config = EXMC_SDCLK_PERIODS_3_HCLK;  
+    sdram_init_struct.sdclock_config = SDCTL_SDCLK(timing.sdclk_div);
     /*突发读开关*/
     sdram_init_struct.burst_read_switch = ENABLE;
     /*流水线读数据延迟*/
@@ -196,81 +263,96 @@ ErrStatus exmc_synchronous_dynamic_ram_init(uint32_t sdram_device)
     }    
     /* send the command */
     exmc_sdram_command_config(&sdram_command_init_struct);
+    return SUCCESS;
+}
 
-    /* step 4 : insert 10ms delay----------------------------------------------*/
-    delay_1ms(10);
+/* wait until the controller takes a command, give up after SDRAM_READY_TICKS */
+#define SDRAM_AWAIT_READY(coro, sdram_device)                                           \
+    do{                                                                                 \
+        CORO_AWAIT_TIMEOUT((coro), sdram_ready(sdram_device), SDRAM_READY_TICKS);       \
+        if(CORO_TIMED_OUT(coro)){                                                       \
+            CORO_EXIT((coro), -1);                                                      \
+        }                                                                               \
+    }while(0)
+
+/* check whether the controller takes a command */
+static int sdram_ready(uint32_t sdram_device)
+{
+    return (RESET == exmc_flag_get(sdram_device, EXMC_SDRAM_FLAG_NREADY));
+}
 
-    /* step 5 : configure precharge all command 配置预充电命令----------------------------------*/
-    sdram_command_init_struct.command = EXMC_SDRAM_PRECHARGE_ALL;
-    sdram_command_init_struct.bank_select = bank_select;
-    sdram_command_init_struct.auto_refresh_number = EXMC_SDRAM_AUTO_REFLESH_1_SDCLK;
-    sdram_command_init_struct.mode_register_content = 0;
-    /* wait until the SDRAM controller is ready */
-    timeout = SDRAM_TIMEOUT; 
-    while((exmc_flag_get(sdram_device, EXMC_SDRAM_FLAG_NREADY) != RESET) && (timeout > 0)){
-        timeout--;
-    }
-    if(0 == timeout){
-        return ERROR;
-    }    
-    /* send the command */
+/*!
+    \brief      send a command to a SDRAM device
+    \param[in]  sdram_device: specifie the SDRAM device
+    \param[in]  command: EXMC_SDRAM_PRECHARGE_ALL, EXMC_SDRAM_AUTO_REFRESH or EXMC_SDRAM_LOAD_MODE_REGISTER
+    \param[in]  auto_refresh_number: EXMC_SDRAM_AUTO_REFLESH_x_SDCLK
+    \param[in]  mode_register_content: mode register for EXMC_SDRAM_LOAD_MODE_REGISTER
+    \param[out] none
+    \retval     none
+*/
+static void sdram_command(uint32_t sdram_device, uint32_t command, uint32_t auto_refresh_number,
+                          uint32_t mode_register_content)
+{
+    exmc_sdram_command_parameter_struct sdram_command_init_struct;
+
+    sdram_command_init_struct.command = command;
+    sdram_command_init_struct.bank_select = sdram_bank_select(sdram_device);
+    sdram_command_init_struct.auto_refresh_number = auto_refresh_number;
+    sdram_command_init_struct.mode_register_content = mode_register_content;
     exmc_sdram_command_config(&sdram_command_init_struct);
+}
+
+/*!
+    \brief      initialize the SDRAM once its power-up time has passed, a coroutine
+                that waits for the controller between the commands instead of spinning
+    \param[in]  coro: coroutine, coro->arg is the SDRAM device as a uintptr_t
+    \param[out] none
+    \retval     CORO_WAITING, 0 when done or -1 when the controller did not get ready
+*/
+int exmc_sdram_start_coro(coro_struct *coro)
+{
+    uint32_t sdram_device = (uint32_t)(uintptr_t)coro->arg;
+    uint32_t command_content;
+
+    CORO_BEGIN(coro);
+
+    /* step 4 : SDRAM_POWER_UP_MS since the clock was enabled, waited by the caller */
+
+    /* step 5 : configure precharge all command 配置预充电命令----------------------------------*/
+    SDRAM_AWAIT_READY(coro, sdram_device);
+    sdram_command(sdram_device, EXMC_SDRAM_PRECHARGE_ALL, EXMC_SDRAM_AUTO_REFLESH_1_SDCLK, 0U);
 
     /* step 6 : configure Auto-Refresh command  配置自动刷新命令-----------------------------------*/
-    sdram_command_init_struct.command = EXMC_SDRAM_AUTO_REFRESH;
-    sdram_command_init_struct.bank_select = bank_select;
-    sdram_command_init_struct.auto_refresh_number = EXMC_SDRAM_AUTO_REFLESH_8_SDCLK;
-    sdram_command_init_struct.mode_register_content = 0;
-    /* wait until the SDRAM controller is ready */ 
-    timeout = SDRAM_TIMEOUT; 
-    while((exmc_flag_get(sdram_device, EXMC_SDRAM_FLAG_NREADY) != RESET) && (timeout > 0)){
-        timeout--;
-    }
-    if(0 == timeout){
-        return ERROR;
-    }    
-    /* send the command */
-    exmc_sdram_command_config(&sdram_command_init_struct);
+    SDRAM_AWAIT_READY(coro, sdram_device);
+    sdram_command(sdram_device, EXMC_SDRAM_AUTO_REFRESH, EXMC_SDRAM_AUTO_REFLESH_8_SDCLK, 0U);
 
     /* step 7 : configure load mode register command 配置加载模式寄存器命令-------------------------------*/
+    SDRAM_AWAIT_READY(coro, sdram_device);
     /* program mode register */
     command_content = (uint32_t)SDRAM_MODEREG_BURST_LENGTH_1        |
                                 SDRAM_MODEREG_BURST_TYPE_SEQUENTIAL   |
-                                SDRAM_MODEREG_CAS_LATENCY_2           |
+                                ((3U == timing.cas_latency) ? SDRAM_MODEREG_CAS_LATENCY_3 : SDRAM_MODEREG_CAS_LATENCY_2) |
                                 SDRAM_MODEREG_OPERATING_MODE_STANDARD |
                                 SDRAM_MODEREG_WRITEBURST_MODE_SINGLE;
-
-    sdram_command_init_struct.command = EXMC_SDRAM_LOAD_MODE_REGISTER;
-    sdram_command_init_struct.bank_select = bank_select;
-    sdram_command_init_struct.auto_refresh_number = EXMC_SDRAM_AUTO_REFLESH_1_SDCLK;
-    sdram_command_init_struct.mode_register_content = command_content;
-
-    /* wait until the SDRAM controller is ready */ 
-    timeout = SDRAM_TIMEOUT; 
-    while((exmc_flag_get(sdram_device, EXMC_SDRAM_FLAG_NREADY) != RESET) && (timeout > 0)){
-        timeout--;
-    }
-    if(0 == timeout){
-        return ERROR;
-    }    
-    /* send the command */
-    exmc_sdram_command_config(&sdram_command_init_struct);
+    sdram_command(sdram_device, EXMC_SDRAM_LOAD_MODE_REGISTER, EXMC_SDRAM_AUTO_REFLESH_1_SDCLK, command_content);
 
     /* step 8 : set the auto-refresh rate counter 设置自动刷新率计数器 -------------------------------*/
-    /* 64ms, 8192-cycle refresh, 64ms/8192=7.81us */
-    /* SDCLK_Freq = SYS_Freq/2 */
-    /* (7.81 us * SDCLK_Freq) - 20 */
-    exmc_sdram_refresh_count_set(761); 
+    /* (refresh period / rows * SDCLK_Freq) - 20, 64ms/8192=7.81us */
+    exmc_sdram_refresh_count_set(timing.refresh_count);
+    SDRAM_AWAIT_READY(coro, sdram_device);
 
-    /* wait until the SDRAM controller is ready */ 
-    timeout = SDRAM_TIMEOUT; 
-    while((exmc_flag_get(sdram_device, EXMC_SDRAM_FLAG_NREADY) != RESET) && (timeout > 0)){
-        timeout--;
-    }
-    if(0 == timeout){
-        return ERROR;
-    }
-    return SUCCESS;    
+    CORO_END(coro);
+}
+
+/*!
+    \brief      get the base address of a SDRAM device
+    \param[in]  sdram_device: specify the SDRAM device
+    \param[out] none
+    \retval     base address of the device
+*/
+static uint32_t sdram_base_addr(uint32_t sdram_device)
+{
+    return (EXMC_SDRAM_DEVICE0 == sdram_device) ? SDRAM_DEVICE0_ADDR : SDRAM_DEVICE1_ADDR;
 }
 
 /*!
@@ -302,23 +384,7 @@ void fill_buffer(uint8_t *pbuffer, uint16_t buffer_lengh, uint16_t offset)
 */
 void sdram_writebuffer_8(uint32_t sdram_device,uint8_t* pbuffer, uint32_t writeaddr, uint32_t numbytetowrite)
 {
-    uint32_t temp_addr;
-    
-    /* Select the base address according to EXMC_Bank */
-    if(sdram_device == EXMC_SDRAM_DEVICE0){
-        temp_addr = SDRAM_DEVICE0_ADDR;
-    }else{
-        temp_addr = SDRAM_DEVICE1_ADDR;
-    }
-    
-     /* While there is data to write */
-    for(; numbytetowrite != 0; numbytetowrite--) {
-        /* Transfer data to the memory */
-        *(uint8_t *) (temp_addr + writeaddr) = *pbuffer++;
-
-        /* Increment the address*/  
-        writeaddr += 1;
-    }
+    sdram_copy((void *)(sdram_base_addr(sdram_device) + writeaddr), pbuffer, numbytetowrite);
 }
 
 /*!
@@ -332,23 +398,7 @@ void sdram_writebuffer_8(uint32_t sdram_device,uint8_t* pbuffer, uint32_t writea
 */
 void sdram_readbuffer_8(uint32_t sdram_device,uint8_t* pbuffer, uint32_t readaddr, uint32_t numbytetoread)
 {
-    uint32_t temp_addr;
-    
-    /* select the base address according to EXMC_Bank */
-    if(sdram_device == EXMC_SDRAM_DEVICE0){
-        temp_addr = SDRAM_DEVICE0_ADDR;
-    }else{
-        temp_addr = SDRAM_DEVICE1_ADDR;
-    }
-    
-    /* while there is data to read */
-    for(; numbytetoread != 0; numbytetoread--){
-        /* read a byte from the memory */
-        *pbuffer++ = *(uint8_t*) (temp_addr + readaddr);
-    
-        /* increment the address */
-        readaddr += 1;
-    }
+    sdram_copy(pbuffer, (const void *)(sdram_base_addr(sdram_device) + readaddr), numbytetoread);
 }
 
 /*!
@@ -362,24 +412,7 @@ void sdram_readbuffer_8(uint32_t sdram_device,uint8_t* pbuffer, uint32_t readadd
 */
 void sdram_writebuffer_16(uint32_t sdram_device,uint16_t* pbuffer, uint32_t writeaddr, uint32_t numtowrite)
 {
-    uint32_t temp_addr;
-    __IO uint32_t write_addr_prt = writeaddr;
-    
-    /* Select the base address according to EXMC_Bank */
-    if(sdram_device == EXMC_SDRAM_DEVICE0){
-        temp_addr = SDRAM_DEVICE0_ADDR;
-    }else{
-        temp_addr = SDRAM_DEVICE1_ADDR;
-    }
-    
-     /* While there is data to write */
-    for(; numtowrite != 0; numtowrite--) {
-        /* Transfer data to the memory */
-        *(uint16_t *) (temp_addr + write_addr_prt) = *pbuffer++;
-
-        /* Increment the address */  
-        write_addr_prt += 2;
-    }
+    sdram_copy((void *)(sdram_base_addr(sdram_device) + writeaddr), pbuffer, numtowrite * 2U);
 }
 
 /*!
@@ -393,22 +426,5 @@ void sdram_writebuffer_16(uint32_t sdram_device,uint16_t* pbuffer, uint32_t writ
 */
 void sdram_readbuffer_16(uint32_t sdram_device,uint16_t* pbuffer, uint32_t readaddr, uint32_t numtowrite)
 {
-    uint32_t temp_addr;
-    __IO uint32_t write_addr_prt = readaddr;    
-    
-    /* select the base address according to EXMC_Bank */
-    if(sdram_device == EXMC_SDRAM_DEVICE0){
-        temp_addr = SDRAM_DEVICE0_ADDR;
-    }else{
-        temp_addr = SDRAM_DEVICE1_ADDR;
-    }
-    
-    /* while there is data to read */
-    for(; numtowrite != 0; numtowrite--){
-        /* read a byte from the memory */
-        *pbuffer++ = *(uint16_t*) (temp_addr + write_addr_prt);
-    
-        /* increment the address */
-        write_addr_prt += 2;
-    }
+    sdram_copy(pbuffer, (const void *)(sdram_base_addr(sdram_device) + readaddr), numtowrite * 2U);
 }
@@ -37,9 +37,17 @@ OF SUCH DAMAGE.
 #define EXMC_SDRAM_H
 
 #include "gd32f4xx.h"
+#include "coro.h"
 
-/* sdram peripheral initialize */
+/* time the SDRAM needs between the clock enable and the first command */
+#define SDRAM_POWER_UP_MS                          10U
+
+/* sdram peripheral initialize, blocking with a timeout, for the boot before work_port_init() only */
 ErrStatus exmc_synchronous_dynamic_ram_init(uint32_t sdram_device);
+/* configure the controller and enable the SDRAM clock, first half of the initialization */
+ErrStatus exmc_sdram_power_up(uint32_t sdram_device);
+/* precharge, refresh and load the mode register, second half after SDRAM_POWER_UP_MS, a coroutine */
+int exmc_sdram_start_coro(coro_struct *coro);
 /* fill the buffer with specified value */
 void fill_buffer(uint8_t *pbuffer, uint16_t buffer_lengh, uint16_t offset);
 /* write a byte buffer(data is 8 bits) to the EXMC SDRAM memory */
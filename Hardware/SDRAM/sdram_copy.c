@@ -0,0 +1,159 @@
+/*!
+    \file    sdram_copy.c
+    \brief   SDRAM block copy
+
+    The destination is aligned with byte stores, then the body moves in
+    32-bit words: eight at a time with LDM/STM when the source is word
+    aligned as well, so every load is one EXMC read burst, otherwise with
+    aligned loads shifted together. Unaligned word accesses are never
+    issued, they fault on the device region the SDRAM is mapped to. No
+    byte outside the source is read, not even within an aligned word.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "sdram_copy.h"
+
+/* word access to memory declared with another type */
+typedef uint32_t copy_word_t __attribute__((__may_alias__));
+
+/*!
+    \brief      copy words between two word aligned areas
+    \param[in]  s: source
+    \param[in]  words: number of words
+    \param[out] d: destination
+    \retval     none
+*/
+static void copy_words_aligned(copy_word_t *d, const copy_word_t *s, uint32_t words)
+{
+#if defined(__GNUC__) && defined(__ARM_ARCH_7EM__)
+    while(words >= 8U){
+        __asm volatile(
+            "ldmia %[s]!, {r3-r6, r8-r10, r12}\n\t"
+            "stmia %[d]!, {r3-r6, r8-r10, r12}\n\t"
+            : [s] "+r" (s), [d] "+r" (d)
+            :
+            : "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "memory");
+        words -= 8U;
+    }
+#else
+    uint32_t w0, w1, w2, w3, w4, w5, w6, w7;
+
+    while(words >= 8U){
+        w0 = s[0];
+        w1 = s[1];
+        w2 = s[2];
+        w3 = s[3];
+        w4 = s[4];
+        w5 = s[5];
+        w6 = s[6];
+        w7 = s[7];
+        d[0] = w0;
+        d[1] = w1;
+        d[2] = w2;
+        d[3] = w3;
+        d[4] = w4;
+        d[5] = w5;
+        d[6] = w6;
+        d[7] = w7;
+        s += 8;
+        d += 8;
+        words -= 8U;
+    }
+#endif
+    while(0U != words){
+        *d++ = *s++;
+        words--;
+    }
+}
+
+/*!
+    \brief      copy words from a source that is not word aligned
+    \param[in]  src: source, not word aligned
+    \param[in]  words: number of words, at least 1
+    \param[out] d: word aligned destination
+    \retval     none
+*/
+static void copy_words_shifted(copy_word_t *d, const uint8_t *src, uint32_t words)
+{
+    /* the aligned words in between are loaded whole, the partial ones at both ends byte by byte */
+    const copy_word_t *s = (const copy_word_t *)(((uintptr_t)src + 3U) & ~(uintptr_t)3U);
+    uint32_t offset = (uint32_t)(uintptr_t)src & 3U;
+    uint32_t lo = offset * 8U;
+    uint32_t hi = 32U - lo;
+    uint32_t w0 = 0, w1, i;
+    const uint8_t *tail;
+
+    /* the bytes below lo are never used */
+    for(i = offset; i < 4U; i++){
+        w0 |= (uint32_t)src[i - offset] << (i * 8U);
+    }
+
+    words--;
+    while(words >= 4U){
+        w1 = s[0];
+        d[0] = (w0 >> lo) | (w1 << hi);
+        w0 = s[1];
+        d[1] = (w1 >> lo) | (w0 << hi);
+        w1 = s[2];
+        d[2] = (w0 >> lo) | (w1 << hi);
+        w0 = s[3];
+        d[3] = (w1 >> lo) | (w0 << hi);
+        s += 4;
+        d += 4;
+        words -= 4U;
+    }
+    while(0U != words){
+        w1 = *s++;
+        *d++ = (w0 >> lo) | (w1 << hi);
+        w0 = w1;
+        words--;
+    }
+
+    /* the last word ends offset bytes into the next aligned word, a whole load would read past the source */
+    tail = (const uint8_t *)s;
+    w1 = 0;
+    for(i = 0; i < offset; i++){
+        w1 |= (uint32_t)tail[i] << (i * 8U);
+    }
+    *d = (w0 >> lo) | (w1 << hi);
+}
+
+/*!
+    \brief      copy a block between SDRAM and memory or within SDRAM
+    \param[in]  src: source, any alignment
+    \param[in]  length: number of bytes
+    \param[out] dst: destination, any alignment, must not overlap src
+    \retval     none
+*/
+void sdram_copy(void *dst, const void *src, uint32_t length)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    uint32_t words;
+
+    if(length >= SDRAM_COPY_SMALL){
+        /* head: align the destination */
+        while(0U != ((uintptr_t)d & 3U)){
+            *d++ = *s++;
+            length--;
+        }
+
+        words = length >> 2;
+        if(0U == ((uintptr_t)s & 3U)){
+            copy_words_aligned((copy_word_t *)d, (const copy_word_t *)s, words);
+        }else{
+            copy_words_shifted((copy_word_t *)d, s, words);
+        }
+        d += words * 4U;
+        s += words * 4U;
+        length &= 3U;
+    }
+
+    /* tail, or the whole of a small block */
+    while(0U != length){
+        *d++ = *s++;
+        length--;
+    }
+}
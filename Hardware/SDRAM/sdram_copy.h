@@ -0,0 +1,19 @@
+/*!
+    \file    sdram_copy.h
+    \brief   the header file of the SDRAM block copy
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef SDRAM_COPY_H
+#define SDRAM_COPY_H
+
+#include <stdint.h>
+
+/* below this length the head/tail set-up costs more than it saves */
+#define SDRAM_COPY_SMALL            8U
+
+/* copy a block, any alignment, the areas must not overlap */
+void sdram_copy(void *dst, const void *src, uint32_t length);
+
+#endif /* SDRAM_COPY_H */
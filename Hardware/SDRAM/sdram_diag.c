@@ -0,0 +1,333 @@
+/*!
+    \file    sdram_diag.c
+    \brief   SDRAM diagnostics and bandwidth self-test
+
+    The fault tests reach the memory through sdram_diag_mem_struct only,
+    so they can run against a simulated part with injected faults:
+    - walking ones finds data lines stuck or shorted,
+    - the address test writes one word per address line and finds lines
+      stuck high, stuck low or shorted together,
+    - March C- finds stuck-at, transition and coupling faults between
+      words, the extra data backgrounds extend it to bits within a word.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "sdram_diag.h"
+
+#define ADDRESS_PATTERN             0xAAAAAAAAU
+#define ADDRESS_ANTIPATTERN         0x55555555U
+
+/* word backgrounds, each pair of bits differs in at least one of them */
+static const uint32_t march_background[SDRAM_DIAG_BACKGROUNDS] = {
+    0x00000000U, 0x55555555U, 0x33333333U, 0x0F0F0F0FU, 0x00FF00FFU, 0x0000FFFFU
+};
+
+/*!
+    \brief      read a word through a plain pointer
+    \param[in]  ctx: base address
+    \param[in]  offset: byte offset
+    \param[out] none
+    \retval     word read
+*/
+static uint32_t direct_read(void *ctx, uint32_t offset)
+{
+    return *(volatile uint32_t *)((volatile uint8_t *)ctx + offset);
+}
+
+/*!
+    \brief      write a word through a plain pointer
+    \param[in]  ctx: base address
+    \param[in]  offset: byte offset
+    \param[in]  value: word to write
+    \param[out] none
+    \retval     none
+*/
+static void direct_write(void *ctx, uint32_t offset, uint32_t value)
+{
+    *(volatile uint32_t *)((volatile uint8_t *)ctx + offset) = value;
+}
+
+/*!
+    \brief      access memory through a plain pointer
+    \param[in]  base: first byte of the memory
+    \param[in]  size: bytes, a power of two
+    \param[out] mem: access functions
+    \retval     none
+*/
+void sdram_diag_mem_direct(sdram_diag_mem_struct *mem, volatile void *base, uint32_t size)
+{
+    mem->read = direct_read;
+    mem->write = direct_write;
+    mem->ctx = (void *)base;
+    mem->size = size;
+}
+
+/*!
+    \brief      walk a one over the data bus
+    \param[in]  mem: memory under test
+    \param[in]  offset: word used for the test
+    \param[out] none
+    \retval     data lines that did not follow, 0 when all passed
+*/
+uint32_t sdram_diag_data_bus(const sdram_diag_mem_struct *mem, uint32_t offset)
+{
+    uint32_t bit, pattern, failed = 0;
+
+    for(bit = 0; bit < 32U; bit++){
+        pattern = 1U << bit;
+        mem->write(mem->ctx, offset, pattern);
+        failed |= mem->read(mem->ctx, offset) ^ pattern;
+    }
+    return failed;
+}
+
+/*!
+    \brief      check the address lines covering a range
+    \param[in]  mem: memory under test
+    \param[in]  offset: start of the range, aligned to the power of two covering length
+    \param[in]  length: bytes
+    \param[out] none
+    \retval     address lines stuck or shorted, as byte offset bits, 0 when all passed
+*/
+uint32_t sdram_diag_address_bus(const sdram_diag_mem_struct *mem, uint32_t offset, uint32_t length)
+{
+    uint32_t line, test, failed = 0;
+
+    for(line = 4; line < length; line <<= 1){
+        mem->write(mem->ctx, offset + line, ADDRESS_PATTERN);
+    }
+
+    /* a line stuck high makes the write to the base land somewhere else */
+    mem->write(mem->ctx, offset, ADDRESS_ANTIPATTERN);
+    for(line = 4; line < length; line <<= 1){
+        if(ADDRESS_PATTERN != mem->read(mem->ctx, offset + line)){
+            failed |= line;
+        }
+    }
+    mem->write(mem->ctx, offset, ADDRESS_PATTERN);
+
+    /* a line stuck low or shorted to another one aliases two of the words */
+    for(test = 4; test < length; test <<= 1){
+        mem->write(mem->ctx, offset + test, ADDRESS_ANTIPATTERN);
+        if(ADDRESS_PATTERN != mem->read(mem->ctx, offset)){
+            failed |= test;
+        }
+        for(line = 4; line < length; line <<= 1){
+            if((line != test) && (ADDRESS_PATTERN != mem->read(mem->ctx, offset + line))){
+                failed |= test;
+            }
+        }
+        mem->write(mem->ctx, offset + test, ADDRESS_PATTERN);
+    }
+
+    return failed;
+}
+
+/*!
+    \brief      read a word and record a mismatch
+    \param[in]  mem: memory under test
+    \param[in]  offset: byte offset
+    \param[in]  expected: value that should be read
+    \param[out] fault: failure record
+    \retval     none
+*/
+static void march_check(const sdram_diag_mem_struct *mem, uint32_t offset, uint32_t expected, sdram_diag_fault_struct *fault)
+{
+    uint32_t actual = mem->read(mem->ctx, offset);
+
+    if(actual != expected){
+        if(0U == fault->errors){
+            fault->offset = offset;
+            fault->expected = expected;
+            fault->actual = actual;
+        }
+        fault->errors++;
+    }
+}
+
+/*!
+    \brief      run March C- over a range
+    \param[in]  mem: memory under test
+    \param[in]  offset: start of the range, word aligned
+    \param[in]  length: bytes, a multiple of 4
+    \param[in]  backgrounds: number of data backgrounds, 1..SDRAM_DIAG_BACKGROUNDS
+    \param[out] fault: first failure and number of failing reads
+    \retval     number of failing reads
+*/
+uint32_t sdram_diag_march_c(const sdram_diag_mem_struct *mem, uint32_t offset, uint32_t length,
+                            uint32_t backgrounds, sdram_diag_fault_struct *fault)
+{
+    uint32_t end = offset + length, bg, zero, one, o;
+
+    memset(fault, 0, sizeof(*fault));
+    if(backgrounds > SDRAM_DIAG_BACKGROUNDS){
+        backgrounds = SDRAM_DIAG_BACKGROUNDS;
+    }
+
+    for(bg = 0; bg < backgrounds; bg++){
+        zero = march_background[bg];
+        one = ~zero;
+
+        /* up (w0) */
+        for(o = offset; o < end; o += 4U){
+            mem->write(mem->ctx, o, zero);
+        }
+        /* up (r0, w1) */
+        for(o = offset; o < end; o += 4U){
+            march_check(mem, o, zero, fault);
+            mem->write(mem->ctx, o, one);
+        }
+        /* up (r1, w0) */
+        for(o = offset; o < end; o += 4U){
+            march_check(mem, o, one, fault);
+            mem->write(mem->ctx, o, zero);
+        }
+        /* down (r0, w1) */
+        for(o = end; o > offset; ){
+            o -= 4U;
+            march_check(mem, o, zero, fault);
+            mem->write(mem->ctx, o, one);
+        }
+        /* down (r1, w0) */
+        for(o = end; o > offset; ){
+            o -= 4U;
+            march_check(mem, o, one, fault);
+            mem->write(mem->ctx, o, zero);
+        }
+        /* up (r0) */
+        for(o = offset; o < end; o += 4U){
+            march_check(mem, o, zero, fault);
+        }
+    }
+
+    return fault->errors;
+}
+
+/*!
+    \brief      convert a transfer to KB/s
+    \param[in]  bytes: bytes moved
+    \param[in]  cycles: cycles it took
+    \param[in]  cycle_hz: cycle counter frequency
+    \param[out] none
+    \retval     KB/s
+*/
+static uint32_t bw_kbps(uint32_t bytes, uint32_t cycles, uint32_t cycle_hz)
+{
+    if(0U == cycles){
+        cycles = 1;
+    }
+    return (uint32_t)(((uint64_t)bytes * cycle_hz) / ((uint64_t)cycles * 1024U));
+}
+
+/*!
+    \brief      measure read, write and copy bandwidth for every access width
+    \param[in]  area: memory that may be overwritten, word aligned
+    \param[in]  length: bytes, the copy moves the first half to the second
+    \param[in]  cycles: free running cycle counter
+    \param[in]  cycle_hz: counter frequency
+    \param[out] bw: results for 8, 16 and 32 bit accesses
+    \retval     none
+*/
+void sdram_diag_bandwidth(uint8_t *area, uint32_t length, uint32_t (*cycles)(void), uint32_t cycle_hz,
+                          sdram_diag_bw_struct bw[SDRAM_DIAG_WIDTHS])
+{
+    volatile uint8_t *p8 = area;
+    volatile uint16_t *p16 = (volatile uint16_t *)area;
+    volatile uint32_t *p32 = (volatile uint32_t *)area;
+    uint32_t i, n, half, start, sink = 0;
+
+    length &= ~7U;
+    half = length / 2U;
+
+    /* 8 bit */
+    start = cycles();
+    for(i = 0; i < length; i++){
+        p8[i] = (uint8_t)i;
+    }
+    bw[0].write = bw_kbps(length, cycles() - start, cycle_hz);
+    start = cycles();
+    for(i = 0; i < length; i++){
+        sink += p8[i];
+    }
+    bw[0].read = bw_kbps(length, cycles() - start, cycle_hz);
+    start = cycles();
+    for(i = 0; i < half; i++){
+        p8[half + i] = p8[i];
+    }
+    bw[0].copy = bw_kbps(half, cycles() - start, cycle_hz);
+
+    /* 16 bit */
+    n = length / 2U;
+    start = cycles();
+    for(i = 0; i < n; i++){
+        p16[i] = (uint16_t)i;
+    }
+    bw[1].write = bw_kbps(length, cycles() - start, cycle_hz);
+    start = cycles();
+    for(i = 0; i < n; i++){
+        sink += p16[i];
+    }
+    bw[1].read = bw_kbps(length, cycles() - start, cycle_hz);
+    start = cycles();
+    for(i = 0; i < n / 2U; i++){
+        p16[n / 2U + i] = p16[i];
+    }
+    bw[1].copy = bw_kbps(half, cycles() - start, cycle_hz);
+
+    /* 32 bit */
+    n = length / 4U;
+    start = cycles();
+    for(i = 0; i < n; i++){
+        p32[i] = i;
+    }
+    bw[2].write = bw_kbps(length, cycles() - start, cycle_hz);
+    start = cycles();
+    for(i = 0; i < n; i++){
+        sink += p32[i];
+    }
+    bw[2].read = bw_kbps(length, cycles() - start, cycle_hz);
+    start = cycles();
+    for(i = 0; i < n / 2U; i++){
+        p32[n / 2U + i] = p32[i];
+    }
+    bw[2].copy = bw_kbps(half, cycles() - start, cycle_hz);
+
+    /* keep the reads */
+    p32[0] = sink;
+}
+
+/*!
+    \brief      run every test of a configuration
+    \param[in]  config: memory, ranges and clock
+    \param[out] report: results
+    \retval     0 when no fault was found, 1 otherwise
+*/
+int sdram_diag_run(const sdram_diag_config_struct *config, sdram_diag_report_struct *report)
+{
+    const sdram_diag_mem_struct *mem = config->mem;
+    uint32_t start = 0, march_length;
+
+    memset(report, 0, sizeof(*report));
+    if(NULL != config->cycles){
+        start = config->cycles();
+    }
+
+    report->data_bits = sdram_diag_data_bus(mem, config->offset);
+    report->address_bits = sdram_diag_address_bus(mem, config->offset, config->length);
+
+    march_length = (0U != config->march_length) ? config->march_length : config->length;
+    sdram_diag_march_c(mem, config->offset, march_length, config->backgrounds, &report->march);
+
+    if((NULL != config->bw_area) && (NULL != config->cycles)){
+        sdram_diag_bandwidth(config->bw_area, config->bw_length, config->cycles, config->cycle_hz, report->bw);
+    }
+
+    if(NULL != config->cycles){
+        report->cycles = config->cycles() - start;
+    }
+
+    return ((0U != report->data_bits) || (0U != report->address_bits) || (0U != report->march.errors)) ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+/*!
+    \file    sdram_diag.h
+    \brief   the header file of the SDRAM diagnostics and bandwidth self-test
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef SDRAM_DIAG_H
+#define SDRAM_DIAG_H
+
+#include <stdint.h>
+
+/* data backgrounds March C- can run with, the first is the solid one */
+#define SDRAM_DIAG_BACKGROUNDS      6U
+
+/* access widths of the bandwidth test */
+#define SDRAM_DIAG_WIDTHS           3U                  /*!< 8, 16 and 32 bit */
+
+/* word access to the memory under test, offsets are in bytes and word aligned */
+typedef struct {
+    uint32_t (*read)(void *ctx, uint32_t offset);
+    void (*write)(void *ctx, uint32_t offset, uint32_t value);
+    void *ctx;
+    uint32_t size;                                      /*!< bytes, a power of two */
+} sdram_diag_mem_struct;
+
+/* first failure of a test */
+typedef struct {
+    uint32_t errors;                                    /*!< failing reads */
+    uint32_t offset;                                    /*!< offset of the first one */
+    uint32_t expected;
+    uint32_t actual;
+} sdram_diag_fault_struct;
+
+/* bandwidth of one access width in KB/s */
+typedef struct {
+    uint32_t read;
+    uint32_t write;
+    uint32_t copy;
+} sdram_diag_bw_struct;
+
+typedef struct {
+    const sdram_diag_mem_struct *mem;
+    uint32_t offset;                                    /*!< range checked by the address test, aligned to its size */
+    uint32_t length;
+    uint32_t march_length;                              /*!< bytes from offset March C- runs over, 0 for the whole range */
+    uint32_t backgrounds;                               /*!< March C- backgrounds, 1..SDRAM_DIAG_BACKGROUNDS */
+    uint8_t *bw_area;                                   /*!< memory the bandwidth test may overwrite, NULL to skip */
+    uint32_t bw_length;                                 /*!< bytes, split in two halves for the copy */
+    uint32_t (*cycles)(void);                           /*!< free running cycle counter */
+    uint32_t cycle_hz;
+} sdram_diag_config_struct;
+
+typedef struct {
+    uint32_t data_bits;                                 /*!< data lines that failed walking ones */
+    uint32_t address_bits;                              /*!< address lines stuck or shorted */
+    sdram_diag_fault_struct march;
+    sdram_diag_bw_struct bw[SDRAM_DIAG_WIDTHS];
+    uint32_t cycles;                                    /*!< duration of the whole run */
+} sdram_diag_report_struct;
+
+/* memory access through a plain pointer */
+void sdram_diag_mem_direct(sdram_diag_mem_struct *mem, volatile void *base, uint32_t size);
+/* walk a one over the data bus at one word, return the failing data lines */
+uint32_t sdram_diag_data_bus(const sdram_diag_mem_struct *mem, uint32_t offset);
+/* check the address lines covering a range, return the failing ones */
+uint32_t sdram_diag_address_bus(const sdram_diag_mem_struct *mem, uint32_t offset, uint32_t length);
+/* run March C- over a range, return the number of failing reads */
+uint32_t sdram_diag_march_c(const sdram_diag_mem_struct *mem, uint32_t offset, uint32_t length,
+                            uint32_t backgrounds, sdram_diag_fault_struct *fault);
+/* measure read, write and copy bandwidth for every access width */
+void sdram_diag_bandwidth(uint8_t *area, uint32_t length, uint32_t (*cycles)(void), uint32_t cycle_hz,
+                          sdram_diag_bw_struct bw[SDRAM_DIAG_WIDTHS]);
+/* run every test of a configuration, return 0 when no fault was found */
+int sdram_diag_run(const sdram_diag_config_struct *config, sdram_diag_report_struct *report);
+
+/* target functions, sdram_diag_port.c */
+/* test the SDRAM and print the report over RTT, return 0 when no fault was found */
+int sdram_diag_selftest(uint32_t sdram_device);
+
+#endif /* SDRAM_DIAG_H */
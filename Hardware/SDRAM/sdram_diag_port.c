@@ -0,0 +1,93 @@
+/*!
+    \file    sdram_diag_port.c
+    \brief   SDRAM self-test on the target
+
+    Times the tests with the DWT cycle counter and prints the report on
+    RTT channel 0. It overwrites the memory it checks, so it runs at boot
+    before anything is kept in SDRAM.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "exmc_sdram.h"
+#include "sdram_diag.h"
+#include "SEGGER_RTT.h"
+
+/* SDRAM size from the linker script, the one place it is set */
+extern uint8_t _sdram_length[];
+#define SDRAM_DIAG_DEVICE_SIZE      ((uint32_t)_sdram_length)
+/* March C- window, the whole device takes seconds per background */
+#define SDRAM_DIAG_MARCH_LENGTH     (1024U * 1024U)
+#define SDRAM_DIAG_MARCH_BACKGROUNDS 1U
+/* bandwidth area, placed right after the March window */
+#define SDRAM_DIAG_BW_LENGTH        (64U * 1024U)
+
+/*!
+    \brief      read the DWT cycle counter
+    \param[in]  none
+    \param[out] none
+    \retval     core cycles
+*/
+static uint32_t diag_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*!
+    \brief      test the SDRAM and print the report over RTT
+    \param[in]  sdram_device: specify which SDRAM device is tested
+      \arg        EXMC_SDRAM_DEVICE0: SDRAM device0
+      \arg        EXMC_SDRAM_DEVICE1: SDRAM device1
+    \param[out] none
+    \retval     0 when no fault was found, 1 otherwise
+*/
+int sdram_diag_selftest(uint32_t sdram_device)
+{
+    sdram_diag_mem_struct mem;
+    sdram_diag_config_struct config;
+    sdram_diag_report_struct report;
+    uint8_t *base;
+    uint32_t i;
+    int result;
+    static const uint8_t width[SDRAM_DIAG_WIDTHS] = {8U, 16U, 32U};
+
+    if(EXMC_SDRAM_DEVICE0 == sdram_device){
+        base = (uint8_t *)SDRAM_DEVICE0_ADDR;
+    }else{
+        base = (uint8_t *)SDRAM_DEVICE1_ADDR;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    sdram_diag_mem_direct(&mem, base, SDRAM_DIAG_DEVICE_SIZE);
+    config.mem = &mem;
+    config.offset = 0;
+    config.length = SDRAM_DIAG_DEVICE_SIZE;
+    config.march_length = SDRAM_DIAG_MARCH_LENGTH;
+    config.backgrounds = SDRAM_DIAG_MARCH_BACKGROUNDS;
+    config.bw_area = base + SDRAM_DIAG_MARCH_LENGTH;
+    config.bw_length = SDRAM_DIAG_BW_LENGTH;
+    config.cycles = diag_cycles;
+    config.cycle_hz = SystemCoreClock;
+
+    result = sdram_diag_run(&config, &report);
+
+    SEGGER_RTT_printf(0, "sdram: data lines 0x%08x, address lines 0x%08x\n",
+                      report.data_bits, report.address_bits);
+    SEGGER_RTT_printf(0, "sdram: march %u errors", report.march.errors);
+    if(0U != report.march.errors){
+        SEGGER_RTT_printf(0, ", first at 0x%08x expected 0x%08x read 0x%08x",
+                          report.march.offset, report.march.expected, report.march.actual);
+    }
+    SEGGER_RTT_printf(0, "\n");
+    for(i = 0; i < SDRAM_DIAG_WIDTHS; i++){
+        SEGGER_RTT_printf(0, "sdram: %2u bit read %u write %u copy %u KB/s\n",
+                          width[i], report.bw[i].read, report.bw[i].write, report.bw[i].copy);
+    }
+    SEGGER_RTT_printf(0, "sdram: self-test %s in %u ms\n", result ? "FAILED" : "passed",
+                      report.cycles / (SystemCoreClock / 1000U));
+
+    return result;
+}
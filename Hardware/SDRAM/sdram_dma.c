@@ -0,0 +1,301 @@
+/*!
+    \file    sdram_dma.c
+    \brief   asynchronous SDRAM copy service
+
+    Copies are served in the order they were queued. Each one is split
+    into a head and tail the CPU copies and a body the DMA moves with the
+    widest item both addresses allow, in transfers of at most 65535
+    items. Copies below SDRAM_DMA_CPU_THRESHOLD are done on the CPU, at
+    once when the queue is empty, otherwise in turn so they never pass a
+    copy they may depend on.
+
+    Tokens are handed out in queue order, so a copy is done once the last
+    completed token has reached it.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include "sdram_dma.h"
+#include "sdram_copy.h"
+
+typedef struct {
+    uint8_t *dst;
+    const uint8_t *src;
+    uint32_t length;
+    uint32_t head;                                      /*!< bytes before the DMA body */
+    uint32_t body;                                      /*!< bytes moved by the DMA */
+    uint32_t done;                                      /*!< body bytes already moved */
+    uint32_t segment;                                   /*!< body bytes of the running transfer */
+    uint32_t token;
+    sdram_dma_callback_func callback;
+    void *arg;
+    uint8_t width;                                      /*!< bytes per DMA item */
+    uint8_t started;                                    /*!< head and tail are copied */
+} sdram_dma_request_struct;
+
+static struct {
+    sdram_dma_request_struct queue[SDRAM_DMA_QUEUE_LEN];
+    uint32_t first;
+    uint32_t count;
+    uint32_t next_token;
+    _Atomic uint32_t completed;                         /*!< token of the last finished copy */
+    uint8_t running;                                    /*!< a DMA transfer is in flight or the queue is being served */
+    sdram_dma_stats_struct stats;
+} dma;
+
+/*!
+    \brief      reset the queue and set up the DMA channel
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sdram_dma_init(void)
+{
+    dma.first = 0;
+    dma.count = 0;
+    dma.next_token = 1;
+    atomic_store_explicit(&dma.completed, 0U, memory_order_relaxed);
+    dma.running = 0;
+    dma.stats.requests = 0;
+    dma.stats.rejected = 0;
+    dma.stats.cpu_bytes = 0;
+    dma.stats.dma_bytes = 0;
+    dma.stats.segments = 0;
+    dma.stats.errors = 0;
+    sdram_dma_port_init();
+}
+
+/*!
+    \brief      hand out the next token, 0 is skipped
+    \param[in]  none
+    \param[out] none
+    \retval     token
+*/
+static uint32_t token_next(void)
+{
+    uint32_t token = dma.next_token++;
+
+    if(SDRAM_DMA_TOKEN_NONE == dma.next_token){
+        dma.next_token = 1;
+    }
+    return token;
+}
+
+/*!
+    \brief      retire the first request and report it
+    \param[in]  error: 1 when the DMA failed
+    \param[out] none
+    \retval     none
+*/
+static void request_finish(int error)
+{
+    sdram_dma_request_struct *req = &dma.queue[dma.first];
+    sdram_dma_callback_func callback = req->callback;
+    void *arg = req->arg;
+    uint32_t token = req->token;
+
+    dma.first = (dma.first + 1U) % SDRAM_DMA_QUEUE_LEN;
+    dma.count--;
+    atomic_store_explicit(&dma.completed, token, memory_order_release);
+    if(NULL != callback){
+        callback(token, arg, error);
+    }
+}
+
+/*!
+    \brief      start the next DMA transfer of the first request
+    \param[in]  req: first request
+    \param[out] none
+    \retval     none
+*/
+static void segment_start(sdram_dma_request_struct *req)
+{
+    uint32_t items = (req->body - req->done) / req->width;
+
+    if(items > SDRAM_DMA_MAX_ITEMS){
+        items = SDRAM_DMA_MAX_ITEMS;
+    }
+    req->segment = items * req->width;
+    dma.stats.segments++;
+    sdram_dma_port_start(req->dst + req->head + req->done, req->src + req->head + req->done, items, req->width);
+}
+
+/*!
+    \brief      serve the queue until a DMA transfer is running or the queue is empty
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void queue_run(void)
+{
+    sdram_dma_request_struct *req;
+    uint32_t tail;
+
+    /* callbacks may queue more copies, the outer call picks them up */
+    if(dma.running){
+        return;
+    }
+    dma.running = 1;
+
+    while(0U != dma.count){
+        req = &dma.queue[dma.first];
+        if(!req->started){
+            req->started = 1;
+            tail = req->length - req->head - req->body;
+            sdram_copy(req->dst, req->src, req->head);
+            sdram_copy(req->dst + req->head + req->body, req->src + req->head + req->body, tail);
+            dma.stats.cpu_bytes += req->head + tail;
+        }
+        if(req->done < req->body){
+            segment_start(req);
+            return;
+        }
+        request_finish(0);
+    }
+    dma.running = 0;
+}
+
+/*!
+    \brief      queue a copy
+    \param[in]  src: source, any alignment
+    \param[in]  length: number of bytes
+    \param[in]  callback: called when the copy has finished, may be NULL, see sdram_dma_callback_func
+    \param[in]  arg: passed to callback
+    \param[out] dst: destination, must not overlap src
+    \retval     completion token, SDRAM_DMA_TOKEN_NONE when the queue is full
+*/
+uint32_t sdram_dma_copy(void *dst, const void *src, uint32_t length, sdram_dma_callback_func callback, void *arg)
+{
+    sdram_dma_request_struct *req;
+    uint32_t state, token, width, misalign;
+
+    state = sdram_dma_port_lock();
+
+    if((0U == dma.count) && (length < SDRAM_DMA_CPU_THRESHOLD)){
+        /* nothing to wait for, finish it right here */
+        token = token_next();
+        sdram_copy(dst, src, length);
+        dma.stats.requests++;
+        dma.stats.cpu_bytes += length;
+        atomic_store_explicit(&dma.completed, token, memory_order_release);
+        sdram_dma_port_unlock(state);
+        if(NULL != callback){
+            callback(token, arg, 0);
+        }
+        return token;
+    }
+
+    if(SDRAM_DMA_QUEUE_LEN == dma.count){
+        dma.stats.rejected++;
+        sdram_dma_port_unlock(state);
+        return SDRAM_DMA_TOKEN_NONE;
+    }
+
+    req = &dma.queue[(dma.first + dma.count) % SDRAM_DMA_QUEUE_LEN];
+    req->dst = (uint8_t *)dst;
+    req->src = (const uint8_t *)src;
+    req->length = length;
+    req->callback = callback;
+    req->arg = arg;
+    req->done = 0;
+    req->started = 0;
+    req->head = length;
+    req->body = 0;
+    req->width = 1;
+
+    if(length >= SDRAM_DMA_CPU_THRESHOLD){
+        /* the widest item both addresses can be aligned to */
+        misalign = (uint32_t)((uintptr_t)dst ^ (uintptr_t)src);
+        width = (0U == (misalign & 3U)) ? 4U : ((0U == (misalign & 1U)) ? 2U : 1U);
+        req->head = (uint32_t)(-(uintptr_t)dst) & (width - 1U);
+        req->body = ((length - req->head) / width) * width;
+        req->width = (uint8_t)width;
+    }
+
+    token = token_next();
+    req->token = token;
+    dma.count++;
+    dma.stats.requests++;
+    queue_run();
+
+    sdram_dma_port_unlock(state);
+
+    return token;
+}
+
+/*!
+    \brief      report the end of the running DMA transfer
+    \param[in]  error: 1 when the transfer failed
+    \param[out] none
+    \retval     none
+*/
+void sdram_dma_transfer_done(int error)
+{
+    sdram_dma_request_struct *req;
+
+    if(0U == dma.count){
+        return;
+    }
+    req = &dma.queue[dma.first];
+
+    dma.running = 0;
+    if(error){
+        dma.stats.errors++;
+        request_finish(1);
+    }else{
+        req->done += req->segment;
+        dma.stats.dma_bytes += req->segment;
+        if(req->done >= req->body){
+            request_finish(0);
+        }
+    }
+    queue_run();
+}
+
+/*!
+    \brief      check whether a copy has finished
+    \param[in]  token: token returned by sdram_dma_copy()
+    \param[out] none
+    \retval     1 when finished, 0 otherwise
+*/
+int sdram_dma_done(uint32_t token)
+{
+    /* acquire pairs with the release in request_finish(), the copied bytes are visible once it is seen */
+    return (int32_t)(atomic_load_explicit(&dma.completed, memory_order_acquire) - token) >= 0;
+}
+
+/*!
+    \brief      wait until a copy has finished
+    \param[in]  token: token returned by sdram_dma_copy()
+    \param[out] none
+    \retval     none
+*/
+void sdram_dma_wait(uint32_t token)
+{
+    while(!sdram_dma_done(token)){
+    }
+}
+
+/*!
+    \brief      get the number of copies queued or running
+    \param[in]  none
+    \param[out] none
+    \retval     number of copies
+*/
+uint32_t sdram_dma_pending(void)
+{
+    return dma.count;
+}
+
+/*!
+    \brief      get the statistics
+    \param[in]  none
+    \param[out] none
+    \retval     statistics
+*/
+const sdram_dma_stats_struct *sdram_dma_stats_get(void)
+{
+    return &dma.stats;
+}
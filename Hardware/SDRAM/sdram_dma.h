@@ -0,0 +1,66 @@
+/*!
+    \file    sdram_dma.h
+    \brief   the header file of the asynchronous SDRAM copy service
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef SDRAM_DMA_H
+#define SDRAM_DMA_H
+
+#include <stdint.h>
+
+/* number of copies that can wait at the same time */
+#define SDRAM_DMA_QUEUE_LEN         16U
+/* shorter copies run on the CPU, the DMA set-up would cost more */
+#define SDRAM_DMA_CPU_THRESHOLD     256U
+/* largest item count of one DMA transfer */
+#define SDRAM_DMA_MAX_ITEMS         65535U
+
+/* returned when the queue is full, never a valid token */
+#define SDRAM_DMA_TOKEN_NONE        0U
+
+/* called when a copy has finished, error is 1 on a transfer error. Usually from the DMA
+   interrupt, but a copy done on the CPU reports from the caller's context: inside
+   sdram_dma_copy() for a short copy into an empty queue, after the lock is released, and for
+   short copies queued behind a finished transfer, with the lock held. A callback may queue
+   copies but must not wait for one. */
+typedef void (*sdram_dma_callback_func)(uint32_t token, void *arg, int error);
+
+typedef struct {
+    uint32_t requests;                                  /*!< copies accepted */
+    uint32_t rejected;                                  /*!< copies refused because the queue was full */
+    uint32_t cpu_bytes;                                 /*!< bytes moved by the CPU */
+    uint32_t dma_bytes;                                 /*!< bytes moved by the DMA */
+    uint32_t segments;                                  /*!< DMA transfers started */
+    uint32_t errors;                                    /*!< DMA transfer errors */
+} sdram_dma_stats_struct;
+
+/* reset the queue and set up the DMA channel */
+void sdram_dma_init(void);
+/* queue a copy, return its completion token or SDRAM_DMA_TOKEN_NONE when the queue is full */
+uint32_t sdram_dma_copy(void *dst, const void *src, uint32_t length, sdram_dma_callback_func callback, void *arg);
+/* check whether a copy has finished */
+int sdram_dma_done(uint32_t token);
+/* wait until a copy has finished */
+void sdram_dma_wait(uint32_t token);
+/* number of copies queued or running */
+uint32_t sdram_dma_pending(void);
+/* get the statistics */
+const sdram_dma_stats_struct *sdram_dma_stats_get(void);
+/* report the end of the running DMA transfer, called by the port from its interrupt */
+void sdram_dma_transfer_done(int error);
+
+/* port functions, sdram_dma_port.c on the target */
+/* enable the DMA controller */
+void sdram_dma_port_init(void);
+/* start a memory to memory transfer of items of width bytes */
+void sdram_dma_port_start(void *dst, const void *src, uint32_t items, uint32_t width);
+/* keep sdram_dma_transfer_done() out, return the state to restore */
+uint32_t sdram_dma_port_lock(void);
+/* restore the state returned by sdram_dma_port_lock() */
+void sdram_dma_port_unlock(uint32_t state);
+/* serve the DMA interrupt */
+void sdram_dma_port_irq(void);
+
+#endif /* SDRAM_DMA_H */
@@ -0,0 +1,117 @@
+/*!
+    \file    sdram_dma_port.c
+    \brief   SDRAM copy service on DMA1 channel 0
+
+    Only DMA1 can move memory to memory. The FIFO is required in that
+    mode, the source goes in the peripheral address register.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "sdram_dma.h"
+
+#define SDRAM_DMA_PERIPH            DMA1
+#define SDRAM_DMA_CHANNEL           DMA_CH0
+
+/*!
+    \brief      enable the DMA controller and its interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sdram_dma_port_init(void)
+{
+    rcu_periph_clock_enable(RCU_DMA1);
+    dma_deinit(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL);
+    nvic_irq_enable(DMA1_Channel0_IRQn, 2, 0);
+}
+
+/*!
+    \brief      start a memory to memory transfer
+    \param[in]  src: source, aligned to width
+    \param[in]  items: number of items, at most SDRAM_DMA_MAX_ITEMS
+    \param[in]  width: item size, 1, 2 or 4 bytes
+    \param[out] dst: destination, aligned to width
+    \retval     none
+*/
+void sdram_dma_port_start(void *dst, const void *src, uint32_t items, uint32_t width)
+{
+    dma_multi_data_parameter_struct dma_init_struct;
+    uint32_t periph_width, memory_width;
+
+    if(4U == width){
+        periph_width = DMA_PERIPH_WIDTH_32BIT;
+        memory_width = DMA_MEMORY_WIDTH_32BIT;
+    }else if(2U == width){
+        periph_width = DMA_PERIPH_WIDTH_16BIT;
+        memory_width = DMA_MEMORY_WIDTH_16BIT;
+    }else{
+        periph_width = DMA_PERIPH_WIDTH_8BIT;
+        memory_width = DMA_MEMORY_WIDTH_8BIT;
+    }
+
+    /* deinit also clears the flags of the previous transfer */
+    dma_deinit(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL);
+    dma_multi_data_para_struct_init(&dma_init_struct);
+    dma_init_struct.periph_addr = (uint32_t)src;
+    dma_init_struct.periph_width = periph_width;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_ENABLE;
+    dma_init_struct.memory0_addr = (uint32_t)dst;
+    dma_init_struct.memory_width = memory_width;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.memory_burst_width = DMA_MEMORY_BURST_SINGLE;
+    dma_init_struct.periph_burst_width = DMA_PERIPH_BURST_SINGLE;
+    dma_init_struct.critical_value = DMA_FIFO_4_WORD;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_DISABLE;
+    dma_init_struct.direction = DMA_MEMORY_TO_MEMORY;
+    dma_init_struct.number = items;
+    dma_init_struct.priority = DMA_PRIORITY_LOW;
+    dma_multi_data_mode_init(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL, &dma_init_struct);
+
+    dma_interrupt_enable(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL, DMA_INT_FTF | DMA_INT_TAE);
+    dma_channel_enable(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL);
+}
+
+/*!
+    \brief      mask interrupts
+    \param[in]  none
+    \param[out] none
+    \retval     previous PRIMASK
+*/
+uint32_t sdram_dma_port_lock(void)
+{
+    uint32_t state = __get_PRIMASK();
+
+    __disable_irq();
+    return state;
+}
+
+/*!
+    \brief      restore the interrupt mask
+    \param[in]  state: value returned by sdram_dma_port_lock()
+    \param[out] none
+    \retval     none
+*/
+void sdram_dma_port_unlock(uint32_t state)
+{
+    __set_PRIMASK(state);
+}
+
+/*!
+    \brief      handle the DMA1 channel 0 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sdram_dma_port_irq(void)
+{
+    if(SET == dma_interrupt_flag_get(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL, DMA_INT_FLAG_TAE)){
+        dma_interrupt_flag_clear(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL, DMA_INT_FLAG_TAE);
+        dma_channel_disable(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL);
+        sdram_dma_transfer_done(1);
+    }else if(SET == dma_interrupt_flag_get(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL, DMA_INT_FLAG_FTF)){
+        dma_interrupt_flag_clear(SDRAM_DMA_PERIPH, SDRAM_DMA_CHANNEL, DMA_INT_FLAG_FTF);
+        sdram_dma_transfer_done(0);
+    }
+}
@@ -0,0 +1,145 @@
+/*!
+    \file    sdram_timing.c
+    \brief   SDRAM timing calculator
+
+    The EXMC counts every SDRAM delay in SDCLK cycles, SDCLK being HCLK
+    divided by 2 or 3. Each delay is the datasheet minimum rounded up to
+    whole cycles, so it stays legal at any clock and is no longer than
+    it has to be. The EXMC precharges a row write recovery cycles after
+    a write, which has to satisfy tRAS and tRC as well when the write
+    follows the activate, so the write recovery delay is raised to
+    cover them.
+
+    The auto-refresh interval spreads the refresh commands over the
+    refresh period, less a margin for a refresh that has to wait for an
+    access in progress.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "sdram_timing.h"
+
+const sdram_part_struct sdram_parts[SDRAM_PART_COUNT] = {
+    [SDRAM_PART_MT48LC16M16A2_6A] = {
+        "MT48LC16M16A2-6A", 133000000U, 167000000U, 2U, 1U, 6000U,
+        67000U, 42000U, 60000U, 18000U, 18000U, 64U, 8192U, 9U, 13U, 4U, 16U
+    },
+    [SDRAM_PART_MT48LC16M16A2_75] = {
+        "MT48LC16M16A2-75", 100000000U, 133000000U, 2U, 1U, 7500U,
+        75000U, 44000U, 66000U, 20000U, 20000U, 64U, 8192U, 9U, 13U, 4U, 16U
+    },
+    [SDRAM_PART_W9825G6KH_6] = {
+        "W9825G6KH-6", 133000000U, 166000000U, 2U, 2U, 0U,
+        72000U, 42000U, 60000U, 15000U, 15000U, 64U, 8192U, 9U, 13U, 4U, 16U
+    },
+    [SDRAM_PART_IS42S16400J_7] = {
+        "IS42S16400J-7", 100000000U, 143000000U, 2U, 2U, 0U,
+        70000U, 42000U, 63000U, 15000U, 15000U, 64U, 4096U, 8U, 12U, 4U, 16U
+    },
+    [SDRAM_PART_IS42S16320D_7] = {
+        "IS42S16320D-7", 100000000U, 143000000U, 2U, 2U, 0U,
+        67000U, 37000U, 60000U, 15000U, 15000U, 64U, 8192U, 10U, 13U, 4U, 16U
+    },
+};
+
+/*!
+    \brief      convert a time to a delay field
+    \param[in]  ps: time in picoseconds
+    \param[in]  clk: clocks added to the time
+    \param[in]  sdclk_hz: SDCLK frequency
+    \param[out] cycles: SDCLK cycles
+    \retval     0, -1 when the delay does not fit the field
+*/
+static int timing_cycles(uint32_t ps, uint32_t clk, uint32_t sdclk_hz, uint8_t *cycles)
+{
+    uint32_t n = SDRAM_TIMING_CYCLES(ps, sdclk_hz) + clk;
+
+    if(n < SDRAM_TIMING_CYCLES_MIN){
+        n = SDRAM_TIMING_CYCLES_MIN;
+    }
+    if(n > SDRAM_TIMING_CYCLES_MAX){
+        return -1;
+    }
+    *cycles = (uint8_t)n;
+    return 0;
+}
+
+/*!
+    \brief      compute the timing of a part at one SDCLK divider
+    \param[in]  part: datasheet values
+    \param[in]  hclk_hz: AHB clock
+    \param[in]  sdclk_div: HCLK periods per SDCLK, 2 or 3
+    \param[out] timing: register values
+    \retval     0, -1 when the part is too slow for the clock or a delay does not fit
+*/
+int sdram_timing_at(const sdram_part_struct *part, uint32_t hclk_hz, uint32_t sdclk_div, sdram_timing_struct *timing)
+{
+    uint32_t sdclk_hz, refresh, rc_min;
+    int err = 0;
+
+    if((2U != sdclk_div) && (3U != sdclk_div)){
+        return -1;
+    }
+    sdclk_hz = hclk_hz / sdclk_div;
+
+    /* the lowest latency the part can take at this clock */
+    if((0U != part->cl2_hz) && (sdclk_hz <= part->cl2_hz)){
+        timing->cas_latency = 2U;
+    }else if(sdclk_hz <= part->cl3_hz){
+        timing->cas_latency = 3U;
+    }else{
+        return -1;
+    }
+    timing->sdclk_hz = sdclk_hz;
+    timing->sdclk_div = (uint8_t)sdclk_div;
+
+    err |= timing_cycles(0U, part->t_mrd_clk, sdclk_hz, &timing->load_mode_register_delay);
+    err |= timing_cycles(part->t_xsr_ps, 0U, sdclk_hz, &timing->exit_selfrefresh_delay);
+    err |= timing_cycles(part->t_ras_ps, 0U, sdclk_hz, &timing->row_address_select_delay);
+    err |= timing_cycles(part->t_rc_ps, 0U, sdclk_hz, &timing->auto_refresh_delay);
+    err |= timing_cycles(part->t_wr_ps, part->t_wr_clk, sdclk_hz, &timing->write_recovery_delay);
+    err |= timing_cycles(part->t_rp_ps, 0U, sdclk_hz, &timing->row_precharge_delay);
+    err |= timing_cycles(part->t_rcd_ps, 0U, sdclk_hz, &timing->row_to_column_delay);
+    if(0 != err){
+        return -1;
+    }
+
+    /* a write right after the activate must not precharge before tRAS and tRC */
+    if(timing->write_recovery_delay + timing->row_to_column_delay < timing->row_address_select_delay){
+        timing->write_recovery_delay = timing->row_address_select_delay - timing->row_to_column_delay;
+    }
+    rc_min = (uint32_t)timing->auto_refresh_delay - timing->row_to_column_delay - timing->row_precharge_delay;
+    if((timing->auto_refresh_delay > timing->row_to_column_delay + timing->row_precharge_delay) &&
+       (timing->write_recovery_delay < rc_min)){
+        timing->write_recovery_delay = (uint8_t)rc_min;
+    }
+
+    refresh = (uint32_t)(((uint64_t)part->refresh_ms * sdclk_hz) / (1000U * (uint64_t)part->refresh_rows));
+    if((refresh <= SDRAM_TIMING_REFRESH_MARGIN + timing->auto_refresh_delay) ||
+       (refresh - SDRAM_TIMING_REFRESH_MARGIN > SDRAM_TIMING_REFRESH_MAX)){
+        return -1;
+    }
+    timing->refresh_count = (uint16_t)(refresh - SDRAM_TIMING_REFRESH_MARGIN);
+    return 0;
+}
+
+/*!
+    \brief      compute the fastest timing of a part
+    \param[in]  part: datasheet values
+    \param[in]  hclk_hz: AHB clock
+    \param[in]  sdclk_max_hz: highest SDCLK the board and controller allow
+    \param[out] timing: register values
+    \retval     0, -1 when no divider gives a legal timing
+*/
+int sdram_timing_calc(const sdram_part_struct *part, uint32_t hclk_hz, uint32_t sdclk_max_hz, sdram_timing_struct *timing)
+{
+    uint32_t div;
+
+    for(div = 2U; div <= 3U; div++){
+        if((hclk_hz / div <= sdclk_max_hz) && (0 == sdram_timing_at(part, hclk_hz, div, timing))){
+            return 0;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,79 @@
+/*!
+    \file    sdram_timing.h
+    \brief   the header file of the SDRAM timing calculator
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef SDRAM_TIMING_H
+#define SDRAM_TIMING_H
+
+#include <stdint.h>
+
+/* range of the EXMC timing fields in SDCLK cycles */
+#define SDRAM_TIMING_CYCLES_MIN     1U
+#define SDRAM_TIMING_CYCLES_MAX     16U
+/* largest auto-refresh interval the EXMC takes, 13 bits */
+#define SDRAM_TIMING_REFRESH_MAX    8191U
+/* SDCLK cycles the auto-refresh interval is shortened by, from the user manual */
+#define SDRAM_TIMING_REFRESH_MARGIN 20U
+
+/* SDCLK cycles that cover a time in picoseconds, rounded up, for constant folding */
+#define SDRAM_TIMING_CYCLES(ps, hz) \
+    ((uint32_t)(((uint64_t)(ps) * (hz) + 999999999999ULL) / 1000000000000ULL))
+
+/* SDRAM parts with a table entry */
+typedef enum {
+    SDRAM_PART_MT48LC16M16A2_6A = 0,                    /*!< Micron 256 Mbit, 4M x 16 x 4 banks, 167 MHz */
+    SDRAM_PART_MT48LC16M16A2_75,                        /*!< Micron 256 Mbit, 4M x 16 x 4 banks, 133 MHz */
+    SDRAM_PART_W9825G6KH_6,                             /*!< Winbond 256 Mbit, 4M x 16 x 4 banks, 166 MHz */
+    SDRAM_PART_IS42S16400J_7,                           /*!< ISSI 64 Mbit, 1M x 16 x 4 banks, 143 MHz */
+    SDRAM_PART_IS42S16320D_7,                           /*!< ISSI 512 Mbit, 8M x 16 x 4 banks, 143 MHz */
+    SDRAM_PART_COUNT
+} sdram_part_enum;
+
+/* datasheet values of a part, times in picoseconds */
+typedef struct {
+    const char *name;
+    uint32_t cl2_hz;                                    /*!< highest clock with CAS latency 2, 0 when not supported */
+    uint32_t cl3_hz;                                    /*!< highest clock with CAS latency 3 */
+    uint8_t t_mrd_clk;                                  /*!< load mode register to active, clocks */
+    uint8_t t_wr_clk;                                   /*!< write recovery, clocks added to t_wr_ps */
+    uint32_t t_wr_ps;
+    uint32_t t_xsr_ps;                                  /*!< exit self-refresh to active */
+    uint32_t t_ras_ps;                                  /*!< active to precharge, minimum */
+    uint32_t t_rc_ps;                                   /*!< active to active and auto-refresh period */
+    uint32_t t_rp_ps;                                   /*!< precharge to active */
+    uint32_t t_rcd_ps;                                  /*!< active to read or write */
+    uint32_t refresh_ms;                                /*!< every row is refreshed once in this time */
+    uint32_t refresh_rows;                              /*!< auto-refresh commands in refresh_ms */
+    uint8_t column_bits;
+    uint8_t row_bits;
+    uint8_t banks;
+    uint8_t data_bits;
+} sdram_part_struct;
+
+/* register values for one part at one clock */
+typedef struct {
+    uint32_t sdclk_hz;
+    uint8_t sdclk_div;                                  /*!< HCLK periods per SDCLK, 2 or 3 */
+    uint8_t cas_latency;                                /*!< 2 or 3 */
+    uint8_t load_mode_register_delay;                   /*!< the delays are in SDCLK cycles, 1..16 */
+    uint8_t exit_selfrefresh_delay;
+    uint8_t row_address_select_delay;
+    uint8_t auto_refresh_delay;
+    uint8_t write_recovery_delay;
+    uint8_t row_precharge_delay;
+    uint8_t row_to_column_delay;
+    uint16_t refresh_count;                             /*!< auto-refresh interval in SDCLK cycles */
+} sdram_timing_struct;
+
+/* datasheet values, indexed by sdram_part_enum */
+extern const sdram_part_struct sdram_parts[SDRAM_PART_COUNT];
+
+/* compute the timing of a part at one SDCLK divider, return 0 or -1 when it cannot run there */
+int sdram_timing_at(const sdram_part_struct *part, uint32_t hclk_hz, uint32_t sdclk_div, sdram_timing_struct *timing);
+/* compute the fastest timing of a part with SDCLK at most sdclk_max_hz, return 0 or -1 */
+int sdram_timing_calc(const sdram_part_struct *part, uint32_t hclk_hz, uint32_t sdclk_max_hz, sdram_timing_struct *timing);
+
+#endif /* SDRAM_TIMING_H */
@@ -0,0 +1,179 @@
+/*!
+    \file    boot.c
+    \brief   boot sequencer
+
+    The board is brought up by a table of steps, each naming the steps
+    it has to follow. The sequencer runs the first step in table order
+    whose dependencies are done, and starts over from the top after
+    each one, so the table order is the priority. A step that only
+    starts hardware returns at once and reports through busy() when it
+    has finished or failed, and a step whose hardware then needs time to settle
+    asks for it with hold_us. Steps that do not depend on it run during
+    that time instead of waiting in a delay loop.
+
+    A step that fails takes the steps depending on it out of the
+    sequence, as do dependencies that cannot finish, so a broken step
+    or a cycle in the table cannot hang the boot.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "boot.h"
+
+/* result of checking the dependencies of a step */
+typedef enum {
+    DEPS_READY = 0,
+    DEPS_WAIT,                                          /*!< a dependency is not done or still holds */
+    DEPS_BROKEN                                         /*!< a dependency failed, was skipped or does not exist */
+} deps_enum;
+
+/*!
+    \brief      check the dependencies of a step
+    \param[in]  steps: step table
+    \param[in]  count: number of steps
+    \param[in]  records: state of the steps
+    \param[in]  index: step to check
+    \param[in]  now: microseconds since the start of the sequence
+    \param[out] wake: lowered to the end of the first hold that delays the step
+    \retval     DEPS_READY, DEPS_WAIT or DEPS_BROKEN
+*/
+static deps_enum deps_check(const boot_step_struct *steps, uint32_t count, const boot_record_struct *records,
+                            uint32_t index, uint32_t now, uint32_t *wake)
+{
+    uint32_t after = steps[index].after;
+    uint32_t d, ready_at;
+    deps_enum result = DEPS_READY;
+
+    for(d = 0; (d < BOOT_STEPS_MAX) && (0U != after); d++){
+        if(0U == (after & BOOT_AFTER(d))){
+            continue;
+        }
+        after &= ~BOOT_AFTER(d);
+        if((d >= count) || (d == index) ||
+           (BOOT_STEP_FAILED == records[d].state) || (BOOT_STEP_SKIPPED == records[d].state)){
+            return DEPS_BROKEN;
+        }
+        if(BOOT_STEP_DONE != records[d].state){
+            result = DEPS_WAIT;
+            continue;
+        }
+        ready_at = records[d].end + steps[d].hold_us;
+        if(now < ready_at){
+            result = DEPS_WAIT;
+            if(ready_at < *wake){
+                *wake = ready_at;
+            }
+        }
+    }
+    return result;
+}
+
+/*!
+    \brief      run the steps as their dependencies allow
+    \param[in]  steps: step table, at most BOOT_STEPS_MAX
+    \param[in]  count: number of steps
+    \param[in]  clock: time source
+    \param[out] records: state and times of every step
+    \retval     number of steps not done
+*/
+uint32_t boot_run(const boot_step_struct *steps, uint32_t count, const boot_clock_struct *clock,
+                  boot_record_struct *records)
+{
+    const boot_step_struct *step;
+    boot_record_struct *record;
+    uint32_t start = clock->now();
+    uint32_t i, now, wake, waiting, busy, not_done = 0;
+    int progressed, result;
+    deps_enum deps;
+
+    if(count > BOOT_STEPS_MAX){
+        count = BOOT_STEPS_MAX;
+    }
+    for(i = 0; i < count; i++){
+        records[i].state = BOOT_STEP_WAITING;
+        records[i].start = 0;
+        records[i].end = 0;
+    }
+
+    for(;;){
+        now = clock->now() - start;
+        wake = UINT32_MAX;
+        waiting = 0;
+        busy = 0;
+        progressed = 0;
+
+        for(i = 0; (i < count) && !progressed; i++){
+            step = &steps[i];
+            record = &records[i];
+
+            if(BOOT_STEP_BUSY == record->state){
+                result = step->busy();
+                if(result > 0){
+                    busy++;
+                }else{
+                    record->state = (0 == result) ? BOOT_STEP_DONE : BOOT_STEP_FAILED;
+                    record->end = clock->now() - start;
+                    progressed = 1;
+                }
+                continue;
+            }
+            if(BOOT_STEP_WAITING != record->state){
+                continue;
+            }
+
+            deps = deps_check(steps, count, records, i, now, &wake);
+            if(DEPS_BROKEN == deps){
+                record->state = BOOT_STEP_SKIPPED;
+                record->start = now;
+                record->end = now;
+                progressed = 1;
+            }else if(DEPS_WAIT == deps){
+                waiting++;
+            }else{
+                record->start = now;
+                result = step->run();
+                if((result >= 0) && (NULL != step->busy)){
+                    result = step->busy();
+                }
+                if(result < 0){
+                    record->state = BOOT_STEP_FAILED;
+                }else if((NULL != step->busy) && (result > 0)){
+                    record->state = BOOT_STEP_BUSY;
+                }else{
+                    record->state = BOOT_STEP_DONE;
+                }
+                record->end = clock->now() - start;
+                progressed = 1;
+            }
+        }
+
+        if(progressed){
+            continue;
+        }
+        if(0U == waiting + busy){
+            break;
+        }
+        if((0U == busy) && (UINT32_MAX == wake)){
+            /* the waiting steps wait for each other */
+            for(i = 0; i < count; i++){
+                if(BOOT_STEP_WAITING == records[i].state){
+                    records[i].state = BOOT_STEP_SKIPPED;
+                    records[i].start = now;
+                    records[i].end = now;
+                }
+            }
+            break;
+        }
+        if(NULL != clock->idle){
+            clock->idle(start + ((0U != busy) ? now : wake));
+        }
+    }
+
+    for(i = 0; i < count; i++){
+        if(BOOT_STEP_DONE != records[i].state){
+            not_done++;
+        }
+    }
+    return not_done;
+}
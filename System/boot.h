@@ -0,0 +1,56 @@
+/*!
+    \file    boot.h
+    \brief   the header file of the boot sequencer
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+/* steps of one sequence, dependencies are a bit mask */
+#define BOOT_STEPS_MAX              32U
+#define BOOT_AFTER(step)            (1UL << (step))
+
+/* state of a step */
+typedef enum {
+    BOOT_STEP_WAITING = 0,                              /*!< dependencies not done yet */
+    BOOT_STEP_BUSY,                                     /*!< run() returned, busy() still reports work */
+    BOOT_STEP_DONE,
+    BOOT_STEP_FAILED,                                   /*!< run() or busy() returned an error */
+    BOOT_STEP_SKIPPED                                   /*!< a dependency failed or can never finish */
+} boot_step_state_enum;
+
+/* one init step */
+typedef struct {
+    const char *name;
+    uint32_t after;                                     /*!< BOOT_AFTER() of the steps that must be done first */
+    int (*run)(void);                                   /*!< 0 or a negative error */
+    int (*busy)(void);                                  /*!< NULL, or positive while work started by run() goes on, negative when it failed */
+    uint32_t hold_us;                                   /*!< time after the step before its dependents may start */
+} boot_step_struct;
+
+/* what happened to a step, times in microseconds from the start of the sequence */
+typedef struct {
+    boot_step_state_enum state;
+    uint32_t start;
+    uint32_t end;                                       /*!< when the step was done, failed or skipped */
+} boot_record_struct;
+
+/* time source of the sequencer */
+typedef struct {
+    uint32_t (*now)(void);                              /*!< free running microseconds */
+    void (*idle)(uint32_t until);                       /*!< NULL, or wait while nothing can run, until is a now() value */
+} boot_clock_struct;
+
+/* run the steps as their dependencies allow, return the number of steps not done */
+uint32_t boot_run(const boot_step_struct *steps, uint32_t count, const boot_clock_struct *clock,
+                  boot_record_struct *records);
+
+/* target functions, boot_port.c */
+/* bring up the board and print the step times over RTT, return the number of steps not done */
+uint32_t boot_start(void);
+
+#endif /* BOOT_H */
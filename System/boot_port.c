@@ -0,0 +1,210 @@
+/*!
+    \file    boot_port.c
+    \brief   boot sequence of the board
+
+    The SDRAM needs SDRAM_POWER_UP_MS between its clock enable and the
+    first command. Its power-up step comes first and holds for that
+    time, while the MPU, timer, event, SysTick, LED, TLI, DMA and pool
+    steps run. The frame buffer is cleared by the IPA, the heap is set up
+    during the transfer, and the display is switched on once the frame
+    is black. The self-test overwrites the start of the SDRAM, so the
+    clear and the heap follow it. The SDRAM commands are sent by a
+    coroutine on the soft timers, which its busy() runs, so the steps
+    after SysTick go on while it waits for the controller.
+
+    Steps are timed with the system clock, which needs no tick until
+    the counter first wraps, and the table is printed on RTT channel 0.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "systick.h"
+#include "led.h"
+#include "lcd.h"
+#include "exmc_sdram.h"
+#include "sdram_dma.h"
+#include "sdram_diag.h"
+#include "sdram_heap.h"
+#include "mem_pool.h"
+#include "soft_timer.h"
+#include "coro.h"
+#include "event_loop.h"
+#include "mpu.h"
+#include "boot.h"
+#include "sys_clock.h"
+#include "idle.h"
+#include "SEGGER_RTT.h"
+
+/* steps in priority order */
+typedef enum {
+    STEP_SDRAM_POWER = 0,
+    STEP_MPU,
+    STEP_TIMERS,
+    STEP_EVENTS,
+    STEP_SYSTICK,
+    STEP_LED,
+    STEP_TLI,
+    STEP_DMA,
+    STEP_SDRAM_START,
+    STEP_SDRAM_TEST,
+    STEP_FB_CLEAR,
+    STEP_HEAP,
+    STEP_POOLS,
+    STEP_DISPLAY,
+    STEP_COUNT
+} boot_step_enum;
+
+/* colour of the first frame */
+#define BOOT_FB_COLOR               0x0000U
+
+/* sends the SDRAM commands */
+static coro_struct sdram_start;
+
+/*!
+    \brief      read the microseconds of the system clock
+    \param[in]  none
+    \param[out] none
+    \retval     microseconds, wrapping after 71 minutes
+*/
+static uint32_t boot_now(void)
+{
+    return (uint32_t)sys_clock_us();
+}
+
+/* steps, 0 when done or a negative error */
+static int step_sdram_power(void)
+{
+    return (SUCCESS == exmc_sdram_power_up(EXMC_SDRAM_DEVICE0)) ? 0 : -1;
+}
+
+static int step_mpu(void)
+{
+    return (mpu_init() > 0) ? 0 : -1;
+}
+
+static int step_timers(void)
+{
+    soft_timer_wheel_init(&soft_timers);
+    return 0;
+}
+
+static int step_events(void)
+{
+    event_loop_init(&events, event_loop_port_cycles, event_loop_port_idle);
+    return 0;
+}
+
+static int step_systick(void)
+{
+    systick_config();
+    idle_port_init();
+    return 0;
+}
+
+static int step_led(void)
+{
+    led_gpio_config();
+    return 0;
+}
+
+static int step_tli(void)
+{
+    lcd_tli_config();
+    return 0;
+}
+
+static int step_dma(void)
+{
+    sdram_dma_init();
+    return 0;
+}
+
+static int step_sdram_start(void)
+{
+    coro_start(&sdram_start, &soft_timers, exmc_sdram_start_coro, (void *)(uintptr_t)EXMC_SDRAM_DEVICE0, NULL);
+    return 0;
+}
+
+/* the wheel is run here until the event loop takes it over */
+static int step_sdram_start_busy(void)
+{
+    soft_timer_run(&soft_timers);
+    return coro_active(&sdram_start) ? 1 : sdram_start.result;
+}
+
+/* a fault is reported by the test itself, the SDRAM is still used as before */
+static int step_sdram_test(void)
+{
+    sdram_diag_selftest(EXMC_SDRAM_DEVICE0);
+    return 0;
+}
+
+static int step_fb_clear(void)
+{
+    lcd_ipa_fill_start((uint32_t)ltdc_lcd_framebuf0, 0U, LCD_WIDTH, LCD_HEIGHT, BOOT_FB_COLOR);
+    return 0;
+}
+
+static int step_heap(void)
+{
+    return sdram_heap_init();
+}
+
+static int step_pools(void)
+{
+    mem_pool_init();
+    return 0;
+}
+
+static int step_display(void)
+{
+    lcd_disp_start();
+    return 0;
+}
+
+static const boot_step_struct boot_steps[STEP_COUNT] = {
+    [STEP_SDRAM_POWER] = {"sdram power", 0U, step_sdram_power, NULL, SDRAM_POWER_UP_MS * 1000U},
+    [STEP_MPU]         = {"mpu", 0U, step_mpu, NULL, 0U},
+    [STEP_TIMERS]      = {"timers", 0U, step_timers, NULL, 0U},
+    [STEP_EVENTS]      = {"events", 0U, step_events, NULL, 0U},
+    [STEP_SYSTICK]     = {"systick", BOOT_AFTER(STEP_TIMERS) | BOOT_AFTER(STEP_EVENTS), step_systick, NULL, 0U},
+    [STEP_LED]         = {"led", 0U, step_led, NULL, 0U},
+    [STEP_TLI]         = {"tli", 0U, step_tli, NULL, 0U},
+    [STEP_DMA]         = {"dma", 0U, step_dma, NULL, 0U},
+    [STEP_SDRAM_START] = {"sdram start", BOOT_AFTER(STEP_SDRAM_POWER) | BOOT_AFTER(STEP_SYSTICK),
+                          step_sdram_start, step_sdram_start_busy, 0U},
+    [STEP_SDRAM_TEST]  = {"sdram test", BOOT_AFTER(STEP_SDRAM_START) | BOOT_AFTER(STEP_MPU),
+                          step_sdram_test, NULL, 0U},
+    [STEP_FB_CLEAR]    = {"fb clear", BOOT_AFTER(STEP_SDRAM_TEST) | BOOT_AFTER(STEP_TLI),
+                          step_fb_clear, lcd_ipa_busy, 0U},
+    [STEP_HEAP]        = {"heap", BOOT_AFTER(STEP_SDRAM_TEST), step_heap, NULL, 0U},
+    [STEP_POOLS]       = {"pools", 0U, step_pools, NULL, 0U},
+    [STEP_DISPLAY]     = {"display", BOOT_AFTER(STEP_FB_CLEAR), step_display, NULL, 0U},
+};
+
+/*!
+    \brief      bring up the board and print the step times over RTT
+    \param[in]  none
+    \param[out] none
+    \retval     number of steps not done
+*/
+uint32_t boot_start(void)
+{
+    static const char *const state_name[] = {"waiting", "busy", "done", "FAILED", "skipped"};
+    static const boot_clock_struct clock = {boot_now, NULL};
+    boot_record_struct records[STEP_COUNT];
+    uint32_t i, not_done;
+
+    sys_clock_port_init();
+    not_done = boot_run(boot_steps, STEP_COUNT, &clock, records);
+
+    for(i = 0; i < STEP_COUNT; i++){
+        /* SEGGER_RTT_printf() has no width for %s, the names go last */
+        SEGGER_RTT_printf(0, "boot: at %7u us took %7u us %s %s\n", records[i].start,
+                          records[i].end - records[i].start, state_name[records[i].state], boot_steps[i].name);
+    }
+    SEGGER_RTT_printf(0, "boot: first pixel after %u us, %u steps not done\n",
+                      records[STEP_DISPLAY].end, not_done);
+    return not_done;
+}
@@ -0,0 +1,233 @@
+/*!
+    \file    coro.c
+    \brief   stackless coroutines
+
+    A coroutine is a function that returns where it would block and is
+    called again later to go on from there, protothread style: the
+    resume point is a line number and all state lives in the caller's
+    objects, so a coroutine costs its coro_struct and no stack of its
+    own. Multi-step hardware sequences are written as one straight
+    function with waits in it, and run between the other work of the
+    loop instead of spinning.
+
+    Waits are kept by the timer wheel. A coroutine waiting for a
+    condition has its timer fire every tick and checks again, one
+    sleeping has it fire once at the deadline, and one waiting for an
+    event sits in the event's list and is run by coro_event_signal().
+    Time is wheel->now, the ticks processed by soft_timer_run(), so the
+    coroutines run from the same context as the timer callbacks, and a
+    test drives them with soft_timer_tick() alone.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "coro.h"
+
+/* take a coroutine out of the list of the event it waits for */
+static void event_unlink(coro_struct *coro)
+{
+    coro_struct **link;
+
+    if(NULL == coro->event){
+        return;
+    }
+    for(link = &coro->event->waiters; NULL != *link; link = &(*link)->next){
+        if(coro == *link){
+            *link = coro->next;
+            break;
+        }
+    }
+    coro->event = NULL;
+    coro->next = NULL;
+}
+
+/*!
+    \brief      run a coroutine up to its next wait or its end
+    \param[in]  coro: active coroutine
+    \param[out] none
+    \retval     none
+*/
+static void coro_run(coro_struct *coro)
+{
+    int result;
+
+    soft_timer_stop(&coro->timer);
+    event_unlink(coro);
+
+    result = coro->fn(coro);
+    if(CORO_WAITING == result){
+        return;
+    }
+    coro->active = 0U;
+    coro->result = result;
+    if(NULL != coro->done){
+        coro->done(coro, result);
+    }
+}
+
+/* timer callback, the wait of the coroutine may be over */
+static void coro_timer(soft_timer_struct *timer, void *arg)
+{
+    (void)timer;
+    coro_run((coro_struct *)arg);
+}
+
+/*!
+    \brief      start a coroutine on a wheel and run it up to its first wait,
+                a coroutine that is still active is restarted
+    \param[in]  coro: coroutine
+    \param[in]  wheel: wheel its waits are timed and resumed by
+    \param[in]  fn: body of the coroutine
+    \param[in]  arg: state of the coroutine, coro->arg in fn
+    \param[in]  done: NULL, or called with the result when fn has finished
+    \param[out] none
+    \retval     none
+*/
+void coro_start(coro_struct *coro, soft_timer_wheel_struct *wheel, coro_fn fn, void *arg, coro_done_cb done)
+{
+    if(coro_active(coro)){
+        coro_stop(coro);
+    }
+    coro->fn = fn;
+    coro->arg = arg;
+    coro->done = done;
+    coro->wheel = wheel;
+    soft_timer_init(&coro->timer, coro_timer, coro);
+    coro->event = NULL;
+    coro->next = NULL;
+    coro->line = 0U;
+    coro->timed = 0U;
+    coro->timed_out = 0U;
+    coro->active = 1U;
+    coro->result = CORO_WAITING;
+    coro_run(coro);
+}
+
+/*!
+    \brief      stop a coroutine where it waits, done is not called
+    \param[in]  coro: coroutine
+    \param[out] none
+    \retval     none
+*/
+void coro_stop(coro_struct *coro)
+{
+    if(!coro_active(coro)){
+        return;
+    }
+    soft_timer_stop(&coro->timer);
+    event_unlink(coro);
+    coro->active = 0U;
+    coro->line = 0U;
+}
+
+/*!
+    \brief      check whether a coroutine is started and not finished
+    \param[in]  coro: coroutine
+    \param[out] none
+    \retval     nonzero while it is active
+*/
+int coro_active(const coro_struct *coro)
+{
+    return (0U != coro->active);
+}
+
+/*!
+    \brief      set up an event with no signal and no waiter
+    \param[in]  event: event
+    \param[out] none
+    \retval     none
+*/
+void coro_event_init(coro_event_struct *event)
+{
+    event->count = 0U;
+    event->waiters = NULL;
+}
+
+/*!
+    \brief      signal an event and run the coroutines waiting for it
+    \param[in]  event: event
+    \param[out] none
+    \retval     none
+*/
+void coro_event_signal(coro_event_struct *event)
+{
+    coro_struct *waiter;
+
+    event->count++;
+
+    /* a waiter run here may stop others or wait again on the event, so
+       the list is searched again after each for one that waits from
+       before the signal, that is one that has not seen the count */
+    do{
+        for(waiter = event->waiters; NULL != waiter; waiter = waiter->next){
+            if(waiter->seen != event->count){
+                coro_run(waiter);
+                break;
+            }
+        }
+    }while(NULL != waiter);
+}
+
+/*!
+    \brief      start the deadline of a wait
+    \param[in]  coro: running coroutine
+    \param[in]  ticks: ticks from now, CORO_FOREVER for none
+    \param[out] none
+    \retval     none
+*/
+void coro_deadline_set(coro_struct *coro, uint32_t ticks)
+{
+    coro->timed = (CORO_FOREVER != ticks) ? 1U : 0U;
+    coro->deadline = coro->wheel->now + ticks;
+}
+
+/*!
+    \brief      check the deadline of a wait
+    \param[in]  coro: running coroutine
+    \param[out] none
+    \retval     nonzero when the wait has a deadline and it has come
+*/
+int coro_deadline_passed(const coro_struct *coro)
+{
+    return (0U != coro->timed) && ((int32_t)(coro->wheel->now - coro->deadline) >= 0);
+}
+
+/*!
+    \brief      resume a coroutine at the next tick
+    \param[in]  coro: running coroutine
+    \param[out] none
+    \retval     none
+*/
+void coro_wait_tick(coro_struct *coro)
+{
+    soft_timer_start(coro->wheel, &coro->timer, 1U, 0U);
+}
+
+/*!
+    \brief      resume a coroutine at its deadline
+    \param[in]  coro: running coroutine with a deadline not passed
+    \param[out] none
+    \retval     none
+*/
+void coro_wait_deadline(coro_struct *coro)
+{
+    soft_timer_start(coro->wheel, &coro->timer, coro->deadline - coro->wheel->now, 0U);
+}
+
+/*!
+    \brief      resume a coroutine when an event is signalled, or at its deadline
+    \param[in]  coro: running coroutine
+    \param[in]  event: event it waits for
+    \param[out] none
+    \retval     none
+*/
+void coro_wait_event(coro_struct *coro, coro_event_struct *event)
+{
+    coro->event = event;
+    coro->next = event->waiters;
+    event->waiters = coro;
+    if(0U != coro->timed){
+        coro_wait_deadline(coro);
+    }
+}
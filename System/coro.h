@@ -0,0 +1,143 @@
+/*!
+    \file    coro.h
+    \brief   the header file of the stackless coroutines
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef CORO_H
+#define CORO_H
+
+#include <stdint.h>
+#include "soft_timer.h"
+
+/* returned by a coroutine that waits, anything else is its result, 0 or a negative error */
+#define CORO_WAITING                1
+/* timeout of a wait that has none */
+#define CORO_FOREVER                UINT32_MAX
+
+typedef struct coro_struct coro_struct;
+
+/* the body of a coroutine, CORO_BEGIN() to CORO_END() */
+typedef int (*coro_fn)(coro_struct *coro);
+/* called with the result when a coroutine has finished */
+typedef void (*coro_done_cb)(coro_struct *coro, int result);
+
+/* something coroutines wait for, signalled from the context they run in */
+typedef struct {
+    uint32_t count;                                     /*!< signals so far */
+    coro_struct *waiters;
+} coro_event_struct;
+
+struct coro_struct {
+    coro_fn fn;
+    void *arg;
+    coro_done_cb done;                                  /*!< NULL, or called when fn has finished */
+    soft_timer_wheel_struct *wheel;                     /*!< clock of the waits */
+    soft_timer_struct timer;                            /*!< resumes the coroutine */
+    coro_event_struct *event;                           /*!< event waited for, NULL when none */
+    coro_struct *next;                                  /*!< next waiter of the event */
+    uint32_t line;                                      /*!< resume point, 0 at the start */
+    uint32_t deadline;                                  /*!< wheel tick the running wait ends at */
+    uint32_t seen;                                      /*!< event count when the running wait started */
+    uint8_t timed;                                      /*!< the running wait has a deadline */
+    uint8_t timed_out;                                  /*!< the last wait with a timeout ended by it */
+    uint8_t active;                                     /*!< started and not finished */
+    int result;                                         /*!< CORO_WAITING until fn has finished */
+};
+
+/* a wait runs on into its own resume point */
+#if defined(__GNUC__) && (__GNUC__ >= 7)
+#define CORO_FALLTHROUGH            __attribute__((__fallthrough__))
+#else
+#define CORO_FALLTHROUGH            ((void)0)
+#endif
+
+/*
+    The body of a coroutine is a switch on its resume point, each wait
+    saves __LINE__ and returns, so only one wait fits on a source line,
+    and a local variable does not keep its value across a wait: state
+    goes in the object behind coro->arg. A coroutine may be resumed
+    before what it waits for has happened, every wait checks again.
+*/
+#define CORO_BEGIN(coro)            switch((coro)->line){ case 0U:
+#define CORO_END(coro)              } (coro)->line = 0U; return 0
+
+/* finish with a result, 0 or a negative error */
+#define CORO_EXIT(coro, result)                                                         \
+    do{ (coro)->line = 0U; return (result); }while(0)
+
+/* let the other work run, resume at the next tick */
+#define CORO_YIELD(coro)                                                                \
+    do{                                                                                 \
+        (coro)->line = __LINE__; coro_wait_tick(coro); return CORO_WAITING;             \
+        case __LINE__:;                                                                 \
+    }while(0)
+
+/* wait until cond is true, checked once per tick, a flag set by an interrupt for example */
+#define CORO_AWAIT(coro, cond)                                                          \
+    do{                                                                                 \
+        (coro)->line = __LINE__; CORO_FALLTHROUGH;                                      \
+        case __LINE__:                                                                  \
+        if(!(cond)){ coro_wait_tick(coro); return CORO_WAITING; }                       \
+    }while(0)
+
+/* wait until cond is true or ticks have passed, CORO_TIMED_OUT() tells which */
+#define CORO_AWAIT_TIMEOUT(coro, cond, ticks)                                           \
+    do{                                                                                 \
+        coro_deadline_set((coro), (ticks)); (coro)->line = __LINE__; CORO_FALLTHROUGH;  \
+        case __LINE__:                                                                  \
+        (coro)->timed_out = 0U;                                                         \
+        if(!(cond)){                                                                    \
+            if(!coro_deadline_passed(coro)){ coro_wait_tick(coro); return CORO_WAITING; } \
+            (coro)->timed_out = 1U;                                                     \
+        }                                                                               \
+    }while(0)
+
+/* wait ticks, the running tick counts as one */
+#define CORO_SLEEP(coro, ticks)                                                         \
+    do{                                                                                 \
+        coro_deadline_set((coro), (ticks)); (coro)->line = __LINE__; CORO_FALLTHROUGH;  \
+        case __LINE__:                                                                  \
+        if(!coro_deadline_passed(coro)){ coro_wait_deadline(coro); return CORO_WAITING; } \
+    }while(0)
+
+/* wait for the next signal of an event or until ticks have passed, CORO_TIMED_OUT() tells which */
+#define CORO_AWAIT_EVENT_TIMEOUT(coro, ev, ticks)                                       \
+    do{                                                                                 \
+        (coro)->seen = (ev)->count; coro_deadline_set((coro), (ticks));                 \
+        (coro)->line = __LINE__; CORO_FALLTHROUGH;                                      \
+        case __LINE__:                                                                  \
+        (coro)->timed_out = 0U;                                                         \
+        if((coro)->seen == (ev)->count){                                                \
+            if(!coro_deadline_passed(coro)){ coro_wait_event((coro), (ev)); return CORO_WAITING; } \
+            (coro)->timed_out = 1U;                                                     \
+        }                                                                               \
+    }while(0)
+
+/* wait for the next signal of an event */
+#define CORO_AWAIT_EVENT(coro, ev)  CORO_AWAIT_EVENT_TIMEOUT((coro), (ev), CORO_FOREVER)
+
+/* the last wait with a timeout ended by it */
+#define CORO_TIMED_OUT(coro)        (0U != (coro)->timed_out)
+
+/* start a coroutine on a wheel and run it up to its first wait, restarts it when it runs */
+void coro_start(coro_struct *coro, soft_timer_wheel_struct *wheel, coro_fn fn, void *arg, coro_done_cb done);
+/* stop a coroutine where it waits, done is not called */
+void coro_stop(coro_struct *coro);
+/* check whether a coroutine is started and not finished */
+int coro_active(const coro_struct *coro);
+
+/* set up an event with no signal and no waiter */
+void coro_event_init(coro_event_struct *event);
+/* signal an event and run its waiters, never from an interrupt */
+void coro_event_signal(coro_event_struct *event);
+
+/* used by the wait macros */
+void coro_deadline_set(coro_struct *coro, uint32_t ticks);
+int coro_deadline_passed(const coro_struct *coro);
+void coro_wait_tick(coro_struct *coro);
+void coro_wait_deadline(coro_struct *coro);
+void coro_wait_event(coro_struct *coro, coro_event_struct *event);
+
+#endif /* CORO_H */
@@ -0,0 +1,135 @@
+/*!
+    \file    event_loop.c
+    \brief   run-to-completion event loop
+
+    Work is split into handlers that run to the end once started. An
+    event names a handler and a word of argument and goes into the
+    queue of the handler's priority, the loop always takes from the
+    highest priority queue that is not empty. The thread running the
+    loop is the only taker, interrupt handlers, other threads and the
+    loop itself post.
+
+    Each queue is a ringbuf_mpsc_struct, so posting needs no lock and
+    never waits for the loop. The loop sees an event whose poster was
+    interrupted before it finished as not queued yet, and takes it on a
+    later pass.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "event_loop.h"
+
+_Static_assert(0U == (EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1U)), "EVENT_QUEUE_SIZE must be a power of two");
+
+event_loop_struct events;
+
+/*!
+    \brief      empty the queues and set the hooks
+    \param[in]  loop: loop
+    \param[in]  cycles: free running cycle counter for the handler accounting, NULL for none
+    \param[in]  idle: called when nothing is queued, NULL to poll
+    \param[out] none
+    \retval     none
+*/
+void event_loop_init(event_loop_struct *loop, uint32_t (*cycles)(void), void (*idle)(void))
+{
+    uint32_t p;
+
+    for(p = 0; p < EVENT_PRIORITIES; p++){
+        ringbuf_mpsc_init(&loop->queues[p], loop->seq[p], loop->cells[p], EVENT_QUEUE_SIZE, sizeof(event_struct));
+    }
+    loop->cycles = cycles;
+    loop->idle = idle;
+    loop->idles = 0;
+}
+
+/*!
+    \brief      queue an event
+    \param[in]  loop: loop
+    \param[in]  handler: handler to run
+    \param[in]  arg: passed to the handler
+    \param[out] none
+    \retval     0, -1 when the queue is full
+*/
+int event_post(event_loop_struct *loop, event_handler_struct *handler, uint32_t arg)
+{
+    event_struct event;
+
+    event.handler = handler;
+    event.arg = arg;
+    if(0 != ringbuf_mpsc_put(&loop->queues[handler->priority], &event)){
+        __atomic_add_fetch(&handler->dropped, 1U, __ATOMIC_RELAXED);
+        return -1;
+    }
+    return 0;
+}
+
+/*!
+    \brief      check whether an event is queued
+    \param[in]  loop: loop
+    \param[out] none
+    \retval     1 when the loop has an event to take, 0 otherwise
+*/
+int event_pending(event_loop_struct *loop)
+{
+    uint32_t p;
+
+    for(p = 0; p < EVENT_PRIORITIES; p++){
+        if(ringbuf_mpsc_ready(&loop->queues[p])){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+    \brief      run the first event of the highest priority queued
+    \param[in]  loop: loop
+    \param[out] none
+    \retval     1 when an event was run, 0 when there was none
+*/
+int event_run_once(event_loop_struct *loop)
+{
+    event_struct event;
+    event_handler_struct *handler;
+    uint32_t p, start, spent;
+
+    for(p = 0; p < EVENT_PRIORITIES; p++){
+        if(0 != ringbuf_mpsc_get(&loop->queues[p], &event)){
+            continue;
+        }
+
+        handler = event.handler;
+        if(NULL != loop->cycles){
+            start = loop->cycles();
+            handler->fn(event.arg);
+            spent = loop->cycles() - start;
+            handler->cycles += spent;
+            if(spent > handler->cycles_max){
+                handler->cycles_max = spent;
+            }
+        }else{
+            handler->fn(event.arg);
+        }
+        handler->runs++;
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+    \brief      run events and idle when there are none
+    \param[in]  loop: loop
+    \param[out] none
+    \retval     none
+*/
+void event_loop_run(event_loop_struct *loop)
+{
+    for(;;){
+        if(!event_run_once(loop) && (NULL != loop->idle)){
+            loop->idles++;
+            loop->idle();
+        }
+    }
+}
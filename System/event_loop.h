@@ -0,0 +1,78 @@
+/*!
+    \file    event_loop.h
+    \brief   the header file of the run-to-completion event loop
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <stdint.h>
+#include "ringbuf.h"
+
+/* run queues, 0 is served first */
+#define EVENT_PRIORITIES            4U
+/* events one queue holds, a power of two */
+#define EVENT_QUEUE_SIZE            32U
+
+/* priorities of the board */
+#define EVENT_PRIO_TIMER            0U                  /*!< timer callbacks that cannot wait for a frame */
+#define EVENT_PRIO_IO               1U                  /*!< drivers */
+#define EVENT_PRIO_GUI              2U                  /*!< frames */
+#define EVENT_PRIO_IDLE             3U                  /*!< telemetry and housekeeping */
+
+typedef void (*event_fn)(uint32_t arg);
+
+/* an event handler and what it has cost */
+typedef struct {
+    event_fn fn;
+    const char *name;
+    uint32_t priority;                                  /*!< 0 .. EVENT_PRIORITIES - 1 */
+    uint32_t runs;
+    uint64_t cycles;                                    /*!< spent in fn in total */
+    uint32_t cycles_max;                                /*!< longest run */
+    uint32_t dropped;                                   /*!< posts lost to a full queue */
+} event_handler_struct;
+
+/* static initialiser of a handler */
+#define EVENT_HANDLER(fn, priority)  { (fn), #fn, (priority), 0U, 0U, 0U, 0U }
+
+/* one queued event */
+typedef struct {
+    event_handler_struct *handler;
+    uint32_t arg;
+} event_struct;
+
+typedef struct {
+    ringbuf_mpsc_struct queues[EVENT_PRIORITIES];       /*!< any number of posters, the loop takes */
+    ringbuf_atomic_t seq[EVENT_PRIORITIES][EVENT_QUEUE_SIZE];
+    event_struct cells[EVENT_PRIORITIES][EVENT_QUEUE_SIZE];
+    uint32_t (*cycles)(void);                           /*!< free running cycle counter, NULL for no accounting */
+    void (*idle)(void);                                 /*!< NULL, or sleep until an interrupt when nothing is queued */
+    uint32_t idles;                                     /*!< calls of idle */
+} event_loop_struct;
+
+/* the loop of the board */
+extern event_loop_struct events;
+
+/* empty the queues and set the hooks */
+void event_loop_init(event_loop_struct *loop, uint32_t (*cycles)(void), void (*idle)(void));
+/* queue an event, from any context, return 0 or -1 when the queue is full */
+int event_post(event_loop_struct *loop, event_handler_struct *handler, uint32_t arg);
+/* check whether an event is queued */
+int event_pending(event_loop_struct *loop);
+/* run the first event of the highest priority queued, return 0 when there was none */
+int event_run_once(event_loop_struct *loop);
+/* run events, idle when there are none, never returns */
+void event_loop_run(event_loop_struct *loop);
+
+/* target functions, event_loop_port.c */
+/* read the DWT cycle counter */
+uint32_t event_loop_port_cycles(void);
+/* wait for an interrupt unless an event is queued */
+void event_loop_port_idle(void);
+/* print the cost of a handler over RTT */
+void event_loop_port_print(const event_handler_struct *handler);
+
+#endif /* EVENT_LOOP_H */
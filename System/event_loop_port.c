@@ -0,0 +1,59 @@
+/*!
+    \file    event_loop_port.c
+    \brief   event loop on the target
+
+    The software timers are run by the work thread, their callbacks post
+    the events. The idle hook sleeps with
+    interrupts masked around the check, an interrupt that posts between
+    the check and WFI still wakes the core since WFI returns on a
+    pending interrupt whether or not it is masked. The sleep itself is
+    idle_port_sleep(), tickless up to the next deadline.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "event_loop.h"
+#include "idle.h"
+#include "SEGGER_RTT.h"
+
+/*!
+    \brief      read the DWT cycle counter
+    \param[in]  none
+    \param[out] none
+    \retval     core cycles
+*/
+uint32_t event_loop_port_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*!
+    \brief      wait for an interrupt unless an event is queued
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void event_loop_port_idle(void)
+{
+    __disable_irq();
+    if(!event_pending(&events)){
+        idle_port_sleep();
+    }
+    __enable_irq();
+}
+
+/*!
+    \brief      print the cost of a handler over RTT
+    \param[in]  handler: handler
+    \param[out] none
+    \retval     none
+*/
+void event_loop_port_print(const event_handler_struct *handler)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    uint32_t avg = (0U != handler->runs) ? (uint32_t)(handler->cycles / handler->runs) : 0U;
+
+    SEGGER_RTT_printf(0, "evt p%u runs=%u avg=%uus max=%uus dropped=%u %s\n", handler->priority, handler->runs,
+                      avg / cycles_per_us, handler->cycles_max / cycles_per_us, handler->dropped, handler->name);
+}
@@ -0,0 +1,123 @@
+/*!
+    \file    idle.c
+    \brief   tickless idle and CPU load
+
+    When nothing can run, the port sleeps until the next deadline
+    instead of waking for every tick: the kernel knows when its first
+    sleeping thread wakes, the timer wheel when its next timer can
+    fire, and the SysTick counter bounds how far a single period
+    reaches. The sleep is the shortest of these, and waits of less than
+    IDLE_TICKLESS_MIN ticks keep the periodic tick, where stopping it
+    would cost more than it saves.
+
+    The port counts the cycles of every sleep. Time is cut in windows
+    of a fixed length, and the share of a window not slept is its load,
+    which goes into a histogram by steps of 100 / IDLE_LOAD_BINS
+    percent. A window is closed by the first sleep that ends after it,
+    a sleep across its end is split between the two, and windows
+    without any sleep count as fully loaded.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "idle.h"
+
+idle_struct cpu_idle;
+
+/*!
+    \brief      get the ticks to sleep without the tick
+    \param[in]  kernel_wait: ticks to the next thread wake-up
+    \param[in]  timer_wait: ticks to the next timer
+    \param[in]  max: longest sleep the tick counter can time
+    \param[out] none
+    \retval     ticks to sleep, 0 to keep the periodic tick
+*/
+uint32_t idle_ticks(uint32_t kernel_wait, uint32_t timer_wait, uint32_t max)
+{
+    uint32_t ticks = max;
+
+    if(kernel_wait < ticks){
+        ticks = kernel_wait;
+    }
+    if(timer_wait < ticks){
+        ticks = timer_wait;
+    }
+    return (ticks < IDLE_TICKLESS_MIN) ? 0U : ticks;
+}
+
+/*!
+    \brief      start the accounting
+    \param[in]  idle: accounting
+    \param[in]  now: counter value
+    \param[in]  window: cycles of one load window
+    \param[out] none
+    \retval     none
+*/
+void idle_init(idle_struct *idle, uint32_t now, uint32_t window)
+{
+    uint32_t i;
+
+    idle->window = window;
+    idle->window_start = now;
+    idle->idle = 0U;
+    idle->load = 0U;
+    idle->load_max = 0U;
+    idle->windows = 0U;
+    for(i = 0; i < IDLE_LOAD_BINS; i++){
+        idle->histogram[i] = 0U;
+    }
+    idle->sleeps = 0U;
+    idle->tickless = 0U;
+    idle->skipped = 0U;
+}
+
+/* close the running window with the cycles slept in it */
+static void window_close(idle_struct *idle, uint32_t slept)
+{
+    uint32_t load, bin;
+
+    if(slept > idle->window){
+        slept = idle->window;
+    }
+    load = 1000U - (uint32_t)(((uint64_t)slept * 1000U) / idle->window);
+    bin = (load * IDLE_LOAD_BINS) / 1000U;
+    if(bin >= IDLE_LOAD_BINS){
+        bin = IDLE_LOAD_BINS - 1U;
+    }
+
+    idle->load = load;
+    if(load > idle->load_max){
+        idle->load_max = load;
+    }
+    idle->histogram[bin]++;
+    idle->windows++;
+    idle->window_start += idle->window;
+    idle->idle = 0U;
+}
+
+/*!
+    \brief      count a sleep, closing the windows that ended
+    \param[in]  idle: accounting
+    \param[in]  now: counter value at the end of the sleep
+    \param[in]  slept: cycles slept, 0 to only close the windows that ended
+    \param[out] none
+    \retval     none
+*/
+void idle_account(idle_struct *idle, uint32_t now, uint32_t slept)
+{
+    uint32_t end, before;
+
+    while((uint32_t)(now - idle->window_start) >= idle->window){
+        /* the part of the sleep before the end of the window belongs to it */
+        end = idle->window_start + idle->window;
+        before = (uint32_t)(end - (now - slept));
+        if((int32_t)before < 0){
+            before = 0U;
+        }else if(before > slept){
+            before = slept;
+        }
+        slept -= before;
+        window_close(idle, idle->idle + before);
+    }
+    idle->idle += slept;
+}
@@ -0,0 +1,50 @@
+/*!
+    \file    idle.h
+    \brief   the header file of the tickless idle and the CPU load
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <stdint.h>
+
+/* shorter sleeps keep the periodic tick */
+#define IDLE_TICKLESS_MIN           2U
+/* bins of the load histogram, each 100 / IDLE_LOAD_BINS percent wide */
+#define IDLE_LOAD_BINS              10U
+
+/* idle and busy time of the core, in counter cycles */
+typedef struct {
+    uint32_t window;                                    /*!< cycles of one load window */
+    uint32_t window_start;                              /*!< counter at the start of the running window */
+    uint32_t idle;                                      /*!< cycles slept in the running window */
+    uint32_t load;                                      /*!< load of the last full window, per mille */
+    uint32_t load_max;                                  /*!< highest load of a window */
+    uint32_t windows;                                   /*!< full windows */
+    uint32_t histogram[IDLE_LOAD_BINS];                 /*!< windows by load, bin 0 the least loaded */
+    uint32_t sleeps;                                    /*!< sleeps with the tick running */
+    uint32_t tickless;                                  /*!< sleeps with the tick stopped */
+    uint32_t skipped;                                   /*!< ticks not taken thanks to them */
+} idle_struct;
+
+/* the core of the board */
+extern idle_struct cpu_idle;
+
+/* get the ticks to sleep without the tick, 0 to keep it, the waits are ticks to the next deadline */
+uint32_t idle_ticks(uint32_t kernel_wait, uint32_t timer_wait, uint32_t max);
+/* start the accounting at the counter value now with windows of window cycles */
+void idle_init(idle_struct *idle, uint32_t now, uint32_t window);
+/* count a sleep of slept cycles that ended at now, closing the windows that ended */
+void idle_account(idle_struct *idle, uint32_t now, uint32_t slept);
+
+/* target functions, idle_port.c */
+/* take the tick period and start the accounting, after systick_config() */
+void idle_port_init(void);
+/* sleep until an interrupt or the next deadline, with interrupts masked */
+void idle_port_sleep(void);
+/* print the load and its histogram over RTT */
+void idle_port_print(void);
+
+#endif /* IDLE_H */
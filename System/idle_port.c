@@ -0,0 +1,144 @@
+/*!
+    \file    idle_port.c
+    \brief   tickless idle and CPU load on the target
+
+    SysTick runs from the core clock and its 24-bit counter reaches 69
+    ticks at 240 MHz, which bounds a sleep. For a longer sleep the
+    counter is reloaded to end with the last tick of it, the core waits
+    in WFI, and on the way out the counter is read back for the ticks
+    that passed and restarted where the period in progress stands. The
+    ticks passed are handed to systick_ticks() at once, so the wheel,
+    the kernel and the work queue see them before interrupts are taken
+    again. A sleep that ran to its end leaves SysTick pending, and the
+    handler counts that last tick itself. The few cycles of the reload
+    are lost to the tick, the system clock runs on DWT CYCCNT and loses
+    nothing.
+
+    Both sleeping places, the idle thread and the idle hook of the
+    event loop, come here with interrupts masked. The cycles from
+    entry to exit are counted as idle.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "gd32f4xx_it.h"
+#include "idle.h"
+#include "kernel.h"
+#include "soft_timer.h"
+#include "SEGGER_RTT.h"
+
+/* windows of the load, per second */
+#define IDLE_PORT_WINDOWS_PER_S     10U
+/* shortest remainder of a period SysTick is restarted with, a shorter one is counted as passed */
+#define IDLE_PORT_MIN_CYCLES        64U
+
+static uint32_t tick_cycles;
+static uint32_t max_ticks;
+
+/*!
+    \brief      take the tick period and start the accounting, after systick_config()
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void idle_port_init(void)
+{
+    tick_cycles = SysTick->LOAD + 1U;
+    max_ticks = (SysTick_LOAD_RELOAD_Msk + 1U) / tick_cycles;
+    idle_init(&cpu_idle, DWT->CYCCNT, SystemCoreClock / IDLE_PORT_WINDOWS_PER_S);
+}
+
+/*!
+    \brief      sleep with SysTick timing ticks periods, then count the ticks passed
+    \param[in]  ticks: IDLE_TICKLESS_MIN .. max_ticks
+    \param[out] none
+    \retval     none
+*/
+static void sleep_tickless(uint32_t ticks)
+{
+    uint32_t ctrl, left, load, elapsed, passed;
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    /* the period in progress ends in left cycles, ticks - 1 more follow */
+    left = SysTick->VAL;
+    load = left + (ticks - 1U) * tick_cycles;
+    SysTick->LOAD = load - 1U;
+    SysTick->VAL = 0U;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+
+    /* reading CTRL clears COUNTFLAG, a wrap before the stop shows in one of the reads */
+    ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+    ctrl |= SysTick->CTRL;
+    if(0U != (ctrl & SysTick_CTRL_COUNTFLAG_Msk)){
+        /* ran to the end, the pending SysTick takes the last tick */
+        passed = ticks - 1U;
+        elapsed = (load - 1U) - SysTick->VAL;
+    }else{
+        elapsed = (tick_cycles - left) + ((load - 1U) - SysTick->VAL);
+        passed = elapsed / tick_cycles;
+        elapsed %= tick_cycles;
+    }
+    if(elapsed >= tick_cycles - IDLE_PORT_MIN_CYCLES){
+        elapsed = 0U;
+        passed++;
+    }
+
+    /* finish the period in progress, later ones are full again */
+    SysTick->LOAD = tick_cycles - elapsed - 1U;
+    SysTick->VAL = 0U;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = tick_cycles - 1U;
+
+    if(0U != passed){
+        systick_ticks(passed);
+    }
+    cpu_idle.tickless++;
+    cpu_idle.skipped += passed;
+}
+
+/*!
+    \brief      sleep until an interrupt or the next deadline, with interrupts masked
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void idle_port_sleep(void)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t ticks = idle_ticks(kernel_idle_ticks(), soft_timer_next(&soft_timers), max_ticks);
+
+    if(0U != ticks){
+        sleep_tickless(ticks);
+    }else{
+        __DSB();
+        __WFI();
+        cpu_idle.sleeps++;
+    }
+    idle_account(&cpu_idle, DWT->CYCCNT, DWT->CYCCNT - start);
+}
+
+/*!
+    \brief      print the load and its histogram over RTT
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void idle_port_print(void)
+{
+    const uint32_t *h = cpu_idle.histogram;
+
+    __disable_irq();
+    idle_account(&cpu_idle, DWT->CYCCNT, 0U);
+    __enable_irq();
+
+    SEGGER_RTT_printf(0, "cpu load %u.%u%% max %u.%u%% sleeps=%u tickless=%u skipped=%u\n",
+                      cpu_idle.load / 10U, cpu_idle.load % 10U, cpu_idle.load_max / 10U, cpu_idle.load_max % 10U,
+                      cpu_idle.sleeps, cpu_idle.tickless, cpu_idle.skipped);
+    SEGGER_RTT_printf(0, "cpu load by 10%%: %u %u %u %u %u %u %u %u %u %u\n",
+                      h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7], h[8], h[9]);
+}
@@ -0,0 +1,749 @@
+/*!
+    \file    kernel.c
+    \brief   preemptive priority kernel
+
+    The highest priority ready thread runs. The ready list is sorted by
+    priority and first come first within a priority, so the running
+    thread is the first of its priority and its head is the thread to
+    run. Threads of the same priority take turns every
+    KERNEL_SLICE_TICKS ticks or when one yields.
+
+    Every kernel call does its work under the port lock and, when the
+    head of the ready list is no longer the running thread, sets
+    kernel.next and asks the port for a switch. The port switches when
+    the lock is released, on the target that is the PendSV exception, so
+    a call from an interrupt switches when the interrupt returns.
+
+    A thread waiting on a mutex, semaphore or queue sits in the wait
+    list of the object, again by priority, and in the delay list when it
+    gave a timeout. A mutex owner runs at the priority of the highest
+    thread waiting for any mutex it holds, passed on along a chain of
+    owners that wait themselves, and drops back when it unlocks or the
+    waiter gives up. Messages are copied straight between a waiting
+    thread and the caller when there is one.
+
+    The lists are walked, which is fine for the handful of threads of
+    the firmware.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "kernel.h"
+
+/* longest timeout the delay list can order */
+#define TIMEOUT_MAX                 0x7FFFFFFFUL
+
+/* the port reaches these by offset */
+_Static_assert(0U == offsetof(kernel_thread_struct, sp), "sp must be first in kernel_thread_struct");
+_Static_assert(0U == offsetof(kernel_struct, current), "current must be first in kernel_struct");
+_Static_assert(sizeof(void *) == offsetof(kernel_struct, next), "next must follow current in kernel_struct");
+_Static_assert(2U * sizeof(void *) == offsetof(kernel_struct, started), "started must follow next in kernel_struct");
+_Static_assert(offsetof(kernel_struct, started) + sizeof(void *) == offsetof(kernel_struct, ready),
+               "ready must follow started in kernel_struct");
+
+kernel_struct kernel;
+
+static kernel_thread_struct idle_thread;
+static uint32_t idle_stack[KERNEL_IDLE_STACK_SIZE / sizeof(uint32_t)];
+
+/* insert a thread behind the threads of higher or the same priority */
+static void list_insert(kernel_list_struct *list, kernel_thread_struct *thread)
+{
+    kernel_thread_struct **link = &list->head;
+
+    while((NULL != *link) && ((*link)->priority <= thread->priority)){
+        link = &(*link)->next;
+    }
+    thread->next = *link;
+    *link = thread;
+}
+
+/* take a thread out of a list */
+static void list_remove(kernel_list_struct *list, kernel_thread_struct *thread)
+{
+    kernel_thread_struct **link = &list->head;
+
+    while((NULL != *link) && (*link != thread)){
+        link = &(*link)->next;
+    }
+    if(NULL != *link){
+        *link = thread->next;
+    }
+    thread->next = NULL;
+}
+
+/* put a thread in the delay list, due ticks from now */
+static void delay_insert(kernel_thread_struct *thread, uint32_t ticks)
+{
+    kernel_thread_struct **link = &kernel.delays;
+
+    if(ticks > TIMEOUT_MAX){
+        ticks = TIMEOUT_MAX;
+    }
+    thread->wake = kernel.ticks + ticks;
+    while((NULL != *link) && ((int32_t)((*link)->wake - thread->wake) <= 0)){
+        link = &(*link)->delay_next;
+    }
+    thread->delay_next = *link;
+    *link = thread;
+    thread->delayed = 1U;
+}
+
+/* take a thread out of the delay list */
+static void delay_remove(kernel_thread_struct *thread)
+{
+    kernel_thread_struct **link = &kernel.delays;
+
+    while((NULL != *link) && (*link != thread)){
+        link = &(*link)->delay_next;
+    }
+    if(NULL != *link){
+        *link = thread->delay_next;
+    }
+    thread->delay_next = NULL;
+    thread->delayed = 0U;
+}
+
+/*!
+    \brief      ask the port for a switch when the head of the ready list is not running
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void schedule(void)
+{
+    kernel_thread_struct *next = kernel.ready.head;
+
+    if(!kernel.started){
+        return;
+    }
+    kernel.next = next;
+    if(next != kernel.current){
+        kernel.switches++;
+        kernel_port_switch();
+    }
+}
+
+/*!
+    \brief      take the running thread off the ready list to wait
+    \param[in]  list: wait list of the object, NULL for a plain delay
+    \param[in]  timeout: ticks, or KERNEL_WAIT_FOREVER
+    \param[out] none
+    \retval     none
+*/
+static void block(kernel_list_struct *list, uint32_t timeout)
+{
+    kernel_thread_struct *self = kernel.current;
+
+    list_remove(&kernel.ready, self);
+    self->state = KERNEL_THREAD_BLOCKED;
+    self->wait_result = KERNEL_TIMEOUT;
+    self->wait_list = list;
+    if(NULL != list){
+        list_insert(list, self);
+    }
+    if(KERNEL_WAIT_FOREVER != timeout){
+        delay_insert(self, timeout);
+    }
+}
+
+/*!
+    \brief      make a blocked thread ready
+    \param[in]  thread: blocked thread
+    \param[in]  result: returned by the call it waits in
+    \param[out] none
+    \retval     none
+*/
+static void wake(kernel_thread_struct *thread, int result)
+{
+    if(thread->delayed){
+        delay_remove(thread);
+    }
+    if(NULL != thread->wait_list){
+        list_remove(thread->wait_list, thread);
+        thread->wait_list = NULL;
+    }
+    thread->wait_mutex = NULL;
+    thread->wait_result = result;
+    thread->state = KERNEL_THREAD_READY;
+    list_insert(&kernel.ready, thread);
+}
+
+/*!
+    \brief      set a thread to the priority its mutexes ask for and pass the change on
+    \param[in]  thread: thread, NULL for none
+    \param[out] none
+    \retval     none
+*/
+static void priority_update(kernel_thread_struct *thread)
+{
+    kernel_mutex_struct *mutex;
+    kernel_thread_struct *waiter;
+    uint32_t priority;
+
+    while(NULL != thread){
+        priority = thread->base_priority;
+        for(mutex = thread->held; NULL != mutex; mutex = mutex->next_held){
+            waiter = mutex->waiters.head;
+            if((NULL != waiter) && (waiter->priority < priority)){
+                priority = waiter->priority;
+            }
+        }
+        if(priority == thread->priority){
+            return;
+        }
+
+        /* the lists are sorted, move the thread to its new place */
+        if(KERNEL_THREAD_READY == thread->state){
+            list_remove(&kernel.ready, thread);
+            thread->priority = (uint8_t)priority;
+            list_insert(&kernel.ready, thread);
+        }else if(NULL != thread->wait_list){
+            list_remove(thread->wait_list, thread);
+            thread->priority = (uint8_t)priority;
+            list_insert(thread->wait_list, thread);
+        }else{
+            thread->priority = (uint8_t)priority;
+        }
+
+        /* an owner waiting for another mutex lends its priority on */
+        thread = (NULL != thread->wait_mutex) ? thread->wait_mutex->owner : NULL;
+    }
+}
+
+/*!
+    \brief      run the idle thread, lowest of all
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     none
+*/
+static void idle_entry(void *arg)
+{
+    (void)arg;
+    for(;;){
+        kernel_port_idle();
+    }
+}
+
+/*!
+    \brief      set up a thread and make it ready
+    \param[in]  thread: thread
+    \param[in]  name: name, no spaces
+    \param[in]  entry: function the thread runs
+    \param[in]  arg: passed to entry
+    \param[in]  priority: 0 is the highest
+    \param[in]  stack: lowest word of the stack
+    \param[in]  stack_size: bytes
+    \param[out] none
+    \retval     none
+*/
+static void thread_setup(kernel_thread_struct *thread, const char *name, void (*entry)(void *arg), void *arg,
+                         uint32_t priority, uint32_t *stack, uint32_t stack_size)
+{
+    uint32_t key;
+
+    memset(thread, 0, sizeof(*thread));
+    thread->name = name;
+    thread->entry = entry;
+    thread->arg = arg;
+    thread->stack = stack;
+    thread->stack_size = stack_size;
+    thread->priority = (uint8_t)priority;
+    thread->base_priority = (uint8_t)priority;
+    thread->state = KERNEL_THREAD_READY;
+    thread->slice = KERNEL_SLICE_TICKS;
+    kernel_port_thread_init(thread);
+
+    key = kernel_port_lock();
+    list_insert(&kernel.ready, thread);
+    schedule();
+    kernel_port_unlock(key);
+}
+
+/*!
+    \brief      set up the kernel and its idle thread
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_init(void)
+{
+    memset(&kernel, 0, sizeof(kernel));
+    thread_setup(&idle_thread, "idle", idle_entry, NULL, KERNEL_PRIORITIES, idle_stack, sizeof(idle_stack));
+}
+
+/*!
+    \brief      create a thread, it is ready at once
+    \param[in]  thread: thread, owned by the kernel until it is done
+    \param[in]  name: name, no spaces
+    \param[in]  entry: function the thread runs
+    \param[in]  arg: passed to entry
+    \param[in]  priority: 0 is the highest, below KERNEL_PRIORITIES
+    \param[in]  stack: lowest word of the stack
+    \param[in]  stack_size: bytes
+    \param[out] none
+    \retval     KERNEL_OK, KERNEL_ERROR for a bad priority or stack
+*/
+int kernel_thread_create(kernel_thread_struct *thread, const char *name, void (*entry)(void *arg), void *arg,
+                         uint32_t priority, uint32_t *stack, uint32_t stack_size)
+{
+    if((priority >= KERNEL_PRIORITIES) || (NULL == stack) || (0U == stack_size) || (NULL == entry)){
+        return KERNEL_ERROR;
+    }
+    thread_setup(thread, name, entry, arg, priority, stack, stack_size);
+    return KERNEL_OK;
+}
+
+/*!
+    \brief      end the running thread, mutexes it still owns stay locked
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_thread_exit(void)
+{
+    uint32_t key = kernel_port_lock();
+
+    list_remove(&kernel.ready, kernel.current);
+    kernel.current->state = KERNEL_THREAD_DONE;
+    schedule();
+    kernel_port_unlock(key);
+    for(;;){
+    }
+}
+
+/*!
+    \brief      run the threads
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_start(void)
+{
+    /* the port picks the first thread and sets started as it enters it,
+       until then a tick or a give from an interrupt only changes the lists
+       and cannot ask for a switch away from a thread that is not running */
+    kernel_port_start();
+}
+
+/*!
+    \brief      count a tick, wake the threads due and slice the time
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_tick(void)
+{
+    kernel_thread_struct *thread;
+    kernel_mutex_struct *mutex;
+    uint32_t key = kernel_port_lock();
+
+    kernel.ticks++;
+    if(!kernel.started){
+        kernel_port_unlock(key);
+        return;
+    }
+
+    while((NULL != kernel.delays) && ((int32_t)(kernel.ticks - kernel.delays->wake) >= 0)){
+        thread = kernel.delays;
+        mutex = thread->wait_mutex;
+        wake(thread, KERNEL_TIMEOUT);
+        if(NULL != mutex){
+            /* the owner no longer owes this waiter its priority */
+            priority_update(mutex->owner);
+        }
+    }
+
+    thread = kernel.current;
+    if((KERNEL_THREAD_READY == thread->state) && (NULL != thread->next) &&
+       (thread->next->priority == thread->priority) && (0U == --thread->slice)){
+        thread->slice = KERNEL_SLICE_TICKS;
+        list_remove(&kernel.ready, thread);
+        list_insert(&kernel.ready, thread);
+    }
+    schedule();
+    kernel_port_unlock(key);
+}
+
+/*!
+    \brief      get the ticks counted
+    \param[in]  none
+    \param[out] none
+    \retval     ticks since kernel_init()
+*/
+uint32_t kernel_ticks_get(void)
+{
+    return kernel.ticks;
+}
+
+/*!
+    \brief      get the ticks the kernel can go without a tick
+    \param[in]  none
+    \param[out] none
+    \retval     ticks to the next wake-up, 1 while the time is sliced, KERNEL_WAIT_FOREVER for no limit
+*/
+uint32_t kernel_idle_ticks(void)
+{
+    kernel_thread_struct *thread;
+    uint32_t ticks = KERNEL_WAIT_FOREVER;
+    uint32_t key = kernel_port_lock();
+
+    if(!kernel.started){
+        kernel_port_unlock(key);
+        return ticks;
+    }
+    thread = kernel.current;
+    if((KERNEL_THREAD_READY == thread->state) && (NULL != thread->next) &&
+       (thread->next->priority == thread->priority)){
+        ticks = 1U;
+    }else if(NULL != kernel.delays){
+        ticks = ((int32_t)(kernel.delays->wake - kernel.ticks) > 0) ? kernel.delays->wake - kernel.ticks : 0U;
+    }
+    kernel_port_unlock(key);
+    return ticks;
+}
+
+/*!
+    \brief      give the core to the next ready thread of the same priority
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_yield(void)
+{
+    kernel_thread_struct *self = kernel.current;
+    uint32_t key = kernel_port_lock();
+
+    self->slice = KERNEL_SLICE_TICKS;
+    list_remove(&kernel.ready, self);
+    list_insert(&kernel.ready, self);
+    schedule();
+    kernel_port_unlock(key);
+}
+
+/*!
+    \brief      block the running thread for a number of ticks
+    \param[in]  ticks: ticks to wait, 0 yields
+    \param[out] none
+    \retval     none
+*/
+void kernel_sleep(uint32_t ticks)
+{
+    uint32_t key;
+
+    if(0U == ticks){
+        kernel_yield();
+        return;
+    }
+    key = kernel_port_lock();
+    block(NULL, ticks);
+    schedule();
+    kernel_port_unlock(key);
+}
+
+/* the helper of kernel_switch_bench(), yields back while the measurement runs */
+static volatile uint32_t bench_running;
+
+static void bench_entry(void *arg)
+{
+    (void)arg;
+    while(bench_running){
+        kernel_yield();
+    }
+}
+
+/*!
+    \brief      measure a context switch against a helper thread
+    \param[in]  helper: thread to use as the other side, not in use
+    \param[in]  stack: stack of the helper
+    \param[in]  stack_size: bytes
+    \param[in]  rounds: yields each way
+    \param[in]  clock: free running counter, in the units of the result
+    \param[out] none
+    \retval     counter units from a yield to the other thread running, 0 when the helper cannot start
+*/
+uint32_t kernel_switch_bench(kernel_thread_struct *helper, uint32_t *stack, uint32_t stack_size, uint32_t rounds,
+                             uint32_t (*clock)(void))
+{
+    uint32_t i, start, spent;
+
+    /* the helper shares the priority, so a yield always goes to it and back */
+    bench_running = 1U;
+    if((0U == rounds) ||
+       (KERNEL_OK != kernel_thread_create(helper, "bench", bench_entry, NULL, kernel.current->priority,
+                                          stack, stack_size))){
+        return 0U;
+    }
+    kernel_yield();
+
+    start = clock();
+    for(i = 0; i < rounds; i++){
+        kernel_yield();
+    }
+    spent = clock() - start;
+
+    bench_running = 0U;
+    kernel_yield();
+    return spent / (2U * rounds);
+}
+
+/*!
+    \brief      set up an unlocked mutex
+    \param[in]  mutex: mutex
+    \param[out] none
+    \retval     none
+*/
+void kernel_mutex_init(kernel_mutex_struct *mutex)
+{
+    mutex->owner = NULL;
+    mutex->waiters.head = NULL;
+    mutex->next_held = NULL;
+}
+
+/*!
+    \brief      lock a mutex, from a thread
+    \param[in]  mutex: mutex
+    \param[in]  timeout: ticks to wait, KERNEL_NO_WAIT or KERNEL_WAIT_FOREVER
+    \param[out] none
+    \retval     KERNEL_OK, KERNEL_TIMEOUT, KERNEL_ERROR when the thread owns it already
+*/
+int kernel_mutex_lock(kernel_mutex_struct *mutex, uint32_t timeout)
+{
+    kernel_thread_struct *self = kernel.current;
+    uint32_t key = kernel_port_lock();
+
+    if(NULL == mutex->owner){
+        mutex->owner = self;
+        mutex->next_held = self->held;
+        self->held = mutex;
+        kernel_port_unlock(key);
+        return KERNEL_OK;
+    }
+    if((mutex->owner == self) || (KERNEL_NO_WAIT == timeout)){
+        kernel_port_unlock(key);
+        return (mutex->owner == self) ? KERNEL_ERROR : KERNEL_TIMEOUT;
+    }
+
+    block(&mutex->waiters, timeout);
+    self->wait_mutex = mutex;
+    priority_update(mutex->owner);
+    schedule();
+    kernel_port_unlock(key);
+    return self->wait_result;
+}
+
+/*!
+    \brief      unlock a mutex and hand it to the highest waiter
+    \param[in]  mutex: mutex
+    \param[out] none
+    \retval     KERNEL_OK, KERNEL_ERROR when the running thread is not the owner
+*/
+int kernel_mutex_unlock(kernel_mutex_struct *mutex)
+{
+    kernel_thread_struct *self = kernel.current;
+    kernel_thread_struct *waiter;
+    kernel_mutex_struct **link;
+    uint32_t key = kernel_port_lock();
+
+    if(mutex->owner != self){
+        kernel_port_unlock(key);
+        return KERNEL_ERROR;
+    }
+    for(link = &self->held; (NULL != *link) && (*link != mutex); link = &(*link)->next_held){
+    }
+    if(NULL != *link){
+        *link = mutex->next_held;
+    }
+    mutex->next_held = NULL;
+
+    waiter = mutex->waiters.head;
+    mutex->owner = waiter;
+    if(NULL != waiter){
+        mutex->next_held = waiter->held;
+        waiter->held = mutex;
+        wake(waiter, KERNEL_OK);
+        priority_update(waiter);
+    }
+    priority_update(self);
+    schedule();
+    kernel_port_unlock(key);
+    return KERNEL_OK;
+}
+
+/*!
+    \brief      set up a semaphore
+    \param[in]  sem: semaphore
+    \param[in]  count: initial count
+    \param[in]  max: highest count, 1 for a binary semaphore
+    \param[out] none
+    \retval     none
+*/
+void kernel_sem_init(kernel_sem_struct *sem, uint32_t count, uint32_t max)
+{
+    sem->count = (count < max) ? count : max;
+    sem->max = max;
+    sem->waiters.head = NULL;
+}
+
+/*!
+    \brief      take a semaphore
+    \param[in]  sem: semaphore
+    \param[in]  timeout: ticks to wait, KERNEL_NO_WAIT from an interrupt
+    \param[out] none
+    \retval     KERNEL_OK, KERNEL_TIMEOUT
+*/
+int kernel_sem_take(kernel_sem_struct *sem, uint32_t timeout)
+{
+    kernel_thread_struct *self = kernel.current;
+    uint32_t key = kernel_port_lock();
+
+    if(0U != sem->count){
+        sem->count--;
+        kernel_port_unlock(key);
+        return KERNEL_OK;
+    }
+    if(KERNEL_NO_WAIT == timeout){
+        kernel_port_unlock(key);
+        return KERNEL_TIMEOUT;
+    }
+
+    block(&sem->waiters, timeout);
+    schedule();
+    kernel_port_unlock(key);
+    return self->wait_result;
+}
+
+/*!
+    \brief      give a semaphore, to the highest waiter if there is one
+    \param[in]  sem: semaphore
+    \param[out] none
+    \retval     KERNEL_OK, KERNEL_ERROR when the count is at max
+*/
+int kernel_sem_give(kernel_sem_struct *sem)
+{
+    int result = KERNEL_OK;
+    uint32_t key = kernel_port_lock();
+
+    if(NULL != sem->waiters.head){
+        wake(sem->waiters.head, KERNEL_OK);
+        schedule();
+    }else if(sem->count < sem->max){
+        sem->count++;
+    }else{
+        result = KERNEL_ERROR;
+    }
+    kernel_port_unlock(key);
+    return result;
+}
+
+/*!
+    \brief      set up an empty queue
+    \param[in]  queue: queue
+    \param[in]  buffer: size * capacity bytes
+    \param[in]  size: bytes of a message
+    \param[in]  capacity: messages the buffer holds, at least 1
+    \param[out] none
+    \retval     none
+*/
+void kernel_queue_init(kernel_queue_struct *queue, void *buffer, uint32_t size, uint32_t capacity)
+{
+    queue->buffer = (uint8_t *)buffer;
+    queue->size = size;
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->used = 0;
+    queue->senders.head = NULL;
+    queue->receivers.head = NULL;
+}
+
+/* address of the message index places after the head */
+static uint8_t *queue_slot(const kernel_queue_struct *queue, uint32_t index)
+{
+    return &queue->buffer[((queue->head + index) % queue->capacity) * queue->size];
+}
+
+/*!
+    \brief      send a message
+    \param[in]  queue: queue
+    \param[in]  message: size bytes, copied
+    \param[in]  timeout: ticks to wait while the queue is full, KERNEL_NO_WAIT from an interrupt
+    \param[out] none
+    \retval     KERNEL_OK, KERNEL_TIMEOUT
+*/
+int kernel_queue_send(kernel_queue_struct *queue, const void *message, uint32_t timeout)
+{
+    kernel_thread_struct *self = kernel.current;
+    kernel_thread_struct *receiver;
+    uint32_t key = kernel_port_lock();
+
+    receiver = queue->receivers.head;
+    if(NULL != receiver){
+        /* the queue is empty, the message goes straight to the receiver */
+        memcpy(receiver->wait_data, message, queue->size);
+        wake(receiver, KERNEL_OK);
+        schedule();
+        kernel_port_unlock(key);
+        return KERNEL_OK;
+    }
+    if(queue->used < queue->capacity){
+        memcpy(queue_slot(queue, queue->used), message, queue->size);
+        queue->used++;
+        kernel_port_unlock(key);
+        return KERNEL_OK;
+    }
+    if(KERNEL_NO_WAIT == timeout){
+        kernel_port_unlock(key);
+        return KERNEL_TIMEOUT;
+    }
+
+    /* the receiver that makes room copies the message in */
+    self->wait_data = (void *)message;
+    block(&queue->senders, timeout);
+    schedule();
+    kernel_port_unlock(key);
+    return self->wait_result;
+}
+
+/*!
+    \brief      receive a message
+    \param[in]  queue: queue
+    \param[in]  timeout: ticks to wait while the queue is empty, KERNEL_NO_WAIT from an interrupt
+    \param[out] message: size bytes
+    \retval     KERNEL_OK, KERNEL_TIMEOUT
+*/
+int kernel_queue_receive(kernel_queue_struct *queue, void *message, uint32_t timeout)
+{
+    kernel_thread_struct *self = kernel.current;
+    kernel_thread_struct *sender;
+    uint32_t key = kernel_port_lock();
+
+    if(0U != queue->used){
+        memcpy(message, queue_slot(queue, 0U), queue->size);
+        queue->head = (queue->head + 1U) % queue->capacity;
+        queue->used--;
+
+        /* the queue was full, take the message of the first sender waiting */
+        sender = queue->senders.head;
+        if(NULL != sender){
+            memcpy(queue_slot(queue, queue->used), sender->wait_data, queue->size);
+            queue->used++;
+            wake(sender, KERNEL_OK);
+            schedule();
+        }
+        kernel_port_unlock(key);
+        return KERNEL_OK;
+    }
+    if(KERNEL_NO_WAIT == timeout){
+        kernel_port_unlock(key);
+        return KERNEL_TIMEOUT;
+    }
+
+    /* the sender that finds this thread waiting copies the message out */
+    self->wait_data = message;
+    block(&queue->receivers, timeout);
+    schedule();
+    kernel_port_unlock(key);
+    return self->wait_result;
+}
@@ -0,0 +1,163 @@
+/*!
+    \file    kernel.h
+    \brief   the header file of the preemptive kernel
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <stdint.h>
+
+/* thread priorities, 0 is the highest, the idle thread runs below KERNEL_PRIORITIES - 1 */
+#define KERNEL_PRIORITIES           8U
+/* ticks a thread runs before the next thread of its priority gets the core */
+#define KERNEL_SLICE_TICKS          10U
+/* bytes of the idle thread stack */
+#ifndef KERNEL_IDLE_STACK_SIZE
+#define KERNEL_IDLE_STACK_SIZE      384U
+#endif
+
+/* timeouts in ticks */
+#define KERNEL_NO_WAIT              0U
+#define KERNEL_WAIT_FOREVER         0xFFFFFFFFUL
+
+/* results of the waiting calls */
+#define KERNEL_OK                   0
+#define KERNEL_TIMEOUT              (-1)                /*!< not available in time, or at once with KERNEL_NO_WAIT */
+#define KERNEL_ERROR                (-2)                /*!< bad argument or not the owner */
+
+typedef struct kernel_thread_struct kernel_thread_struct;
+typedef struct kernel_mutex_struct kernel_mutex_struct;
+
+/* threads ordered by priority, first come first within a priority */
+typedef struct {
+    kernel_thread_struct *head;
+} kernel_list_struct;
+
+/* state of a thread */
+typedef enum {
+    KERNEL_THREAD_READY = 0,                            /*!< running or waiting for the core */
+    KERNEL_THREAD_BLOCKED,                              /*!< waiting for an object or a delay */
+    KERNEL_THREAD_DONE                                  /*!< entry returned */
+} kernel_thread_state_enum;
+
+struct kernel_thread_struct {
+    void *sp;                                           /*!< saved context, first for the port */
+    const char *name;
+    void (*entry)(void *arg);
+    void *arg;
+    uint32_t *stack;                                    /*!< lowest word */
+    uint32_t stack_size;                                /*!< bytes */
+    uint8_t priority;                                   /*!< current, raised by the mutexes it holds */
+    uint8_t base_priority;                              /*!< given at creation */
+    uint8_t state;                                      /*!< kernel_thread_state_enum */
+    uint8_t slice;                                      /*!< ticks left of the time slice */
+    kernel_thread_struct *next;                         /*!< in the ready list or a wait list */
+    kernel_list_struct *wait_list;                      /*!< list it is blocked on, NULL otherwise */
+    kernel_mutex_struct *wait_mutex;                    /*!< mutex it is blocked on, NULL otherwise */
+    void *wait_data;                                    /*!< message to send or buffer to receive into */
+    int wait_result;                                    /*!< KERNEL_OK or KERNEL_TIMEOUT when woken */
+    uint32_t wake;                                      /*!< tick the delay ends at */
+    kernel_thread_struct *delay_next;                   /*!< in the delay list */
+    uint8_t delayed;                                    /*!< in the delay list */
+    kernel_mutex_struct *held;                          /*!< mutexes it owns */
+};
+
+/* mutex, the owner runs at least at the priority of its highest waiter */
+struct kernel_mutex_struct {
+    kernel_thread_struct *owner;
+    kernel_list_struct waiters;
+    kernel_mutex_struct *next_held;                     /*!< next mutex of the owner */
+};
+
+/* counting semaphore */
+typedef struct {
+    uint32_t count;
+    uint32_t max;
+    kernel_list_struct waiters;
+} kernel_sem_struct;
+
+/* queue of fixed size messages, copied in and out */
+typedef struct {
+    uint8_t *buffer;                                    /*!< size * capacity bytes */
+    uint32_t size;                                      /*!< bytes of a message */
+    uint32_t capacity;                                  /*!< messages the buffer holds */
+    uint32_t head;                                      /*!< next message to receive */
+    uint32_t used;
+    kernel_list_struct senders;                         /*!< waiting while the queue is full */
+    kernel_list_struct receivers;                       /*!< waiting while the queue is empty */
+} kernel_queue_struct;
+
+typedef struct {
+    kernel_thread_struct *current;                      /*!< running thread, first for the port */
+    kernel_thread_struct *next;                         /*!< thread the port switches to */
+    int started;                                        /*!< set by the port as it enters the first thread */
+    kernel_list_struct ready;
+    kernel_thread_struct *delays;                       /*!< blocked threads with a timeout, by wake tick */
+    volatile uint32_t ticks;
+    uint32_t switches;                                  /*!< context switches requested */
+} kernel_struct;
+
+extern kernel_struct kernel;
+
+/* set up the kernel and its idle thread, before any other call */
+void kernel_init(void);
+/* create a thread, it is ready at once, return KERNEL_OK or KERNEL_ERROR */
+int kernel_thread_create(kernel_thread_struct *thread, const char *name, void (*entry)(void *arg), void *arg,
+                         uint32_t priority, uint32_t *stack, uint32_t stack_size);
+/* end the running thread, also reached when its entry returns */
+void kernel_thread_exit(void);
+/* run the threads, never returns */
+void kernel_start(void);
+/* count a tick, wake the threads due and slice the time, from the tick interrupt */
+void kernel_tick(void);
+/* get the ticks counted */
+uint32_t kernel_ticks_get(void);
+/* get the ticks the kernel can go without a tick, for a tickless idle */
+uint32_t kernel_idle_ticks(void);
+/* give the core to the next ready thread of the same priority */
+void kernel_yield(void);
+/* block the running thread for a number of ticks */
+void kernel_sleep(uint32_t ticks);
+/* measure a context switch against a helper thread, return clock units per switch */
+uint32_t kernel_switch_bench(kernel_thread_struct *helper, uint32_t *stack, uint32_t stack_size, uint32_t rounds,
+                             uint32_t (*clock)(void));
+
+/* set up an unlocked mutex */
+void kernel_mutex_init(kernel_mutex_struct *mutex);
+/* lock a mutex, from a thread, return KERNEL_OK, KERNEL_TIMEOUT or KERNEL_ERROR when already owned */
+int kernel_mutex_lock(kernel_mutex_struct *mutex, uint32_t timeout);
+/* unlock a mutex, return KERNEL_OK or KERNEL_ERROR when not the owner */
+int kernel_mutex_unlock(kernel_mutex_struct *mutex);
+
+/* set up a semaphore */
+void kernel_sem_init(kernel_sem_struct *sem, uint32_t count, uint32_t max);
+/* take a semaphore, from a thread or with KERNEL_NO_WAIT from an interrupt, return KERNEL_OK or KERNEL_TIMEOUT */
+int kernel_sem_take(kernel_sem_struct *sem, uint32_t timeout);
+/* give a semaphore, from anywhere, return KERNEL_OK or KERNEL_ERROR when it is at max */
+int kernel_sem_give(kernel_sem_struct *sem);
+
+/* set up an empty queue over a buffer of size * capacity bytes */
+void kernel_queue_init(kernel_queue_struct *queue, void *buffer, uint32_t size, uint32_t capacity);
+/* send a message, from a thread or with KERNEL_NO_WAIT from an interrupt, return KERNEL_OK or KERNEL_TIMEOUT */
+int kernel_queue_send(kernel_queue_struct *queue, const void *message, uint32_t timeout);
+/* receive a message, from a thread or with KERNEL_NO_WAIT from an interrupt, return KERNEL_OK or KERNEL_TIMEOUT */
+int kernel_queue_receive(kernel_queue_struct *queue, void *message, uint32_t timeout);
+
+/* port functions, kernel_port.c on the target, host/kernel_port_host.c on the host */
+/* mask the kernel interrupts, return what unlock needs to restore */
+uint32_t kernel_port_lock(void);
+/* restore the mask, a switch requested meanwhile happens here */
+void kernel_port_unlock(uint32_t key);
+/* prepare the stack of a new thread to start at its entry, set thread->sp */
+void kernel_port_thread_init(kernel_thread_struct *thread);
+/* request a switch to kernel.next once the lock is released */
+void kernel_port_switch(void);
+/* enter the first ready thread, setting kernel.current, kernel.next and kernel.started as it does, never returns */
+void kernel_port_start(void);
+/* wait for an interrupt, from the idle thread */
+void kernel_port_idle(void);
+
+#endif /* KERNEL_H */
@@ -0,0 +1,199 @@
+/*!
+    \file    kernel_port.c
+    \brief   kernel on the Cortex-M4F
+
+    Threads run in thread mode on the process stack, interrupts keep the
+    main stack. The lock is PRIMASK. A switch is requested by pending
+    PendSV, which has the lowest priority, so it is taken once the lock
+    is released and every interrupt has returned.
+
+    PendSV pushes r4-r11 and the EXC_RETURN of the thread below the frame
+    the hardware stacked. A thread that has used the FPU has an extended
+    frame, bit 4 of EXC_RETURN clear, and only then are s16-s31 saved as
+    well. The reset value of FPCCR has lazy stacking on, so the hardware
+    reserves room for s0-s15 and FPSCR but only writes them when the
+    handler touches the FPU, which the vstmdb of s16-s31 does. Threads
+    that never use the FPU pay nothing for it.
+
+    SVC 0 starts the first thread from the frame kernel_port_thread_init()
+    built, and gives the main stack back to the interrupts. It picks the
+    head of the ready list and sets kernel.started as it does, with
+    nothing above it to interrupt it, so PendSV is never pended while
+    the process stack is not set up yet and a thread an interrupt made
+    ready before is not passed over.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "kernel.h"
+#include "mem_stat.h"
+#include "idle.h"
+
+/* EXC_RETURN to thread mode on the process stack without FPU state */
+#define PORT_EXC_RETURN             0xFFFFFFFDUL
+/* xPSR of a new thread, Thumb state */
+#define PORT_XPSR                   0x01000000UL
+/* words of the first frame, r4-r11 and EXC_RETURN then r0-r3, r12, lr, pc and xPSR */
+#define PORT_FRAME_WORDS            17U
+
+/*!
+    \brief      mask the interrupts
+    \param[in]  none
+    \param[out] none
+    \retval     PRIMASK before
+*/
+uint32_t kernel_port_lock(void)
+{
+    uint32_t key = __get_PRIMASK();
+
+    __disable_irq();
+    return key;
+}
+
+/*!
+    \brief      restore the interrupt mask, a pending PendSV is taken here
+    \param[in]  key: returned by kernel_port_lock()
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_unlock(uint32_t key)
+{
+    __set_PRIMASK(key);
+    /* the switch has to happen before the caller reads its wait result */
+    __ISB();
+}
+
+/*!
+    \brief      build the first frame of a thread and watch its stack
+    \param[in]  thread: thread with its entry and stack set
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_thread_init(kernel_thread_struct *thread)
+{
+    uint32_t *top = (uint32_t *)(((uint32_t)thread->stack + thread->stack_size) & ~7UL);
+    uint32_t *sp = top - PORT_FRAME_WORDS;
+    uint32_t i;
+
+    mem_stat_paint(thread->stack, sp);
+    mem_stat_stack_add(thread->name, thread->stack, thread->stack_size);
+
+    for(i = 0; i < 8U; i++){
+        sp[i] = 0U;
+    }
+    sp[8] = PORT_EXC_RETURN;
+    sp[9] = (uint32_t)thread->arg;
+    sp[10] = 0U;
+    sp[11] = 0U;
+    sp[12] = 0U;
+    sp[13] = 0U;
+    sp[14] = (uint32_t)kernel_thread_exit;
+    sp[15] = (uint32_t)thread->entry & ~1UL;
+    sp[16] = PORT_XPSR;
+    thread->sp = sp;
+}
+
+/*!
+    \brief      pend PendSV
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_switch(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+/*!
+    \brief      enter the first ready thread through SVC 0
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_start(void)
+{
+    NVIC_SetPriority(PendSV_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+    NVIC_SetPriority(SVCall_IRQn, 0U);
+
+    /* drop the FPU context of main(), its frame is never returned to */
+    __set_CONTROL(0U);
+    __ISB();
+    __enable_irq();
+    __ASM volatile("svc 0");
+    for(;;){
+    }
+}
+
+/*!
+    \brief      sleep until an interrupt or the next deadline
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_idle(void)
+{
+    __disable_irq();
+    idle_port_sleep();
+    __enable_irq();
+}
+
+/*!
+    \brief      start the first thread, reached from kernel_port_start()
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((naked)) void SVC_Handler(void)
+{
+    __ASM volatile(
+        "   ldr     r0, =_estack            \n" /* main() is gone, its stack is the interrupts' */
+        "   msr     msp, r0                 \n"
+        "   ldr     r1, =kernel             \n"
+        "   movs    r3, #1                  \n"
+        "   str     r3, [r1, #8]            \n" /* kernel.started */
+        "   ldr     r2, [r1, #12]           \n" /* kernel.ready.head, as interrupts left it */
+        "   str     r2, [r1]                \n" /* kernel.current */
+        "   str     r2, [r1, #4]            \n" /* kernel.next */
+        "   ldr     r0, [r2]                \n" /* its sp */
+        "   ldmia   r0!, {r4-r11, lr}       \n"
+        "   msr     psp, r0                 \n"
+        "   isb                             \n"
+        "   bx      lr                      \n"
+        "   .ltorg                          \n"
+    );
+}
+
+/*!
+    \brief      switch from kernel.current to kernel.next
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((naked)) void PendSV_Handler(void)
+{
+    __ASM volatile(
+        "   mrs     r0, psp                 \n"
+        "   isb                             \n"
+        "   tst     lr, #0x10               \n" /* extended frame, the thread used the FPU */
+        "   it      eq                      \n"
+        "   vstmdbeq r0!, {s16-s31}         \n"
+        "   stmdb   r0!, {r4-r11, lr}       \n"
+        "   ldr     r1, =kernel             \n"
+        "   ldr     r2, [r1]                \n"
+        "   str     r0, [r2]                \n" /* kernel.current->sp */
+        "   cpsid   i                       \n"
+        "   ldr     r2, [r1, #4]            \n" /* kernel.current = kernel.next */
+        "   str     r2, [r1]                \n"
+        "   cpsie   i                       \n"
+        "   ldr     r0, [r2]                \n"
+        "   ldmia   r0!, {r4-r11, lr}       \n"
+        "   tst     lr, #0x10               \n"
+        "   it      eq                      \n"
+        "   vldmiaeq r0!, {s16-s31}         \n"
+        "   msr     psp, r0                 \n"
+        "   isb                             \n"
+        "   bx      lr                      \n"
+        "   .ltorg                          \n"
+    );
+}
@@ -0,0 +1,254 @@
+/*!
+    \file    mem_pool.c
+    \brief   fixed-size object pools
+
+    Each size class is a static array of objects with a free list kept as
+    a stack. The head packs the index of the top object with a 16 bit tag
+    that changes on every push and pop, so one compare-and-swap updates
+    it and a pop that was preempted by a pop and a push of the same
+    object fails instead of corrupting the list. The link to the next
+    free object lives in the first word of the object. On the Cortex-M4
+    the compare-and-swap is an LDREX/STREX pair, so interrupt handlers
+    can allocate and free without masking interrupts.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "mem_pool.h"
+
+#define POOL_NONE                   0xFFFFU
+#define HEAD_INDEX(head)            ((head) >> 16)
+#define HEAD_MAKE(index, tag)       (((uint32_t)(index) << 16) | ((tag) & 0xFFFFU))
+
+typedef struct {
+    uint8_t *base;
+    uint32_t size;
+    uint32_t count;
+    uint32_t head;                                      /*!< top object index << 16 | tag */
+    uint32_t used;
+    uint32_t peak;
+    uint32_t allocs;
+    uint32_t failures;
+    uint32_t corruptions;
+} mem_pool_class_struct;
+
+#define MEM_POOL_STORAGE(name, size, count)                                     \
+    _Static_assert(((size) % 8U == 0U) && ((count) < POOL_NONE), #name " size or count");  \
+    static uint64_t name##_storage[(size) * (count) / 8U] MEM_POOL_SECTION;
+MEM_POOL_CLASSES(MEM_POOL_STORAGE)
+#undef MEM_POOL_STORAGE
+
+#define MEM_POOL_ENTRY(name, size, count) { (uint8_t *)name##_storage, (size), (count), 0, 0, 0, 0, 0, 0 },
+static mem_pool_class_struct pools[MEM_POOL_CLASS_COUNT] = {
+    MEM_POOL_CLASSES(MEM_POOL_ENTRY)
+};
+#undef MEM_POOL_ENTRY
+
+/* link word of an object */
+static volatile uint32_t *pool_link(const mem_pool_class_struct *pool, uint32_t index)
+{
+    return (volatile uint32_t *)(pool->base + index * pool->size);
+}
+
+/*!
+    \brief      push an object on the free list of its class
+    \param[in]  pool: class
+    \param[in]  index: object index
+    \param[out] none
+    \retval     none
+*/
+static void pool_push(mem_pool_class_struct *pool, uint32_t index)
+{
+    uint32_t old = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+    uint32_t new;
+
+    do{
+        *pool_link(pool, index) = HEAD_INDEX(old);
+        new = HEAD_MAKE(index, old + 1U);
+    }while(!__atomic_compare_exchange_n(&pool->head, &old, new, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/*!
+    \brief      pop an object from the free list of its class
+    \param[in]  pool: class
+    \param[out] none
+    \retval     object index, POOL_NONE when the class is empty
+*/
+static uint32_t pool_pop(mem_pool_class_struct *pool)
+{
+    uint32_t old = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+    uint32_t index, new;
+
+    do{
+        index = HEAD_INDEX(old);
+        if(POOL_NONE == index){
+            return POOL_NONE;
+        }
+        /* the link may be stale if the object was taken meanwhile, the tag catches it */
+        new = HEAD_MAKE(*pool_link(pool, index), old + 1U);
+    }while(!__atomic_compare_exchange_n(&pool->head, &old, new, 1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+    return index;
+}
+
+/*!
+    \brief      put every object on its free list
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void mem_pool_init(void)
+{
+    mem_pool_class_struct *pool;
+    uint32_t c, i;
+
+    for(c = 0; c < MEM_POOL_CLASS_COUNT; c++){
+        pool = &pools[c];
+        pool->head = HEAD_MAKE(POOL_NONE, 0U);
+        pool->used = 0;
+        pool->peak = 0;
+        pool->allocs = 0;
+        pool->failures = 0;
+        pool->corruptions = 0;
+#if MEM_POOL_POISON
+        memset(pool->base, MEM_POOL_FREE_BYTE, pool->size * pool->count);
+#endif
+        /* push in reverse so the first allocation gets the first object */
+        for(i = pool->count; i > 0U; i--){
+            pool_push(pool, i - 1U);
+        }
+    }
+}
+
+/*!
+    \brief      count an allocation and keep the peak
+    \param[in]  pool: class
+    \param[out] none
+    \retval     none
+*/
+static void pool_count_alloc(mem_pool_class_struct *pool)
+{
+    uint32_t used = __atomic_add_fetch(&pool->used, 1U, __ATOMIC_RELAXED);
+    uint32_t peak = __atomic_load_n(&pool->peak, __ATOMIC_RELAXED);
+
+    while((used > peak) &&
+          !__atomic_compare_exchange_n(&pool->peak, &peak, used, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+    }
+    __atomic_add_fetch(&pool->allocs, 1U, __ATOMIC_RELAXED);
+}
+
+/*!
+    \brief      take an object from a class
+    \param[in]  pool: class
+    \param[out] none
+    \retval     object, NULL when the class is empty
+*/
+static void *pool_take(mem_pool_class_struct *pool)
+{
+    uint32_t index = pool_pop(pool);
+    uint8_t *obj;
+#if MEM_POOL_POISON
+    uint32_t i;
+#endif
+
+    if(POOL_NONE == index){
+        __atomic_add_fetch(&pool->failures, 1U, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    obj = pool->base + index * pool->size;
+
+#if MEM_POOL_POISON
+    /* the first word was the link, the rest must still hold the pattern */
+    for(i = sizeof(uint32_t); i < pool->size; i++){
+        if(MEM_POOL_FREE_BYTE != obj[i]){
+            __atomic_add_fetch(&pool->corruptions, 1U, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    memset(obj, MEM_POOL_ALLOC_BYTE, pool->size);
+#endif
+
+    pool_count_alloc(pool);
+    return obj;
+}
+
+/*!
+    \brief      allocate from the smallest class that fits and has a free object
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     object, NULL when no class has one
+*/
+void *mem_pool_alloc(size_t size)
+{
+    void *obj;
+    uint32_t c;
+
+    for(c = 0; c < MEM_POOL_CLASS_COUNT; c++){
+        if(size <= pools[c].size){
+            obj = pool_take(&pools[c]);
+            if(NULL != obj){
+                return obj;
+            }
+        }
+    }
+    return NULL;
+}
+
+/*!
+    \brief      allocate from one class
+    \param[in]  pool_class: size class
+    \param[out] none
+    \retval     object, NULL when the class is empty
+*/
+void *mem_pool_alloc_class(mem_pool_class_enum pool_class)
+{
+    return pool_take(&pools[pool_class]);
+}
+
+/*!
+    \brief      return an object to its class
+    \param[in]  ptr: object returned by the pools, NULL is ignored
+    \param[out] none
+    \retval     none
+*/
+void mem_pool_free(void *ptr)
+{
+    mem_pool_class_struct *pool;
+    uint8_t *obj = (uint8_t *)ptr;
+    uint32_t c;
+
+    if(NULL == ptr){
+        return;
+    }
+    for(c = 0; c < MEM_POOL_CLASS_COUNT; c++){
+        pool = &pools[c];
+        if((obj >= pool->base) && (obj < pool->base + pool->size * pool->count)){
+#if MEM_POOL_POISON
+            memset(obj, MEM_POOL_FREE_BYTE, pool->size);
+#endif
+            __atomic_sub_fetch(&pool->used, 1U, __ATOMIC_RELAXED);
+            pool_push(pool, (uint32_t)(obj - pool->base) / pool->size);
+            return;
+        }
+    }
+}
+
+/*!
+    \brief      get the usage of a class
+    \param[in]  pool_class: size class
+    \param[out] stats: usage
+    \retval     none
+*/
+void mem_pool_stats_get(mem_pool_class_enum pool_class, mem_pool_stats_struct *stats)
+{
+    const mem_pool_class_struct *pool = &pools[pool_class];
+
+    stats->size = pool->size;
+    stats->count = pool->count;
+    stats->used = __atomic_load_n(&pool->used, __ATOMIC_RELAXED);
+    stats->peak = __atomic_load_n(&pool->peak, __ATOMIC_RELAXED);
+    stats->allocs = __atomic_load_n(&pool->allocs, __ATOMIC_RELAXED);
+    stats->failures = __atomic_load_n(&pool->failures, __ATOMIC_RELAXED);
+    stats->corruptions = __atomic_load_n(&pool->corruptions, __ATOMIC_RELAXED);
+}
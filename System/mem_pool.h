@@ -0,0 +1,66 @@
+/*!
+    \file    mem_pool.h
+    \brief   the header file of the fixed-size object pools
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* size classes: X(name, object bytes, objects), sizes ascending and multiples of 8 */
+#define MEM_POOL_CLASSES(X)                                                     \
+    X(MEM_POOL_32,      32U,    128U)                                           \
+    X(MEM_POOL_64,      64U,    64U)                                            \
+    X(MEM_POOL_128,     128U,   32U)                                            \
+    X(MEM_POOL_256,     256U,   16U)
+
+/* section of the pool storage, internal SRAM by default */
+#ifndef MEM_POOL_SECTION
+#define MEM_POOL_SECTION
+#endif
+
+/* fill free objects with a pattern and check it on allocation */
+#ifndef MEM_POOL_POISON
+#ifdef DEBUG
+#define MEM_POOL_POISON             1
+#else
+#define MEM_POOL_POISON             0
+#endif
+#endif
+
+#define MEM_POOL_FREE_BYTE          0xDDU               /*!< free objects */
+#define MEM_POOL_ALLOC_BYTE         0xCDU               /*!< new objects */
+
+#define MEM_POOL_ENUM(name, size, count) name,
+typedef enum {
+    MEM_POOL_CLASSES(MEM_POOL_ENUM)
+    MEM_POOL_CLASS_COUNT
+} mem_pool_class_enum;
+#undef MEM_POOL_ENUM
+
+typedef struct {
+    uint32_t size;                                      /*!< object bytes */
+    uint32_t count;                                     /*!< objects */
+    uint32_t used;                                      /*!< objects allocated now */
+    uint32_t peak;                                      /*!< most objects allocated at once */
+    uint32_t allocs;                                    /*!< successful allocations */
+    uint32_t failures;                                  /*!< allocations that found the class empty */
+    uint32_t corruptions;                               /*!< free objects found written, with MEM_POOL_POISON */
+} mem_pool_stats_struct;
+
+/* put every object on its free list, call before any allocation */
+void mem_pool_init(void);
+/* allocate from the smallest class that fits and has a free object, NULL when none has */
+void *mem_pool_alloc(size_t size);
+/* allocate from one class, NULL when it is empty */
+void *mem_pool_alloc_class(mem_pool_class_enum pool_class);
+/* return an object to its class, NULL is ignored */
+void mem_pool_free(void *ptr);
+/* get the usage of a class */
+void mem_pool_stats_get(mem_pool_class_enum pool_class, mem_pool_stats_struct *stats);
+
+#endif /* MEM_POOL_H */
@@ -0,0 +1,27 @@
+/*!
+    \file    mem_section.h
+    \brief   placement of code and data in the memories of the GD32F470
+
+    The 64 KB TCMSRAM at 0x10000000 is the fastest data memory, it sits on
+    the core data bus with no wait states and no contention with the
+    DMA, IPA and TLI masters. Those masters cannot reach it either, so
+    buffers they read or write must not be placed there. The CPU cannot
+    fetch instructions from it, functions that should not wait for the
+    flash go to the internal SRAM with RAMFUNC.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef MEM_SECTION_H
+#define MEM_SECTION_H
+
+/* initialised data in the TCM, copied from flash at reset */
+#define TCM_DATA                    __attribute__((section(".tcm_data")))
+/* zero initialised data in the TCM, must not have an initialiser */
+#define TCM_BSS                     __attribute__((section(".tcm_bss")))
+/* function run from the internal SRAM, called through a long branch */
+#define RAMFUNC                     __attribute__((section(".ramfunc"), noinline, long_call))
+/* zero initialised data in the SDRAM, not cleared at reset */
+#define SDRAM_BSS                   __attribute__((section(".sdram")))
+
+#endif /* MEM_SECTION_H */
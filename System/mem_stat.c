@@ -0,0 +1,94 @@
+/*!
+    \file    mem_stat.c
+    \brief   memory usage telemetry
+
+    A stack is painted with a pattern before it is used. Whatever has
+    been pushed since overwrote the pattern from the top down, so the
+    painted words left at the bottom are the part of the stack that was
+    never reached. Stacks are watched through a small table so that
+    every stack of the system shows up in the same dump.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "mem_stat.h"
+
+static mem_stat_stack_struct stacks[MEM_STAT_STACKS];
+static uint32_t stack_count;
+
+/*!
+    \brief      fill a range with MEM_STAT_PAINT
+    \param[in]  start: first word
+    \param[in]  end: word after the last one
+    \param[out] none
+    \retval     none
+*/
+void mem_stat_paint(uint32_t *start, uint32_t *end)
+{
+    volatile uint32_t *word = start;
+
+    while(word < end){
+        *word++ = MEM_STAT_PAINT;
+    }
+}
+
+/*!
+    \brief      get the most bytes a painted stack has used
+    \param[in]  base: lowest word of the stack
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     bytes from the top down to the deepest word written
+*/
+uint32_t mem_stat_stack_peak(const uint32_t *base, uint32_t size)
+{
+    const volatile uint32_t *word = base;
+    uint32_t words = size / 4U, unused = 0;
+
+    while((unused < words) && (MEM_STAT_PAINT == word[unused])){
+        unused++;
+    }
+    return size - unused * 4U;
+}
+
+/*!
+    \brief      watch a stack that has been painted
+    \param[in]  name: key of the stack in the dump
+    \param[in]  base: lowest word
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     0, -1 when the table is full
+*/
+int mem_stat_stack_add(const char *name, uint32_t *base, uint32_t size)
+{
+    if(stack_count >= MEM_STAT_STACKS){
+        return -1;
+    }
+    stacks[stack_count].name = name;
+    stacks[stack_count].base = base;
+    stacks[stack_count].size = size;
+    stack_count++;
+    return 0;
+}
+
+/*!
+    \brief      get the number of stacks watched
+    \param[in]  none
+    \param[out] none
+    \retval     stacks
+*/
+uint32_t mem_stat_stack_count(void)
+{
+    return stack_count;
+}
+
+/*!
+    \brief      get a watched stack
+    \param[in]  index: 0 .. mem_stat_stack_count() - 1
+    \param[out] none
+    \retval     stack, NULL when there is none
+*/
+const mem_stat_stack_struct *mem_stat_stack_get(uint32_t index)
+{
+    return (index < stack_count) ? &stacks[index] : NULL;
+}
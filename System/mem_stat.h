@@ -0,0 +1,46 @@
+/*!
+    \file    mem_stat.h
+    \brief   the header file of the memory usage telemetry
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef MEM_STAT_H
+#define MEM_STAT_H
+
+#include <stdint.h>
+
+/* stacks that can be watched */
+#define MEM_STAT_STACKS             8U
+/* word painted over unused stack */
+#define MEM_STAT_PAINT              0xC5C5C5C5UL
+/* milliseconds between two dumps */
+#ifndef MEM_STAT_PERIOD_MS
+#define MEM_STAT_PERIOD_MS          5000U
+#endif
+
+/* a stack growing down from base + size */
+typedef struct {
+    const char *name;                                   /*!< no spaces, it is a key of the dump */
+    uint32_t *base;                                     /*!< lowest word */
+    uint32_t size;                                      /*!< bytes, a multiple of 4 */
+} mem_stat_stack_struct;
+
+/* fill a range with MEM_STAT_PAINT */
+void mem_stat_paint(uint32_t *start, uint32_t *end);
+/* get the most bytes a painted stack has used */
+uint32_t mem_stat_stack_peak(const uint32_t *base, uint32_t size);
+/* watch a stack that has been painted, return 0 or -1 when the table is full */
+int mem_stat_stack_add(const char *name, uint32_t *base, uint32_t size);
+/* number of stacks watched */
+uint32_t mem_stat_stack_count(void);
+/* get a watched stack */
+const mem_stat_stack_struct *mem_stat_stack_get(uint32_t index);
+
+/* target functions, mem_stat_port.c */
+/* paint the unused part of the main stack and watch it, call first in main() */
+void mem_stat_init(void);
+/* print the memory usage in one line over RTT */
+void mem_stat_dump(void);
+
+#endif /* MEM_STAT_H */
@@ -0,0 +1,98 @@
+/*!
+    \file    mem_stat_port.c
+    \brief   memory usage telemetry on the target
+
+    mem_stat_dump() prints one line on RTT channel 0 made of key=value
+    tokens, a value is either a number of bytes or used/capacity:
+
+      mem t=<ms> stack.<name>=<peak>/<size> ... sram=<used>/<size>
+          tcm=<used>/<size> sdram=<used>/<size> sec.<section>=<bytes> ...
+          heap=<used>/<size> heap.peak=<bytes> heap.largest=<bytes>
+          heap.frag=<permille> heap.fail=<count>
+          pool.<size>=<used>/<count> pool.<size>.peak=<count>
+          pool.<size>.fail=<count> pool.<size>.bad=<count>
+
+    tools/mem_budget.py turns a log of these lines into a budget report.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "systick.h"
+#include "mem_stat.h"
+#include "mem_pool.h"
+#include "sdram_heap.h"
+#include "SEGGER_RTT.h"
+
+/* stack left unpainted below the stack pointer for the frame of mem_stat_paint() */
+#define MEM_STAT_SP_MARGIN          64U
+
+/* defined in link.ld */
+extern uint32_t _sstack[];
+extern uint32_t _estack[];
+extern uint8_t _sstack_guard[];
+extern uint8_t _sdata[], _edata[];
+extern uint8_t _sbss[], _ebss[];
+extern uint8_t _stcm_data[], _etcm_data[];
+extern uint8_t _stcm_bss[], _etcm_bss[];
+extern uint8_t _ssdram[], _esdram[];
+extern uint8_t _sram_length[], _tcm_length[], _sdram_length[];
+
+/*!
+    \brief      paint the unused part of the main stack and watch it
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void mem_stat_init(void)
+{
+    uint32_t *sp = (uint32_t *)(__get_MSP() - MEM_STAT_SP_MARGIN);
+
+    mem_stat_paint(_sstack, sp);
+    mem_stat_stack_add("main", _sstack, (uint32_t)((uint8_t *)_estack - (uint8_t *)_sstack));
+}
+
+/*!
+    \brief      print the memory usage in one line over RTT
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void mem_stat_dump(void)
+{
+    const mem_stat_stack_struct *stack;
+    mem_pool_stats_struct pool;
+    tlsf_stats_struct heap;
+    uint32_t i, data, bss, tcm_data, tcm_bss, sdram;
+
+    data = (uint32_t)(_edata - _sdata);
+    bss = (uint32_t)(_ebss - _sbss);
+    tcm_data = (uint32_t)(_etcm_data - _stcm_data);
+    tcm_bss = (uint32_t)(_etcm_bss - _stcm_bss);
+    sdram = (uint32_t)(_esdram - _ssdram);
+
+    SEGGER_RTT_printf(0, "mem t=%u", systick_ms_get());
+    for(i = 0; i < mem_stat_stack_count(); i++){
+        stack = mem_stat_stack_get(i);
+        SEGGER_RTT_printf(0, " stack.%s=%u/%u", stack->name, mem_stat_stack_peak(stack->base, stack->size), stack->size);
+    }
+
+    SEGGER_RTT_printf(0, " sram=%u/%u tcm=%u/%u sdram=%u/%u", data + bss, (uint32_t)_sram_length,
+                      (uint32_t)((uint8_t *)_estack - _sstack_guard) + tcm_data + tcm_bss, (uint32_t)_tcm_length,
+                      sdram, (uint32_t)_sdram_length);
+    SEGGER_RTT_printf(0, " sec.data=%u sec.bss=%u sec.tcm_data=%u sec.tcm_bss=%u sec.sdram=%u",
+                      data, bss, tcm_data, tcm_bss, sdram);
+
+    sdram_heap_stats_get(&heap);
+    SEGGER_RTT_printf(0, " heap=%u/%u heap.peak=%u heap.largest=%u heap.frag=%u heap.fail=%u",
+                      (uint32_t)heap.used, (uint32_t)(heap.used + heap.free), (uint32_t)heap.high_water,
+                      (uint32_t)heap.largest, heap.fragmentation, heap.failures);
+
+    for(i = 0; i < MEM_POOL_CLASS_COUNT; i++){
+        mem_pool_stats_get((mem_pool_class_enum)i, &pool);
+        SEGGER_RTT_printf(0, " pool.%u=%u/%u pool.%u.peak=%u pool.%u.fail=%u pool.%u.bad=%u",
+                          pool.size, pool.used, pool.count, pool.size, pool.peak,
+                          pool.size, pool.failures, pool.size, pool.corruptions);
+    }
+    SEGGER_RTT_printf(0, "\n");
+}
@@ -0,0 +1,201 @@
+/*!
+    \file    mpu.c
+    \brief   MPU region planner
+
+    An ARMv7-M region is a power of two of 32 bytes or more, aligned to
+    its size. Regions of 256 bytes and more are split in eight
+    subregions that can be left out. mpu_plan() covers each area
+    exactly, starting every region at the current address with the size
+    that covers the most of what is left, so an area costs one region
+    when it fits a power of two block with whole subregions, and a few
+    more otherwise.
+
+    Regions are numbered in table order and the MPU gives a higher
+    number priority, so a guard listed after the area it sits in wins.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "mpu.h"
+
+/* RBAR and RASR fields, ARMv7-M */
+#define RBAR_VALID                  (1UL << 4)
+#define RASR_XN                     (1UL << 28)
+#define RASR_AP(ap)                 ((uint32_t)(ap) << 24)
+#define RASR_TEX(tex)               ((uint32_t)(tex) << 19)
+#define RASR_S                      (1UL << 18)
+#define RASR_C                      (1UL << 17)
+#define RASR_B                      (1UL << 16)
+#define RASR_SRD(mask)              ((uint32_t)(mask) << 8)
+#define RASR_SIZE(log2)             ((uint32_t)((log2) - 1U) << 1)
+#define RASR_ENABLE                 1UL
+
+#define RASR_SRD_GET(rasr)          (((rasr) >> 8) & 0xFFU)
+#define RASR_LOG2_GET(rasr)         ((((rasr) >> 1) & 0x1FU) + 1U)
+
+/*!
+    \brief      get the attribute bits of an area
+    \param[in]  area: area
+    \param[out] none
+    \retval     RASR without subregion disables, size and enable
+*/
+static uint32_t area_attributes(const mpu_area_struct *area)
+{
+    uint32_t rasr = 0;
+
+    switch(area->mem){
+    case MPU_MEM_STRONG:
+        break;
+    case MPU_MEM_DEVICE:
+        rasr |= RASR_B | RASR_S;
+        break;
+    case MPU_MEM_NORMAL_NC:
+        rasr |= RASR_TEX(1U);
+        break;
+    case MPU_MEM_NORMAL_WT:
+        rasr |= RASR_C;
+        break;
+    default:
+        rasr |= RASR_C | RASR_B;
+        break;
+    }
+
+    switch(area->access){
+    case MPU_ACCESS_NONE:
+        rasr |= RASR_AP(0U);
+        break;
+    case MPU_ACCESS_PRIV_RW:
+        rasr |= RASR_AP(1U);
+        break;
+    case MPU_ACCESS_RO:
+        rasr |= RASR_AP(6U);
+        break;
+    default:
+        rasr |= RASR_AP(3U);
+        break;
+    }
+
+    if(!area->execute){
+        rasr |= RASR_XN;
+    }
+    return rasr;
+}
+
+/*!
+    \brief      find the region that covers the most from an address
+    \param[in]  cur: first byte still to cover, 32 byte aligned
+    \param[in]  end: end of the area
+    \param[out] log2: region size
+    \param[out] top: end of what the region covers
+    \retval     bytes covered, 0 when no region fits
+*/
+static uint64_t region_best(uint64_t cur, uint64_t end, uint32_t *log2, uint64_t *top)
+{
+    uint64_t size, base, sub, limit, best = 0;
+    uint32_t l;
+
+    for(l = 32U; l >= 5U; l--){
+        size = (uint64_t)1U << l;
+        base = cur & ~(size - 1U);
+        if(size >= MPU_SUBREGION_MIN_REGION){
+            /* whole subregions from cur up to the end of the area or the region */
+            sub = size / 8U;
+            if(0U != (cur & (sub - 1U))){
+                continue;
+            }
+            limit = (end < base + size) ? end : base + size;
+            limit &= ~(sub - 1U);
+        }else{
+            if((base != cur) || (cur + size > end)){
+                continue;
+            }
+            limit = cur + size;
+        }
+        /* among equal ones keep the smallest, it disables fewer subregions */
+        if(limit > cur && limit - cur >= best){
+            best = limit - cur;
+            *log2 = l;
+            *top = limit;
+        }
+    }
+    return best;
+}
+
+/*!
+    \brief      cover areas with regions
+    \param[in]  areas: address ranges and their mapping, later ones win where they overlap
+    \param[in]  area_count: number of areas
+    \param[in]  max_regions: size of regions
+    \param[out] regions: register values in region order
+    \retval     number of regions used, -1 when an area is not 32 byte aligned or there are too few regions
+*/
+int mpu_plan(const mpu_area_struct *areas, uint32_t area_count, mpu_region_struct *regions, uint32_t max_regions)
+{
+    const mpu_area_struct *area;
+    uint64_t cur, end, top = 0, base, sub;
+    uint32_t a, n = 0, log2 = 0, attributes, srd, i;
+
+    for(a = 0; a < area_count; a++){
+        area = &areas[a];
+        if((0U != (area->base & (MPU_REGION_MIN - 1U))) || (0U != (area->size & (MPU_REGION_MIN - 1U)))){
+            return -1;
+        }
+        attributes = area_attributes(area);
+        cur = area->base;
+        end = (uint64_t)area->base + area->size;
+
+        while(cur < end){
+            if((n == max_regions) || (n == MPU_REGIONS) || (0U == region_best(cur, end, &log2, &top))){
+                return -1;
+            }
+            base = cur & ~(((uint64_t)1U << log2) - 1U);
+
+            /* leave out the subregions outside cur..top */
+            srd = 0;
+            if(log2 >= 8U){
+                sub = ((uint64_t)1U << log2) / 8U;
+                for(i = 0; i < 8U; i++){
+                    if((base + sub * i < cur) || (base + sub * (i + 1U) > top)){
+                        srd |= 1U << i;
+                    }
+                }
+            }
+
+            regions[n].rbar = (uint32_t)base | RBAR_VALID | n;
+            regions[n].rasr = attributes | RASR_SRD(srd) | RASR_SIZE(log2) | RASR_ENABLE;
+            n++;
+            cur = top;
+        }
+    }
+    return (int)n;
+}
+
+/*!
+    \brief      get the first and last byte a region covers
+    \param[in]  region: register values, its enabled subregions must be contiguous
+    \param[out] first: first byte
+    \param[out] last: last byte
+    \retval     none
+*/
+void mpu_region_range(const mpu_region_struct *region, uint32_t *first, uint32_t *last)
+{
+    uint32_t log2 = RASR_LOG2_GET(region->rasr);
+    uint32_t srd = RASR_SRD_GET(region->rasr);
+    uint64_t base = region->rbar & ~0x1FUL;
+    uint64_t size = (uint64_t)1U << log2;
+    uint64_t sub = size / 8U;
+    uint32_t lo = 0, hi = 7;
+
+    if(log2 < 8U){
+        srd = 0;
+    }
+    while((lo < 8U) && (0U != (srd & (1U << lo)))){
+        lo++;
+    }
+    while((hi > lo) && (0U != (srd & (1U << hi)))){
+        hi--;
+    }
+    *first = (uint32_t)(base + sub * lo);
+    *last = (uint32_t)(base + sub * (hi + 1U) - 1U);
+}
@@ -0,0 +1,62 @@
+/*!
+    \file    mpu.h
+    \brief   the header file of the MPU region planner
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef MPU_H
+#define MPU_H
+
+#include <stdint.h>
+
+/* regions of the Cortex-M4 MPU */
+#define MPU_REGIONS                 8U
+/* smallest region, subregions need 256 bytes */
+#define MPU_REGION_MIN              32U
+#define MPU_SUBREGION_MIN_REGION    256U
+
+/* memory type of an area */
+typedef enum {
+    MPU_MEM_STRONG = 0,                                 /*!< strongly ordered */
+    MPU_MEM_DEVICE,                                     /*!< shareable device */
+    MPU_MEM_NORMAL_NC,                                  /*!< normal, not cacheable */
+    MPU_MEM_NORMAL_WT,                                  /*!< normal, write-through */
+    MPU_MEM_NORMAL_WB                                   /*!< normal, write-back, writes are buffered and merged */
+} mpu_mem_enum;
+
+/* access permission of an area */
+typedef enum {
+    MPU_ACCESS_NONE = 0,                                /*!< any access faults, for guards */
+    MPU_ACCESS_PRIV_RW,                                 /*!< privileged code only */
+    MPU_ACCESS_RW,
+    MPU_ACCESS_RO
+} mpu_access_enum;
+
+/* an address range and how it is to be mapped */
+typedef struct {
+    uint32_t base;                                      /*!< 32 byte aligned */
+    uint32_t size;                                      /*!< multiple of 32 bytes */
+    mpu_mem_enum mem;
+    mpu_access_enum access;
+    uint8_t execute;                                    /*!< 1 to allow instruction fetches */
+} mpu_area_struct;
+
+/* register values of one region */
+typedef struct {
+    uint32_t rbar;                                      /*!< address, VALID and region number */
+    uint32_t rasr;                                      /*!< attributes, subregion disables, size, enable */
+} mpu_region_struct;
+
+/* cover areas with regions, later areas win where they overlap, return the number of regions or -1 */
+int mpu_plan(const mpu_area_struct *areas, uint32_t area_count, mpu_region_struct *regions, uint32_t max_regions);
+/* get the first and last byte a region covers with its enabled subregions */
+void mpu_region_range(const mpu_region_struct *region, uint32_t *first, uint32_t *last);
+
+/* target functions, mpu_port.c */
+/* program regions and enable the MPU with the default map as background */
+void mpu_apply(const mpu_region_struct *regions, uint32_t count);
+/* map the SDRAM as normal memory and guard the bottom of the stack */
+int mpu_init(void);
+
+#endif /* MPU_H */
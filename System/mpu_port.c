@@ -0,0 +1,86 @@
+/*!
+    \file    mpu_port.c
+    \brief   MPU set-up of the board
+
+    The SDRAM lies in the external device part of the default memory
+    map: every store waits for the one before it, nothing is merged in
+    the write buffer and an unaligned access faults. Mapping the part the
+    linker uses, framebuffers, z-buffer and heap, as normal write-back
+    memory lifts all three. The Cortex-M4 has no cache, so the LTDC and
+    the DMA still see every store once it has left the write buffer.
+
+    The 32 bytes below the main stack are made inaccessible, so an
+    overflow raises a MemManage fault at the instruction that caused it.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "exmc_sdram.h"
+#include "mpu.h"
+
+/* defined in link.ld */
+extern uint8_t _sdram_heap_end[];
+extern uint8_t _sstack_guard[];
+
+/*!
+    \brief      program regions and enable the MPU
+    \param[in]  regions: register values from mpu_plan()
+    \param[in]  count: number of regions
+    \param[out] none
+    \retval     none
+*/
+void mpu_apply(const mpu_region_struct *regions, uint32_t count)
+{
+    uint32_t i;
+
+    __DMB();
+    MPU->CTRL = 0;
+
+    for(i = 0; i < MPU_REGIONS; i++){
+        MPU->RNR = i;
+        if(i < count){
+            MPU->RBAR = regions[i].rbar;
+            MPU->RASR = regions[i].rasr;
+        }else{
+            MPU->RASR = 0;
+        }
+    }
+
+    /* the default map stays in place behind the regions */
+    MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+    __DSB();
+    __ISB();
+}
+
+/*!
+    \brief      map the SDRAM as normal memory and guard the bottom of the stack
+    \param[in]  none
+    \param[out] none
+    \retval     number of regions used, -1 when the table does not fit
+*/
+int mpu_init(void)
+{
+    mpu_area_struct areas[2];
+    mpu_region_struct regions[MPU_REGIONS];
+    int count;
+
+    areas[0].base = SDRAM_DEVICE0_ADDR;
+    areas[0].size = (uint32_t)_sdram_heap_end - SDRAM_DEVICE0_ADDR;
+    areas[0].mem = MPU_MEM_NORMAL_WB;
+    areas[0].access = MPU_ACCESS_RW;
+    areas[0].execute = 0;
+
+    areas[1].base = (uint32_t)_sstack_guard;
+    areas[1].size = MPU_REGION_MIN;
+    areas[1].mem = MPU_MEM_STRONG;
+    areas[1].access = MPU_ACCESS_NONE;
+    areas[1].execute = 0;
+
+    count = mpu_plan(areas, sizeof(areas) / sizeof(areas[0]), regions, MPU_REGIONS);
+    if(count > 0){
+        mpu_apply(regions, (uint32_t)count);
+    }
+    return count;
+}
@@ -0,0 +1,159 @@
+/*!
+    \file    profiler.c
+    \brief   sampling profiler
+
+    A timer interrupt at a fixed rate takes the pc, and with it the lr,
+    from the exception frame of whatever code it interrupted, thread or
+    handler, and queues them. The sampling costs a few dozen cycles per
+    sample whatever runs, and over enough samples the share of them
+    falling in a function is the share of time spent in it. The lr
+    names the caller only while the function has not reused it, in a
+    leaf function or before its first call, so the host treats it as a
+    hint for one level of stack.
+
+    The drain runs outside interrupt level and cuts the queue in
+    batches for the host:
+
+        u32 PROFILER_MAGIC
+        u16 samples
+        u16 flags, PROFILER_FLAG_LR
+        u32 samples lost since the previous batch
+        u32 pc[, u32 lr] per sample
+
+    all little-endian, so a host that lost bytes of the stream can find
+    the next batch by its magic. Samples the ring had no room for, and
+    those of batches the channel refused, are reported in the next
+    batch that gets through.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "profiler.h"
+
+_Static_assert(0U == (PROFILER_RING_SIZE & (PROFILER_RING_SIZE - 1U)), "PROFILER_RING_SIZE must be a power of two");
+
+profiler_struct profiler;
+
+/* store a 32-bit word little-endian */
+static uint8_t *put32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+    return out + 4;
+}
+
+/* read a 32-bit word stored little-endian */
+static uint32_t get32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+/*!
+    \brief      empty the ring and clear the counts
+    \param[in]  p: profiler
+    \param[in]  with_lr: non-zero to send the lr of each sample
+    \param[out] none
+    \retval     none
+*/
+void profiler_init(profiler_struct *p, int with_lr)
+{
+    ringbuf_init(&p->ring, p->samples, PROFILER_RING_SIZE, sizeof(profiler_sample_struct));
+    p->with_lr = (0 != with_lr) ? 1U : 0U;
+    p->taken = 0U;
+    p->lost = 0U;
+    p->skipped = 0U;
+    p->reported = 0U;
+}
+
+/*!
+    \brief      take a sample, from the sampling interrupt
+    \param[in]  p: profiler
+    \param[in]  pc: stacked pc of the interrupted code
+    \param[in]  lr: stacked lr of the interrupted code
+    \param[out] none
+    \retval     none
+*/
+void profiler_sample(profiler_struct *p, uint32_t pc, uint32_t lr)
+{
+    void *data;
+    profiler_sample_struct *sample;
+
+    if(0U == ringbuf_write_reserve(&p->ring, &data)){
+        p->lost++;
+        return;
+    }
+    sample = (profiler_sample_struct *)data;
+    sample->pc = pc;
+    sample->lr = lr;
+    ringbuf_write_commit(&p->ring, 1U);
+    p->taken++;
+}
+
+/*!
+    \brief      move queued samples into a batch
+    \param[in]  p: profiler
+    \param[in]  size: bytes of out, at least PROFILER_HEADER_SIZE and one sample
+    \param[out] out: the batch
+    \retval     bytes of the batch, 0 when no sample is queued
+*/
+uint32_t profiler_batch(profiler_struct *p, uint8_t *out, uint32_t size)
+{
+    const void *data;
+    const profiler_sample_struct *sample;
+    uint8_t *pos = out + PROFILER_HEADER_SIZE;
+    uint32_t each = (0U != p->with_lr) ? 8U : 4U;
+    uint32_t room = (size - PROFILER_HEADER_SIZE) / each;
+    uint32_t count = 0U;
+    uint32_t n, i, missed;
+
+    if(room > 0xFFFFU){
+        room = 0xFFFFU;
+    }
+    /* the ring may wrap, take its two halves */
+    while(count < room){
+        n = ringbuf_read_reserve(&p->ring, &data);
+        if(0U == n){
+            break;
+        }
+        if(n > room - count){
+            n = room - count;
+        }
+        sample = (const profiler_sample_struct *)data;
+        for(i = 0; i < n; i++){
+            pos = put32(pos, sample[i].pc);
+            if(0U != p->with_lr){
+                pos = put32(pos, sample[i].lr);
+            }
+        }
+        ringbuf_read_commit(&p->ring, n);
+        count += n;
+    }
+
+    if(0U == count){
+        return 0U;
+    }
+    missed = __atomic_load_n(&p->lost, __ATOMIC_RELAXED) + p->skipped;
+    (void)put32(out, PROFILER_MAGIC);
+    out[4] = (uint8_t)count;
+    out[5] = (uint8_t)(count >> 8);
+    out[6] = (uint8_t)((0U != p->with_lr) ? PROFILER_FLAG_LR : 0U);
+    out[7] = 0U;
+    (void)put32(&out[8], missed - p->reported);
+    p->reported = missed;
+    return (uint32_t)(pos - out);
+}
+
+/*!
+    \brief      count a batch that could not be sent, its samples and the losses it reported
+    \param[in]  p: profiler
+    \param[in]  batch: the batch from profiler_batch()
+    \param[out] none
+    \retval     none
+*/
+void profiler_skip(profiler_struct *p, const uint8_t *batch)
+{
+    p->skipped += (uint32_t)batch[4] | ((uint32_t)batch[5] << 8);
+    p->reported -= get32(&batch[8]);
+}
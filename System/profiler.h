@@ -0,0 +1,62 @@
+/*!
+    \file    profiler.h
+    \brief   the header file of the sampling profiler
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include "ringbuf.h"
+
+/* samples the ring holds, a power of two */
+#define PROFILER_RING_SIZE          256U
+/* first word of a batch, "PRF1" in memory */
+#define PROFILER_MAGIC              0x31465250U
+/* bytes of the batch header: magic, count, flags, lost */
+#define PROFILER_HEADER_SIZE        12U
+/* flags of a batch */
+#define PROFILER_FLAG_LR            0x0001U             /*!< every pc is followed by the lr of the frame */
+
+/* one sample, the stacked registers of the interrupted code */
+typedef struct {
+    uint32_t pc;
+    uint32_t lr;
+} profiler_sample_struct;
+
+/* samples on their way from the timer interrupt to the host */
+typedef struct {
+    ringbuf_struct ring;                                /*!< the interrupt writes, the drain reads */
+    profiler_sample_struct samples[PROFILER_RING_SIZE];
+    uint32_t with_lr;                                   /*!< send the lr of each sample too */
+    uint32_t taken;                                     /*!< samples written, by the interrupt */
+    uint32_t lost;                                      /*!< samples lost to a full ring, by the interrupt */
+    uint32_t skipped;                                   /*!< samples of batches the channel had no room for, by the drain */
+    uint32_t reported;                                  /*!< lost and skipped samples told to the host */
+} profiler_struct;
+
+/* the profiler of the board */
+extern profiler_struct profiler;
+
+/* empty the ring, with_lr selects sending the lr of each sample */
+void profiler_init(profiler_struct *p, int with_lr);
+/* take a sample, from the sampling interrupt */
+void profiler_sample(profiler_struct *p, uint32_t pc, uint32_t lr);
+/* move queued samples into a batch of at most size bytes, returns its bytes, 0 when none */
+uint32_t profiler_batch(profiler_struct *p, uint8_t *out, uint32_t size);
+/* count a batch that could not be sent, the next one reports its samples as lost */
+void profiler_skip(profiler_struct *p, const uint8_t *batch);
+
+/* target functions, profiler_port.c */
+/* sample hz times per second on TIMER6, with_lr to send the caller too */
+void profiler_port_start(uint32_t hz, int with_lr);
+/* stop sampling */
+void profiler_port_stop(void);
+/* send the queued samples on the profile RTT channel, from the event loop */
+void profiler_port_drain(void);
+/* print the sample counts over RTT */
+void profiler_port_print(void);
+
+#endif /* PROFILER_H */
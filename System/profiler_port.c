@@ -0,0 +1,151 @@
+/*!
+    \file    profiler_port.c
+    \brief   sampling profiler on the target
+
+    TIMER6, a basic timer no peripheral needs, counts at 1 MHz and
+    interrupts at the sampling rate at priority 0, shared only with
+    SysTick, so the other handlers are sampled too. Its handler
+    finds the exception frame on the stack the interrupted code used,
+    the process stack of a thread or the main stack of a handler, and
+    takes the pc and lr stacked in it. Code running with interrupts
+    masked is sampled when it unmasks them, at the instruction after.
+
+    The samples go out on their own RTT up-channel in the skip mode,
+    so a host that does not read it never slows the board down: a
+    batch that does not fit is dropped whole and reported lost. The
+    channel is read raw by the debug probe, for instance with
+    "JLinkRTTLogger -RTTChannel 1" or the "rtt server start" of OpenOCD,
+    and the file goes to tools/profile_symbolize.py.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "profiler.h"
+#include "SEGGER_RTT.h"
+
+/* up-channel of the samples, 0 is the terminal */
+#define PROFILER_RTT_CHANNEL        1U
+/* bytes of the channel, four 10 ms drains of 10 kHz samples with the lr */
+#define PROFILER_RTT_SIZE           4096U
+/* bytes of one batch */
+#define PROFILER_BATCH_SIZE         (PROFILER_HEADER_SIZE + 64U * 8U)
+/* counting rate of the timer */
+#define PROFILER_TIMER_HZ           1000000U
+
+static uint8_t rtt_buffer[PROFILER_RTT_SIZE];
+static uint8_t batch[PROFILER_BATCH_SIZE];
+
+/*!
+    \brief      take a sample from the frame of the interrupted code, reached from TIMER6_IRQHandler()
+    \param[in]  frame: r0, r1, r2, r3, r12, lr, pc, xpsr of the interrupted code
+    \param[out] none
+    \retval     none
+*/
+__attribute__((used)) void profiler_port_irq(const uint32_t *frame)
+{
+    timer_interrupt_flag_clear(TIMER6, TIMER_INT_FLAG_UP);
+    profiler_sample(&profiler, frame[6], frame[5]);
+}
+
+/*!
+    \brief      find the exception frame and sample it
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((naked)) void TIMER6_IRQHandler(void)
+{
+    __ASM volatile(
+        "   tst     lr, #4                  \n" /* the frame is on the process stack */
+        "   ite     eq                      \n"
+        "   mrseq   r0, msp                 \n"
+        "   mrsne   r0, psp                 \n"
+        "   b       profiler_port_irq       \n" /* returns with the EXC_RETURN in lr */
+    );
+}
+
+/* get the counter clock of the APB1 timers, RCU_TIMER_PSC_MUL2 */
+static uint32_t timer_clock(void)
+{
+    uint32_t ahb = rcu_clock_freq_get(CK_AHB);
+    uint32_t apb1 = rcu_clock_freq_get(CK_APB1);
+
+    return (apb1 * 2U < ahb) ? apb1 * 2U : ahb;
+}
+
+/*!
+    \brief      sample at a fixed rate on TIMER6
+    \param[in]  hz: samples per second, 16 .. 100000
+    \param[in]  with_lr: non-zero to send the lr of each sample, for a level of callers
+    \param[out] none
+    \retval     none
+*/
+void profiler_port_start(uint32_t hz, int with_lr)
+{
+    timer_parameter_struct timer;
+
+    profiler_port_stop();
+    profiler_init(&profiler, with_lr);
+    SEGGER_RTT_ConfigUpBuffer(PROFILER_RTT_CHANNEL, "profile", rtt_buffer, sizeof(rtt_buffer),
+                              SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+
+    rcu_periph_clock_enable(RCU_TIMER6);
+    timer_deinit(TIMER6);
+    timer_struct_para_init(&timer);
+    timer.prescaler = (uint16_t)(timer_clock() / PROFILER_TIMER_HZ - 1U);
+    timer.alignedmode = TIMER_COUNTER_EDGE;
+    timer.counterdirection = TIMER_COUNTER_UP;
+    timer.clockdivision = TIMER_CKDIV_DIV1;
+    timer.period = PROFILER_TIMER_HZ / hz - 1U;
+    timer_init(TIMER6, &timer);
+
+    timer_interrupt_flag_clear(TIMER6, TIMER_INT_FLAG_UP);
+    timer_interrupt_enable(TIMER6, TIMER_INT_UP);
+    nvic_irq_enable(TIMER6_IRQn, 0U, 0U);
+    timer_enable(TIMER6);
+}
+
+/*!
+    \brief      stop sampling, the samples queued can still be drained
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void profiler_port_stop(void)
+{
+    nvic_irq_disable(TIMER6_IRQn);
+    timer_disable(TIMER6);
+}
+
+/*!
+    \brief      send the queued samples on the profile RTT channel, from the event loop
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void profiler_port_drain(void)
+{
+    uint32_t size;
+
+    for(;;){
+        size = profiler_batch(&profiler, batch, sizeof(batch));
+        if(0U == size){
+            break;
+        }
+        if(0U == SEGGER_RTT_Write(PROFILER_RTT_CHANNEL, batch, size)){
+            profiler_skip(&profiler, batch);
+        }
+    }
+}
+
+/*!
+    \brief      print the sample counts over RTT
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void profiler_port_print(void)
+{
+    SEGGER_RTT_printf(0, "profiler taken=%u lost=%u skipped=%u\n", profiler.taken, profiler.lost, profiler.skipped);
+}
@@ -0,0 +1,369 @@
+/*!
+    \file    ringbuf.h
+    \brief   lock-free ring buffers
+
+    ringbuf_struct is a ring of fixed size elements, bytes when the size
+    is 1, for one producer and one consumer, typically an interrupt and
+    a thread. The producer only writes head and the consumer only tail,
+    both free running, so neither needs a lock. Elements are copied in
+    and out in bulk, or written and read in place: reserve returns the
+    contiguous part of the free or filled space and commit hands it
+    over.
+
+    ringbuf_mpsc_struct takes any number of producers and one consumer.
+    Each cell has a sequence number saying whether it is free for the
+    producer of a given turn or filled for the consumer. A producer
+    claims a cell by advancing head with LDREX/STREX on the target and
+    a C11 compare-and-swap on the host, fills it and publishes it
+    through the sequence number. An interrupt between LDREX and STREX
+    clears the exclusive monitor, so the STREX fails and the claim is
+    tried again. The consumer sees a claimed but unpublished cell as
+    empty until the producer that claimed it has finished.
+
+    On the target the rings assume one core, where keeping the compiler
+    from reordering the accesses is enough. The host build uses C11
+    atomics with acquire and release, so the rings can be tested with
+    threads.
+
+    The number of elements of both rings is a power of two.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef RINGBUF_H
+#define RINGBUF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define RINGBUF_TARGET              1
+#else
+#define RINGBUF_TARGET              0
+#include <stdatomic.h>
+#endif
+
+#if RINGBUF_TARGET
+typedef volatile uint32_t ringbuf_atomic_t;
+#define RINGBUF_LOAD_ACQUIRE(p)     ringbuf_load_acquire(p)
+#define RINGBUF_STORE_RELEASE(p, v) ringbuf_store_release((p), (v))
+#else
+typedef _Atomic uint32_t ringbuf_atomic_t;
+#define RINGBUF_LOAD_ACQUIRE(p)     atomic_load_explicit((p), memory_order_acquire)
+#define RINGBUF_STORE_RELEASE(p, v) atomic_store_explicit((p), (v), memory_order_release)
+#endif
+
+/* ring for one producer and one consumer */
+typedef struct {
+    uint8_t *buffer;                                    /*!< count * size bytes */
+    uint32_t mask;                                      /*!< count - 1 */
+    uint32_t size;                                      /*!< bytes of an element */
+    ringbuf_atomic_t head;                              /*!< elements written, by the producer only */
+    ringbuf_atomic_t tail;                              /*!< elements read, by the consumer only */
+} ringbuf_struct;
+
+/* ring for many producers and one consumer */
+typedef struct {
+    ringbuf_atomic_t *seq;                              /*!< count sequence numbers */
+    uint8_t *buffer;                                    /*!< count * size bytes */
+    uint32_t mask;                                      /*!< count - 1 */
+    uint32_t size;                                      /*!< bytes of an element */
+    ringbuf_atomic_t head;                              /*!< next cell to claim */
+    uint32_t tail;                                      /*!< next cell to take, by the consumer only */
+} ringbuf_mpsc_struct;
+
+#if RINGBUF_TARGET
+/* load that later accesses are not moved above, one core */
+static inline uint32_t ringbuf_load_acquire(ringbuf_atomic_t *p)
+{
+    uint32_t value = *p;
+
+    __atomic_signal_fence(__ATOMIC_ACQUIRE);
+    return value;
+}
+
+/* store that earlier accesses are not moved below, one core */
+static inline void ringbuf_store_release(ringbuf_atomic_t *p, uint32_t value)
+{
+    __atomic_signal_fence(__ATOMIC_RELEASE);
+    *p = value;
+}
+
+/* claim the cell at head by advancing head, return 1 when claimed and the position in pos */
+static inline int ringbuf_mpsc_claim(ringbuf_mpsc_struct *ring, uint32_t *pos)
+{
+    uint32_t head, failed;
+    int32_t diff;
+
+    for(;;){
+        __asm volatile("ldrex %0, [%1]" : "=r"(head) : "r"(&ring->head) : "memory");
+        diff = (int32_t)(ring->seq[head & ring->mask] - head);
+        if(diff < 0){
+            /* the consumer has not taken the cell since the last turn */
+            __asm volatile("clrex" ::: "memory");
+            return 0;
+        }
+        if(diff > 0){
+            __asm volatile("clrex" ::: "memory");
+            continue;
+        }
+        __asm volatile("strex %0, %2, [%1]" : "=&r"(failed) : "r"(&ring->head), "r"(head + 1U) : "memory");
+        if(0U == failed){
+            *pos = head;
+            return 1;
+        }
+    }
+}
+#else
+/* claim the cell at head by advancing head, return 1 when claimed and the position in pos */
+static inline int ringbuf_mpsc_claim(ringbuf_mpsc_struct *ring, uint32_t *pos)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    int32_t diff;
+
+    for(;;){
+        diff = (int32_t)(RINGBUF_LOAD_ACQUIRE(&ring->seq[head & ring->mask]) - head);
+        if(diff < 0){
+            return 0;
+        }
+        if(0 == diff){
+            if(atomic_compare_exchange_weak_explicit(&ring->head, &head, head + 1U, memory_order_relaxed,
+                                                     memory_order_relaxed)){
+                *pos = head;
+                return 1;
+            }
+        }else{
+            head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+}
+#endif
+
+/*!
+    \brief      set up an empty ring
+    \param[in]  ring: ring
+    \param[in]  buffer: count * size bytes
+    \param[in]  count: elements, a power of two
+    \param[in]  size: bytes of an element
+    \param[out] none
+    \retval     none
+*/
+static inline void ringbuf_init(ringbuf_struct *ring, void *buffer, uint32_t count, uint32_t size)
+{
+    ring->buffer = (uint8_t *)buffer;
+    ring->mask = count - 1U;
+    ring->size = size;
+    ring->head = 0U;
+    ring->tail = 0U;
+}
+
+/* elements the consumer can read */
+static inline uint32_t ringbuf_count(ringbuf_struct *ring)
+{
+    return RINGBUF_LOAD_ACQUIRE(&ring->head) - ring->tail;
+}
+
+/* elements the producer can write */
+static inline uint32_t ringbuf_space(ringbuf_struct *ring)
+{
+    return ring->mask + 1U - (ring->head - RINGBUF_LOAD_ACQUIRE(&ring->tail));
+}
+
+/*!
+    \brief      get the contiguous free space, from the producer
+    \param[in]  ring: ring
+    \param[out] data: first free element
+    \retval     elements that can be written at data before ringbuf_write_commit()
+*/
+static inline uint32_t ringbuf_write_reserve(ringbuf_struct *ring, void **data)
+{
+    uint32_t head = ring->head;
+    uint32_t index = head & ring->mask;
+    uint32_t space = ring->mask + 1U - (head - RINGBUF_LOAD_ACQUIRE(&ring->tail));
+    uint32_t to_end = ring->mask + 1U - index;
+
+    *data = &ring->buffer[index * ring->size];
+    return (space < to_end) ? space : to_end;
+}
+
+/* hand count elements written in place to the consumer, at most what was reserved */
+static inline void ringbuf_write_commit(ringbuf_struct *ring, uint32_t count)
+{
+    RINGBUF_STORE_RELEASE(&ring->head, ring->head + count);
+}
+
+/*!
+    \brief      get the contiguous filled space, from the consumer
+    \param[in]  ring: ring
+    \param[out] data: first element to read
+    \retval     elements that can be read at data before ringbuf_read_commit()
+*/
+static inline uint32_t ringbuf_read_reserve(ringbuf_struct *ring, const void **data)
+{
+    uint32_t tail = ring->tail;
+    uint32_t index = tail & ring->mask;
+    uint32_t count = RINGBUF_LOAD_ACQUIRE(&ring->head) - tail;
+    uint32_t to_end = ring->mask + 1U - index;
+
+    *data = &ring->buffer[index * ring->size];
+    return (count < to_end) ? count : to_end;
+}
+
+/* give count elements read in place back to the producer, at most what was reserved */
+static inline void ringbuf_read_commit(ringbuf_struct *ring, uint32_t count)
+{
+    RINGBUF_STORE_RELEASE(&ring->tail, ring->tail + count);
+}
+
+/*!
+    \brief      write as many elements as fit, from the producer
+    \param[in]  ring: ring
+    \param[in]  data: elements
+    \param[in]  count: elements to write
+    \param[out] none
+    \retval     elements written
+*/
+static inline uint32_t ringbuf_write(ringbuf_struct *ring, const void *data, uint32_t count)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    uint32_t head = ring->head;
+    uint32_t index = head & ring->mask;
+    uint32_t space = ring->mask + 1U - (head - RINGBUF_LOAD_ACQUIRE(&ring->tail));
+    uint32_t first;
+
+    if(count > space){
+        count = space;
+    }
+    first = ring->mask + 1U - index;
+    if(first > count){
+        first = count;
+    }
+    memcpy(&ring->buffer[index * ring->size], src, first * ring->size);
+    memcpy(ring->buffer, &src[first * ring->size], (count - first) * ring->size);
+    RINGBUF_STORE_RELEASE(&ring->head, head + count);
+    return count;
+}
+
+/*!
+    \brief      read as many elements as there are, from the consumer
+    \param[in]  ring: ring
+    \param[in]  count: elements to read at most
+    \param[out] data: elements
+    \retval     elements read
+*/
+static inline uint32_t ringbuf_read(ringbuf_struct *ring, void *data, uint32_t count)
+{
+    uint8_t *dst = (uint8_t *)data;
+    uint32_t tail = ring->tail;
+    uint32_t index = tail & ring->mask;
+    uint32_t used = RINGBUF_LOAD_ACQUIRE(&ring->head) - tail;
+    uint32_t first;
+
+    if(count > used){
+        count = used;
+    }
+    first = ring->mask + 1U - index;
+    if(first > count){
+        first = count;
+    }
+    memcpy(dst, &ring->buffer[index * ring->size], first * ring->size);
+    memcpy(&dst[first * ring->size], ring->buffer, (count - first) * ring->size);
+    RINGBUF_STORE_RELEASE(&ring->tail, tail + count);
+    return count;
+}
+
+/*!
+    \brief      set up an empty ring
+    \param[in]  ring: ring
+    \param[in]  seq: count sequence numbers
+    \param[in]  buffer: count * size bytes
+    \param[in]  count: elements, a power of two
+    \param[in]  size: bytes of an element
+    \param[out] none
+    \retval     none
+*/
+static inline void ringbuf_mpsc_init(ringbuf_mpsc_struct *ring, ringbuf_atomic_t *seq, void *buffer, uint32_t count,
+                                     uint32_t size)
+{
+    uint32_t i;
+
+    for(i = 0; i < count; i++){
+        seq[i] = i;
+    }
+    ring->seq = seq;
+    ring->buffer = (uint8_t *)buffer;
+    ring->mask = count - 1U;
+    ring->size = size;
+    ring->head = 0U;
+    ring->tail = 0U;
+}
+
+/*!
+    \brief      claim a cell to fill in place, from any context
+    \param[in]  ring: ring
+    \param[out] pos: position of the cell, for ringbuf_mpsc_publish()
+    \retval     the cell, NULL when the ring is full
+*/
+static inline void *ringbuf_mpsc_reserve(ringbuf_mpsc_struct *ring, uint32_t *pos)
+{
+    if(!ringbuf_mpsc_claim(ring, pos)){
+        return NULL;
+    }
+    return &ring->buffer[(*pos & ring->mask) * ring->size];
+}
+
+/* hand a cell filled in place to the consumer, pos from ringbuf_mpsc_reserve() */
+static inline void ringbuf_mpsc_publish(ringbuf_mpsc_struct *ring, uint32_t pos)
+{
+    RINGBUF_STORE_RELEASE(&ring->seq[pos & ring->mask], pos + 1U);
+}
+
+/*!
+    \brief      add an element, from any context
+    \param[in]  ring: ring
+    \param[in]  data: element
+    \param[out] none
+    \retval     0, -1 when the ring is full
+*/
+static inline int ringbuf_mpsc_put(ringbuf_mpsc_struct *ring, const void *data)
+{
+    uint32_t pos;
+    void *cell = ringbuf_mpsc_reserve(ring, &pos);
+
+    if(NULL == cell){
+        return -1;
+    }
+    memcpy(cell, data, ring->size);
+    ringbuf_mpsc_publish(ring, pos);
+    return 0;
+}
+
+/* check whether the consumer has an element to take */
+static inline int ringbuf_mpsc_ready(ringbuf_mpsc_struct *ring)
+{
+    return RINGBUF_LOAD_ACQUIRE(&ring->seq[ring->tail & ring->mask]) == ring->tail + 1U;
+}
+
+/*!
+    \brief      take the oldest element, from the consumer
+    \param[in]  ring: ring
+    \param[out] data: element
+    \retval     0, -1 when there is none
+*/
+static inline int ringbuf_mpsc_get(ringbuf_mpsc_struct *ring, void *data)
+{
+    uint32_t tail = ring->tail;
+    uint32_t index = tail & ring->mask;
+
+    if(RINGBUF_LOAD_ACQUIRE(&ring->seq[index]) != tail + 1U){
+        return -1;
+    }
+    memcpy(data, &ring->buffer[index * ring->size], ring->size);
+    /* hand the cell to the producer of the next turn */
+    RINGBUF_STORE_RELEASE(&ring->seq[index], tail + ring->mask + 1U);
+    ring->tail = tail + 1U;
+    return 0;
+}
+
+#endif /* RINGBUF_H */
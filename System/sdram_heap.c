@@ -0,0 +1,96 @@
+/*!
+    \file    sdram_heap.c
+    \brief   SDRAM heap
+
+    Buffers that are too large for the internal SRAM, decoded images and
+    scratch surfaces, come from the part of the SDRAM the linker leaves
+    after .sdram. Calls mask interrupts so an interrupt handler can free
+    a buffer it was handed.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "sdram_heap.h"
+
+/* defined in link.ld */
+extern uint8_t _sdram_heap_start[];
+extern uint8_t _sdram_heap_end[];
+
+static tlsf_struct sdram_heap;
+
+/*!
+    \brief      hand the SDRAM above .sdram to the heap
+    \param[in]  none
+    \param[out] none
+    \retval     0 on success, -1 when the region cannot be used
+*/
+int sdram_heap_init(void)
+{
+    return tlsf_init(&sdram_heap, _sdram_heap_start, (size_t)(_sdram_heap_end - _sdram_heap_start));
+}
+
+/*!
+    \brief      allocate a block
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     word aligned block, NULL when none is large enough
+*/
+void *sdram_malloc(size_t size)
+{
+    uint32_t state = __get_PRIMASK();
+    void *ptr;
+
+    __disable_irq();
+    ptr = tlsf_malloc(&sdram_heap, size);
+    __set_PRIMASK(state);
+    return ptr;
+}
+
+/*!
+    \brief      allocate an aligned block
+    \param[in]  align: power of two
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     block, NULL when none is large enough
+*/
+void *sdram_memalign(size_t align, size_t size)
+{
+    uint32_t state = __get_PRIMASK();
+    void *ptr;
+
+    __disable_irq();
+    ptr = tlsf_memalign(&sdram_heap, align, size);
+    __set_PRIMASK(state);
+    return ptr;
+}
+
+/*!
+    \brief      release a block
+    \param[in]  ptr: block returned by sdram_malloc() or sdram_memalign(), NULL is ignored
+    \param[out] none
+    \retval     none
+*/
+void sdram_free(void *ptr)
+{
+    uint32_t state = __get_PRIMASK();
+
+    __disable_irq();
+    tlsf_free(&sdram_heap, ptr);
+    __set_PRIMASK(state);
+}
+
+/*!
+    \brief      get the statistics
+    \param[in]  none
+    \param[out] stats: statistics
+    \retval     none
+*/
+void sdram_heap_stats_get(tlsf_stats_struct *stats)
+{
+    uint32_t state = __get_PRIMASK();
+
+    __disable_irq();
+    tlsf_stats_get(&sdram_heap, stats);
+    __set_PRIMASK(state);
+}
@@ -0,0 +1,25 @@
+/*!
+    \file    sdram_heap.h
+    \brief   the header file of the SDRAM heap
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef SDRAM_HEAP_H
+#define SDRAM_HEAP_H
+
+#include <stddef.h>
+#include "tlsf.h"
+
+/* hand the SDRAM above .sdram to the heap, return 0 on success */
+int sdram_heap_init(void);
+/* allocate a block, NULL when none is large enough */
+void *sdram_malloc(size_t size);
+/* allocate a block aligned to align, a power of two */
+void *sdram_memalign(size_t align, size_t size);
+/* release a block, NULL is ignored */
+void sdram_free(void *ptr);
+/* get the statistics */
+void sdram_heap_stats_get(tlsf_stats_struct *stats);
+
+#endif /* SDRAM_HEAP_H */
@@ -0,0 +1,267 @@
+/*!
+    \file    soft_timer.c
+    \brief   software timers on a hierarchical timing wheel
+
+    Level 0 has one slot per tick, each higher level one slot per full
+    turn of the level below. A timer goes in the lowest level its delay
+    fits, into the slot of its expiry tick, so starting and stopping is
+    a list insert or unlink. When level 0 wraps, the next slot of level
+    1 is emptied and its timers are put back, now on level 0, and so on
+    up. A timer is moved at most once per level on its way down.
+
+    The tick interrupt only counts. soft_timer_run() walks the wheel up
+    to the count from the main loop and runs the callbacks there, so
+    callbacks may start and stop timers and take as long as they need.
+    Timers are started and stopped from that same context only.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "soft_timer.h"
+
+#define SLOT_MASK                   (SOFT_TIMER_SLOTS - 1U)
+
+soft_timer_wheel_struct soft_timers;
+
+/* empty a list */
+static void list_init(soft_timer_list_struct *list)
+{
+    list->next = list;
+    list->prev = list;
+}
+
+/* add a node at the end of a list */
+static void list_add(soft_timer_list_struct *list, soft_timer_list_struct *node)
+{
+    node->prev = list->prev;
+    node->next = list;
+    list->prev->next = node;
+    list->prev = node;
+}
+
+/* take a node out of its list */
+static void list_del(soft_timer_list_struct *node)
+{
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+/* move every node of a list to an empty one */
+static void list_move(soft_timer_list_struct *from, soft_timer_list_struct *to)
+{
+    if(from->next == from){
+        list_init(to);
+        return;
+    }
+    to->next = from->next;
+    to->prev = from->prev;
+    to->next->prev = to;
+    to->prev->next = to;
+    list_init(from);
+}
+
+/*!
+    \brief      put a timer in the slot of its expiry tick
+    \param[in]  wheel: wheel
+    \param[in]  timer: timer with expires set, not in a list
+    \param[out] none
+    \retval     none
+*/
+static void wheel_insert(soft_timer_wheel_struct *wheel, soft_timer_struct *timer)
+{
+    uint32_t delta = timer->expires - wheel->now;
+    uint32_t expires = timer->expires;
+    uint32_t level;
+
+    /* further than the wheel reaches, park it in the last slot it does */
+    if(delta > SOFT_TIMER_RANGE){
+        delta = SOFT_TIMER_RANGE;
+        expires = wheel->now + SOFT_TIMER_RANGE;
+    }
+    for(level = 0; level < SOFT_TIMER_LEVELS - 1U; level++){
+        if(delta < (1UL << (SOFT_TIMER_SLOT_BITS * (level + 1U)))){
+            break;
+        }
+    }
+    list_add(&wheel->slots[level][(expires >> (SOFT_TIMER_SLOT_BITS * level)) & SLOT_MASK], &timer->node);
+}
+
+/*!
+    \brief      empty a wheel and start it at the ticks already counted
+    \param[in]  wheel: wheel
+    \param[out] none
+    \retval     none
+*/
+void soft_timer_wheel_init(soft_timer_wheel_struct *wheel)
+{
+    uint32_t level, slot;
+
+    for(level = 0; level < SOFT_TIMER_LEVELS; level++){
+        for(slot = 0; slot < SOFT_TIMER_SLOTS; slot++){
+            list_init(&wheel->slots[level][slot]);
+        }
+    }
+    wheel->now = wheel->ticks;
+    wheel->fired = 0;
+}
+
+/*!
+    \brief      set up a stopped timer
+    \param[in]  timer: timer
+    \param[in]  callback: function run when the timer fires
+    \param[in]  arg: passed to callback
+    \param[out] none
+    \retval     none
+*/
+void soft_timer_init(soft_timer_struct *timer, soft_timer_cb callback, void *arg)
+{
+    timer->node.next = NULL;
+    timer->node.prev = NULL;
+    timer->expires = 0;
+    timer->period = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+/*!
+    \brief      (re)start a timer
+    \param[in]  wheel: wheel
+    \param[in]  timer: timer set up by soft_timer_init()
+    \param[in]  delay: ticks to the first firing, 0 is taken as 1
+    \param[in]  period: ticks between later firings, 0 for one-shot
+    \param[out] none
+    \retval     none
+*/
+void soft_timer_start(soft_timer_wheel_struct *wheel, soft_timer_struct *timer, uint32_t delay, uint32_t period)
+{
+    soft_timer_stop(timer);
+    /* the slot of the current tick has been processed already */
+    timer->expires = wheel->now + ((0U == delay) ? 1U : delay);
+    timer->period = period;
+    wheel_insert(wheel, timer);
+}
+
+/*!
+    \brief      stop a timer
+    \param[in]  timer: timer
+    \param[out] none
+    \retval     none
+*/
+void soft_timer_stop(soft_timer_struct *timer)
+{
+    if(NULL != timer->node.next){
+        list_del(&timer->node);
+    }
+}
+
+/*!
+    \brief      check whether a timer is started
+    \param[in]  timer: timer
+    \param[out] none
+    \retval     1 while started, 0 otherwise
+*/
+int soft_timer_active(const soft_timer_struct *timer)
+{
+    return (NULL != timer->node.next) ? 1 : 0;
+}
+
+/*!
+    \brief      count one tick
+    \param[in]  wheel: wheel
+    \param[out] none
+    \retval     none
+*/
+void soft_timer_tick(soft_timer_wheel_struct *wheel)
+{
+    wheel->ticks = wheel->ticks + 1U;
+}
+
+/*!
+    \brief      put the timers of the current slot of a level back on the wheel
+    \param[in]  wheel: wheel
+    \param[in]  level: 1 .. SOFT_TIMER_LEVELS - 1
+    \param[out] none
+    \retval     none
+*/
+static void wheel_cascade(soft_timer_wheel_struct *wheel, uint32_t level)
+{
+    soft_timer_list_struct pending;
+    soft_timer_list_struct *node;
+    uint32_t slot = (wheel->now >> (SOFT_TIMER_SLOT_BITS * level)) & SLOT_MASK;
+
+    list_move(&wheel->slots[level][slot], &pending);
+    while(pending.next != &pending){
+        node = pending.next;
+        list_del(node);
+        wheel_insert(wheel, (soft_timer_struct *)node);
+    }
+}
+
+/*!
+    \brief      process the counted ticks and run the callbacks due
+    \param[in]  wheel: wheel
+    \param[out] none
+    \retval     callbacks run
+*/
+uint32_t soft_timer_run(soft_timer_wheel_struct *wheel)
+{
+    soft_timer_list_struct expired;
+    soft_timer_struct *timer;
+    uint32_t target = wheel->ticks;
+    uint32_t level, fired = 0;
+
+    while(wheel->now != target){
+        wheel->now++;
+
+        /* a level wraps to 0, move down the next slot of the level above */
+        for(level = 1; level < SOFT_TIMER_LEVELS; level++){
+            if(0U != ((wheel->now >> (SOFT_TIMER_SLOT_BITS * (level - 1U))) & SLOT_MASK)){
+                break;
+            }
+            wheel_cascade(wheel, level);
+        }
+
+        list_move(&wheel->slots[0][wheel->now & SLOT_MASK], &expired);
+        while(expired.next != &expired){
+            timer = (soft_timer_struct *)expired.next;
+            list_del(&timer->node);
+            if(0U != timer->period){
+                timer->expires += timer->period;
+                wheel_insert(wheel, timer);
+            }
+            fired++;
+            timer->callback(timer, timer->arg);
+        }
+    }
+    wheel->fired += fired;
+    return fired;
+}
+
+/*!
+    \brief      get the ticks the wheel can go without being run
+    \param[in]  wheel: wheel
+    \param[out] none
+    \retval     ticks to the next firing or level 0 wrap, 0 when ticks wait to be processed
+*/
+uint32_t soft_timer_next(const soft_timer_wheel_struct *wheel)
+{
+    const soft_timer_list_struct *slot;
+    uint32_t i, tick;
+
+    if(wheel->ticks != wheel->now){
+        return 0U;
+    }
+    /* level 0 holds the next SOFT_TIMER_SLOTS ticks, the levels above
+       only come down when it wraps, so that tick ends the search */
+    for(i = 1U; i < SOFT_TIMER_SLOTS; i++){
+        tick = wheel->now + i;
+        slot = &wheel->slots[0][tick & SLOT_MASK];
+        if((0U == (tick & SLOT_MASK)) || (slot->next != slot)){
+            break;
+        }
+    }
+    return i;
+}
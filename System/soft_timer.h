@@ -0,0 +1,66 @@
+/*!
+    \file    soft_timer.h
+    \brief   the header file of the software timers
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef SOFT_TIMER_H
+#define SOFT_TIMER_H
+
+#include <stdint.h>
+
+/* wheel geometry, SOFT_TIMER_LEVELS levels of 2^SOFT_TIMER_SLOT_BITS slots */
+#define SOFT_TIMER_SLOT_BITS        6U
+#define SOFT_TIMER_SLOTS            (1UL << SOFT_TIMER_SLOT_BITS)
+#define SOFT_TIMER_LEVELS           4U
+/* longest delay the wheel holds directly, longer ones are moved down again when they come near */
+#define SOFT_TIMER_RANGE            ((1UL << (SOFT_TIMER_SLOT_BITS * SOFT_TIMER_LEVELS)) - 1U)
+
+typedef struct soft_timer_list_struct soft_timer_list_struct;
+typedef struct soft_timer_struct soft_timer_struct;
+
+/* called from soft_timer_run(), never from the tick interrupt */
+typedef void (*soft_timer_cb)(soft_timer_struct *timer, void *arg);
+
+struct soft_timer_list_struct {
+    soft_timer_list_struct *next;
+    soft_timer_list_struct *prev;
+};
+
+struct soft_timer_struct {
+    soft_timer_list_struct node;                        /*!< slot link, next is NULL while stopped */
+    uint32_t expires;                                   /*!< tick it fires at */
+    uint32_t period;                                    /*!< ticks between firings, 0 for one-shot */
+    soft_timer_cb callback;
+    void *arg;
+};
+
+typedef struct {
+    soft_timer_list_struct slots[SOFT_TIMER_LEVELS][SOFT_TIMER_SLOTS];
+    volatile uint32_t ticks;                            /*!< ticks counted by soft_timer_tick() */
+    uint32_t now;                                       /*!< ticks processed by soft_timer_run() */
+    uint32_t fired;                                     /*!< callbacks run */
+} soft_timer_wheel_struct;
+
+/* the wheel driven by SysTick, one tick per millisecond */
+extern soft_timer_wheel_struct soft_timers;
+
+/* empty a wheel and start it at the ticks already counted */
+void soft_timer_wheel_init(soft_timer_wheel_struct *wheel);
+/* set up a stopped timer */
+void soft_timer_init(soft_timer_struct *timer, soft_timer_cb callback, void *arg);
+/* (re)start a timer delay ticks from now, then every period ticks unless period is 0 */
+void soft_timer_start(soft_timer_wheel_struct *wheel, soft_timer_struct *timer, uint32_t delay, uint32_t period);
+/* stop a timer, stopping a stopped one does nothing */
+void soft_timer_stop(soft_timer_struct *timer);
+/* check whether a timer is started */
+int soft_timer_active(const soft_timer_struct *timer);
+/* count one tick, from the tick interrupt */
+void soft_timer_tick(soft_timer_wheel_struct *wheel);
+/* process the counted ticks and run the callbacks due, return the number run */
+uint32_t soft_timer_run(soft_timer_wheel_struct *wheel);
+/* get the ticks the wheel can go without being run, at most SOFT_TIMER_SLOTS */
+uint32_t soft_timer_next(const soft_timer_wheel_struct *wheel);
+
+#endif /* SOFT_TIMER_H */
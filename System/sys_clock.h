@@ -0,0 +1,119 @@
+/*!
+    \file    sys_clock.h
+    \brief   the header file of the 64-bit monotonic clock
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef SYS_CLOCK_H
+#define SYS_CLOCK_H
+
+#include <stdint.h>
+
+/* free running 32-bit cycle counter, DWT CYCCNT unless a test provides one */
+#ifndef SYS_CLOCK_COUNTER
+#define SYS_CLOCK_COUNTER()         (*(volatile uint32_t *)0xE0001004UL)
+#endif
+
+/* the clock at one tick */
+typedef struct {
+    uint64_t cycles;                                    /*!< cycles from sys_clock_init() to the tick */
+    uint32_t last;                                      /*!< counter read by the tick */
+} sys_clock_epoch_struct;
+
+typedef struct {
+    sys_clock_epoch_struct epochs[2];                   /*!< written in turn, epochs[gen & 1] is the current one */
+    volatile uint32_t gen;                              /*!< epochs written */
+    uint32_t hz;                                        /*!< counter frequency */
+} sys_clock_struct;
+
+/* the clock over the core cycles */
+extern sys_clock_struct sys_clock;
+
+/* start the clock at the counter value, hz is the counter frequency */
+void sys_clock_init(uint32_t hz);
+/* take a new epoch, at least once per counter wrap and from one context only */
+void sys_clock_tick(void);
+
+/*!
+    \brief      read the clock
+    \param[in]  none
+    \param[out] none
+    \retval     counter cycles since sys_clock_init()
+*/
+static inline uint64_t sys_clock_cycles(void)
+{
+    const sys_clock_epoch_struct *epoch;
+    uint64_t cycles;
+    uint32_t gen, last, now;
+
+    /* a tick between reading the epoch and the counter shows as a new gen */
+    do{
+        gen = sys_clock.gen;
+        __atomic_signal_fence(__ATOMIC_ACQUIRE);
+        epoch = &sys_clock.epochs[gen & 1U];
+        cycles = epoch->cycles;
+        last = epoch->last;
+        now = SYS_CLOCK_COUNTER();
+        __atomic_signal_fence(__ATOMIC_ACQUIRE);
+    }while(gen != sys_clock.gen);
+
+    return cycles + (uint32_t)(now - last);
+}
+
+/*!
+    \brief      convert cycles to microseconds, rounded down
+    \param[in]  cycles: counter cycles
+    \param[out] none
+    \retval     microseconds
+*/
+static inline uint64_t sys_clock_cycles_to_us(uint64_t cycles)
+{
+    uint32_t hz = sys_clock.hz;
+
+    return (cycles / hz) * 1000000U + ((cycles % hz) * 1000000U) / hz;
+}
+
+/*!
+    \brief      convert cycles to milliseconds, rounded down
+    \param[in]  cycles: counter cycles
+    \param[out] none
+    \retval     milliseconds
+*/
+static inline uint64_t sys_clock_cycles_to_ms(uint64_t cycles)
+{
+    uint32_t hz = sys_clock.hz;
+
+    return (cycles / hz) * 1000U + ((cycles % hz) * 1000U) / hz;
+}
+
+/*!
+    \brief      convert microseconds to cycles, rounded down
+    \param[in]  us: microseconds
+    \param[out] none
+    \retval     counter cycles
+*/
+static inline uint64_t sys_clock_us_to_cycles(uint64_t us)
+{
+    uint32_t hz = sys_clock.hz;
+
+    return (us / 1000000U) * hz + ((us % 1000000U) * hz) / 1000000U;
+}
+
+/* read the clock in microseconds */
+static inline uint64_t sys_clock_us(void)
+{
+    return sys_clock_cycles_to_us(sys_clock_cycles());
+}
+
+/* read the clock in milliseconds */
+static inline uint64_t sys_clock_ms(void)
+{
+    return sys_clock_cycles_to_ms(sys_clock_cycles());
+}
+
+/* target functions, sys_clock_port.c */
+/* start the DWT cycle counter and the clock at SystemCoreClock */
+void sys_clock_port_init(void);
+
+#endif /* SYS_CLOCK_H */
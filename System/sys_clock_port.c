@@ -0,0 +1,26 @@
+/*!
+    \file    sys_clock_port.c
+    \brief   64-bit monotonic clock on the target
+
+    The clock counts core cycles with DWT CYCCNT and takes its epoch in
+    SysTick_Handler. CYCCNT stops with the core clock, in deep-sleep
+    and while the debugger halts the core, and the clock with it.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "sys_clock.h"
+
+/*!
+    \brief      start the DWT cycle counter and the clock at SystemCoreClock
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sys_clock_port_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    sys_clock_init(SystemCoreClock);
+}
@@ -0,0 +1,639 @@
+/*!
+    \file    tlsf.c
+    \brief   two-level segregated fit allocator
+
+    Free blocks are kept in lists indexed by the power of two of their
+    size and by one of TLSF_SL_COUNT steps inside it. Two bitmaps tell
+    which lists are not empty, so finding a block, splitting it and
+    merging it back with its neighbours take constant time.
+
+    Every block starts with the size of its payload, the two low bits of
+    which flag whether the block and the one before it are free. A free
+    block also keeps its list links in the payload and its address in
+    the last word, where the next block finds it as prev_phys. A used
+    block costs one word.
+
+    The allocator does no locking, callers serialise access.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "tlsf.h"
+
+#define BLOCK_FREE                  ((size_t)1U)
+#define BLOCK_PREV_FREE             ((size_t)2U)
+#define BLOCK_FLAGS                 (BLOCK_FREE | BLOCK_PREV_FREE)
+
+/* bytes a used block adds to its payload */
+#define BLOCK_OVERHEAD              sizeof(size_t)
+/* from the block to its payload */
+#define BLOCK_PTR_OFFSET            (offsetof(tlsf_block_struct, size) + sizeof(size_t))
+/* a free block must hold its links, prev_phys lives in the next block */
+#define BLOCK_SIZE_MIN              (sizeof(tlsf_block_struct) - sizeof(tlsf_block_struct *))
+#define BLOCK_SIZE_MAX              ((size_t)1U << TLSF_FL_MAX)
+
+/*!
+    \brief      find the most significant set bit
+    \param[in]  word: value, not 0
+    \param[out] none
+    \retval     bit index
+*/
+static uint32_t tlsf_fls(uint32_t word)
+{
+    return 31U - (uint32_t)__builtin_clz(word);
+}
+
+/*!
+    \brief      find the least significant set bit
+    \param[in]  word: value, not 0
+    \param[out] none
+    \retval     bit index
+*/
+static uint32_t tlsf_ffs(uint32_t word)
+{
+    return (uint32_t)__builtin_ctz(word);
+}
+
+/* header accessors */
+static size_t block_size(const tlsf_block_struct *block)
+{
+    return block->size & ~BLOCK_FLAGS;
+}
+
+static void block_set_size(tlsf_block_struct *block, size_t size)
+{
+    block->size = size | (block->size & BLOCK_FLAGS);
+}
+
+static int block_is_free(const tlsf_block_struct *block)
+{
+    return 0U != (block->size & BLOCK_FREE);
+}
+
+static int block_is_prev_free(const tlsf_block_struct *block)
+{
+    return 0U != (block->size & BLOCK_PREV_FREE);
+}
+
+static void *block_to_ptr(const tlsf_block_struct *block)
+{
+    return (uint8_t *)block + BLOCK_PTR_OFFSET;
+}
+
+static tlsf_block_struct *block_from_ptr(const void *ptr)
+{
+    return (tlsf_block_struct *)((uint8_t *)ptr - BLOCK_PTR_OFFSET);
+}
+
+/* the next block starts in the last word of this payload */
+static tlsf_block_struct *block_next(const tlsf_block_struct *block)
+{
+    return (tlsf_block_struct *)((uint8_t *)block_to_ptr(block) + block_size(block) - BLOCK_OVERHEAD);
+}
+
+/* tell the next block where this one starts and return it */
+static tlsf_block_struct *block_link_next(tlsf_block_struct *block)
+{
+    tlsf_block_struct *next = block_next(block);
+
+    next->prev_phys = block;
+    return next;
+}
+
+/* flag the block in its own header and in the next one */
+static void block_mark_free(tlsf_block_struct *block)
+{
+    tlsf_block_struct *next = block_link_next(block);
+
+    next->size |= BLOCK_PREV_FREE;
+    block->size |= BLOCK_FREE;
+}
+
+static void block_mark_used(tlsf_block_struct *block)
+{
+    tlsf_block_struct *next = block_next(block);
+
+    next->size &= ~BLOCK_PREV_FREE;
+    block->size &= ~BLOCK_FREE;
+}
+
+/*!
+    \brief      get the lists a size belongs to
+    \param[in]  size: block size
+    \param[out] fl: first level index
+    \param[out] sl: second level index
+    \retval     none
+*/
+static void mapping_insert(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    uint32_t f, s;
+
+    if(size < TLSF_SMALL_BLOCK){
+        f = 0;
+        s = (uint32_t)size >> TLSF_ALIGN_LOG2;
+    }else{
+        f = tlsf_fls((uint32_t)size);
+        s = ((uint32_t)size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        f -= TLSF_FL_SHIFT - 1U;
+    }
+    *fl = f;
+    *sl = s;
+}
+
+/*!
+    \brief      get the first lists whose blocks all fit a size
+    \param[in]  size: requested size
+    \param[out] fl: first level index
+    \param[out] sl: second level index
+    \retval     none
+*/
+static void mapping_search(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    if(size >= TLSF_SMALL_BLOCK){
+        size += ((size_t)1U << (tlsf_fls((uint32_t)size) - TLSF_SL_LOG2)) - 1U;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+/*!
+    \brief      unlink a block from its free list
+    \param[in]  tlsf: allocator
+    \param[in]  block: free block
+    \param[in]  fl: first level index
+    \param[in]  sl: second level index
+    \param[out] none
+    \retval     none
+*/
+static void block_remove(tlsf_struct *tlsf, tlsf_block_struct *block, uint32_t fl, uint32_t sl)
+{
+    tlsf_block_struct *prev = block->prev_free;
+    tlsf_block_struct *next = block->next_free;
+
+    next->prev_free = prev;
+    prev->next_free = next;
+    if(tlsf->blocks[fl][sl] == block){
+        tlsf->blocks[fl][sl] = next;
+        if(next == &tlsf->null){
+            tlsf->sl_bitmap[fl] &= ~(1U << sl);
+            if(0U == tlsf->sl_bitmap[fl]){
+                tlsf->fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+    tlsf->free -= block_size(block);
+}
+
+/*!
+    \brief      link a block at the head of its free list
+    \param[in]  tlsf: allocator
+    \param[in]  block: free block
+    \param[out] none
+    \retval     none
+*/
+static void block_insert(tlsf_struct *tlsf, tlsf_block_struct *block)
+{
+    tlsf_block_struct *head;
+    uint32_t fl, sl;
+
+    mapping_insert(block_size(block), &fl, &sl);
+    head = tlsf->blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = &tlsf->null;
+    head->prev_free = block;
+    tlsf->blocks[fl][sl] = block;
+    tlsf->fl_bitmap |= 1U << fl;
+    tlsf->sl_bitmap[fl] |= 1U << sl;
+    tlsf->free += block_size(block);
+}
+
+/* unlink a free block whose list is not known */
+static void block_unlink(tlsf_struct *tlsf, tlsf_block_struct *block)
+{
+    uint32_t fl, sl;
+
+    mapping_insert(block_size(block), &fl, &sl);
+    block_remove(tlsf, block, fl, sl);
+}
+
+/*!
+    \brief      cut a block in two, the second part is marked free
+    \param[in]  block: block to cut
+    \param[in]  size: payload left in the first part
+    \param[out] none
+    \retval     second part
+*/
+static tlsf_block_struct *block_split(tlsf_block_struct *block, size_t size)
+{
+    tlsf_block_struct *rest = (tlsf_block_struct *)((uint8_t *)block_to_ptr(block) + size - BLOCK_OVERHEAD);
+    size_t rest_size = block_size(block) - (size + BLOCK_OVERHEAD);
+
+    rest->size = rest_size;
+    block_set_size(block, size);
+    block_mark_free(rest);
+    return rest;
+}
+
+/* grow prev over the block that follows it */
+static tlsf_block_struct *block_absorb(tlsf_block_struct *prev, tlsf_block_struct *block)
+{
+    prev->size += block_size(block) + BLOCK_OVERHEAD;
+    block_link_next(prev);
+    return prev;
+}
+
+/* the rest after size bytes can hold a free block */
+static int block_can_split(const tlsf_block_struct *block, size_t size)
+{
+    return block_size(block) >= sizeof(tlsf_block_struct) + size;
+}
+
+/*!
+    \brief      return the end of a taken block to the free lists
+    \param[in]  tlsf: allocator
+    \param[in]  block: block out of the lists
+    \param[in]  size: payload to keep
+    \param[out] none
+    \retval     none
+*/
+static void block_trim_free(tlsf_struct *tlsf, tlsf_block_struct *block, size_t size)
+{
+    tlsf_block_struct *rest;
+
+    if(block_can_split(block, size)){
+        rest = block_split(block, size);
+        block_link_next(block);
+        rest->size |= BLOCK_PREV_FREE;
+        block_insert(tlsf, rest);
+    }
+}
+
+/*!
+    \brief      return the start of a taken block to the free lists
+    \param[in]  tlsf: allocator
+    \param[in]  block: free block out of the lists
+    \param[in]  size: bytes to give back, from the payload start
+    \param[out] none
+    \retval     block holding the remaining payload
+*/
+static tlsf_block_struct *block_trim_free_leading(tlsf_struct *tlsf, tlsf_block_struct *block, size_t size)
+{
+    tlsf_block_struct *rest = block;
+
+    if(block_can_split(block, size)){
+        rest = block_split(block, size - BLOCK_OVERHEAD);
+        block_link_next(block);
+        rest->size |= BLOCK_PREV_FREE;
+        block_insert(tlsf, block);
+    }
+    return rest;
+}
+
+/*!
+    \brief      take a free block that fits a size out of the lists
+    \param[in]  tlsf: allocator
+    \param[in]  size: adjusted request
+    \param[out] none
+    \retval     block, NULL when none fits
+*/
+static tlsf_block_struct *block_locate_free(tlsf_struct *tlsf, size_t size)
+{
+    tlsf_block_struct *block;
+    uint32_t fl, sl, sl_map, fl_map;
+
+    mapping_search(size, &fl, &sl);
+    if(fl >= TLSF_FL_COUNT){
+        return NULL;
+    }
+
+    sl_map = tlsf->sl_bitmap[fl] & (~0U << sl);
+    if(0U == sl_map){
+        fl_map = tlsf->fl_bitmap & (~0U << (fl + 1U));
+        if(0U == fl_map){
+            return NULL;
+        }
+        fl = tlsf_ffs(fl_map);
+        sl_map = tlsf->sl_bitmap[fl];
+    }
+    sl = tlsf_ffs(sl_map);
+
+    block = tlsf->blocks[fl][sl];
+    block_remove(tlsf, block, fl, sl);
+    return block;
+}
+
+/*!
+    \brief      hand out a taken block
+    \param[in]  tlsf: allocator
+    \param[in]  block: block out of the lists, NULL when none was found
+    \param[in]  size: adjusted request
+    \param[out] none
+    \retval     payload, NULL when block is NULL
+*/
+static void *block_prepare_used(tlsf_struct *tlsf, tlsf_block_struct *block, size_t size)
+{
+    if(NULL == block){
+        tlsf->failures++;
+        return NULL;
+    }
+    block_trim_free(tlsf, block, size);
+    block_mark_used(block);
+
+    tlsf->used += block_size(block);
+    if(tlsf->used > tlsf->high_water){
+        tlsf->high_water = tlsf->used;
+    }
+    tlsf->allocs++;
+    return block_to_ptr(block);
+}
+
+/*!
+    \brief      round a request up to a block size
+    \param[in]  size: requested bytes
+    \param[in]  align: power of two
+    \param[out] none
+    \retval     block size, 0 when the request cannot be served
+*/
+static size_t adjust_request_size(size_t size, size_t align)
+{
+    size_t adjust;
+
+    if((0U == size) || (size >= BLOCK_SIZE_MAX)){
+        return 0;
+    }
+    adjust = (size + (align - 1U)) & ~(align - 1U);
+    if(adjust >= BLOCK_SIZE_MAX){
+        return 0;
+    }
+    return (adjust < BLOCK_SIZE_MIN) ? BLOCK_SIZE_MIN : adjust;
+}
+
+/*!
+    \brief      manage a region
+    \param[in]  tlsf: allocator
+    \param[in]  mem: start of the region
+    \param[in]  bytes: size of the region
+    \param[out] none
+    \retval     0 on success, -1 when the region is too small or too large
+*/
+int tlsf_init(tlsf_struct *tlsf, void *mem, size_t bytes)
+{
+    tlsf_block_struct *block, *last;
+    uintptr_t start, end, payload;
+    size_t size;
+    uint32_t i, j;
+
+    tlsf->null.next_free = &tlsf->null;
+    tlsf->null.prev_free = &tlsf->null;
+    tlsf->fl_bitmap = 0;
+    for(i = 0; i < TLSF_FL_COUNT; i++){
+        tlsf->sl_bitmap[i] = 0;
+        for(j = 0; j < TLSF_SL_COUNT; j++){
+            tlsf->blocks[i][j] = &tlsf->null;
+        }
+    }
+    tlsf->first = NULL;
+    tlsf->free = 0;
+    tlsf->used = 0;
+    tlsf->high_water = 0;
+    tlsf->allocs = 0;
+    tlsf->frees = 0;
+    tlsf->failures = 0;
+
+    /* the first payload is aligned, the last block is an empty used one */
+    start = (uintptr_t)mem;
+    end = start + bytes;
+    payload = (start + BLOCK_PTR_OFFSET + (TLSF_ALIGN - 1U)) & ~(uintptr_t)(TLSF_ALIGN - 1U);
+    if(payload + BLOCK_OVERHEAD + BLOCK_SIZE_MIN > end){
+        return -1;
+    }
+    size = (end - payload - BLOCK_OVERHEAD) & ~(size_t)(TLSF_ALIGN - 1U);
+    if((size < BLOCK_SIZE_MIN) || (size >= BLOCK_SIZE_MAX)){
+        return -1;
+    }
+
+    block = block_from_ptr((void *)payload);
+    block->size = size | BLOCK_FREE;
+    block_insert(tlsf, block);
+
+    last = block_link_next(block);
+    last->size = BLOCK_PREV_FREE;
+    tlsf->first = block;
+    return 0;
+}
+
+/*!
+    \brief      allocate a block
+    \param[in]  tlsf: allocator
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     TLSF_ALIGN aligned payload, NULL when no block is large enough
+*/
+void *tlsf_malloc(tlsf_struct *tlsf, size_t size)
+{
+    size_t adjust = adjust_request_size(size, TLSF_ALIGN);
+
+    if(0U == adjust){
+        tlsf->failures++;
+        return NULL;
+    }
+    return block_prepare_used(tlsf, block_locate_free(tlsf, adjust), adjust);
+}
+
+/*!
+    \brief      allocate an aligned block
+    \param[in]  tlsf: allocator
+    \param[in]  align: power of two
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     payload, NULL when no block is large enough
+*/
+void *tlsf_memalign(tlsf_struct *tlsf, size_t align, size_t size)
+{
+    tlsf_block_struct *block;
+    size_t adjust = adjust_request_size(size, TLSF_ALIGN);
+    size_t gap_min = sizeof(tlsf_block_struct);
+    size_t with_gap, gap;
+    uintptr_t ptr, aligned;
+
+    if(align <= TLSF_ALIGN){
+        return tlsf_malloc(tlsf, size);
+    }
+    if(0U == adjust){
+        tlsf->failures++;
+        return NULL;
+    }
+
+    /* room to move the payload up to the boundary and free the gap */
+    with_gap = adjust_request_size(adjust + align + gap_min, align);
+    if(0U == with_gap){
+        tlsf->failures++;
+        return NULL;
+    }
+
+    block = block_locate_free(tlsf, with_gap);
+    if(NULL != block){
+        ptr = (uintptr_t)block_to_ptr(block);
+        aligned = (ptr + (align - 1U)) & ~(uintptr_t)(align - 1U);
+        gap = aligned - ptr;
+
+        /* a gap too small to be a block is pushed to a later boundary */
+        if((0U != gap) && (gap < gap_min)){
+            gap = gap_min - gap;
+            if(gap < align){
+                gap = align;
+            }
+            aligned = (aligned + gap + (align - 1U)) & ~(uintptr_t)(align - 1U);
+            gap = aligned - ptr;
+        }
+        if(0U != gap){
+            block = block_trim_free_leading(tlsf, block, gap);
+        }
+    }
+
+    return block_prepare_used(tlsf, block, adjust);
+}
+
+/*!
+    \brief      release a block and merge it with free neighbours
+    \param[in]  tlsf: allocator
+    \param[in]  ptr: payload returned by the allocator, NULL is ignored
+    \param[out] none
+    \retval     none
+*/
+void tlsf_free(tlsf_struct *tlsf, void *ptr)
+{
+    tlsf_block_struct *block, *prev, *next;
+
+    if(NULL == ptr){
+        return;
+    }
+    block = block_from_ptr(ptr);
+    tlsf->used -= block_size(block);
+    tlsf->frees++;
+
+    block_mark_free(block);
+    if(block_is_prev_free(block)){
+        prev = block->prev_phys;
+        block_unlink(tlsf, prev);
+        block = block_absorb(prev, block);
+    }
+    next = block_next(block);
+    if(block_is_free(next)){
+        block_unlink(tlsf, next);
+        block = block_absorb(block, next);
+    }
+    block_insert(tlsf, block);
+}
+
+/*!
+    \brief      get the usable size of an allocated block
+    \param[in]  ptr: payload returned by the allocator
+    \param[out] none
+    \retval     bytes, 0 for NULL
+*/
+size_t tlsf_block_size(const void *ptr)
+{
+    return (NULL == ptr) ? 0U : block_size(block_from_ptr(ptr));
+}
+
+/*!
+    \brief      get the statistics
+    \param[in]  tlsf: allocator
+    \param[out] stats: statistics
+    \retval     none
+*/
+void tlsf_stats_get(const tlsf_struct *tlsf, tlsf_stats_struct *stats)
+{
+    const tlsf_block_struct *block;
+    uint32_t fl, sl;
+    size_t largest = 0;
+
+    /* the largest block is in the highest list that is not empty */
+    if(0U != tlsf->fl_bitmap){
+        fl = tlsf_fls(tlsf->fl_bitmap);
+        sl = tlsf_fls(tlsf->sl_bitmap[fl]);
+        for(block = tlsf->blocks[fl][sl]; block != &tlsf->null; block = block->next_free){
+            if(block_size(block) > largest){
+                largest = block_size(block);
+            }
+        }
+    }
+
+    stats->free = tlsf->free;
+    stats->used = tlsf->used;
+    stats->largest = largest;
+    stats->high_water = tlsf->high_water;
+    stats->fragmentation = (0U == tlsf->free) ? 0U :
+                           1000U - (uint32_t)(((uint64_t)largest * 1000U) / tlsf->free);
+    stats->allocs = tlsf->allocs;
+    stats->frees = tlsf->frees;
+    stats->failures = tlsf->failures;
+}
+
+/*!
+    \brief      walk the region and the free lists
+    \param[in]  tlsf: allocator
+    \param[out] none
+    \retval     0 when they are consistent, -1 otherwise
+*/
+int tlsf_check(const tlsf_struct *tlsf)
+{
+    const tlsf_block_struct *block, *prev = NULL;
+    size_t free = 0, used = 0;
+    uint32_t fl, sl, block_fl, block_sl, map_fl, map_sl;
+    int prev_free = 0;
+
+    if(NULL == tlsf->first){
+        return -1;
+    }
+
+    /* physical order: flags agree, no two free blocks touch */
+    for(block = tlsf->first; 0U != block_size(block); block = block_next(block)){
+        if(block_is_prev_free(block) != prev_free){
+            return -1;
+        }
+        if(block_is_free(block)){
+            if(prev_free || (block_next(block)->prev_phys != block)){
+                return -1;
+            }
+            free += block_size(block);
+        }else{
+            used += block_size(block);
+        }
+        prev_free = block_is_free(block);
+        prev = block;
+    }
+    if((block_is_prev_free(block) != prev_free) || block_is_free(block) || (NULL == prev)){
+        return -1;
+    }
+    if((free != tlsf->free) || (used != tlsf->used)){
+        return -1;
+    }
+
+    /* free lists: every block is free, in the right list, and the bitmaps match */
+    for(fl = 0; fl < TLSF_FL_COUNT; fl++){
+        map_fl = (tlsf->fl_bitmap >> fl) & 1U;
+        if(map_fl != (0U != tlsf->sl_bitmap[fl])){
+            return -1;
+        }
+        for(sl = 0; sl < TLSF_SL_COUNT; sl++){
+            map_sl = (tlsf->sl_bitmap[fl] >> sl) & 1U;
+            if(map_sl != (tlsf->blocks[fl][sl] != &tlsf->null)){
+                return -1;
+            }
+            for(block = tlsf->blocks[fl][sl]; block != &tlsf->null; block = block->next_free){
+                if(!block_is_free(block) || block_is_prev_free(block) || block_is_free(block_next(block))){
+                    return -1;
+                }
+                mapping_insert(block_size(block), &block_fl, &block_sl);
+                if((block_fl != fl) || (block_sl != sl)){
+                    return -1;
+                }
+                if((block->next_free != &tlsf->null) && (block->next_free->prev_free != block)){
+                    return -1;
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*!
+    \file    tlsf.h
+    \brief   the header file of the two-level segregated fit allocator
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef TLSF_H
+#define TLSF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* alignment of every block, one pointer, tlsf_memalign() gives more */
+#if UINTPTR_MAX > 0xFFFFFFFFU
+#define TLSF_ALIGN_LOG2             3U
+#else
+#define TLSF_ALIGN_LOG2             2U
+#endif
+#define TLSF_ALIGN                  (1U << TLSF_ALIGN_LOG2)
+/* second level lists per power of two */
+#define TLSF_SL_LOG2                5U
+#define TLSF_SL_COUNT               (1U << TLSF_SL_LOG2)
+/* blocks below this share the first list, split in TLSF_ALIGN steps */
+#define TLSF_FL_SHIFT               (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_SMALL_BLOCK            (1U << TLSF_FL_SHIFT)
+/* blocks must stay below 2^TLSF_FL_MAX bytes, 32 MB */
+#define TLSF_FL_MAX                 25U
+#define TLSF_FL_COUNT               (TLSF_FL_MAX - TLSF_FL_SHIFT + 1U)
+
+typedef struct tlsf_block_struct tlsf_block_struct;
+
+struct tlsf_block_struct {
+    tlsf_block_struct *prev_phys;                       /*!< previous block, only valid while it is free */
+    size_t size;                                        /*!< payload bytes, bit 0 free, bit 1 previous free */
+    tlsf_block_struct *next_free;                       /*!< free list links, only valid while free */
+    tlsf_block_struct *prev_free;
+};
+
+typedef struct {
+    size_t free;                                        /*!< bytes in free blocks */
+    size_t used;                                        /*!< bytes in allocated blocks */
+    size_t largest;                                     /*!< largest free block, a request of this size may round up past it */
+    size_t high_water;                                  /*!< most bytes ever allocated */
+    uint32_t fragmentation;                             /*!< 1000 * (1 - largest / free) */
+    uint32_t allocs;                                    /*!< successful allocations */
+    uint32_t frees;
+    uint32_t failures;                                  /*!< allocations that found no block */
+} tlsf_stats_struct;
+
+typedef struct {
+    tlsf_block_struct null;                             /*!< end of every free list */
+    tlsf_block_struct *first;                           /*!< first block of the region */
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[TLSF_FL_COUNT];
+    tlsf_block_struct *blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+    size_t free;
+    size_t used;
+    size_t high_water;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failures;
+} tlsf_struct;
+
+/* manage a region, return 0 on success, -1 when it is too small or too large */
+int tlsf_init(tlsf_struct *tlsf, void *mem, size_t bytes);
+/* allocate a block, NULL when none is large enough */
+void *tlsf_malloc(tlsf_struct *tlsf, size_t size);
+/* allocate a block aligned to align, a power of two */
+void *tlsf_memalign(tlsf_struct *tlsf, size_t align, size_t size);
+/* release a block, NULL is ignored */
+void tlsf_free(tlsf_struct *tlsf, void *ptr);
+/* get the usable size of an allocated block */
+size_t tlsf_block_size(const void *ptr);
+/* get the statistics */
+void tlsf_stats_get(const tlsf_struct *tlsf, tlsf_stats_struct *stats);
+/* walk the region and the free lists, return 0 when they are consistent */
+int tlsf_check(const tlsf_struct *tlsf);
+
+#endif /* TLSF_H */
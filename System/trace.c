@@ -0,0 +1,156 @@
+/*!
+    \file    trace.c
+    \brief   event tracer
+
+    Code marks where spans of work begin and end, points in time and
+    the values of counters, each as a record of four words: the cycle
+    counter, the address of the name, the context that wrote it with
+    the kind of record in its low bits, and a value. Names are string
+    constants, the host reads them from the ELF file, so a record costs
+    no string copy and no registration. The records go into a ring any
+    number of threads and interrupts write at once, filled in place
+    between the claim and the publish of a cell, and a full ring counts
+    the record lost instead of waiting.
+
+    The drain runs outside interrupt level and cuts the ring in batches
+    for the host:
+
+        u32 TRACE_MAGIC
+        u16 records
+        u16 flags, 0
+        u32 records lost since the previous batch
+        u32 counter frequency
+        u32 counter at the batch
+        u32 time, name, context, value per record
+
+    all little-endian. The counter wraps, the host takes the time of a
+    record back from the counter at its batch, and the time between two
+    batches from their counters, so the batches must come more often
+    than the counter wraps.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "trace.h"
+
+_Static_assert(0U == (TRACE_RING_SIZE & (TRACE_RING_SIZE - 1U)), "TRACE_RING_SIZE must be a power of two");
+
+trace_struct tracer;
+
+/* store a 32-bit word little-endian */
+static uint8_t *put32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+    return out + 4;
+}
+
+/* read a 32-bit word stored little-endian */
+static uint32_t get32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+/*!
+    \brief      empty the ring and set the hooks
+    \param[in]  trace: tracer
+    \param[in]  cycles: free running 32-bit counter of the timestamps
+    \param[in]  context: who is writing, a multiple of 4 such as a thread address
+    \param[in]  hz: frequency of cycles
+    \param[out] none
+    \retval     none
+*/
+void trace_init(trace_struct *trace, uint32_t (*cycles)(void), uint32_t (*context)(void), uint32_t hz)
+{
+    ringbuf_mpsc_init(&trace->ring, trace->seq, trace->records, TRACE_RING_SIZE, sizeof(trace_record_struct));
+    trace->cycles = cycles;
+    trace->context = context;
+    trace->hz = hz;
+    trace->lost = 0U;
+    trace->skipped = 0U;
+    trace->reported = 0U;
+}
+
+/*!
+    \brief      write a record, from any context
+    \param[in]  trace: tracer
+    \param[in]  type: kind of record
+    \param[in]  name: string constant naming the span, event or counter
+    \param[in]  value: argument of an instant, value of a counter
+    \param[out] none
+    \retval     none
+*/
+void trace_event(trace_struct *trace, trace_type_enum type, const char *name, int32_t value)
+{
+    uint32_t pos;
+    trace_record_struct *record = (trace_record_struct *)ringbuf_mpsc_reserve(&trace->ring, &pos);
+
+    if(NULL == record){
+        __atomic_add_fetch(&trace->lost, 1U, __ATOMIC_RELAXED);
+        return;
+    }
+    record->time = trace->cycles();
+    record->name = (uint32_t)(uintptr_t)name;
+    record->context = trace->context() | (uint32_t)type;
+    record->value = value;
+    ringbuf_mpsc_publish(&trace->ring, pos);
+}
+
+/*!
+    \brief      move queued records into a batch
+    \param[in]  trace: tracer
+    \param[in]  size: bytes of out, at least TRACE_HEADER_SIZE and one record
+    \param[out] out: the batch
+    \retval     bytes of the batch, 0 when no record is queued
+*/
+uint32_t trace_batch(trace_struct *trace, uint8_t *out, uint32_t size)
+{
+    trace_record_struct record;
+    uint8_t *pos = out + TRACE_HEADER_SIZE;
+    uint32_t room = (size - TRACE_HEADER_SIZE) / TRACE_RECORD_SIZE;
+    uint32_t count = 0U;
+    uint32_t missed;
+
+    if(room > 0xFFFFU){
+        room = 0xFFFFU;
+    }
+    while((count < room) && (0 == ringbuf_mpsc_get(&trace->ring, &record))){
+        pos = put32(pos, record.time);
+        pos = put32(pos, record.name);
+        pos = put32(pos, record.context);
+        pos = put32(pos, (uint32_t)record.value);
+        count++;
+    }
+    if(0U == count){
+        return 0U;
+    }
+
+    missed = __atomic_load_n(&trace->lost, __ATOMIC_RELAXED) + trace->skipped;
+    (void)put32(out, TRACE_MAGIC);
+    out[4] = (uint8_t)count;
+    out[5] = (uint8_t)(count >> 8);
+    out[6] = 0U;
+    out[7] = 0U;
+    (void)put32(&out[8], missed - trace->reported);
+    (void)put32(&out[12], trace->hz);
+    /* read after the records, every one of them is older */
+    (void)put32(&out[16], trace->cycles());
+    trace->reported = missed;
+    return (uint32_t)(pos - out);
+}
+
+/*!
+    \brief      count a batch that could not be sent, its records and the losses it reported
+    \param[in]  trace: tracer
+    \param[in]  batch: the batch from trace_batch()
+    \param[out] none
+    \retval     none
+*/
+void trace_skip(trace_struct *trace, const uint8_t *batch)
+{
+    trace->skipped += (uint32_t)batch[4] | ((uint32_t)batch[5] << 8);
+    trace->reported -= get32(&batch[8]);
+}
@@ -0,0 +1,97 @@
+/*!
+    \file    trace.h
+    \brief   the header file of the event tracer
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "ringbuf.h"
+
+/* records the ring holds, a power of two */
+#define TRACE_RING_SIZE             256U
+/* first word of a batch, "TRC1" in memory */
+#define TRACE_MAGIC                 0x31435254U
+/* bytes of the batch header: magic, count, flags, lost, hz, now */
+#define TRACE_HEADER_SIZE           20U
+/* bytes of a record in a batch */
+#define TRACE_RECORD_SIZE           16U
+
+/* kinds of record, in the low bits of the context */
+typedef enum {
+    TRACE_BEGIN = 0,                                    /*!< a span starts */
+    TRACE_END,                                          /*!< the last span started in the context ends */
+    TRACE_INSTANT,                                      /*!< a point in time, with an argument */
+    TRACE_COUNTER                                       /*!< the value of a counter */
+} trace_type_enum;
+#define TRACE_TYPE_MASK             0x3U
+
+/* one event */
+typedef struct {
+    uint32_t time;                                      /*!< counter value */
+    uint32_t name;                                      /*!< address of the name, a string constant */
+    uint32_t context;                                   /*!< word-aligned context from the hook, or trace_type_enum */
+    int32_t value;                                      /*!< argument or counter value */
+} trace_record_struct;
+
+/* events on their way from any context to the host */
+typedef struct {
+    ringbuf_mpsc_struct ring;                           /*!< any context writes, the drain reads */
+    ringbuf_atomic_t seq[TRACE_RING_SIZE];
+    trace_record_struct records[TRACE_RING_SIZE];
+    uint32_t (*cycles)(void);                           /*!< free running counter of the timestamps */
+    uint32_t (*context)(void);                          /*!< who writes, a multiple of 4 */
+    uint32_t hz;                                        /*!< counter frequency */
+    uint32_t lost;                                      /*!< records lost to a full ring */
+    uint32_t skipped;                                   /*!< records of batches the channel had no room for, by the drain */
+    uint32_t reported;                                  /*!< lost and skipped records told to the host */
+} trace_struct;
+
+/* the tracer of the board */
+extern trace_struct tracer;
+
+/* empty the ring and set the hooks, hz is the frequency of cycles */
+void trace_init(trace_struct *trace, uint32_t (*cycles)(void), uint32_t (*context)(void), uint32_t hz);
+/* write a record, from any context */
+void trace_event(trace_struct *trace, trace_type_enum type, const char *name, int32_t value);
+/* move queued records into a batch of at most size bytes, returns its bytes, 0 when none */
+uint32_t trace_batch(trace_struct *trace, uint8_t *out, uint32_t size);
+/* count a batch that could not be sent, the next one reports its records as lost */
+void trace_skip(trace_struct *trace, const uint8_t *batch);
+
+/* start a span named by a string constant */
+static inline void trace_begin(trace_struct *trace, const char *name)
+{
+    trace_event(trace, TRACE_BEGIN, name, 0);
+}
+
+/* end the last span started in the context */
+static inline void trace_end(trace_struct *trace, const char *name)
+{
+    trace_event(trace, TRACE_END, name, 0);
+}
+
+/* mark a point in time */
+static inline void trace_instant(trace_struct *trace, const char *name, int32_t arg)
+{
+    trace_event(trace, TRACE_INSTANT, name, arg);
+}
+
+/* set a counter */
+static inline void trace_counter(trace_struct *trace, const char *name, int32_t value)
+{
+    trace_event(trace, TRACE_COUNTER, name, value);
+}
+
+/* target functions, trace_port.c */
+/* trace with the cycle counter and the kernel threads, after kernel_init() */
+void trace_port_init(void);
+/* send the queued records on the trace RTT channel, from the event loop */
+void trace_port_drain(void);
+/* print the record counts and the cost of a record over RTT */
+void trace_port_print(void);
+
+#endif /* TRACE_H */
@@ -0,0 +1,108 @@
+/*!
+    \file    trace_port.c
+    \brief   event tracer on the target
+
+    The timestamps are DWT CYCCNT, and the context of a record is the
+    exception number times 4 in a handler, the kernel thread running
+    otherwise, and 0 before the kernel starts. Thread structures are
+    word-aligned and exception numbers stay below 256, so the two never
+    meet and the low two bits are free for the kind of record.
+
+    The batches go out on their own RTT up-channel in the skip mode,
+    as the samples of the profiler do, and tools/trace2chrome.py turns a
+    raw capture of it into a Chrome or Perfetto trace.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "trace.h"
+#include "kernel.h"
+#include "SEGGER_RTT.h"
+
+/* up-channel of the records, 1 is the profiler */
+#define TRACE_RTT_CHANNEL           2U
+/* bytes of the channel */
+#define TRACE_RTT_SIZE              4096U
+/* bytes of one batch */
+#define TRACE_BATCH_SIZE            (TRACE_HEADER_SIZE + 32U * TRACE_RECORD_SIZE)
+/* records written to measure the cost of one */
+#define TRACE_BENCH_ROUNDS          32U
+
+static uint8_t rtt_buffer[TRACE_RTT_SIZE];
+static uint8_t batch[TRACE_BATCH_SIZE];
+static uint32_t record_cycles;
+
+/* read the DWT cycle counter */
+static uint32_t trace_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/* the exception number times 4 in a handler, the running thread otherwise */
+static uint32_t trace_context(void)
+{
+    uint32_t ipsr = __get_IPSR();
+
+    if(0U != ipsr){
+        return ipsr << 2;
+    }
+    return kernel.started ? (uint32_t)(uintptr_t)kernel.current : 0U;
+}
+
+/*!
+    \brief      trace with the cycle counter and the kernel threads, after kernel_init()
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void trace_port_init(void)
+{
+    uint32_t i, start;
+
+    SEGGER_RTT_ConfigUpBuffer(TRACE_RTT_CHANNEL, "trace", rtt_buffer, sizeof(rtt_buffer),
+                              SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+    trace_init(&tracer, trace_cycles, trace_context, SystemCoreClock);
+
+    /* the cost of a record, into an empty ring and without interrupts */
+    __disable_irq();
+    start = DWT->CYCCNT;
+    for(i = 0; i < TRACE_BENCH_ROUNDS; i++){
+        trace_instant(&tracer, "trace_bench", (int32_t)i);
+    }
+    record_cycles = (DWT->CYCCNT - start) / TRACE_BENCH_ROUNDS;
+    trace_init(&tracer, trace_cycles, trace_context, SystemCoreClock);
+    __enable_irq();
+}
+
+/*!
+    \brief      send the queued records on the trace RTT channel, from the event loop
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void trace_port_drain(void)
+{
+    uint32_t size;
+
+    for(;;){
+        size = trace_batch(&tracer, batch, sizeof(batch));
+        if(0U == size){
+            break;
+        }
+        if(0U == SEGGER_RTT_Write(TRACE_RTT_CHANNEL, batch, size)){
+            trace_skip(&tracer, batch);
+        }
+    }
+}
+
+/*!
+    \brief      print the record counts and the cost of a record over RTT
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void trace_port_print(void)
+{
+    SEGGER_RTT_printf(0, "trace lost=%u skipped=%u record=%u cycles\n", tracer.lost, tracer.skipped, record_cycles);
+}
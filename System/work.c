@@ -0,0 +1,150 @@
+/*!
+    \file    work.c
+    \brief   deferred interrupt work
+
+    An interrupt handler does what cannot wait, clearing the flags and
+    taking the data, and queues the rest as an item naming a work and a
+    word of argument. The items go into the queue of the work's
+    priority and are run outside interrupt level, highest priority
+    first, by the one drainer of the queues. Interrupts then stay short
+    whatever the work costs, and the work runs with interrupts enabled.
+
+    Each item carries the cycle counter at the time it was queued, the
+    drainer takes the difference when it starts the work, and keeps the
+    worst of it per work and per queue. That is the time a bottom half
+    waits for the core, the figure to watch when deciding its priority.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stddef.h>
+#include "work.h"
+
+_Static_assert(0U == (WORK_QUEUE_SIZE & (WORK_QUEUE_SIZE - 1U)), "WORK_QUEUE_SIZE must be a power of two");
+
+work_queue_struct work_queue;
+
+/*!
+    \brief      empty the queues and set the hooks
+    \param[in]  queue: work queue
+    \param[in]  cycles: free running cycle counter for the latency, NULL for none
+    \param[in]  notify: called after an item was queued, NULL when the drainer polls
+    \param[out] none
+    \retval     none
+*/
+void work_queue_init(work_queue_struct *queue, uint32_t (*cycles)(void), void (*notify)(void))
+{
+    uint32_t p;
+
+    for(p = 0; p < WORK_PRIORITIES; p++){
+        ringbuf_mpsc_init(&queue->queues[p], queue->seq[p], queue->cells[p], WORK_QUEUE_SIZE,
+                          sizeof(work_item_struct));
+        queue->latency_max[p] = 0U;
+    }
+    queue->cycles = cycles;
+    queue->notify = notify;
+}
+
+/*!
+    \brief      queue an item
+    \param[in]  queue: work queue
+    \param[in]  work: work to run
+    \param[in]  arg: passed to the work
+    \param[out] none
+    \retval     0, -1 when the queue is full or the priority of the work is out of range
+*/
+int work_post(work_queue_struct *queue, work_struct *work, uint32_t arg)
+{
+    work_item_struct item;
+
+    if(work->priority >= WORK_PRIORITIES){
+        return -1;
+    }
+    item.work = work;
+    item.arg = arg;
+    item.queued = (NULL != queue->cycles) ? queue->cycles() : 0U;
+    if(0 != ringbuf_mpsc_put(&queue->queues[work->priority], &item)){
+        __atomic_add_fetch(&work->dropped, 1U, __ATOMIC_RELAXED);
+        return -1;
+    }
+    if(NULL != queue->notify){
+        queue->notify();
+    }
+    return 0;
+}
+
+/*!
+    \brief      check whether an item is queued
+    \param[in]  queue: work queue
+    \param[out] none
+    \retval     1 when the drainer has an item to take, 0 otherwise
+*/
+int work_pending(work_queue_struct *queue)
+{
+    uint32_t p;
+
+    for(p = 0; p < WORK_PRIORITIES; p++){
+        if(ringbuf_mpsc_ready(&queue->queues[p])){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+    \brief      run the first item of the highest priority queued
+    \param[in]  queue: work queue
+    \param[out] none
+    \retval     1 when an item was run, 0 when there was none
+*/
+int work_run_once(work_queue_struct *queue)
+{
+    work_item_struct item;
+    work_struct *work;
+    uint32_t p, start, latency, spent;
+
+    for(p = 0; p < WORK_PRIORITIES; p++){
+        if(0 != ringbuf_mpsc_get(&queue->queues[p], &item)){
+            continue;
+        }
+
+        work = item.work;
+        if(NULL != queue->cycles){
+            start = queue->cycles();
+            latency = start - item.queued;
+            work->latency += latency;
+            if(latency > work->latency_max){
+                work->latency_max = latency;
+            }
+            if(latency > queue->latency_max[p]){
+                queue->latency_max[p] = latency;
+            }
+            work->fn(item.arg);
+            spent = queue->cycles() - start;
+            if(spent > work->cycles_max){
+                work->cycles_max = spent;
+            }
+        }else{
+            work->fn(item.arg);
+        }
+        work->runs++;
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+    \brief      run items until none is queued
+    \param[in]  queue: work queue
+    \param[out] none
+    \retval     number of items run
+*/
+uint32_t work_run(work_queue_struct *queue)
+{
+    uint32_t runs = 0;
+
+    while(work_run_once(queue)){
+        runs++;
+    }
+    return runs;
+}
@@ -0,0 +1,83 @@
+/*!
+    \file    work.h
+    \brief   the header file of the deferred interrupt work
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef WORK_H
+#define WORK_H
+
+#include <stdint.h>
+#include "ringbuf.h"
+
+/* work queues, 0 is drained first */
+#define WORK_PRIORITIES             3U
+/* items one queue holds, a power of two */
+#define WORK_QUEUE_SIZE             16U
+
+/* priorities of the board */
+#define WORK_PRIO_HIGH              0U                  /*!< completions a transfer waits on */
+#define WORK_PRIO_NORMAL            1U
+#define WORK_PRIO_LOW               2U                  /*!< bookkeeping */
+
+typedef void (*work_fn)(uint32_t arg);
+
+/* the deferred half of an interrupt handler and its latency */
+typedef struct {
+    work_fn fn;
+    const char *name;
+    uint32_t priority;                                  /*!< 0 .. WORK_PRIORITIES - 1 */
+    uint32_t runs;
+    uint32_t dropped;                                   /*!< items lost to a full queue */
+    uint64_t latency;                                   /*!< cycles from work_queue() to the start of fn in total */
+    uint32_t latency_max;                               /*!< longest of them */
+    uint32_t cycles_max;                                /*!< longest run of fn */
+} work_struct;
+
+/* static initialiser of a work */
+#define WORK_INIT(fn, priority)     { (fn), #fn, (priority), 0U, 0U, 0U, 0U, 0U }
+
+/* one queued item */
+typedef struct {
+    work_struct *work;
+    uint32_t arg;
+    uint32_t queued;                                    /*!< cycle counter at work_queue() */
+} work_item_struct;
+
+typedef struct {
+    ringbuf_mpsc_struct queues[WORK_PRIORITIES];        /*!< interrupts queue, the drainer takes */
+    ringbuf_atomic_t seq[WORK_PRIORITIES][WORK_QUEUE_SIZE];
+    work_item_struct cells[WORK_PRIORITIES][WORK_QUEUE_SIZE];
+    uint32_t (*cycles)(void);                           /*!< free running cycle counter, NULL for no accounting */
+    void (*notify)(void);                               /*!< NULL, or wake the drainer after an item was queued */
+    uint32_t latency_max[WORK_PRIORITIES];              /*!< longest latency of each queue */
+} work_queue_struct;
+
+/* the work queue of the board */
+extern work_queue_struct work_queue;
+
+/* empty the queues and set the hooks */
+void work_queue_init(work_queue_struct *queue, uint32_t (*cycles)(void), void (*notify)(void));
+/* queue an item, from any context, return 0 or -1 when the queue is full or the priority out of range */
+int work_post(work_queue_struct *queue, work_struct *work, uint32_t arg);
+/* check whether an item is queued */
+int work_pending(work_queue_struct *queue);
+/* run the first item of the highest priority queued, return 0 when there was none */
+int work_run_once(work_queue_struct *queue);
+/* run items until none is queued, return the number run */
+uint32_t work_run(work_queue_struct *queue);
+
+/* target functions, work_port.c */
+/* runs the software timers, queued by work_port_tick() */
+extern work_struct work_timer;
+/* set up work_queue and the thread draining it, after kernel_init() */
+void work_port_init(uint32_t priority);
+/* count a tick and queue the software timers, from SysTick_Handler */
+void work_port_tick(void);
+/* print the latency of a work over RTT */
+void work_port_print(const work_struct *work);
+/* print the worst latency of each queue over RTT */
+void work_port_print_queues(void);
+
+#endif /* WORK_H */
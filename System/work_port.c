@@ -0,0 +1,142 @@
+/*!
+    \file    work_port.c
+    \brief   deferred interrupt work on the target
+
+    The queues are drained by a kernel thread that waits on a binary
+    semaphore, given by every work_post(). Its priority is right below
+    the control thread, so the work runs as soon as no interrupt is
+    active and the control thread does not need the core, ahead of the
+    event loop, with the kernel calls of a thread at hand.
+
+    PendSV is not used for the draining: it is the kernel's switch and
+    runs at the lowest priority, work in it would lengthen every switch,
+    run on the main stack and could not block.
+
+    The software timers are the bottom half of SysTick: the handler only
+    counts the tick on the wheel and queues work_timer once per batch of
+    ticks, the flag keeps a long run from filling the queue with items
+    that would find nothing left to do. Until work_port_init() the boot
+    sequencer runs the wheel itself and SysTick only counts.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "gd32f4xx.h"
+#include "work.h"
+#include "kernel.h"
+#include "soft_timer.h"
+#include "mem_section.h"
+#include "SEGGER_RTT.h"
+
+static kernel_sem_struct work_sem;
+static kernel_thread_struct work_thread;
+static uint32_t work_stack[256] TCM_BSS;
+static volatile uint32_t work_started;
+static volatile uint32_t timer_queued;
+
+/* read the DWT cycle counter */
+static uint32_t work_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/* wake the thread, a give while it is awake already is lost on purpose */
+static void work_notify(void)
+{
+    (void)kernel_sem_give(&work_sem);
+}
+
+/*!
+    \brief      run the software timers, the work queued by SysTick
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     none
+*/
+static void timer_work(uint32_t arg)
+{
+    (void)arg;
+    __atomic_store_n(&timer_queued, 0U, __ATOMIC_RELAXED);
+    soft_timer_run(&soft_timers);
+}
+
+work_struct work_timer = WORK_INIT(timer_work, WORK_PRIO_NORMAL);
+
+/*!
+    \brief      drain the queues whenever an item was queued
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     none
+*/
+static void work_entry(void *arg)
+{
+    (void)arg;
+    for(;;){
+        kernel_sem_take(&work_sem, KERNEL_WAIT_FOREVER);
+        work_run(&work_queue);
+    }
+}
+
+/*!
+    \brief      set up work_queue and the thread draining it, after kernel_init()
+    \param[in]  priority: kernel priority of the thread
+    \param[out] none
+    \retval     none
+*/
+void work_port_init(uint32_t priority)
+{
+    kernel_sem_init(&work_sem, 0U, 1U);
+    work_queue_init(&work_queue, work_cycles, work_notify);
+    kernel_thread_create(&work_thread, "work", work_entry, NULL, priority, work_stack, sizeof(work_stack));
+    work_started = 1U;
+}
+
+/*!
+    \brief      count a tick and queue the software timers, from SysTick_Handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void work_port_tick(void)
+{
+    soft_timer_tick(&soft_timers);
+    if(0U == work_started){
+        return;
+    }
+    if(0U == __atomic_exchange_n(&timer_queued, 1U, __ATOMIC_RELAXED)){
+        if(0 != work_post(&work_queue, &work_timer, 0U)){
+            timer_queued = 0U;
+        }
+    }
+}
+
+/*!
+    \brief      print the latency of a work over RTT
+    \param[in]  work: work
+    \param[out] none
+    \retval     none
+*/
+void work_port_print(const work_struct *work)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    uint32_t avg = (0U != work->runs) ? (uint32_t)(work->latency / work->runs) : 0U;
+
+    SEGGER_RTT_printf(0, "work p%u runs=%u latency avg=%uus max=%uus run max=%uus dropped=%u %s\n",
+                      work->priority, work->runs, avg / cycles_per_us, work->latency_max / cycles_per_us,
+                      work->cycles_max / cycles_per_us, work->dropped, work->name);
+}
+
+/*!
+    \brief      print the worst latency of each queue over RTT
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void work_port_print_queues(void)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    uint32_t p;
+
+    for(p = 0; p < WORK_PRIORITIES; p++){
+        SEGGER_RTT_printf(0, "work p%u latency max=%uus\n", p, work_queue.latency_max[p] / cycles_per_us);
+    }
+}
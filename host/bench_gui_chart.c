@@ -0,0 +1,121 @@
+/*!
+    \file    bench_gui_chart.c
+    \brief   host benchmark of the waveform chart: ingest rate and frame time
+
+    Pushes a synthetic waveform through gui_chart_push() and
+    gui_chart_load() in both modes and prints samples per second, then
+    redraws a full-width chart into a frame buffer and prints the time
+    of a frame. The rates are of the host, they compare the modes and
+    catch regressions, the board numbers come from the target.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "test.h"
+#include "gui_chart.h"
+
+#define BENCH_SAMPLES               (1U << 20)
+#define BENCH_BLOCK                 256U
+#define BENCH_FRAMES                100U
+
+static uint16_t fb[GUI_SCREEN_HEIGHT][GUI_SCREEN_WIDTH];
+static int16_t wave[BENCH_SAMPLES];
+static gui_chart_struct chart;
+static gui_widget_struct root;
+
+static void fb_fill_rect(const gui_rect_struct *rect, uint16_t color, uint8_t alpha)
+{
+    int16_t x, y;
+
+    (void)alpha;
+    for(y = rect->y0; y < rect->y1; y++){
+        for(x = rect->x0; x < rect->x1; x++){
+            fb[y][x] = color;
+        }
+    }
+}
+
+static const gui_disp_struct disp = {
+    fb_fill_rect,
+    NULL,
+    NULL
+};
+
+/* a sawtooth with noise from a linear congruential generator */
+static void wave_build(void)
+{
+    uint32_t i, seed = 1U;
+
+    for(i = 0; i < BENCH_SAMPLES; i++){
+        seed = seed * 1103515245U + 12345U;
+        wave[i] = (int16_t)((int32_t)(i % 4096U) * 8 - 16384 + (int32_t)((seed >> 16) & 0x3FFU) - 512);
+    }
+}
+
+static void print_rate(const char *name, uint64_t samples, uint64_t ns)
+{
+    printf("%-24s %8.1f Msamples/s\n", name, (double)samples * 1e3 / (double)ns);
+}
+
+int main(void)
+{
+    uint64_t start, ns;
+    uint32_t i, spc, frames_drawn;
+
+    wave_build();
+    gui_container_init(&root, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT, 0);
+    gui_init(&disp, &root);
+    gui_chart_init(&chart, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT, -20000, 20000, 16);
+    gui_widget_add(&root, &chart.widget);
+    gui_refresh();
+
+    /* streaming ingest at a few decimation factors */
+    for(spc = 1; spc <= 256U; spc *= 16U){
+        char name[32];
+
+        gui_chart_set_decimation(&chart, spc);
+        chart.samples_in = 0;
+        start = test_now_ns();
+        for(i = 0; i < BENCH_SAMPLES; i += BENCH_BLOCK){
+            gui_chart_push(&chart, &wave[i], BENCH_BLOCK);
+        }
+        ns = test_now_ns() - start;
+        CHECK_EQ(chart.samples_in, BENCH_SAMPLES);
+        snprintf(name, sizeof(name), "push, %u per column", spc);
+        print_rate(name, BENCH_SAMPLES, ns);
+        gui_refresh();
+    }
+
+    /* whole buffer loads, both modes count what they ingest */
+    chart.samples_in = 0;
+    start = test_now_ns();
+    gui_chart_load(&chart, wave, BENCH_SAMPLES, GUI_CHART_MINMAX);
+    ns = test_now_ns() - start;
+    CHECK_EQ(chart.samples_in, BENCH_SAMPLES);
+    print_rate("load, min/max", BENCH_SAMPLES, ns);
+
+    chart.samples_in = 0;
+    start = test_now_ns();
+    gui_chart_load(&chart, wave, BENCH_SAMPLES, GUI_CHART_LTTB);
+    ns = test_now_ns() - start;
+    CHECK_EQ(chart.samples_in, BENCH_SAMPLES);
+    print_rate("load, LTTB", BENCH_SAMPLES, ns);
+
+    /* a full-width redraw: background fill and one span per column */
+    gui_chart_load(&chart, wave, BENCH_SAMPLES, GUI_CHART_MINMAX);
+    gui_refresh();
+    chart.columns_drawn = 0;
+    frames_drawn = 0;
+    start = test_now_ns();
+    for(i = 0; i < BENCH_FRAMES; i++){
+        gui_widget_invalidate(&chart.widget);
+        frames_drawn += gui_refresh();
+    }
+    ns = test_now_ns() - start;
+    CHECK_EQ(frames_drawn, BENCH_FRAMES);
+    CHECK_EQ(chart.columns_drawn, BENCH_FRAMES * GUI_SCREEN_WIDTH);
+    printf("%-24s %8.1f us/frame\n", "full-width frame", (double)ns / BENCH_FRAMES / 1e3);
+
+    return test_result();
+}
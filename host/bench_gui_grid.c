@@ -0,0 +1,111 @@
+/*!
+    \file    bench_gui_grid.c
+    \brief   host benchmark of hit testing and redraw with and without the spatial index
+
+    For screens of 16 to 500 small widgets, times gui_hit_test() at
+    random points and the redraw of a small damaged rectangle, once
+    through tree walks and once through the index, and prints the time
+    of one query. The index should keep both flat as widgets are added
+    while the walks grow with the count.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "test.h"
+#include "gui_widget.h"
+#include "gui_grid.h"
+
+#define BENCH_MAX_WIDGETS           500U
+#define BENCH_QUERIES               20000U
+#define BENCH_DAMAGES               2000U
+
+static gui_grid_struct grid;
+static gui_widget_struct root;
+static gui_widget_struct widgets[BENCH_MAX_WIDGETS];
+static uint32_t seed = 1U;
+static volatile uint32_t sink;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+static void null_fill_rect(const gui_rect_struct *rect, uint16_t color, uint8_t alpha)
+{
+    sink += (uint32_t)rect->x0 + color + alpha;
+}
+
+static const gui_disp_struct disp = {
+    null_fill_rect,
+    NULL,
+    NULL
+};
+
+/* count buttons of 20 to 60 pixels spread over the screen */
+static void screen_build(uint32_t count)
+{
+    uint32_t i;
+
+    gui_set_grid(NULL);
+    gui_container_init(&root, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT, 0);
+    gui_init(&disp, &root);
+    for(i = 0; i < count; i++){
+        gui_button_init(&widgets[i], (int16_t)rnd(GUI_SCREEN_WIDTH - 60), (int16_t)rnd(GUI_SCREEN_HEIGHT - 60),
+                        (int16_t)(20 + rnd(41)), (int16_t)(20 + rnd(41)), NULL);
+        gui_widget_add(&root, &widgets[i]);
+    }
+    gui_refresh();
+}
+
+/* nanoseconds of one hit test */
+static double time_hits(void)
+{
+    uint64_t start;
+    uint32_t i;
+
+    seed = 7U;
+    start = test_now_ns();
+    for(i = 0; i < BENCH_QUERIES; i++){
+        sink += (uint32_t)(uintptr_t)gui_hit_test((int16_t)rnd(GUI_SCREEN_WIDTH), (int16_t)rnd(GUI_SCREEN_HEIGHT));
+    }
+    return (double)(test_now_ns() - start) / BENCH_QUERIES;
+}
+
+/* nanoseconds of one 32x32 redraw */
+static double time_redraws(void)
+{
+    gui_rect_struct r;
+    uint64_t start;
+    uint32_t i;
+
+    seed = 11U;
+    start = test_now_ns();
+    for(i = 0; i < BENCH_DAMAGES; i++){
+        gui_rect_set(&r, (int16_t)rnd(GUI_SCREEN_WIDTH - 32), (int16_t)rnd(GUI_SCREEN_HEIGHT - 32), 32, 32);
+        gui_invalidate_rect(&r);
+        gui_refresh();
+    }
+    return (double)(test_now_ns() - start) / BENCH_DAMAGES;
+}
+
+int main(void)
+{
+    static const uint32_t counts[] = {16, 64, 128, 256, BENCH_MAX_WIDGETS};
+    double walk_hit, grid_hit, walk_draw, grid_draw;
+    uint32_t i;
+
+    printf("%8s %14s %14s %14s %14s\n", "widgets", "walk hit ns", "grid hit ns", "walk draw ns", "grid draw ns");
+    for(i = 0; i < sizeof(counts) / sizeof(counts[0]); i++){
+        seed = counts[i];
+        screen_build(counts[i]);
+        walk_hit = time_hits();
+        walk_draw = time_redraws();
+        gui_set_grid(&grid);
+        CHECK_EQ(grid.count, counts[i] + 1U);
+        grid_hit = time_hits();
+        grid_draw = time_redraws();
+        printf("%8u %14.0f %14.0f %14.0f %14.0f\n", counts[i], walk_hit, grid_hit, walk_draw, grid_draw);
+    }
+    return test_result();
+}
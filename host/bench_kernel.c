@@ -0,0 +1,82 @@
+/*!
+    \file    bench_kernel.c
+    \brief   host benchmark of the kernel context switch on the ucontext port
+
+    Runs kernel_switch_bench() from a thread, a yield to a helper of the
+    same priority and back, in nanoseconds and in counter cycles, then
+    a semaphore handed back and forth between a thread and one of higher
+    priority, a wake-up with its preemption each way. On the host a
+    switch is a swapcontext() with the signal mask saved and restored,
+    so the numbers compare kernel changes with each other, not with the
+    PendSV switch on the target.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stdlib.h>
+#include "test.h"
+#include "kernel.h"
+#include "kernel_host.h"
+
+#define STACK_WORDS                 (KERNEL_HOST_STACK_MIN / sizeof(uint32_t))
+#define BENCH_ROUNDS                200000U
+
+static uint32_t stacks[3][STACK_WORDS];
+static kernel_thread_struct threads[3];
+static kernel_sem_struct ping, pong;
+
+static uint32_t clock_ns(void)
+{
+    return (uint32_t)test_now_ns();
+}
+
+static uint32_t clock_cycles(void)
+{
+    return (uint32_t)test_cycles();
+}
+
+/* above the bench thread, so each give wakes it at once */
+static void pong_entry(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for(i = 0; i < BENCH_ROUNDS; i++){
+        kernel_sem_take(&ping, KERNEL_WAIT_FOREVER);
+        kernel_sem_give(&pong);
+    }
+}
+
+static void bench_entry(void *arg)
+{
+    uint64_t start, ns;
+    uint32_t i;
+
+    (void)arg;
+    printf("yield switch: %u ns, %u cycles\n",
+           kernel_switch_bench(&threads[1], stacks[1], sizeof(stacks[1]), BENCH_ROUNDS, clock_ns),
+           kernel_switch_bench(&threads[1], stacks[1], sizeof(stacks[1]), BENCH_ROUNDS, clock_cycles));
+
+    kernel_sem_init(&ping, 0U, 1U);
+    kernel_sem_init(&pong, 0U, 1U);
+    CHECK_EQ(kernel_thread_create(&threads[2], "pong", pong_entry, NULL, 1U, stacks[2], sizeof(stacks[2])),
+             KERNEL_OK);
+    start = test_now_ns();
+    for(i = 0; i < BENCH_ROUNDS; i++){
+        kernel_sem_give(&ping);
+        kernel_sem_take(&pong, KERNEL_WAIT_FOREVER);
+    }
+    ns = test_now_ns() - start;
+    printf("semaphore wake-up: %.1f ns\n", (double)ns / (2.0 * BENCH_ROUNDS));
+    CHECK_EQ(threads[2].state, KERNEL_THREAD_DONE);
+    exit(test_result());
+}
+
+int main(void)
+{
+    kernel_init();
+    CHECK_EQ(kernel_thread_create(&threads[0], "bench", bench_entry, NULL, 2U, stacks[0], sizeof(stacks[0])),
+             KERNEL_OK);
+    kernel_start();
+    return 1;
+}
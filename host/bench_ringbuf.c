@@ -0,0 +1,171 @@
+/*!
+    \file    bench_ringbuf.c
+    \brief   host benchmark of the lock-free ring buffers
+
+    Prints the cost of an element through each ring on one thread, put
+    and get back to back, the byte rate of bulk copies, and then the
+    rates with the producers on their own threads: one for the SPSC
+    byte ring, one to four for the MPSC ring. The threaded rates depend
+    on the cores the host has and how it schedules, they compare ring
+    changes on the same machine.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include "test.h"
+#include "ringbuf.h"
+
+#define BENCH_ELEMENTS              10000000U
+#define BENCH_BYTES                 200000000U
+#define BENCH_CHUNK                 256U
+#define BENCH_PRODUCERS             4U
+
+static uint8_t byte_buffer[4096];
+static uint32_t word_buffer[256];
+static uint32_t item_buffer[256];
+static ringbuf_atomic_t item_seq[256];
+static ringbuf_struct bytes, words;
+static ringbuf_mpsc_struct items;
+static uint32_t producers;
+static uint32_t sink;
+
+/* one element through each ring at a time */
+static void bench_single(void)
+{
+    uint64_t start, ns;
+    uint32_t i, value;
+    const void *data;
+    void *cell;
+
+    ringbuf_init(&words, word_buffer, 256U, sizeof(uint32_t));
+    start = test_now_ns();
+    for(i = 0; i < BENCH_ELEMENTS; i++){
+        ringbuf_write(&words, &i, 1U);
+        ringbuf_read(&words, &value, 1U);
+        sink += value;
+    }
+    ns = test_now_ns() - start;
+    printf("spsc write+read:    %6.1f ns\n", (double)ns / BENCH_ELEMENTS);
+
+    start = test_now_ns();
+    for(i = 0; i < BENCH_ELEMENTS; i++){
+        ringbuf_write_reserve(&words, &cell);
+        *(uint32_t *)cell = i;
+        ringbuf_write_commit(&words, 1U);
+        ringbuf_read_reserve(&words, &data);
+        sink += *(const uint32_t *)data;
+        ringbuf_read_commit(&words, 1U);
+    }
+    ns = test_now_ns() - start;
+    printf("spsc reserve+commit: %5.1f ns\n", (double)ns / BENCH_ELEMENTS);
+
+    ringbuf_mpsc_init(&items, item_seq, item_buffer, 256U, sizeof(uint32_t));
+    start = test_now_ns();
+    for(i = 0; i < BENCH_ELEMENTS; i++){
+        ringbuf_mpsc_put(&items, &i);
+        ringbuf_mpsc_get(&items, &value);
+        sink += value;
+    }
+    ns = test_now_ns() - start;
+    printf("mpsc put+get:       %6.1f ns\n", (double)ns / BENCH_ELEMENTS);
+}
+
+static void *bytes_producer(void *arg)
+{
+    static uint8_t chunk[BENCH_CHUNK];
+    uint32_t n = 0, i;
+
+    (void)arg;
+    while(n < BENCH_BYTES){
+        i = ringbuf_write(&bytes, chunk, BENCH_CHUNK);
+        if(0U == i){
+            sched_yield();
+        }
+        n += i;
+    }
+    return NULL;
+}
+
+/* bulk bytes, on one thread and then across two */
+static void bench_bytes(void)
+{
+    static uint8_t chunk[BENCH_CHUNK];
+    pthread_t producer;
+    uint64_t start, ns;
+    uint32_t n = 0, i;
+
+    ringbuf_init(&bytes, byte_buffer, sizeof(byte_buffer), 1U);
+    start = test_now_ns();
+    for(i = 0; i < BENCH_BYTES / BENCH_CHUNK; i++){
+        ringbuf_write(&bytes, chunk, BENCH_CHUNK);
+        ringbuf_read(&bytes, chunk, BENCH_CHUNK);
+    }
+    ns = test_now_ns() - start;
+    printf("bytes, %u a copy:   %6.0f MB/s\n", BENCH_CHUNK, (double)BENCH_BYTES * 1e3 / (double)ns);
+
+    start = test_now_ns();
+    pthread_create(&producer, NULL, bytes_producer, NULL);
+    while(n < BENCH_BYTES){
+        i = ringbuf_read(&bytes, chunk, BENCH_CHUNK);
+        if(0U == i){
+            sched_yield();
+        }
+        n += i;
+    }
+    pthread_join(producer, NULL);
+    ns = test_now_ns() - start;
+    printf("bytes, two threads: %6.0f MB/s\n", (double)BENCH_BYTES * 1e3 / (double)ns);
+}
+
+static void *items_producer(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for(i = 0; i < BENCH_ELEMENTS / producers; i++){
+        while(0 != ringbuf_mpsc_put(&items, &i)){
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* elements from 1 to BENCH_PRODUCERS threads into one consumer */
+static void bench_mpsc(void)
+{
+    pthread_t threads[BENCH_PRODUCERS];
+    uint64_t start, ns;
+    uint32_t p, n, value;
+
+    for(producers = 1U; producers <= BENCH_PRODUCERS; producers *= 2U){
+        ringbuf_mpsc_init(&items, item_seq, item_buffer, 256U, sizeof(uint32_t));
+        start = test_now_ns();
+        for(p = 0; p < producers; p++){
+            pthread_create(&threads[p], NULL, items_producer, NULL);
+        }
+        for(n = 0; n < BENCH_ELEMENTS / producers * producers; ){
+            if(0 == ringbuf_mpsc_get(&items, &value)){
+                sink += value;
+                n++;
+            }else{
+                sched_yield();
+            }
+        }
+        for(p = 0; p < producers; p++){
+            pthread_join(threads[p], NULL);
+        }
+        ns = test_now_ns() - start;
+        printf("mpsc, producers %u:  %6.1f M elements/s\n", producers, (double)n * 1e3 / (double)ns);
+    }
+}
+
+int main(void)
+{
+    bench_single();
+    bench_bytes();
+    bench_mpsc();
+    CHECK(0U != sink);
+    return test_result();
+}
@@ -0,0 +1,101 @@
+/*!
+    \file    bench_soft_timer.c
+    \brief   host benchmark of the timing wheel software timers
+
+    Starts and stops a large number of timers with delays spread over
+    every level of the wheel and prints the time of one start and one
+    stop, which should not grow with the number of timers. Then keeps
+    them all running as periodic timers over simulated ticks and prints
+    the firings per second and the cost of a tick with nothing due.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "test.h"
+#include "soft_timer.h"
+
+#define BENCH_MAX_TIMERS            100000U
+#define BENCH_TICKS                 20000U
+#define BENCH_EMPTY_TICKS           10000000U
+
+static soft_timer_wheel_struct wheel;
+static soft_timer_struct timers[BENCH_MAX_TIMERS];
+static uint32_t delays[BENCH_MAX_TIMERS];
+static uint32_t seed = 1U;
+static uint32_t sink;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+static void count_fired(soft_timer_struct *timer, void *arg)
+{
+    (void)arg;
+    sink += timer->expires;
+}
+
+/* time starting and stopping count timers, then fire them as periodic ones */
+static void run(uint32_t count)
+{
+    uint64_t start, start_ns, stop_ns, fire_ns;
+    uint32_t i, fired;
+
+    wheel.ticks = 0;
+    soft_timer_wheel_init(&wheel);
+    for(i = 0; i < count; i++){
+        soft_timer_init(&timers[i], count_fired, NULL);
+        /* a level of the wheel at random, then a delay on it */
+        delays[i] = 1U + rnd(1U << (SOFT_TIMER_SLOT_BITS * (1U + rnd(SOFT_TIMER_LEVELS))));
+    }
+
+    start = test_now_ns();
+    for(i = 0; i < count; i++){
+        soft_timer_start(&wheel, &timers[i], delays[i], 0U);
+    }
+    start_ns = test_now_ns() - start;
+    start = test_now_ns();
+    for(i = 0; i < count; i++){
+        soft_timer_stop(&timers[i]);
+    }
+    stop_ns = test_now_ns() - start;
+
+    /* periods of 1 to 1000 ticks */
+    for(i = 0; i < count; i++){
+        soft_timer_start(&wheel, &timers[i], 1U + delays[i] % 1000U, 1U + delays[i] % 1000U);
+    }
+    start = test_now_ns();
+    wheel.ticks += BENCH_TICKS;
+    fired = soft_timer_run(&wheel);
+    fire_ns = test_now_ns() - start;
+    for(i = 0; i < count; i++){
+        soft_timer_stop(&timers[i]);
+    }
+
+    printf("%8u %10.1f %10.1f %14.0f\n", count, (double)start_ns / count, (double)stop_ns / count,
+           (double)fired * 1e9 / (double)fire_ns);
+}
+
+int main(void)
+{
+    static const uint32_t counts[] = {100, 1000, 10000, BENCH_MAX_TIMERS};
+    uint64_t start, ns;
+    uint32_t i;
+
+    printf("%8s %10s %10s %14s\n", "timers", "start ns", "stop ns", "firings/s");
+    for(i = 0; i < sizeof(counts) / sizeof(counts[0]); i++){
+        run(counts[i]);
+    }
+
+    /* ticks with nothing due, a level 0 wrap every SOFT_TIMER_SLOTS of them */
+    wheel.ticks = 0;
+    soft_timer_wheel_init(&wheel);
+    start = test_now_ns();
+    wheel.ticks += BENCH_EMPTY_TICKS;
+    soft_timer_run(&wheel);
+    ns = test_now_ns() - start;
+    printf("empty tick: %.2f ns\n", (double)ns / BENCH_EMPTY_TICKS);
+    CHECK(0U != sink);
+    return test_result();
+}
@@ -0,0 +1,19 @@
+/*!
+    \file    kernel_host.h
+    \brief   the header file of the host port of the kernel
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef KERNEL_HOST_H
+#define KERNEL_HOST_H
+
+#include <stdint.h>
+
+/* bytes a host thread needs for its context and libc calls */
+#define KERNEL_HOST_STACK_MIN       (64U * 1024U)
+
+/* tick every period_us microseconds with SIGALRM, from a thread or before kernel_start() */
+void kernel_host_tick_start(uint32_t period_us);
+
+#endif /* KERNEL_HOST_H */
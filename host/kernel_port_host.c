@@ -0,0 +1,203 @@
+/*!
+    \file    kernel_port_host.c
+    \brief   host port of the kernel
+
+    Threads are ucontext contexts in one process, the context is kept
+    at the bottom of the thread stack and thread->sp points at it.
+    SIGALRM plays SysTick and blocking it is the lock. A switch is
+    requested with a flag and done when the lock is released or at the
+    end of the signal handler, where PendSV would run on the target,
+    so preemption happens at the same points as there. Every saved
+    context has SIGALRM blocked, a thread resumed by the unlock path
+    unblocks it itself and one resumed in the handler by returning
+    from it.
+
+    swapcontext() is not async-signal-safe by the letter of POSIX but
+    works from a handler with glibc, which is all a test port needs.
+    Build it with System/kernel.c and -DKERNEL_IDLE_STACK_SIZE=65536,
+    and give the threads stacks of at least KERNEL_HOST_STACK_MIN
+    bytes. raise(SIGALRM) gives a tick at a known point,
+    kernel_host_tick_start() a periodic one.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "kernel.h"
+#include "kernel_host.h"
+
+static volatile sig_atomic_t host_switch_pending;
+
+/* change the SIGALRM mask, return 1 when it was blocked */
+static int host_mask(int how)
+{
+    sigset_t set, old;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGALRM);
+    sigprocmask(how, &set, &old);
+    return sigismember(&old, SIGALRM);
+}
+
+/*!
+    \brief      switch to kernel.next if a switch was requested, with SIGALRM blocked
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void host_switch(void)
+{
+    kernel_thread_struct *prev = kernel.current;
+
+    if(!host_switch_pending){
+        return;
+    }
+    host_switch_pending = 0;
+    if(kernel.next == prev){
+        return;
+    }
+    kernel.current = kernel.next;
+    swapcontext((ucontext_t *)prev->sp, (ucontext_t *)kernel.current->sp);
+}
+
+/*!
+    \brief      count a tick, the "SysTick interrupt"
+    \param[in]  sig: unused
+    \param[out] none
+    \retval     none
+*/
+static void host_tick(int sig)
+{
+    (void)sig;
+    kernel_tick();
+    host_switch();
+}
+
+/*!
+    \brief      run a thread, first code of a new context
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void host_entry(void)
+{
+    kernel_thread_struct *self = kernel.current;
+
+    host_mask(SIG_UNBLOCK);
+    self->entry(self->arg);
+    kernel_thread_exit();
+}
+
+/*!
+    \brief      block SIGALRM
+    \param[in]  none
+    \param[out] none
+    \retval     1 when it was blocked already
+*/
+uint32_t kernel_port_lock(void)
+{
+    return (uint32_t)host_mask(SIG_BLOCK);
+}
+
+/*!
+    \brief      switch if requested, then unblock SIGALRM unless it was blocked before
+    \param[in]  key: returned by kernel_port_lock()
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_unlock(uint32_t key)
+{
+    if(0U != key){
+        return;
+    }
+    host_switch();
+    host_mask(SIG_UNBLOCK);
+}
+
+/*!
+    \brief      make the context of a thread at the bottom of its stack
+    \param[in]  thread: thread with its entry and stack set
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_thread_init(kernel_thread_struct *thread)
+{
+    uintptr_t base = ((uintptr_t)thread->stack + 15U) & ~(uintptr_t)15U;
+    uintptr_t end = ((uintptr_t)thread->stack + thread->stack_size) & ~(uintptr_t)15U;
+    ucontext_t *context = (ucontext_t *)base;
+    uintptr_t stack = (base + sizeof(ucontext_t) + 15U) & ~(uintptr_t)15U;
+
+    getcontext(context);
+    context->uc_stack.ss_sp = (void *)stack;
+    context->uc_stack.ss_size = end - stack;
+    context->uc_link = NULL;
+    sigaddset(&context->uc_sigmask, SIGALRM);
+    makecontext(context, host_entry, 0);
+    thread->sp = context;
+}
+
+/*!
+    \brief      request a switch
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_switch(void)
+{
+    host_switch_pending = 1;
+}
+
+/*!
+    \brief      enter the first ready thread and set kernel.started, main() is left for good
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_start(void)
+{
+    struct sigaction action;
+
+    action.sa_handler = host_tick;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &action, NULL);
+
+    host_mask(SIG_BLOCK);
+    host_switch_pending = 0;
+    kernel.started = 1;
+    kernel.current = kernel.ready.head;
+    kernel.next = kernel.current;
+    setcontext((ucontext_t *)kernel.current->sp);
+}
+
+/*!
+    \brief      wait for a signal
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_port_idle(void)
+{
+    pause();
+}
+
+/*!
+    \brief      tick periodically
+    \param[in]  period_us: microseconds between ticks
+    \param[out] none
+    \retval     none
+*/
+void kernel_host_tick_start(uint32_t period_us)
+{
+    struct itimerval timer;
+
+    timer.it_interval.tv_sec = period_us / 1000000U;
+    timer.it_interval.tv_usec = period_us % 1000000U;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, NULL);
+}
@@ -0,0 +1,24 @@
+/*
+    Symbols of profile.elf, the firmware stand-in of test_profile_symbolize.py:
+    Thumb functions at odd addresses as the ARM toolchain writes them, one
+    without a size, and a data object. Only the symbol table is read.
+
+        as --32 -o profile.o profile.s && ld -m elf_i386 -e main -o profile.elf profile.o
+*/
+    .macro function name, address, size
+    .globl \name
+    .type \name, @function
+    .set \name, \address
+    .size \name, \size
+    .endm
+
+    function main,            0x08000201, 0x40
+    function gui_refresh,     0x08000241, 0x80
+    function gui_fill,        0x080002c1, 0x20
+    function memcpy,          0x080002e1, 0
+    function SysTick_Handler, 0x08000301, 0x10
+
+    .globl frame_buffer
+    .type frame_buffer, @object
+    .set frame_buffer, 0x20000000
+    .size frame_buffer, 0x400
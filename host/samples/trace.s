@@ -0,0 +1,58 @@
+/*
+    Sections of trace.elf, the firmware stand-in of test_trace2chrome.py:
+    a vector table naming SysTick_Handler and TIMER6_IRQHandler, the
+    handlers with the Thumb bit set in their symbols as the ARM toolchain
+    writes them, the name strings at 0x08000400 and the thread
+    structures at 0x20000000. test_trace.c writes these addresses.
+
+        as --32 -o trace.o trace.s
+        ld -m elf_i386 -n -e Reset_Handler --section-start=.isr_vector=0x08000000 -Ttext=0x08000200 \
+            --section-start=.rodata=0x08000400 -Tbss=0x20000000 -o trace.elf trace.o
+*/
+    .section .isr_vector, "a"
+    .globl g_pfnVectors
+    .type g_pfnVectors, @object
+g_pfnVectors:
+    .long 0x20030000
+    .long Reset_Handler
+    .org 15 * 4
+    .long SysTick_Handler
+    .org 71 * 4
+    .long TIMER6_IRQHandler
+    .org 72 * 4
+    .size g_pfnVectors, . - g_pfnVectors
+
+    .text
+    .macro function name
+    .globl \name
+    .type \name, @function
+    .set \name, . + 1
+    .fill 16, 1, 0
+    .size \name, 16
+    .endm
+
+    function Reset_Handler
+    function SysTick_Handler
+    function TIMER6_IRQHandler
+
+    .section .rodata
+n_frame:
+    .asciz "gui frame"
+    .org 0x10
+n_mark:
+    .asciz "mark"
+    .org 0x20
+n_load:
+    .asciz "cpu load"
+
+    .bss
+    .macro thread name
+    .globl \name
+    .type \name, @object
+\name:
+    .fill 0x40, 1, 0
+    .size \name, 0x40
+    .endm
+
+    thread control_thread
+    thread events_thread
@@ -0,0 +1,143 @@
+/*!
+    \file    sdram_dma_port_host.c
+    \brief   host stand-in for the SDRAM copy service port
+
+    A worker thread plays the DMA controller: it performs each transfer
+    with memcpy() after a short delay and reports it through
+    sdram_dma_transfer_done() while holding the lock, the way the
+    interrupt is kept out of masked sections on the target. Build it with
+    Hardware/SDRAM/sdram_dma.c and sdram_copy.c and link with -pthread.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "sdram_dma.h"
+
+/* simulated transfer time */
+#define HOST_DMA_DELAY_US           50
+
+static pthread_mutex_t host_lock;
+static pthread_mutex_t host_job_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_job_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t host_worker;
+static int host_started;
+
+static struct {
+    void *dst;
+    const void *src;
+    uint32_t bytes;
+    int pending;
+} host_job;
+
+/*!
+    \brief      perform the transfers handed over by sdram_dma_port_start()
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     none
+*/
+static void *host_worker_main(void *arg)
+{
+    void *dst;
+    const void *src;
+    uint32_t bytes;
+
+    (void)arg;
+    for(;;){
+        pthread_mutex_lock(&host_job_lock);
+        while(!host_job.pending){
+            pthread_cond_wait(&host_job_cond, &host_job_lock);
+        }
+        dst = host_job.dst;
+        src = host_job.src;
+        bytes = host_job.bytes;
+        host_job.pending = 0;
+        pthread_mutex_unlock(&host_job_lock);
+
+        usleep(HOST_DMA_DELAY_US);
+        memcpy(dst, src, bytes);
+
+        /* the "interrupt" */
+        pthread_mutex_lock(&host_lock);
+        sdram_dma_transfer_done(0);
+        pthread_mutex_unlock(&host_lock);
+    }
+    return NULL;
+}
+
+/*!
+    \brief      start the worker thread once
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sdram_dma_port_init(void)
+{
+    pthread_mutexattr_t attr;
+
+    if(host_started){
+        return;
+    }
+    /* callbacks may queue copies from inside the "interrupt" */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&host_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    pthread_create(&host_worker, NULL, host_worker_main, NULL);
+    host_started = 1;
+}
+
+/*!
+    \brief      hand a transfer to the worker thread
+    \param[in]  src: source
+    \param[in]  items: number of items
+    \param[in]  width: item size in bytes
+    \param[out] dst: destination
+    \retval     none
+*/
+void sdram_dma_port_start(void *dst, const void *src, uint32_t items, uint32_t width)
+{
+    pthread_mutex_lock(&host_job_lock);
+    host_job.dst = dst;
+    host_job.src = src;
+    host_job.bytes = items * width;
+    host_job.pending = 1;
+    pthread_cond_signal(&host_job_cond);
+    pthread_mutex_unlock(&host_job_lock);
+}
+
+/*!
+    \brief      keep the worker from reporting
+    \param[in]  none
+    \param[out] none
+    \retval     0
+*/
+uint32_t sdram_dma_port_lock(void)
+{
+    pthread_mutex_lock(&host_lock);
+    return 0;
+}
+
+/*!
+    \brief      let the worker report again
+    \param[in]  state: unused
+    \param[out] none
+    \retval     none
+*/
+void sdram_dma_port_unlock(uint32_t state)
+{
+    (void)state;
+    pthread_mutex_unlock(&host_lock);
+}
+
+/*!
+    \brief      nothing to do, the worker reports directly
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sdram_dma_port_irq(void)
+{
+}
@@ -0,0 +1,207 @@
+/*!
+    \file    sdram_sim.c
+    \brief   simulated memory for the SDRAM diagnostics
+
+    A word array behind sdram_diag_mem_struct with injectable faults:
+    address lines stuck or shorted, bits stuck at a value and coupling
+    between bits of two words. Build it with Hardware/SDRAM/sdram_diag.c
+    to check that each test finds the faults it is meant to.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "sdram_sim.h"
+
+/*!
+    \brief      apply the address line faults to an offset
+    \param[in]  sim: simulated memory
+    \param[in]  offset: byte offset driven by the test
+    \param[out] none
+    \retval     word index reached
+*/
+static uint32_t sim_address(const sdram_sim_struct *sim, uint32_t offset)
+{
+    uint32_t level;
+
+    offset = (offset | sim->address_set) & ~sim->address_clear;
+    if(0U != sim->short_a){
+        level = ((offset & sim->short_a) && (offset & sim->short_b)) ? 1U : 0U;
+        offset &= ~(sim->short_a | sim->short_b);
+        if(level){
+            offset |= sim->short_a | sim->short_b;
+        }
+    }
+    return (offset & (sim->size - 1U)) / 4U;
+}
+
+/*!
+    \brief      apply the stuck-at faults to a word
+    \param[in]  sim: simulated memory
+    \param[in]  index: word index
+    \param[in]  value: word stored or read
+    \param[out] none
+    \retval     word with the stuck bits forced
+*/
+static uint32_t sim_stuck(const sdram_sim_struct *sim, uint32_t index, uint32_t value)
+{
+    const sdram_sim_fault_struct *f;
+    uint32_t i;
+
+    for(i = 0; i < sim->fault_count; i++){
+        f = &sim->faults[i];
+        if((SDRAM_SIM_STUCK_AT == f->type) &&
+           ((SDRAM_SIM_ALL_WORDS == f->offset) || (f->offset / 4U == index))){
+            value = f->value ? (value | (1U << f->bit)) : (value & ~(1U << f->bit));
+        }
+    }
+    return value;
+}
+
+/*!
+    \brief      read a word
+    \param[in]  ctx: simulated memory
+    \param[in]  offset: byte offset
+    \param[out] none
+    \retval     word read
+*/
+static uint32_t sim_read(void *ctx, uint32_t offset)
+{
+    sdram_sim_struct *sim = (sdram_sim_struct *)ctx;
+    uint32_t index = sim_address(sim, offset);
+
+    return sim_stuck(sim, index, sim->words[index]);
+}
+
+/*!
+    \brief      write a word and trigger the coupling faults
+    \param[in]  ctx: simulated memory
+    \param[in]  offset: byte offset
+    \param[in]  value: word to write
+    \param[out] none
+    \retval     none
+*/
+static void sim_write(void *ctx, uint32_t offset, uint32_t value)
+{
+    sdram_sim_struct *sim = (sdram_sim_struct *)ctx;
+    const sdram_sim_fault_struct *f;
+    uint32_t index = sim_address(sim, offset);
+    uint32_t old = sim->words[index], mask, victim, i;
+
+    sim->words[index] = sim_stuck(sim, index, value);
+
+    for(i = 0; i < sim->fault_count; i++){
+        f = &sim->faults[i];
+        if((SDRAM_SIM_STUCK_AT == f->type) || (f->aggressor_offset / 4U != index)){
+            continue;
+        }
+        mask = 1U << f->aggressor_bit;
+        if((0U != (old & mask)) || (0U == (sim->words[index] & mask))){
+            continue;
+        }
+        victim = f->offset / 4U;
+        if(SDRAM_SIM_COUPLING_INVERSION == f->type){
+            sim->words[victim] ^= 1U << f->bit;
+        }else if(f->value){
+            sim->words[victim] |= 1U << f->bit;
+        }else{
+            sim->words[victim] &= ~(1U << f->bit);
+        }
+    }
+}
+
+/*!
+    \brief      set up a fault free memory
+    \param[in]  words: storage, size bytes
+    \param[in]  size: bytes, a power of two
+    \param[out] sim: simulated memory
+    \param[out] mem: access functions for the diagnostics
+    \retval     none
+*/
+void sdram_sim_init(sdram_sim_struct *sim, uint32_t *words, uint32_t size, sdram_diag_mem_struct *mem)
+{
+    memset(sim, 0, sizeof(*sim));
+    memset(words, 0, size);
+    sim->words = words;
+    sim->size = size;
+
+    mem->read = sim_read;
+    mem->write = sim_write;
+    mem->ctx = sim;
+    mem->size = size;
+}
+
+/*!
+    \brief      make a bit read as value
+    \param[in]  sim: simulated memory
+    \param[in]  offset: byte offset of the word, SDRAM_SIM_ALL_WORDS for a data line
+    \param[in]  bit: bit in the word
+    \param[in]  value: 0 or 1
+    \param[out] none
+    \retval     0 on success, -1 when no fault slot is left
+*/
+int sdram_sim_stuck_at(sdram_sim_struct *sim, uint32_t offset, uint32_t bit, uint32_t value)
+{
+    return sdram_sim_coupling(sim, SDRAM_SIM_STUCK_AT, 0, 0, offset, bit, value);
+}
+
+/*!
+    \brief      couple a victim bit to an aggressor bit
+    \param[in]  sim: simulated memory
+    \param[in]  type: fault type
+    \param[in]  aggressor_offset: byte offset of the aggressor word
+    \param[in]  aggressor_bit: bit whose 0 to 1 transition triggers the fault
+    \param[in]  offset: byte offset of the victim word
+    \param[in]  bit: victim bit
+    \param[in]  value: value forced by SDRAM_SIM_COUPLING_IDEMPOTENT
+    \param[out] none
+    \retval     0 on success, -1 when no fault slot is left
+*/
+int sdram_sim_coupling(sdram_sim_struct *sim, sdram_sim_fault_enum type, uint32_t aggressor_offset, uint32_t aggressor_bit,
+                       uint32_t offset, uint32_t bit, uint32_t value)
+{
+    sdram_sim_fault_struct *f;
+
+    if(SDRAM_SIM_MAX_FAULTS == sim->fault_count){
+        return -1;
+    }
+    f = &sim->faults[sim->fault_count++];
+    f->type = type;
+    f->offset = offset;
+    f->bit = bit;
+    f->value = value;
+    f->aggressor_offset = aggressor_offset;
+    f->aggressor_bit = aggressor_bit;
+    return 0;
+}
+
+/*!
+    \brief      hold an address line at a level
+    \param[in]  sim: simulated memory
+    \param[in]  line: offset bit of the line, 2 and up
+    \param[in]  value: 0 or 1
+    \param[out] none
+    \retval     none
+*/
+void sdram_sim_address_stuck(sdram_sim_struct *sim, uint32_t line, uint32_t value)
+{
+    if(value){
+        sim->address_set |= 1U << line;
+    }else{
+        sim->address_clear |= 1U << line;
+    }
+}
+
+/*!
+    \brief      short two address lines
+    \param[in]  sim: simulated memory
+    \param[in]  line_a: offset bit of the first line
+    \param[in]  line_b: offset bit of the second line
+    \param[out] none
+    \retval     none
+*/
+void sdram_sim_address_short(sdram_sim_struct *sim, uint32_t line_a, uint32_t line_b)
+{
+    sim->short_a = 1U << line_a;
+    sim->short_b = 1U << line_b;
+}
@@ -0,0 +1,58 @@
+/*!
+    \file    sdram_sim.h
+    \brief   the header file of the simulated memory for the SDRAM diagnostics
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef SDRAM_SIM_H
+#define SDRAM_SIM_H
+
+#include <stdint.h>
+#include "sdram_diag.h"
+
+/* number of cell faults that can be injected */
+#define SDRAM_SIM_MAX_FAULTS        8U
+
+/* applies to every word, models a data line fault */
+#define SDRAM_SIM_ALL_WORDS         0xFFFFFFFFU
+
+typedef enum {
+    SDRAM_SIM_STUCK_AT = 0,                             /*!< the victim bit always reads value */
+    SDRAM_SIM_COUPLING_INVERSION,                       /*!< a rising aggressor bit inverts the victim bit */
+    SDRAM_SIM_COUPLING_IDEMPOTENT                       /*!< a rising aggressor bit forces the victim bit to value */
+} sdram_sim_fault_enum;
+
+typedef struct {
+    sdram_sim_fault_enum type;
+    uint32_t offset;                                    /*!< victim word, SDRAM_SIM_ALL_WORDS for every word */
+    uint32_t bit;                                       /*!< victim bit */
+    uint32_t value;                                     /*!< forced value */
+    uint32_t aggressor_offset;
+    uint32_t aggressor_bit;
+} sdram_sim_fault_struct;
+
+typedef struct {
+    uint32_t *words;
+    uint32_t size;                                      /*!< bytes, a power of two */
+    uint32_t address_set;                               /*!< offset bits of address lines stuck high */
+    uint32_t address_clear;                             /*!< offset bits of address lines stuck low */
+    uint32_t short_a;                                   /*!< two address lines shorted together, 0 for none */
+    uint32_t short_b;
+    sdram_sim_fault_struct faults[SDRAM_SIM_MAX_FAULTS];
+    uint32_t fault_count;
+} sdram_sim_struct;
+
+/* set up a fault free memory over words and its access functions */
+void sdram_sim_init(sdram_sim_struct *sim, uint32_t *words, uint32_t size, sdram_diag_mem_struct *mem);
+/* make a bit read as value */
+int sdram_sim_stuck_at(sdram_sim_struct *sim, uint32_t offset, uint32_t bit, uint32_t value);
+/* couple a victim bit to an aggressor bit */
+int sdram_sim_coupling(sdram_sim_struct *sim, sdram_sim_fault_enum type, uint32_t aggressor_offset, uint32_t aggressor_bit,
+                       uint32_t offset, uint32_t bit, uint32_t value);
+/* hold an address line at a level */
+void sdram_sim_address_stuck(sdram_sim_struct *sim, uint32_t line, uint32_t value);
+/* short two address lines, both follow their wired AND */
+void sdram_sim_address_short(sdram_sim_struct *sim, uint32_t line_a, uint32_t line_b);
+
+#endif /* SDRAM_SIM_H */
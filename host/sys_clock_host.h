@@ -0,0 +1,21 @@
+/*!
+    \file    sys_clock_host.h
+    \brief   the counter the host tests give the 64-bit clock
+
+    Included ahead of every file of a test of sys_clock, so the clock
+    and the test read the same injected counter instead of DWT CYCCNT.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef SYS_CLOCK_HOST_H
+#define SYS_CLOCK_HOST_H
+
+#include <stdint.h>
+
+/* the injected free running counter, provided by the test */
+uint32_t sys_clock_host_counter(void);
+
+#define SYS_CLOCK_COUNTER()         sys_clock_host_counter()
+
+#endif /* SYS_CLOCK_HOST_H */
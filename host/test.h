@@ -0,0 +1,73 @@
+/*!
+    \file    test.h
+    \brief   checks and timing for the host tests
+
+    A test program runs its checks from main() and returns
+    test_result(), a failed check prints where it was and the test goes
+    on. Benchmarks time with test_now_ns() or count with test_cycles()
+    and print their rates.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static int test_failed;
+
+/* check a condition, count and print a failure */
+#define CHECK(cond)                 do{ \
+                                        if(!(cond)){ \
+                                            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+                                            test_failed++; \
+                                        } \
+                                    }while(0)
+
+/* check that two integers are equal, print both when they are not */
+#define CHECK_EQ(a, b)              do{ \
+                                        long long test_a = (long long)(a), test_b = (long long)(b); \
+                                        if(test_a != test_b){ \
+                                            printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                                                   __FILE__, __LINE__, #a, #b, test_a, test_b); \
+                                            test_failed++; \
+                                        } \
+                                    }while(0)
+
+/* monotonic time in nanoseconds */
+static inline uint64_t test_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+/* cycle counter for per-operation costs: the time stamp counter on x86, nanoseconds elsewhere */
+static inline uint64_t test_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return test_now_ns();
+#endif
+}
+
+/* print the outcome, the exit code of the test */
+static inline int test_result(void)
+{
+    if(0 != test_failed){
+        printf("%d checks failed\n", test_failed);
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}
+
+#endif /* TEST_H */
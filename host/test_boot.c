@@ -0,0 +1,372 @@
+/*!
+    \file    test_boot.c
+    \brief   host test of the boot sequencer on a fake clock
+
+    The steps and the clock are fakes: a step's run() and busy() move
+    the clock on by the time the step takes, and idle() jumps it to the
+    time the sequencer waits for. A table shaped like the board's checks
+    exact start and end times, that steps overlap a settle hold and that
+    busy steps are polled. Failures, dependency cycles and missing steps
+    must skip their dependents and nothing else. Random tables are then
+    checked against the rules: no step starts before its dependencies
+    are done and their holds over, the sequencer never idles while a
+    step could run, and of the steps ready together the first in table
+    order runs first. The same tables must give the same result with no
+    idle() at all, when the sequencer spins on now().
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "test.h"
+#include "boot.h"
+
+#define TABLES                      3000U
+#define SPIN_US                     1U
+
+/* behaviour of a fake step */
+typedef struct {
+    uint32_t run_us;                                    /*!< time run() takes */
+    int run_result;
+    uint32_t busy_us;                                   /*!< time after run() before busy() reports done */
+    int busy_result;                                    /*!< what busy() reports then */
+    uint32_t done_at;                                   /*!< clock at which busy() stops reporting work */
+    uint32_t runs;
+    uint32_t polls;
+} fake_struct;
+
+static uint32_t seed = 1U;
+static uint32_t fake_us;
+static uint32_t clock_start;
+static fake_struct fakes[BOOT_STEPS_MAX];
+static const boot_step_struct *cur_steps;
+static const boot_clock_struct *cur_clock;
+static uint32_t cur_count;
+static boot_record_struct records[BOOT_STEPS_MAX + 1U];
+static uint32_t run_order[BOOT_STEPS_MAX];
+static uint32_t run_count;
+static uint32_t idle_calls;
+static uint32_t rule_errors;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+/* steps ready at a time: waiting with every dependency done and its hold over */
+static int step_ready(uint32_t index, uint32_t now)
+{
+    uint32_t d;
+
+    if(BOOT_STEP_WAITING != records[index].state){
+        return 0;
+    }
+    for(d = 0; d < cur_count; d++){
+        if(0U == (cur_steps[index].after & BOOT_AFTER(d))){
+            continue;
+        }
+        if((BOOT_STEP_DONE != records[d].state) || (now < records[d].end + cur_steps[d].hold_us)){
+            return 0;
+        }
+    }
+    /* dependencies outside the table never finish */
+    return (cur_count >= 32U) || (0U == (cur_steps[index].after >> cur_count));
+}
+
+static int step_run(uint32_t index)
+{
+    fake_struct *f = &fakes[index];
+    uint32_t now = fake_us - clock_start, i;
+
+    /* nothing earlier in the table was ready as well, judged on a clock that only steps move */
+    for(i = 0; (NULL != cur_clock->idle) && (i < index); i++){
+        if(step_ready(i, now)){
+            rule_errors++;
+        }
+    }
+    f->runs++;
+    run_order[run_count++] = index;
+    fake_us += f->run_us;
+    f->done_at = fake_us + f->busy_us;
+    return f->run_result;
+}
+
+static int step_busy(uint32_t index)
+{
+    fake_struct *f = &fakes[index];
+
+    f->polls++;
+    if((int32_t)(fake_us - f->done_at) < 0){
+        return 1;
+    }
+    return f->busy_result;
+}
+
+/* run() and busy() for every step index */
+#define FAKE_STEP(n)                static int run_##n(void){ return step_run(n); } \
+                                    static int busy_##n(void){ return step_busy(n); }
+FAKE_STEP(0)  FAKE_STEP(1)  FAKE_STEP(2)  FAKE_STEP(3)  FAKE_STEP(4)  FAKE_STEP(5)  FAKE_STEP(6)  FAKE_STEP(7)
+FAKE_STEP(8)  FAKE_STEP(9)  FAKE_STEP(10) FAKE_STEP(11) FAKE_STEP(12) FAKE_STEP(13) FAKE_STEP(14) FAKE_STEP(15)
+FAKE_STEP(16) FAKE_STEP(17) FAKE_STEP(18) FAKE_STEP(19) FAKE_STEP(20) FAKE_STEP(21) FAKE_STEP(22) FAKE_STEP(23)
+FAKE_STEP(24) FAKE_STEP(25) FAKE_STEP(26) FAKE_STEP(27) FAKE_STEP(28) FAKE_STEP(29) FAKE_STEP(30) FAKE_STEP(31)
+
+#define FAKE_FN(fn)                 { fn##_0,  fn##_1,  fn##_2,  fn##_3,  fn##_4,  fn##_5,  fn##_6,  fn##_7, \
+                                      fn##_8,  fn##_9,  fn##_10, fn##_11, fn##_12, fn##_13, fn##_14, fn##_15, \
+                                      fn##_16, fn##_17, fn##_18, fn##_19, fn##_20, fn##_21, fn##_22, fn##_23, \
+                                      fn##_24, fn##_25, fn##_26, fn##_27, fn##_28, fn##_29, fn##_30, fn##_31 }
+static int (*const run_fn[BOOT_STEPS_MAX])(void) = FAKE_FN(run);
+static int (*const busy_fn[BOOT_STEPS_MAX])(void) = FAKE_FN(busy);
+
+/* without idle() every read of the clock lets some time pass */
+static uint32_t spin_now(void)
+{
+    fake_us += SPIN_US;
+    return fake_us;
+}
+
+static const boot_clock_struct spin_clock = {spin_now, NULL};
+
+static uint32_t fake_now(void)
+{
+    return fake_us;
+}
+
+/* the sequencer only waits when no step can run */
+static void fake_idle(uint32_t until)
+{
+    uint32_t i, now = fake_us - clock_start;
+
+    idle_calls++;
+    for(i = 0; i < cur_count; i++){
+        if(step_ready(i, now)){
+            rule_errors++;
+        }
+    }
+    if((int32_t)(until - fake_us) > 0){
+        fake_us = until;
+    }else{
+        /* a busy step is being waited for */
+        fake_us++;
+    }
+}
+
+static const boot_clock_struct idle_clock = {fake_now, fake_idle};
+
+
+/* run a table, the clock starting at an odd value to catch absolute times */
+static uint32_t run_table(const boot_step_struct *steps, uint32_t count, const boot_clock_struct *clock)
+{
+    uint32_t i;
+
+    for(i = 0; i < BOOT_STEPS_MAX; i++){
+        fakes[i].runs = 0;
+        fakes[i].polls = 0;
+    }
+    cur_steps = steps;
+    cur_clock = clock;
+    cur_count = count;
+    run_count = 0;
+    idle_calls = 0;
+    rule_errors = 0;
+    fake_us = 0xFFFFF000U;
+    clock_start = fake_us;
+    memset(records, 0xA5, sizeof(records));
+    return boot_run(steps, count, clock, records);
+}
+
+static void fake_set(uint32_t index, uint32_t run_us, int run_result, uint32_t busy_us, int busy_result)
+{
+    fakes[index].run_us = run_us;
+    fakes[index].run_result = run_result;
+    fakes[index].busy_us = busy_us;
+    fakes[index].busy_result = busy_result;
+}
+
+#define CHECK_RECORD(i, st, s, e)   do{ \
+                                        CHECK_EQ(records[i].state, st); \
+                                        CHECK_EQ(records[i].start, s); \
+                                        CHECK_EQ(records[i].end, e); \
+                                    }while(0)
+
+/* the board's shape: a power-up hold that independent steps fill, a busy clear */
+static void test_board_shape(void)
+{
+    enum { POWER, GPIO, TLI, START, CLEAR, HEAP, DISPLAY, COUNT };
+    const boot_step_struct steps[COUNT] = {
+        [POWER]   = {"power", 0U, run_fn[POWER], NULL, 100U},
+        [GPIO]    = {"gpio", 0U, run_fn[GPIO], NULL, 0U},
+        [TLI]     = {"tli", 0U, run_fn[TLI], NULL, 0U},
+        [START]   = {"start", BOOT_AFTER(POWER), run_fn[START], NULL, 0U},
+        [CLEAR]   = {"clear", BOOT_AFTER(START) | BOOT_AFTER(TLI), run_fn[CLEAR], busy_fn[CLEAR], 0U},
+        [HEAP]    = {"heap", BOOT_AFTER(START), run_fn[HEAP], NULL, 0U},
+        [DISPLAY] = {"display", BOOT_AFTER(CLEAR), run_fn[DISPLAY], NULL, 0U},
+    };
+    uint32_t i;
+
+    fake_set(POWER, 5U, 0, 0U, 0);
+    fake_set(GPIO, 10U, 0, 0U, 0);
+    fake_set(TLI, 30U, 0, 0U, 0);
+    fake_set(START, 20U, 0, 0U, 0);
+    fake_set(CLEAR, 2U, 0, 500U, 0);
+    fake_set(HEAP, 40U, 0, 0U, 0);
+    fake_set(DISPLAY, 1U, 0, 0U, 0);
+
+    CHECK_EQ(run_table(steps, COUNT, &idle_clock), 0);
+    CHECK_EQ(rule_errors, 0);
+    /* gpio and tli run in the hold, then it is waited out */
+    CHECK_RECORD(POWER, BOOT_STEP_DONE, 0, 5);
+    CHECK_RECORD(GPIO, BOOT_STEP_DONE, 5, 15);
+    CHECK_RECORD(TLI, BOOT_STEP_DONE, 15, 45);
+    CHECK_RECORD(START, BOOT_STEP_DONE, 105, 125);
+    /* the clear is started before the heap and polled while the heap is set up */
+    CHECK_EQ(records[CLEAR].state, BOOT_STEP_DONE);
+    CHECK_EQ(records[CLEAR].start, 125);
+    CHECK_EQ(records[CLEAR].end, 627);
+    CHECK_RECORD(HEAP, BOOT_STEP_DONE, 127, 167);
+    CHECK(fakes[CLEAR].polls > 1U);
+    CHECK_RECORD(DISPLAY, BOOT_STEP_DONE, 627, 628);
+    CHECK_EQ(run_count, COUNT);
+    for(i = 0; i < COUNT; i++){
+        CHECK_EQ(run_order[i], i);
+    }
+    CHECK(idle_calls > 0U);
+
+    /* a failing busy() fails the clear and skips the display only */
+    fake_set(CLEAR, 2U, 0, 50U, -5);
+    CHECK_EQ(run_table(steps, COUNT, &idle_clock), 2);
+    CHECK_EQ(records[CLEAR].state, BOOT_STEP_FAILED);
+    CHECK_EQ(records[DISPLAY].state, BOOT_STEP_SKIPPED);
+    CHECK_EQ(fakes[DISPLAY].runs, 0);
+    CHECK_EQ(records[HEAP].state, BOOT_STEP_DONE);
+}
+
+/* failures, cycles and missing steps skip their dependents, nothing else */
+static void test_broken(void)
+{
+    const boot_step_struct steps[7] = {
+        {"fails", 0U, run_fn[0], NULL, 0U},
+        {"after fails", BOOT_AFTER(0), run_fn[1], NULL, 0U},
+        {"after that", BOOT_AFTER(1), run_fn[2], NULL, 0U},
+        {"cycle a", BOOT_AFTER(4), run_fn[3], NULL, 0U},
+        {"cycle b", BOOT_AFTER(3), run_fn[4], NULL, 0U},
+        {"missing", BOOT_AFTER(9), run_fn[5], NULL, 0U},
+        {"fine", 0U, run_fn[6], busy_fn[6], 0U},
+    };
+    const boot_step_struct self[1] = {
+        {"self", BOOT_AFTER(0), run_fn[0], NULL, 0U},
+    };
+    boot_step_struct many[BOOT_STEPS_MAX + 1U];
+    uint32_t i;
+
+    for(i = 0; i < 7U; i++){
+        fake_set(i, 1U, 0, 0U, 0);
+    }
+    fakes[0].run_result = -1;
+    fake_set(6, 1U, 0, 3U, 0);
+    CHECK_EQ(run_table(steps, 7, &idle_clock), 6);
+    CHECK_EQ(records[0].state, BOOT_STEP_FAILED);
+    for(i = 1; i <= 5U; i++){
+        CHECK_EQ(records[i].state, BOOT_STEP_SKIPPED);
+        CHECK_EQ(fakes[i].runs, 0);
+    }
+    CHECK_EQ(records[6].state, BOOT_STEP_DONE);
+
+    fake_set(0, 1U, 0, 0U, 0);
+    CHECK_EQ(run_table(self, 1, &idle_clock), 1);
+    CHECK_EQ(records[0].state, BOOT_STEP_SKIPPED);
+    CHECK_EQ(fakes[0].runs, 0);
+
+    CHECK_EQ(run_table(steps, 0, &idle_clock), 0);
+    CHECK_EQ(run_count, 0);
+
+    /* a table longer than BOOT_STEPS_MAX is cut, the record past it untouched */
+    for(i = 0; i <= BOOT_STEPS_MAX; i++){
+        many[i] = steps[6];
+        many[i].run = run_fn[i % BOOT_STEPS_MAX];
+        many[i].busy = NULL;
+        fake_set(i % BOOT_STEPS_MAX, 1U, 0, 0U, 0);
+    }
+    CHECK_EQ(run_table(many, BOOT_STEPS_MAX + 1U, &idle_clock), 0);
+    CHECK_EQ(run_count, BOOT_STEPS_MAX);
+    CHECK_EQ(records[BOOT_STEPS_MAX].start, 0xA5A5A5A5U);
+    CHECK_EQ(records[BOOT_STEPS_MAX - 1U].state, BOOT_STEP_DONE);
+}
+
+/* random tables against the rules, with idle() and spinning on now() */
+static void test_random(void)
+{
+    static boot_step_struct steps[BOOT_STEPS_MAX];
+    boot_record_struct first[BOOT_STEPS_MAX];
+    uint32_t table, count, i, d, not_done, expected, spin_not_done;
+    int broken;
+
+    for(table = 0; table < TABLES; table++){
+        count = 1U + rnd(BOOT_STEPS_MAX);
+        for(i = 0; i < count; i++){
+            steps[i].name = "step";
+            steps[i].after = 0;
+            /* mostly earlier steps, now and then a later one that may close a cycle */
+            for(d = 0; d < count; d++){
+                if((d != i) && (rnd(100) < ((d < i) ? 15U : 2U))){
+                    steps[i].after |= BOOT_AFTER(d);
+                }
+            }
+            steps[i].run = run_fn[i];
+            steps[i].busy = (rnd(4) == 0U) ? busy_fn[i] : NULL;
+            steps[i].hold_us = (rnd(3) == 0U) ? rnd(200) : 0U;
+            fake_set(i, rnd(50), (rnd(20) == 0U) ? -1 : 0, rnd(100), (rnd(20) == 0U) ? -2 : 0);
+        }
+
+        not_done = run_table(steps, count, &idle_clock);
+        CHECK_EQ(rule_errors, 0);
+        memcpy(first, records, sizeof(first));
+        expected = 0;
+        for(i = 0; i < count; i++){
+            if(BOOT_STEP_DONE != records[i].state){
+                expected++;
+            }
+            CHECK(records[i].end >= records[i].start);
+            CHECK((BOOT_STEP_WAITING != records[i].state) && (BOOT_STEP_BUSY != records[i].state));
+            /* run once if it ran, after every dependency finished and held */
+            broken = 0;
+            for(d = 0; d < count; d++){
+                if(0U == (steps[i].after & BOOT_AFTER(d))){
+                    continue;
+                }
+                if(BOOT_STEP_DONE != records[d].state){
+                    broken = 1;
+                }else if(BOOT_STEP_SKIPPED != records[i].state){
+                    CHECK(records[i].start >= records[d].end + steps[d].hold_us);
+                }
+            }
+            if(BOOT_STEP_SKIPPED == records[i].state){
+                CHECK_EQ(fakes[i].runs, 0);
+            }else{
+                CHECK_EQ(fakes[i].runs, 1);
+                CHECK(!broken);
+            }
+            /* a step whose dependencies all finished is never skipped */
+            if(!broken && (BOOT_STEP_SKIPPED == records[i].state)){
+                printf("table %u: step %u skipped with its dependencies done\n", table, i);
+                test_failed++;
+            }
+        }
+        CHECK_EQ(not_done, expected);
+
+        /* spinning gives the same outcome */
+        spin_not_done = run_table(steps, count, &spin_clock);
+        CHECK_EQ(spin_not_done, not_done);
+        for(i = 0; i < count; i++){
+            CHECK_EQ(records[i].state, first[i].state);
+        }
+    }
+}
+
+int main(void)
+{
+    test_board_shape();
+    test_broken();
+    test_random();
+    return test_result();
+}
@@ -0,0 +1,261 @@
+/*!
+    \file    test_coro.c
+    \brief   host test of the stackless coroutines on a fake timer wheel
+
+    The wheel is the clock: the test ticks it and runs it, nothing else
+    moves time, so every wait is checked to the tick. The tick count
+    starts just short of its wrap and the deadlines cross it. A
+    sequence sleeps, waits for a fake hardware flag, times out and
+    yields, and must note each step on its exact tick. Waiters of an
+    event are run by its signal, with a timeout when none comes, and a
+    waiter run by a signal may signal again and stop another waiter
+    without a waiter being run twice or a stopped one being run at all.
+    Last, many coroutines run the sequence at once, one restarted while
+    it waits, and all must finish.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "test.h"
+#include "coro.h"
+
+#define TICKS_START                 0xFFFFFFF0U
+#define MANY                        200U
+#define EVENT_TIMEOUT               50U
+
+static soft_timer_wheel_struct wheel;
+static uint32_t ready_at;
+
+/* state of a sequence, kept across its waits */
+typedef struct {
+    uint32_t steps[8];
+    uint32_t count;
+    uint32_t yields;
+    int timed_out;
+} sequence_struct;
+
+static uint32_t done_count;
+static int done_result;
+
+static void tick(uint32_t n)
+{
+    while(n-- > 0U){
+        soft_timer_tick(&wheel);
+        soft_timer_run(&wheel);
+    }
+}
+
+/* the fake hardware is ready from the tick ready_at on */
+static int hw_ready(void)
+{
+    return (int32_t)(wheel.now - ready_at) >= 0;
+}
+
+static void note_done(coro_struct *coro, int result)
+{
+    (void)coro;
+    done_count++;
+    done_result = result;
+}
+
+#define STEP(s)                     ((s)->steps[(s)->count++] = wheel.now - TICKS_START)
+
+static int sequence(coro_struct *coro)
+{
+    sequence_struct *s = (sequence_struct *)coro->arg;
+
+    CORO_BEGIN(coro);
+    STEP(s);
+    CORO_SLEEP(coro, 10U);
+    STEP(s);
+    CORO_AWAIT(coro, hw_ready());
+    STEP(s);
+    CORO_AWAIT_TIMEOUT(coro, 0, 3U);
+    s->timed_out = CORO_TIMED_OUT(coro);
+    STEP(s);
+    CORO_AWAIT_TIMEOUT(coro, hw_ready(), 3U);
+    s->timed_out += CORO_TIMED_OUT(coro);
+    for(s->yields = 0; s->yields < 3U; s->yields++){
+        CORO_YIELD(coro);
+    }
+    STEP(s);
+    CORO_SLEEP(coro, 0U);
+    STEP(s);
+    CORO_END(coro);
+}
+
+static void test_waits(void)
+{
+    static const uint32_t expected[] = {5U, 15U, 20U, 23U, 26U, 26U};
+    sequence_struct s = {{0}, 0U, 0U, 0};
+    coro_struct coro;
+    uint32_t i;
+
+    wheel.ticks = TICKS_START;
+    soft_timer_wheel_init(&wheel);
+    tick(5U);
+    ready_at = TICKS_START + 20U;
+    done_count = 0;
+    coro_start(&coro, &wheel, sequence, &s, note_done);
+    CHECK_EQ(s.count, 1);
+    CHECK(coro_active(&coro));
+    CHECK_EQ(coro.result, CORO_WAITING);
+    tick(100U);
+    CHECK_EQ(s.count, sizeof(expected) / sizeof(expected[0]));
+    for(i = 0; i < s.count; i++){
+        CHECK_EQ(s.steps[i], expected[i]);
+    }
+    /* the first timeout ran out, the second found the flag */
+    CHECK_EQ(s.timed_out, 1);
+    CHECK(!coro_active(&coro));
+    CHECK_EQ(coro.result, 0);
+    CHECK_EQ(done_count, 1);
+    CHECK_EQ(done_result, 0);
+    /* the deadlines crossed the wrap */
+    CHECK(wheel.now < TICKS_START);
+
+    /* stopped while it waits, it is never resumed and done is not called */
+    s.count = 0;
+    coro_start(&coro, &wheel, sequence, &s, note_done);
+    coro_stop(&coro);
+    tick(100U);
+    CHECK_EQ(s.count, 1);
+    CHECK(!coro_active(&coro));
+    CHECK_EQ(done_count, 1);
+}
+
+static coro_event_struct event;
+static coro_struct waiters[3], signaller_coro;
+static uint32_t got[3];
+
+/* counts signals to three, fails when none comes in time */
+static int waiter(coro_struct *coro)
+{
+    uint32_t id = (uint32_t)(uintptr_t)coro->arg;
+
+    CORO_BEGIN(coro);
+    while(got[id] < 3U){
+        CORO_AWAIT_EVENT_TIMEOUT(coro, &event, EVENT_TIMEOUT);
+        if(CORO_TIMED_OUT(coro)){
+            CORO_EXIT(coro, -1);
+        }
+        got[id]++;
+    }
+    CORO_END(coro);
+}
+
+/* run by a signal, it stops the last waiter and signals again */
+static int signaller(coro_struct *coro)
+{
+    CORO_BEGIN(coro);
+    CORO_AWAIT_EVENT(coro, &event);
+    coro_stop(&waiters[2]);
+    coro_event_signal(&event);
+    CORO_AWAIT_EVENT(coro, &event);
+    CORO_END(coro);
+}
+
+static void waiters_start(void)
+{
+    uint32_t i;
+
+    for(i = 0; i < 3U; i++){
+        got[i] = 0;
+        coro_start(&waiters[i], &wheel, waiter, (void *)(uintptr_t)i, note_done);
+    }
+    done_count = 0;
+}
+
+static void test_events(void)
+{
+    uint32_t i;
+
+    wheel.ticks = TICKS_START;
+    soft_timer_wheel_init(&wheel);
+    coro_event_init(&event);
+
+    /* each signal runs every waiter once */
+    waiters_start();
+    coro_event_signal(&event);
+    for(i = 0; i < 3U; i++){
+        CHECK_EQ(got[i], 1);
+    }
+    coro_event_signal(&event);
+    coro_event_signal(&event);
+    for(i = 0; i < 3U; i++){
+        CHECK_EQ(got[i], 3);
+        CHECK(!coro_active(&waiters[i]));
+        CHECK_EQ(waiters[i].result, 0);
+    }
+    CHECK_EQ(done_count, 3);
+    CHECK(NULL == event.waiters);
+
+    /* the signaller waits first in the list, so it runs before the others and signals again under them */
+    waiters_start();
+    coro_start(&signaller_coro, &wheel, signaller, NULL, NULL);
+    coro_event_signal(&event);
+    CHECK(coro_active(&signaller_coro));
+    CHECK_EQ(got[0], 1);
+    CHECK_EQ(got[1], 1);
+    CHECK_EQ(got[2], 0);
+    CHECK(!coro_active(&waiters[2]));
+    CHECK_EQ(waiters[2].result, CORO_WAITING);
+    coro_event_signal(&event);
+    CHECK(!coro_active(&signaller_coro));
+    CHECK_EQ(signaller_coro.result, 0);
+    coro_event_signal(&event);
+    CHECK_EQ(got[0], 3);
+    CHECK(!coro_active(&waiters[0]));
+    CHECK_EQ(got[2], 0);
+
+    /* no signal: the timeout ends the wait on its tick */
+    got[0] = 0;
+    done_count = 0;
+    coro_start(&waiters[0], &wheel, waiter, (void *)0, note_done);
+    tick(EVENT_TIMEOUT - 1U);
+    CHECK(coro_active(&waiters[0]));
+    tick(1U);
+    CHECK(!coro_active(&waiters[0]));
+    CHECK_EQ(waiters[0].result, -1);
+    CHECK_EQ(done_count, 1);
+    CHECK_EQ(done_result, -1);
+    CHECK(NULL == event.waiters);
+}
+
+/* many at once, one restarted while it waits */
+static void test_many(void)
+{
+    static coro_struct coros[MANY];
+    static sequence_struct states[MANY];
+    uint32_t i;
+
+    wheel.ticks = TICKS_START;
+    soft_timer_wheel_init(&wheel);
+    ready_at = TICKS_START + 1000U;
+    done_count = 0;
+    for(i = 0; i < MANY; i++){
+        coro_start(&coros[i], &wheel, sequence, &states[i], note_done);
+        tick(i % 3U);
+    }
+    tick(500U);
+    states[0].count = 0;
+    coro_start(&coros[0], &wheel, sequence, &states[0], note_done);
+    tick(2000U);
+    for(i = 0; i < MANY; i++){
+        CHECK(!coro_active(&coros[i]));
+        CHECK_EQ(coros[i].result, 0);
+        CHECK_EQ(states[i].count, 6);
+    }
+    CHECK_EQ(done_count, MANY);
+    /* everyone waited for the same flag */
+    CHECK_EQ(states[1].steps[2], 1000);
+    CHECK_EQ(states[0].steps[2], 1000);
+}
+
+int main(void)
+{
+    test_waits();
+    test_events();
+    test_many();
+    return test_result();
+}
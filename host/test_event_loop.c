@@ -0,0 +1,293 @@
+/*!
+    \file    test_event_loop.c
+    \brief   host test of the event loop with a simulated interrupt source
+
+    A signal plays the interrupt: a second thread sends it to the
+    thread running the loop, whose signal handler posts events at any
+    priority, just as an interrupt handler would, right in the middle
+    of a post or a take by the loop. A third thread posts as well. The
+    idle hook sleeps the way the target does, with the signal masked
+    around the check and sigsuspend() standing in for WFI, so a post
+    between the check and the sleep must still wake the loop. Every
+    accepted event must run once, in order of posting within its
+    priority, rejected posts must show up as dropped, and the loop must
+    not sleep through a post: the last wake-up comes only after the
+    sources are done, so a lost one hangs the test until an alarm ends
+    it.
+
+    Before that the single threaded rules are checked: priorities are
+    served in order and each first in first out, a full queue refuses
+    and counts, a handler can post, and the accounting adds up the
+    cycles of a fake counter.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "test.h"
+#include "event_loop.h"
+
+#define IRQ_SIGNAL                  SIGUSR1
+#define IRQS                        20000U
+#define THREAD_POSTS                20000U
+#define SOURCES                     (EVENT_PRIORITIES + 2U)
+#define THREAD_SOURCE               EVENT_PRIORITIES
+#define LOOP_SOURCE                 (EVENT_PRIORITIES + 1U)
+/* a lost wake-up hangs the loop, the alarm then ends the test */
+#define TIMEOUT_S                   60U
+
+static event_loop_struct loop;
+static uint32_t fake_cycles;
+static uint32_t order[64];
+static uint32_t order_count;
+
+/* per source of events: next sequence number to post, to run, and what went wrong */
+static uint32_t posted[SOURCES];
+static uint32_t ran[SOURCES];
+static uint32_t rejected[SOURCES];
+static _Atomic uint32_t misorders;
+static _Atomic uint32_t irq_count;
+static _Atomic int irq_done;
+static _Atomic int thread_done;
+static pthread_t loop_thread;
+
+static uint32_t count_cycles(void)
+{
+    return fake_cycles;
+}
+
+/* note the order, spend arg cycles */
+static void note_fn(uint32_t arg)
+{
+    order[order_count++] = arg;
+    fake_cycles += arg;
+}
+
+static event_handler_struct note[EVENT_PRIORITIES] = {
+    EVENT_HANDLER(note_fn, 0U), EVENT_HANDLER(note_fn, 1U), EVENT_HANDLER(note_fn, 2U), EVENT_HANDLER(note_fn, 3U)
+};
+
+static void repost_fn(uint32_t arg)
+{
+    order[order_count++] = arg;
+    if(arg > 0U){
+        event_post(&loop, &note[0], arg - 1U);
+    }
+}
+
+static event_handler_struct repost = EVENT_HANDLER(repost_fn, 3U);
+
+static void test_rules(void)
+{
+    uint32_t p, i;
+
+    event_loop_init(&loop, count_cycles, NULL);
+    CHECK(!event_pending(&loop));
+    CHECK_EQ(event_run_once(&loop), 0);
+
+    /* posted from the lowest priority up, served from the highest down, each in order */
+    for(p = EVENT_PRIORITIES; p > 0U; p--){
+        for(i = 0; i < 3U; i++){
+            CHECK_EQ(event_post(&loop, &note[p - 1U], (p - 1U) * 10U + i), 0);
+        }
+    }
+    CHECK(event_pending(&loop));
+    order_count = 0;
+    while(event_run_once(&loop)){
+    }
+    CHECK_EQ(order_count, EVENT_PRIORITIES * 3U);
+    for(i = 0; i < order_count; i++){
+        CHECK_EQ(order[i], (i / 3U) * 10U + i % 3U);
+    }
+
+    /* a handler posting a higher priority event gets it run next */
+    order_count = 0;
+    event_post(&loop, &repost, 7U);
+    event_post(&loop, &note[3], 100U);
+    while(event_run_once(&loop)){
+    }
+    CHECK_EQ(order_count, 3);
+    CHECK_EQ(order[0], 7);
+    CHECK_EQ(order[1], 6);
+    CHECK_EQ(order[2], 100);
+
+    /* accounting from the fake counter */
+    event_loop_init(&loop, count_cycles, NULL);
+    note[1].runs = 0;
+    note[1].cycles = 0;
+    note[1].cycles_max = 0;
+    order_count = 0;
+    event_post(&loop, &note[1], 5U);
+    event_post(&loop, &note[1], 40U);
+    event_post(&loop, &note[1], 2U);
+    while(event_run_once(&loop)){
+    }
+    CHECK_EQ(note[1].runs, 3);
+    CHECK_EQ(note[1].cycles, 47);
+    CHECK_EQ(note[1].cycles_max, 40);
+
+    /* a full queue refuses and counts, the others still take events */
+    note[2].dropped = 0;
+    for(i = 0; i < EVENT_QUEUE_SIZE; i++){
+        CHECK_EQ(event_post(&loop, &note[2], 0U), 0);
+    }
+    CHECK_EQ(event_post(&loop, &note[2], 0U), -1);
+    CHECK_EQ(note[2].dropped, 1);
+    CHECK_EQ(event_post(&loop, &note[0], 99U), 0);
+    order_count = 0;
+    CHECK_EQ(event_run_once(&loop), 1);
+    CHECK_EQ(order[0], 99);
+    CHECK_EQ(event_post(&loop, &note[2], 0U), -1);
+    CHECK_EQ(event_run_once(&loop), 1);
+    CHECK_EQ(event_post(&loop, &note[2], 0U), 0);
+    CHECK_EQ(note[2].dropped, 2);
+    while(event_run_once(&loop)){
+        order_count = 0;
+    }
+}
+
+/* events of the threaded test carry their source and sequence number */
+#define EVENT_ARG(source, n)        (((source) << 24) | ((n) & 0xFFFFFFU))
+
+static void check_fn(uint32_t arg)
+{
+    uint32_t source = arg >> 24;
+
+    if((arg & 0xFFFFFFU) != (ran[source] & 0xFFFFFFU)){
+        atomic_fetch_add(&misorders, 1U);
+    }
+    ran[source] = (arg & 0xFFFFFFU) + 1U;
+}
+
+static event_handler_struct check[EVENT_PRIORITIES] = {
+    EVENT_HANDLER(check_fn, 0U), EVENT_HANDLER(check_fn, 1U), EVENT_HANDLER(check_fn, 2U), EVENT_HANDLER(check_fn, 3U)
+};
+
+/* the interrupt: post one to three events at a priority picked from the count */
+static void irq_handler(int sig)
+{
+    uint32_t n = atomic_fetch_add(&irq_count, 1U), p = n % EVENT_PRIORITIES, i;
+
+    (void)sig;
+    for(i = 0; i <= n % 3U; i++){
+        if(0 == event_post(&loop, &check[p], EVENT_ARG(p, posted[p]))){
+            posted[p]++;
+        }else{
+            rejected[p]++;
+        }
+    }
+}
+
+/* sleep like the target: mask, check, and wait with the mask lifted in one step */
+static void irq_idle(void)
+{
+    sigset_t block, old;
+
+    sigemptyset(&block);
+    sigaddset(&block, IRQ_SIGNAL);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+    if(!event_pending(&loop)){
+        sigsuspend(&old);
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+}
+
+static void *irq_source(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for(i = 0; i < IRQS; i++){
+        pthread_kill(loop_thread, IRQ_SIGNAL);
+        if(0U == i % 64U){
+            sched_yield();
+        }
+    }
+    atomic_store(&irq_done, 1);
+    /* wake the loop for the last time */
+    pthread_kill(loop_thread, IRQ_SIGNAL);
+    return NULL;
+}
+
+static void *thread_source(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for(i = 0; i < THREAD_POSTS; i++){
+        /* a post from another thread wakes the loop the way an interrupt does */
+        while(0 != event_post(&loop, &check[EVENT_PRIO_IDLE], EVENT_ARG(THREAD_SOURCE, i))){
+            pthread_kill(loop_thread, IRQ_SIGNAL);
+            sched_yield();
+        }
+        if(0U == i % 16U){
+            pthread_kill(loop_thread, IRQ_SIGNAL);
+        }
+    }
+    atomic_store(&thread_done, 1);
+    pthread_kill(loop_thread, IRQ_SIGNAL);
+    return NULL;
+}
+
+static void test_irq(void)
+{
+    struct sigaction action;
+    pthread_t irq, thread;
+    uint32_t p, idles = 0;
+
+    alarm(TIMEOUT_S);
+    event_loop_init(&loop, NULL, irq_idle);
+    loop_thread = pthread_self();
+    action.sa_handler = irq_handler;
+    action.sa_flags = 0;
+    sigemptyset(&action.sa_mask);
+    sigaction(IRQ_SIGNAL, &action, NULL);
+
+    pthread_create(&irq, NULL, irq_source, NULL);
+    pthread_create(&thread, NULL, thread_source, NULL);
+    /* the loop thread posts too, it can be interrupted in the middle */
+    while(!atomic_load(&irq_done) || !atomic_load(&thread_done) || event_pending(&loop)){
+        if(event_run_once(&loop)){
+            continue;
+        }
+        if(posted[LOOP_SOURCE] < THREAD_POSTS / 10U){
+            if(0 == event_post(&loop, &check[EVENT_PRIO_GUI], EVENT_ARG(LOOP_SOURCE, posted[LOOP_SOURCE]))){
+                posted[LOOP_SOURCE]++;
+            }
+            continue;
+        }
+        idles++;
+        loop.idle();
+    }
+    pthread_join(irq, NULL);
+    pthread_join(thread, NULL);
+    while(event_run_once(&loop)){
+    }
+    signal(IRQ_SIGNAL, SIG_IGN);
+    alarm(0);
+
+    CHECK_EQ(atomic_load(&misorders), 0);
+    for(p = 0; p < EVENT_PRIORITIES; p++){
+        CHECK_EQ(ran[p], posted[p]);
+        /* the thread's refused posts count on the lowest priority too */
+        if(EVENT_PRIO_IDLE == p){
+            CHECK(check[p].dropped >= rejected[p]);
+        }else{
+            CHECK_EQ(check[p].dropped, rejected[p]);
+        }
+    }
+    CHECK_EQ(ran[THREAD_SOURCE], THREAD_POSTS);
+    CHECK_EQ(ran[LOOP_SOURCE], posted[LOOP_SOURCE]);
+    CHECK(atomic_load(&irq_count) > 0U);
+    CHECK(idles > 0U);
+}
+
+int main(void)
+{
+    test_rules();
+    test_irq();
+    return test_result();
+}
@@ -0,0 +1,370 @@
+/*!
+    \file    test_gui_3d.c
+    \brief   host test of the software 3D pipeline: rasterization rules and golden renders
+
+    The rules are checked directly: triangles sharing edges cover every
+    pixel of their union exactly once, back faces are culled, the
+    nearest surface wins whatever the draw order, and clipped triangles
+    never write outside the viewport. The golden renders are a textured
+    cube under a perspective camera at a few angles, compared by a hash
+    of the colour buffer. The pipeline is integer only, so the hashes
+    are the same on every host and on the target. After a deliberate
+    change to the output, run the test with a directory argument: it
+    writes each render there as a PPM file and prints the new hashes.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "test.h"
+#include "gui_3d.h"
+
+#define VIEW_WIDTH                  128
+#define VIEW_HEIGHT                 96
+/* pixels around the viewport that must stay untouched */
+#define GUARD                       8
+#define BUF_WIDTH                   (VIEW_WIDTH + 2 * GUARD)
+#define BUF_HEIGHT                  (VIEW_HEIGHT + 2 * GUARD)
+#define GUARD_COLOR                 0xA5A5U
+
+#define Q(x)                        ((int32_t)((x) * GUI_3D_ONE))
+
+static uint16_t color_buf[BUF_HEIGHT][BUF_WIDTH];
+static uint16_t depth_buf[BUF_HEIGHT][BUF_WIDTH];
+static uint8_t coverage[VIEW_HEIGHT][VIEW_WIDTH];
+static gui_3d_struct ctx;
+static uint32_t seed = 1U;
+
+/* hashes of the golden renders, see the file comment to update them */
+static const struct {
+    int32_t yaw;
+    int32_t pitch;
+    uint32_t hash;
+} goldens[] = {
+    {0, 0, 0xF76F1745U},
+    {30, 20, 0x31D392D7U},
+    {135, -35, 0xF9417D39U},
+    {250, 60, 0x2ACA8A68U},
+};
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+/* clear both buffers and bind the viewport in the middle of them */
+static void target_reset(void)
+{
+    uint32_t x, y;
+
+    for(y = 0; y < BUF_HEIGHT; y++){
+        for(x = 0; x < BUF_WIDTH; x++){
+            color_buf[y][x] = GUARD_COLOR;
+            depth_buf[y][x] = GUARD_COLOR;
+        }
+    }
+    gui_3d_init(&ctx, &color_buf[GUARD][GUARD], BUF_WIDTH, &depth_buf[GUARD][GUARD], BUF_WIDTH, VIEW_WIDTH, VIEW_HEIGHT);
+    gui_3d_clear_depth(&ctx);
+    for(y = 0; y < VIEW_HEIGHT; y++){
+        for(x = 0; x < VIEW_WIDTH; x++){
+            color_buf[GUARD + y][GUARD + x] = 0;
+        }
+    }
+}
+
+/* check that nothing outside the viewport was written */
+static void check_guard(void)
+{
+    uint32_t x, y, bad = 0;
+
+    for(y = 0; y < BUF_HEIGHT; y++){
+        for(x = 0; x < BUF_WIDTH; x++){
+            if((y >= GUARD) && (y < GUARD + VIEW_HEIGHT) && (x >= GUARD) && (x < GUARD + VIEW_WIDTH)){
+                continue;
+            }
+            bad += (GUARD_COLOR != color_buf[y][x]) || (GUARD_COLOR != depth_buf[y][x]);
+        }
+    }
+    CHECK_EQ(bad, 0);
+}
+
+static uint32_t view_hash(void)
+{
+    uint32_t x, y, hash = 2166136261U;
+
+    for(y = 0; y < VIEW_HEIGHT; y++){
+        for(x = 0; x < VIEW_WIDTH; x++){
+            hash = (hash ^ color_buf[GUARD + y][GUARD + x]) * 16777619U;
+        }
+    }
+    return hash;
+}
+
+/* count the pixels one triangle covers into the coverage map */
+static uint32_t cover(const gui_3d_vertex_struct *a, const gui_3d_vertex_struct *b, const gui_3d_vertex_struct *c)
+{
+    uint32_t x, y, count = 0;
+
+    target_reset();
+    gui_3d_draw_triangle(&ctx, a, b, c, NULL, 0xFFFFU);
+    for(y = 0; y < VIEW_HEIGHT; y++){
+        for(x = 0; x < VIEW_WIDTH; x++){
+            if(0xFFFFU == color_buf[GUARD + y][GUARD + x]){
+                coverage[y][x]++;
+                count++;
+            }
+        }
+    }
+    CHECK_EQ(ctx.stats.pixels, count);
+    check_guard();
+    return count;
+}
+
+/* a jittered grid of counter-clockwise triangles covers its outline once, with no gaps */
+static void test_shared_edges(void)
+{
+    static gui_3d_vertex_struct grid[9][9];
+    gui_3d_vertex_struct *a, *b, *c, *d;
+    uint32_t round, i, j, x, y, twice, holes, covered;
+
+    for(round = 0; round < 20U; round++){
+        memset(coverage, 0, sizeof(coverage));
+        for(j = 0; j < 9U; j++){
+            for(i = 0; i < 9U; i++){
+                /* inner points move by up to a third of a cell, in 1/65536 steps */
+                grid[j][i].x = Q(-0.8) + (int32_t)i * Q(0.2) + (((i % 8U) != 0U) ? (int32_t)rnd(Q(0.13)) - Q(0.065) : 0);
+                grid[j][i].y = Q(-0.8) + (int32_t)j * Q(0.2) + (((j % 8U) != 0U) ? (int32_t)rnd(Q(0.13)) - Q(0.065) : 0);
+                grid[j][i].z = 0;
+            }
+        }
+        for(j = 0; j < 8U; j++){
+            for(i = 0; i < 8U; i++){
+                a = &grid[j][i];
+                b = &grid[j][i + 1U];
+                c = &grid[j + 1U][i + 1U];
+                d = &grid[j + 1U][i];
+                /* y up in clip space, so a b c runs counter-clockwise */
+                cover(a, b, c);
+                cover(a, c, d);
+            }
+        }
+
+        /* the outline is the square from -0.8 to 0.8, pixel centres inside it */
+        twice = 0;
+        holes = 0;
+        covered = 0;
+        for(y = 0; y < VIEW_HEIGHT; y++){
+            for(x = 0; x < VIEW_WIDTH; x++){
+                twice += coverage[y][x] > 1U;
+                covered += coverage[y][x] != 0U;
+                if((x >= 13U) && (x < VIEW_WIDTH - 13U) && (y >= 10U) && (y < VIEW_HEIGHT - 10U)){
+                    holes += coverage[y][x] == 0U;
+                }
+            }
+        }
+        CHECK_EQ(twice, 0);
+        CHECK_EQ(holes, 0);
+        /* 0.8 of a half width of 64 is 51.2 pixels each side */
+        CHECK_EQ(covered, 102 * 76);
+    }
+}
+
+/* clockwise triangles are back faces */
+static void test_culling(void)
+{
+    gui_3d_vertex_struct a = {Q(-0.5), Q(-0.5), 0, 0, 0};
+    gui_3d_vertex_struct b = {Q(0.5), Q(-0.5), 0, 0, 0};
+    gui_3d_vertex_struct c = {Q(0), Q(0.5), 0, 0, 0};
+    gui_3d_vertex_struct d = {Q(0.25), Q(0), 0, 0, 0};
+
+    target_reset();
+    gui_3d_draw_triangle(&ctx, &a, &c, &b, NULL, 0xFFFFU);
+    CHECK_EQ(ctx.stats.triangles, 1);
+    CHECK_EQ(ctx.stats.culled, 1);
+    CHECK_EQ(ctx.stats.pixels, 0);
+
+    ctx.cull_back = 0;
+    gui_3d_draw_triangle(&ctx, &a, &c, &b, NULL, 0xFFFFU);
+    CHECK_EQ(ctx.stats.drawn, 1);
+    CHECK(ctx.stats.pixels > 0U);
+
+    /* degenerate triangles draw nothing either way */
+    gui_3d_draw_triangle(&ctx, &a, &b, &b, NULL, 0xFFFFU);
+    gui_3d_draw_triangle(&ctx, &a, &d, &(gui_3d_vertex_struct){Q(1.0), Q(0.5), 0, 0, 0}, NULL, 0xFFFFU);
+    CHECK_EQ(ctx.stats.culled, 3);
+}
+
+/* the nearest triangle wins in either order */
+static void test_depth(void)
+{
+    gui_3d_vertex_struct n0 = {Q(-0.6), Q(-0.6), Q(-0.5), 0, 0};
+    gui_3d_vertex_struct n1 = {Q(0.4), Q(-0.6), Q(-0.5), 0, 0};
+    gui_3d_vertex_struct n2 = {Q(-0.1), Q(0.4), Q(-0.5), 0, 0};
+    gui_3d_vertex_struct f0 = {Q(-0.4), Q(-0.4), Q(0.5), 0, 0};
+    gui_3d_vertex_struct f1 = {Q(0.6), Q(-0.4), Q(0.5), 0, 0};
+    gui_3d_vertex_struct f2 = {Q(0.1), Q(0.6), Q(0.5), 0, 0};
+    uint32_t near_first, far_first;
+
+    target_reset();
+    gui_3d_draw_triangle(&ctx, &n0, &n1, &n2, NULL, 0x1111U);
+    gui_3d_draw_triangle(&ctx, &f0, &f1, &f2, NULL, 0x2222U);
+    near_first = view_hash();
+
+    target_reset();
+    gui_3d_draw_triangle(&ctx, &f0, &f1, &f2, NULL, 0x2222U);
+    gui_3d_draw_triangle(&ctx, &n0, &n1, &n2, NULL, 0x1111U);
+    far_first = view_hash();
+
+    CHECK_EQ(near_first, far_first);
+    /* the middle of the overlap is the near one */
+    CHECK_EQ(color_buf[GUARD + VIEW_HEIGHT / 2][GUARD + VIEW_WIDTH / 2], 0x1111U);
+}
+
+/* triangles crossing the clip planes stay in the viewport, ones outside are rejected */
+static void test_clipping(void)
+{
+    static const int32_t big = Q(3.0);
+    gui_3d_vertex_struct a = {-big, -big, 0, 0, 0};
+    gui_3d_vertex_struct b = {big, -big, 0, 0, 0};
+    gui_3d_vertex_struct c = {0, big, 0, 0, 0};
+    gui_3d_vertex_struct o0 = {Q(2.0), Q(0), 0, 0, 0};
+    gui_3d_vertex_struct o1 = {Q(3.0), Q(0), 0, 0, 0};
+    gui_3d_vertex_struct o2 = {Q(2.5), Q(1.0), 0, 0, 0};
+    gui_3d_vertex_struct p0 = {Q(-0.5), Q(-0.5), Q(-2.0), 0, 0};
+    gui_3d_vertex_struct p1 = {Q(0.5), Q(-0.5), Q(0.5), 0, 0};
+    gui_3d_vertex_struct p2 = {Q(0), Q(0.5), Q(0.5), 0, 0};
+
+    /* a triangle larger than the view fills it exactly */
+    target_reset();
+    gui_3d_draw_triangle(&ctx, &a, &b, &c, NULL, 0xFFFFU);
+    CHECK_EQ(ctx.stats.clipped, 1);
+    CHECK_EQ(ctx.stats.drawn, 1);
+    CHECK_EQ(ctx.stats.pixels, VIEW_WIDTH * VIEW_HEIGHT);
+    check_guard();
+
+    target_reset();
+    gui_3d_draw_triangle(&ctx, &o0, &o1, &o2, NULL, 0xFFFFU);
+    CHECK_EQ(ctx.stats.rejected, 1);
+    CHECK_EQ(ctx.stats.pixels, 0);
+
+    /* one vertex in front of the near plane */
+    target_reset();
+    gui_3d_draw_triangle(&ctx, &p0, &p1, &p2, NULL, 0xFFFFU);
+    CHECK_EQ(ctx.stats.clipped, 1);
+    CHECK_EQ(ctx.stats.drawn, 1);
+    CHECK(ctx.stats.pixels > 0U);
+    check_guard();
+}
+
+/* a unit cube with one texture square per face */
+static const gui_3d_vertex_struct cube_vertices[24] = {
+    /* +z */
+    {Q(-1), Q(-1), Q(1), 0, 0}, {Q(1), Q(-1), Q(1), Q(1), 0}, {Q(1), Q(1), Q(1), Q(1), Q(1)}, {Q(-1), Q(1), Q(1), 0, Q(1)},
+    /* -z */
+    {Q(1), Q(-1), Q(-1), 0, 0}, {Q(-1), Q(-1), Q(-1), Q(1), 0}, {Q(-1), Q(1), Q(-1), Q(1), Q(1)}, {Q(1), Q(1), Q(-1), 0, Q(1)},
+    /* +x */
+    {Q(1), Q(-1), Q(1), 0, 0}, {Q(1), Q(-1), Q(-1), Q(1), 0}, {Q(1), Q(1), Q(-1), Q(1), Q(1)}, {Q(1), Q(1), Q(1), 0, Q(1)},
+    /* -x */
+    {Q(-1), Q(-1), Q(-1), 0, 0}, {Q(-1), Q(-1), Q(1), Q(1), 0}, {Q(-1), Q(1), Q(1), Q(1), Q(1)}, {Q(-1), Q(1), Q(-1), 0, Q(1)},
+    /* +y */
+    {Q(-1), Q(1), Q(1), 0, 0}, {Q(1), Q(1), Q(1), Q(1), 0}, {Q(1), Q(1), Q(-1), Q(1), Q(1)}, {Q(-1), Q(1), Q(-1), 0, Q(1)},
+    /* -y */
+    {Q(-1), Q(-1), Q(-1), 0, 0}, {Q(1), Q(-1), Q(-1), Q(1), 0}, {Q(1), Q(-1), Q(1), Q(1), Q(1)}, {Q(-1), Q(-1), Q(1), 0, Q(1)},
+};
+static uint16_t cube_indices[36];
+static uint16_t checker[16 * 16];
+static const gui_3d_texture_struct checker_texture = {checker, 4, 4};
+static const gui_3d_mesh_struct cube = {cube_vertices, cube_indices, 24, 12, &checker_texture, 0};
+
+static void cube_build(void)
+{
+    uint32_t face, x, y;
+
+    for(face = 0; face < 6U; face++){
+        cube_indices[face * 6U + 0U] = (uint16_t)(face * 4U + 0U);
+        cube_indices[face * 6U + 1U] = (uint16_t)(face * 4U + 1U);
+        cube_indices[face * 6U + 2U] = (uint16_t)(face * 4U + 2U);
+        cube_indices[face * 6U + 3U] = (uint16_t)(face * 4U + 0U);
+        cube_indices[face * 6U + 4U] = (uint16_t)(face * 4U + 2U);
+        cube_indices[face * 6U + 5U] = (uint16_t)(face * 4U + 3U);
+    }
+    for(y = 0; y < 16U; y++){
+        for(x = 0; x < 16U; x++){
+            checker[y * 16U + x] = (uint16_t)((((x >> 2) ^ (y >> 2)) & 1U) ? (x * 0x0800U + y * 0x40U) : 0xFFFFU);
+        }
+    }
+}
+
+/* write the viewport as a binary PPM file */
+static void write_ppm(const char *dir, uint32_t index)
+{
+    char path[512];
+    uint32_t x, y;
+    uint16_t p;
+    FILE *f;
+
+    snprintf(path, sizeof(path), "%s/gui_3d_golden_%u.ppm", dir, index);
+    f = fopen(path, "wb");
+    if(NULL == f){
+        printf("cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", VIEW_WIDTH, VIEW_HEIGHT);
+    for(y = 0; y < VIEW_HEIGHT; y++){
+        for(x = 0; x < VIEW_WIDTH; x++){
+            p = color_buf[GUARD + y][GUARD + x];
+            fputc((p >> 8) & 0xF8, f);
+            fputc((p >> 3) & 0xFC, f);
+            fputc((p << 3) & 0xF8, f);
+        }
+    }
+    fclose(f);
+}
+
+/* the textured cube in perspective against the stored hashes */
+static void test_golden(const char *dir)
+{
+    gui_mat4_struct proj, view, rot, model;
+    uint32_t i, hash;
+
+    cube_build();
+    gui_mat4_perspective(&proj, 60, (VIEW_WIDTH * GUI_3D_ONE) / VIEW_HEIGHT, Q(0.5), Q(20));
+    gui_mat4_translation(&view, 0, 0, Q(-4.5));
+    gui_mat4_mul(&view, &proj, &view);
+
+    for(i = 0; i < sizeof(goldens) / sizeof(goldens[0]); i++){
+        target_reset();
+        gui_3d_set_camera(&ctx, &view);
+        gui_mat4_rotation_y(&model, goldens[i].yaw);
+        gui_mat4_rotation_x(&rot, goldens[i].pitch);
+        gui_mat4_mul(&model, &rot, &model);
+        gui_3d_draw_mesh(&ctx, &cube, &model);
+        check_guard();
+
+        /* a closed convex mesh shows at most three faces and hides the rest */
+        CHECK_EQ(ctx.stats.triangles, 12);
+        CHECK(ctx.stats.culled >= 6U);
+        CHECK_EQ(ctx.stats.drawn + ctx.stats.culled, 12);
+
+        hash = view_hash();
+        if(NULL != dir){
+            write_ppm(dir, i);
+            printf("{%d, %d, 0x%08XU},\n", goldens[i].yaw, goldens[i].pitch, hash);
+        }else if(hash != goldens[i].hash){
+            printf("golden %u (yaw %d, pitch %d): hash 0x%08X, expected 0x%08X\n",
+                   i, goldens[i].yaw, goldens[i].pitch, hash, goldens[i].hash);
+            test_failed++;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    test_shared_edges();
+    test_culling();
+    test_depth();
+    test_clipping();
+    test_golden((argc > 1) ? argv[1] : NULL);
+    return test_result();
+}
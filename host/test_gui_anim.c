@@ -0,0 +1,443 @@
+/*!
+    \file    test_gui_anim.c
+    \brief   host test of the widget animations and the frame pacing
+
+    Every easing curve must start at 0 and end at 65536 without a jump
+    on the way, and the ones that do not overshoot or bounce must never
+    go back. Animations run on a fake clock: positions, values, colours
+    and alpha are checked part way and at the end, with a delay, a
+    clamped alpha, a done callback that restarts its animation and one
+    that stops another, and the millisecond clock wrapping in the
+    middle of a tween.
+
+    gui_frame_due() must render the first call, then once per period,
+    dropping and counting the slots missed by a late frame, also across
+    the clock wrap. gui_frame_task() is timed with a display that takes
+    a few milliseconds to flush.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "test.h"
+#include "gui_widget.h"
+#include "gui_anim.h"
+
+#define RED                         GUI_RGB565(255, 0, 0)
+#define BLUE                        GUI_RGB565(0, 0, 255)
+#define WHITE                       GUI_RGB565(255, 255, 255)
+#define BLACK                       GUI_RGB565(0, 0, 0)
+#define EASES                       (GUI_EASE_OUT_BOUNCE + 1)
+
+static uint32_t now_ms;
+static uint32_t flush_ms;
+static uint32_t done_count;
+
+static gui_widget_struct root, box, bar;
+static gui_anim_struct anim_x, anim_y, anim_alpha, anim_color, anim_value;
+
+static uint32_t fake_clock(void)
+{
+    return now_ms;
+}
+
+static void fake_fill_rect(const gui_rect_struct *rect, uint16_t color, uint8_t alpha)
+{
+    (void)rect;
+    (void)color;
+    (void)alpha;
+}
+
+/* the flush takes flush_ms of the frame */
+static void fake_flush(const gui_rect_struct *rect)
+{
+    (void)rect;
+    now_ms += flush_ms;
+}
+
+static const gui_disp_struct disp = {
+    fake_fill_rect,
+    NULL,
+    fake_flush
+};
+
+static void screen_build(void)
+{
+    gui_container_init(&root, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT, BLACK);
+    gui_init(&disp, &root);
+    gui_container_init(&box, 10, 20, 100, 50, RED);
+    gui_bar_init(&bar, 10, 200, 200, 20, 0, 1000);
+    gui_widget_add(&root, &box);
+    gui_widget_add(&root, &bar);
+}
+
+/* end points, no jumps, and the curves that must not go back */
+static void test_ease(void)
+{
+    int32_t e, t, v, prev, min, max, errors;
+
+    for(e = 0; e < EASES; e++){
+        CHECK_EQ(gui_ease((gui_ease_enum)e, 0), 0);
+        CHECK_EQ(gui_ease((gui_ease_enum)e, GUI_Q16_ONE), GUI_Q16_ONE);
+        CHECK_EQ(gui_ease((gui_ease_enum)e, -1000), 0);
+        CHECK_EQ(gui_ease((gui_ease_enum)e, 2 * GUI_Q16_ONE), GUI_Q16_ONE);
+
+        errors = 0;
+        prev = 0;
+        min = 0;
+        max = 0;
+        for(t = 1; t <= GUI_Q16_ONE; t++){
+            v = gui_ease((gui_ease_enum)e, t);
+            if((v - prev > 16) || (prev - v > 16)){
+                errors++;
+            }
+            if((e < GUI_EASE_OUT_BACK) && (v < prev)){
+                errors++;
+            }
+            min = (v < min) ? v : min;
+            max = (v > max) ? v : max;
+            prev = v;
+        }
+        if(0 != errors){
+            printf("ease %d: %d steps jump or go back\n", e, errors);
+            test_failed++;
+        }
+        /* only the back curve overshoots, nothing goes below the start */
+        CHECK_EQ(min, 0);
+        if(GUI_EASE_OUT_BACK == e){
+            CHECK(max > GUI_Q16_ONE + GUI_Q16_ONE / 20);
+        }else{
+            CHECK_EQ(max, GUI_Q16_ONE);
+        }
+    }
+
+    CHECK_EQ(gui_ease(GUI_EASE_LINEAR, 12345), 12345);
+    CHECK_EQ(gui_ease(GUI_EASE_IN_QUAD, GUI_Q16_ONE / 2), GUI_Q16_ONE / 4);
+    CHECK_EQ(gui_ease(GUI_EASE_OUT_QUAD, GUI_Q16_ONE / 2), GUI_Q16_ONE * 3 / 4);
+    CHECK_EQ(gui_ease(GUI_EASE_IN_CUBIC, GUI_Q16_ONE / 2), GUI_Q16_ONE / 8);
+    CHECK_EQ(gui_ease(GUI_EASE_OUT_CUBIC, GUI_Q16_ONE / 2), GUI_Q16_ONE * 7 / 8);
+    CHECK_EQ(gui_ease(GUI_EASE_IN_OUT_QUAD, GUI_Q16_ONE / 4), GUI_Q16_ONE / 8);
+    CHECK_EQ(gui_ease(GUI_EASE_IN_OUT_CUBIC, GUI_Q16_ONE / 4), GUI_Q16_ONE / 16);
+    /* the in-out curves are symmetric about the middle */
+    for(t = 0; t <= GUI_Q16_ONE; t += 997){
+        v = gui_ease(GUI_EASE_IN_OUT_QUAD, t) + gui_ease(GUI_EASE_IN_OUT_QUAD, GUI_Q16_ONE - t);
+        CHECK((v >= GUI_Q16_ONE - 2) && (v <= GUI_Q16_ONE + 2));
+        v = gui_ease(GUI_EASE_IN_OUT_CUBIC, t) + gui_ease(GUI_EASE_IN_OUT_CUBIC, GUI_Q16_ONE - t);
+        CHECK((v >= GUI_Q16_ONE - 2) && (v <= GUI_Q16_ONE + 2));
+        v = gui_ease(GUI_EASE_IN_OUT_SINE, t) + gui_ease(GUI_EASE_IN_OUT_SINE, GUI_Q16_ONE - t);
+        CHECK((v >= GUI_Q16_ONE - 64) && (v <= GUI_Q16_ONE + 64));
+    }
+    /* 0.7656 half way, the third bounce, and back at the end before 1 */
+    v = gui_ease(GUI_EASE_OUT_BOUNCE, GUI_Q16_ONE / 2);
+    CHECK((v > 50176 - 64) && (v < 50176 + 64));
+    CHECK(gui_ease(GUI_EASE_OUT_BOUNCE, 59578) > gui_ease(GUI_EASE_OUT_BOUNCE, 61000));
+}
+
+static void test_color_mix(void)
+{
+    CHECK_EQ(gui_color_mix(RED, BLUE, 0), RED);
+    CHECK_EQ(gui_color_mix(RED, BLUE, GUI_Q16_ONE), BLUE);
+    CHECK_EQ(gui_color_mix(RED, BLUE, -5), RED);
+    CHECK_EQ(gui_color_mix(RED, BLUE, GUI_Q16_ONE + 5), BLUE);
+    /* channel by channel, each on its own bits, rounded the same way up and down */
+    CHECK_EQ(gui_color_mix(BLACK, WHITE, GUI_Q16_ONE / 2), (16U << 11) | (32U << 5) | 16U);
+    CHECK_EQ(gui_color_mix(WHITE, BLACK, GUI_Q16_ONE / 2), (16U << 11) | (32U << 5) | 16U);
+    CHECK_EQ(gui_color_mix(RED, BLUE, GUI_Q16_ONE / 4), (23U << 11) | 8U);
+    CHECK_EQ(gui_color_mix(BLUE, RED, GUI_Q16_ONE / 4), (8U << 11) | 23U);
+    CHECK_EQ(gui_color_mix(WHITE, BLACK, 1), WHITE);
+    CHECK_EQ(gui_color_mix(BLACK, WHITE, GUI_Q16_ONE - 1), WHITE);
+}
+
+/* position, value, colour and alpha part way and at the end */
+static void test_tween(void)
+{
+    screen_build();
+    now_ms = 1000U;
+
+    gui_anim_init(&anim_x, &box, GUI_ANIM_PROP_X, 10, 110, 100U, GUI_EASE_LINEAR);
+    gui_anim_init(&anim_y, &box, GUI_ANIM_PROP_Y, 20, 220, 100U, GUI_EASE_IN_QUAD);
+    gui_anim_init(&anim_color, &box, GUI_ANIM_PROP_BG_COLOR, RED, BLUE, 200U, GUI_EASE_LINEAR);
+    gui_anim_init(&anim_value, &bar, GUI_ANIM_PROP_VALUE, 0, 2000, 100U, GUI_EASE_LINEAR);
+    /* the alpha waits 50 ms, overshoots above 255 and must clamp */
+    gui_anim_init(&anim_alpha, &box, GUI_ANIM_PROP_ALPHA, -100, 300, 100U, GUI_EASE_OUT_BACK);
+    anim_alpha.delay = 50U;
+    gui_anim_start(&anim_x);
+    gui_anim_start(&anim_y);
+    gui_anim_start(&anim_color);
+    gui_anim_start(&anim_value);
+    gui_anim_start(&anim_alpha);
+    box.alpha = 77U;
+
+    CHECK_EQ(gui_anim_update(), 5);
+    CHECK_EQ(box.x, 10);
+    CHECK_EQ(box.bg_color, RED);
+    CHECK_EQ(box.alpha, 77);
+
+    now_ms = 1050U;
+    CHECK_EQ(gui_anim_update(), 5);
+    CHECK_EQ(box.x, 60);
+    CHECK_EQ(box.y, 70);
+    CHECK_EQ(box.area.x0, 60);
+    CHECK_EQ(box.bg_color, gui_color_mix(RED, BLUE, GUI_Q16_ONE / 4));
+    CHECK_EQ(box.fg_color, WHITE);
+    CHECK_EQ(bar.u.bar.value, 1000);
+    /* the delay is over, the start clamps at 0 */
+    CHECK_EQ(box.alpha, 0);
+
+    now_ms = 1080U;
+    CHECK_EQ(gui_anim_update(), 5);
+    CHECK_EQ(box.alpha, 255);
+    CHECK_EQ(box.x, 90);
+
+    /* past the end the end values exactly, each finished animation leaves the list */
+    now_ms = 1130U;
+    CHECK_EQ(gui_anim_update(), 2);
+    CHECK_EQ(box.x, 110);
+    CHECK_EQ(box.y, 220);
+    CHECK_EQ(bar.u.bar.value, 1000);
+    CHECK(!anim_x.active);
+    CHECK(anim_alpha.active);
+    now_ms = 1150U;
+    CHECK_EQ(gui_anim_update(), 1);
+    CHECK_EQ(box.alpha, 255);
+    CHECK(!anim_alpha.active);
+    now_ms = 5000U;
+    CHECK_EQ(gui_anim_update(), 0);
+    CHECK_EQ(box.bg_color, BLUE);
+    CHECK_EQ(gui_anim_update(), 0);
+
+    /* one past either end of the alpha range */
+    gui_anim_init(&anim_alpha, &box, GUI_ANIM_PROP_ALPHA, -1, 256, 10U, GUI_EASE_LINEAR);
+    gui_anim_start(&anim_alpha);
+    CHECK_EQ(gui_anim_update(), 1);
+    CHECK_EQ(box.alpha, 0);
+    now_ms = 5010U;
+    CHECK_EQ(gui_anim_update(), 0);
+    CHECK_EQ(box.alpha, 255);
+
+    /* stopped animations keep their value, one widget's stop leaves the others */
+    now_ms = 6000U;
+    gui_anim_init(&anim_x, &box, GUI_ANIM_PROP_X, 0, 100, 100U, GUI_EASE_LINEAR);
+    gui_anim_init(&anim_value, &bar, GUI_ANIM_PROP_VALUE, 0, 100, 100U, GUI_EASE_LINEAR);
+    gui_anim_init(&anim_color, &box, GUI_ANIM_PROP_FG_COLOR, BLACK, WHITE, 100U, GUI_EASE_LINEAR);
+    gui_anim_start(&anim_x);
+    gui_anim_start(&anim_value);
+    gui_anim_start(&anim_color);
+    now_ms = 6025U;
+    CHECK_EQ(gui_anim_update(), 3);
+    CHECK_EQ(box.fg_color, gui_color_mix(BLACK, WHITE, GUI_Q16_ONE / 4));
+    CHECK_EQ(box.bg_color, BLUE);
+    gui_anim_stop_widget(&box);
+    CHECK(!anim_x.active);
+    CHECK(!anim_color.active);
+    now_ms = 6050U;
+    CHECK_EQ(gui_anim_update(), 1);
+    CHECK_EQ(box.x, 25);
+    CHECK_EQ(bar.u.bar.value, 50);
+    gui_anim_stop(&anim_value);
+    gui_anim_stop(&anim_value);
+    CHECK_EQ(gui_anim_update(), 0);
+    CHECK_EQ(bar.u.bar.value, 50);
+}
+
+/* back and forth between the end points, as a blinking widget would */
+static void ping_pong(gui_anim_struct *anim)
+{
+    int32_t from = anim->from;
+
+    done_count++;
+    /* the widget is at the end value when the callback runs */
+    CHECK_EQ(anim->widget->x, anim->to);
+    anim->from = anim->to;
+    anim->to = from;
+    if(done_count < 3U){
+        gui_anim_start(anim);
+    }
+}
+
+static void stop_value(gui_anim_struct *anim)
+{
+    (void)anim;
+    done_count++;
+    gui_anim_stop(&anim_value);
+}
+
+static void test_done(void)
+{
+    screen_build();
+    done_count = 0;
+    now_ms = 100U;
+    gui_anim_init(&anim_x, &box, GUI_ANIM_PROP_X, 0, 100, 40U, GUI_EASE_LINEAR);
+    anim_x.done = ping_pong;
+    gui_anim_start(&anim_x);
+
+    now_ms = 120U;
+    CHECK_EQ(gui_anim_update(), 1);
+    CHECK_EQ(box.x, 50);
+    CHECK_EQ(done_count, 0);
+    /* finished late, restarted from the callback: not counted and not moved in the same update */
+    now_ms = 150U;
+    CHECK_EQ(gui_anim_update(), 0);
+    CHECK_EQ(done_count, 1);
+    CHECK(anim_x.active);
+    CHECK_EQ(box.x, 100);
+    CHECK_EQ(anim_x.start, 150);
+    now_ms = 160U;
+    CHECK_EQ(gui_anim_update(), 1);
+    CHECK_EQ(box.x, 75);
+    now_ms = 190U;
+    CHECK_EQ(gui_anim_update(), 0);
+    CHECK_EQ(box.x, 0);
+    CHECK_EQ(done_count, 2);
+    now_ms = 230U;
+    CHECK_EQ(gui_anim_update(), 0);
+    CHECK_EQ(box.x, 100);
+    CHECK_EQ(done_count, 3);
+    CHECK(!anim_x.active);
+    now_ms = 300U;
+    CHECK_EQ(gui_anim_update(), 0);
+    CHECK_EQ(done_count, 3);
+
+    /* a callback stopping another running animation */
+    gui_anim_init(&anim_y, &box, GUI_ANIM_PROP_Y, 0, 10, 10U, GUI_EASE_LINEAR);
+    anim_y.done = stop_value;
+    gui_anim_init(&anim_value, &bar, GUI_ANIM_PROP_VALUE, 0, 100, 100U, GUI_EASE_LINEAR);
+    gui_anim_start(&anim_value);
+    gui_anim_start(&anim_y);
+    now_ms = 320U;
+    CHECK_EQ(gui_anim_update(), 1);
+    CHECK_EQ(done_count, 4);
+    CHECK(!anim_value.active);
+    CHECK_EQ(bar.u.bar.value, 20);
+    CHECK_EQ(gui_anim_update(), 0);
+}
+
+/* the clock wraps in the middle of a tween and of a delay */
+static void test_wrap(void)
+{
+    screen_build();
+    now_ms = 0xFFFFFFF0U;
+    gui_anim_init(&anim_x, &box, GUI_ANIM_PROP_X, 0, 100, 100U, GUI_EASE_LINEAR);
+    gui_anim_init(&anim_value, &bar, GUI_ANIM_PROP_VALUE, 0, 100, 100U, GUI_EASE_LINEAR);
+    anim_value.delay = 40U;
+    gui_anim_start(&anim_x);
+    gui_anim_start(&anim_value);
+    CHECK_EQ(anim_value.start, 0x18U);
+
+    now_ms = 0x10U;
+    CHECK_EQ(gui_anim_update(), 2);
+    CHECK_EQ(box.x, 32);
+    CHECK_EQ(bar.u.bar.value, 0);
+    now_ms = 0x18U + 30U;
+    CHECK_EQ(gui_anim_update(), 2);
+    CHECK_EQ(box.x, 70);
+    CHECK_EQ(bar.u.bar.value, 30);
+    now_ms = 0x18U + 100U;
+    CHECK_EQ(gui_anim_update(), 0);
+    CHECK_EQ(box.x, 100);
+    CHECK_EQ(bar.u.bar.value, 100);
+}
+
+static void test_frame_due(void)
+{
+    const gui_frame_stats_struct *stats = gui_frame_stats_get();
+    uint32_t skipped = stats->skipped;
+
+    gui_frame_set_period(16U);
+    now_ms = 500U;
+    CHECK(gui_frame_due());
+    CHECK(!gui_frame_due());
+    now_ms = 515U;
+    CHECK(!gui_frame_due());
+    now_ms = 516U;
+    CHECK(gui_frame_due());
+    CHECK(!gui_frame_due());
+    /* a little late: no slot missed, the next stays on the grid */
+    now_ms = 540U;
+    CHECK(gui_frame_due());
+    CHECK_EQ(stats->skipped, skipped);
+    now_ms = 547U;
+    CHECK(!gui_frame_due());
+    now_ms = 548U;
+    CHECK(gui_frame_due());
+    /* three slots missed: 564, 580, 596 dropped, 612 rendered now, the next at 628 */
+    now_ms = 615U;
+    CHECK(gui_frame_due());
+    CHECK_EQ(stats->skipped, skipped + 3U);
+    now_ms = 627U;
+    CHECK(!gui_frame_due());
+    now_ms = 628U;
+    CHECK(gui_frame_due());
+
+    /* across the clock wrap */
+    now_ms = 0xFFFFFFF8U;
+    gui_anim_set_clock(fake_clock);
+    CHECK(gui_frame_due());
+    now_ms = 0xFFFFFFFCU;
+    CHECK(!gui_frame_due());
+    now_ms = 0x7U;
+    CHECK(!gui_frame_due());
+    now_ms = 0x8U;
+    CHECK(gui_frame_due());
+    now_ms = 0x8U + 16U * 5U + 1U;
+    CHECK(gui_frame_due());
+    CHECK_EQ(stats->skipped, skipped + 3U + 4U);
+
+    /* period 0 renders on every call */
+    gui_frame_set_period(0U);
+    CHECK(gui_frame_due());
+    CHECK(gui_frame_due());
+    CHECK_EQ(stats->skipped, skipped + 7U);
+    gui_frame_set_period(GUI_FRAME_PERIOD_MS);
+}
+
+/* the frame task updates, redraws and times the frame */
+static void test_frame_task(void)
+{
+    const gui_frame_stats_struct *stats = gui_frame_stats_get();
+    uint32_t frames = stats->frames;
+
+    screen_build();
+    gui_refresh();
+    flush_ms = 5U;
+    now_ms = 2000U;
+    gui_frame_set_period(16U);
+    gui_anim_init(&anim_x, &box, GUI_ANIM_PROP_X, 0, 160, 160U, GUI_EASE_LINEAR);
+    gui_anim_start(&anim_x);
+
+    CHECK_EQ(gui_frame_task(), 1);
+    CHECK_EQ(stats->frames, frames + 1U);
+    CHECK_EQ(stats->last_frame_ms, 5);
+    CHECK_EQ(now_ms, 2005);
+    CHECK_EQ(gui_frame_task(), 0);
+    now_ms = 2016U;
+    CHECK_EQ(gui_frame_task(), 1);
+    CHECK_EQ(box.x, 16);
+    /* nothing moved, nothing flushed */
+    flush_ms = 9U;
+    now_ms = 2032U;
+    gui_anim_stop(&anim_x);
+    CHECK_EQ(gui_frame_task(), 1);
+    CHECK_EQ(stats->last_frame_ms, 0);
+    CHECK(stats->max_frame_ms >= 5U);
+    gui_widget_set_alpha(&box, 10U);
+    now_ms = 2048U;
+    CHECK_EQ(gui_frame_task(), 1);
+    CHECK_EQ(stats->last_frame_ms, 9);
+    CHECK(stats->max_frame_ms >= 9U);
+    CHECK_EQ(stats->frames, frames + 4U);
+    flush_ms = 0;
+}
+
+int main(void)
+{
+    gui_anim_set_clock(fake_clock);
+    test_ease();
+    test_color_mix();
+    test_tween();
+    test_done();
+    test_wrap();
+    test_frame_due();
+    test_frame_task();
+    return test_result();
+}
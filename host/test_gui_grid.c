@@ -0,0 +1,315 @@
+/*!
+    \file    test_gui_grid.c
+    \brief   host test of the spatial index against brute force and tree walks
+
+    The index alone runs random inserts, moves and removals, with items
+    on and off the screen, small and big, and checks every point and
+    rectangle query against a scan of all live items. Then random widget
+    trees are hit tested and redrawn once through tree walks and once
+    through the index, and the hits, renderer statistics and fills must
+    be the same.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "test.h"
+#include "gui_widget.h"
+#include "gui_grid.h"
+
+#define MODEL_ITEMS                 GUI_GRID_MAX_ITEMS
+#define INDEX_ROUNDS                20000U
+#define TREE_WIDGETS                300U
+#define TREE_ROUNDS                 20U
+#define TREE_POINTS                 500U
+#define TREE_DAMAGES                50U
+
+static gui_grid_struct grid;
+static uint32_t seed = 1U;
+
+/* model of the index */
+static struct {
+    int32_t id;
+    gui_rect_struct rect;
+} model[MODEL_ITEMS];
+static uint32_t model_count;
+
+static gui_widget_struct widgets[TREE_WIDGETS];
+static uint32_t fill_hash;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+/* a rectangle that is mostly small, sometimes big and sometimes off the screen */
+static void random_rect(gui_rect_struct *r)
+{
+    uint32_t kind = rnd(10);
+    int16_t w = (int16_t)(1 + rnd(kind < 7 ? 80 : 500));
+    int16_t h = (int16_t)(1 + rnd(kind < 7 ? 80 : 300));
+
+    if(kind == 9){
+        gui_rect_set(r, (int16_t)(rnd(2000) - 1000), (int16_t)(rnd(2000) - 1000), w, h);
+    }else{
+        gui_rect_set(r, (int16_t)(rnd(GUI_SCREEN_WIDTH + 100) - 50), (int16_t)(rnd(GUI_SCREEN_HEIGHT + 100) - 50), w, h);
+    }
+}
+
+/* a query rectangle on the screen */
+static void random_query(gui_rect_struct *r)
+{
+    int16_t x0 = (int16_t)rnd(GUI_SCREEN_WIDTH), y0 = (int16_t)rnd(GUI_SCREEN_HEIGHT);
+    int16_t x1 = (int16_t)(x0 + 1 + rnd(GUI_SCREEN_WIDTH - x0)), y1 = (int16_t)(y0 + 1 + rnd(GUI_SCREEN_HEIGHT - y0));
+
+    r->x0 = x0;
+    r->y0 = y0;
+    r->x1 = (x1 - x0 > 200) ? (int16_t)(x0 + rnd(200) + 1) : x1;
+    r->y1 = (y1 - y0 > 200) ? (int16_t)(y0 + rnd(200) + 1) : y1;
+}
+
+/* compare a query result with the model entries matching it */
+static void check_result(void **out, uint32_t found, const uint8_t *expect)
+{
+    static uint8_t seen[MODEL_ITEMS];
+    uint32_t i, k, wanted = 0;
+
+    memset(seen, 0, sizeof(seen));
+    for(i = 0; i < found; i++){
+        k = (uint32_t)((uintptr_t)out[i] - 1U);
+        CHECK(k < model_count);
+        if(k >= model_count){
+            continue;
+        }
+        /* each item at most once, and only matching ones */
+        CHECK_EQ(seen[k], 0);
+        CHECK(expect[k]);
+        seen[k] = 1;
+    }
+    for(i = 0; i < model_count; i++){
+        wanted += expect[i];
+    }
+    CHECK_EQ(found, wanted);
+}
+
+static void test_index(void)
+{
+    static void *out[MODEL_ITEMS];
+    static uint8_t expect[MODEL_ITEMS];
+    gui_rect_struct r, overlap;
+    uint32_t round, i, k, op, found;
+    int16_t x, y;
+    int32_t id;
+
+    gui_grid_init(&grid);
+    model_count = 0;
+
+    for(round = 0; round < INDEX_ROUNDS; round++){
+        op = rnd(100);
+        if((op < 30) && (model_count < MODEL_ITEMS)){
+            random_rect(&r);
+            /* the data of an item is its model slot plus one */
+            id = gui_grid_insert(&grid, &r, (void *)(uintptr_t)(model_count + 1U));
+            CHECK(id >= 0);
+            model[model_count].id = id;
+            model[model_count].rect = r;
+            model_count++;
+        }else if((op < 50) && (0U != model_count)){
+            k = rnd(model_count);
+            random_rect(&r);
+            gui_grid_update(&grid, model[k].id, &r);
+            model[k].rect = r;
+        }else if((op < 60) && (0U != model_count)){
+            /* small moves that mostly stay in the same cells */
+            k = rnd(model_count);
+            r = model[k].rect;
+            r.x0 = (int16_t)(r.x0 + 1);
+            r.x1 = (int16_t)(r.x1 + 1);
+            gui_grid_update(&grid, model[k].id, &r);
+            model[k].rect = r;
+        }else if((op < 70) && (0U != model_count)){
+            /* remove, the last slot takes its place and its data */
+            k = rnd(model_count);
+            gui_grid_remove(&grid, model[k].id);
+            CHECK(NULL == gui_grid_data(&grid, model[k].id));
+            model[k] = model[--model_count];
+            if(k < model_count){
+                gui_grid_remove(&grid, model[k].id);
+                model[k].id = gui_grid_insert(&grid, &model[k].rect, (void *)(uintptr_t)(k + 1U));
+            }
+        }else if(op < 85){
+            x = (int16_t)(rnd(GUI_SCREEN_WIDTH + 20) - 10);
+            y = (int16_t)(rnd(GUI_SCREEN_HEIGHT + 20) - 10);
+            found = gui_grid_query_point(&grid, x, y, out, MODEL_ITEMS);
+            for(i = 0; i < model_count; i++){
+                expect[i] = (uint8_t)((x >= 0) && (y >= 0) && (x < GUI_SCREEN_WIDTH) && (y < GUI_SCREEN_HEIGHT) &&
+                                      gui_rect_contains_point(&model[i].rect, x, y));
+            }
+            check_result(out, found, expect);
+        }else{
+            random_query(&r);
+            found = gui_grid_query_rect(&grid, &r, out, MODEL_ITEMS);
+            for(i = 0; i < model_count; i++){
+                expect[i] = (uint8_t)gui_rect_intersect(&overlap, &model[i].rect, &r);
+            }
+            check_result(out, found, expect);
+        }
+        CHECK_EQ(grid.count, model_count);
+    }
+
+    /* a full index refuses more items, and a full query stops at max */
+    gui_grid_init(&grid);
+    model_count = 0;
+    while(model_count < MODEL_ITEMS){
+        gui_rect_set(&r, 0, 0, 10, 10);
+        model[model_count].id = gui_grid_insert(&grid, &r, (void *)(uintptr_t)(model_count + 1U));
+        CHECK(model[model_count].id >= 0);
+        model[model_count].rect = r;
+        model_count++;
+    }
+    gui_rect_set(&r, 0, 0, 10, 10);
+    CHECK_EQ(gui_grid_insert(&grid, &r, NULL), -1);
+    CHECK_EQ(gui_grid_query_point(&grid, 5, 5, out, 7), 7);
+    CHECK_EQ(gui_grid_query_rect(&grid, &r, out, 7), 7);
+}
+
+static void hash_fill_rect(const gui_rect_struct *rect, uint16_t color, uint8_t alpha)
+{
+    uint32_t v[6] = {(uint32_t)rect->x0, (uint32_t)rect->y0, (uint32_t)rect->x1, (uint32_t)rect->y1, color, alpha};
+    uint32_t i;
+
+    for(i = 0; i < 6; i++){
+        fill_hash = (fill_hash ^ v[i]) * 16777619U;
+    }
+}
+
+static const gui_disp_struct disp = {
+    hash_fill_rect,
+    NULL,
+    NULL
+};
+
+/* a random tree of nested containers, bars, buttons and transparent labels */
+static void tree_build(gui_widget_struct *root)
+{
+    gui_widget_struct *w, *parent;
+    uint32_t i, kind;
+    gui_rect_struct r;
+
+    gui_container_init(root, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT, 0);
+    gui_init(&disp, root);
+    for(i = 0; i < TREE_WIDGETS; i++){
+        w = &widgets[i];
+        /* parents come first, so the tree has some depth */
+        parent = ((i > 0) && (rnd(3) == 0)) ? &widgets[rnd(i)] : root;
+        if((parent != root) && (parent->draw != root->draw)){
+            parent = root;
+        }
+        random_rect(&r);
+        kind = rnd(5);
+        if(kind == 0){
+            gui_container_init(w, (int16_t)(r.x0 / 2), (int16_t)(r.y0 / 2), (int16_t)(r.x1 - r.x0 + 40), (int16_t)(r.y1 - r.y0 + 40),
+                               (uint16_t)rnd(0x10000));
+        }else if(kind == 1){
+            gui_label_init(w, r.x0, r.y0, (int16_t)(r.x1 - r.x0), (int16_t)(r.y1 - r.y0), "x");
+        }else if(kind == 2){
+            gui_button_init(w, r.x0, r.y0, (int16_t)(r.x1 - r.x0), (int16_t)(r.y1 - r.y0), "x");
+        }else{
+            gui_bar_init(w, r.x0, r.y0, (int16_t)(r.x1 - r.x0), (int16_t)(r.y1 - r.y0), 0, 100);
+            w->u.bar.value = (int32_t)rnd(101);
+        }
+        if(rnd(10) == 0){
+            w->flags |= GUI_FLAG_HIDDEN;
+        }
+        if(rnd(10) == 0){
+            w->alpha = (uint8_t)rnd(255);
+        }
+        gui_widget_add(parent, w);
+    }
+}
+
+/* hits, statistics and fills of the current tree through the current index */
+static void tree_sample(gui_widget_struct **hits, gui_stats_struct *stats, uint32_t *hash, uint32_t round)
+{
+    uint32_t i, saved = seed;
+    gui_rect_struct r;
+
+    /* the same points and damage for both passes */
+    seed = round * 7919U + 1U;
+    for(i = 0; i < TREE_POINTS; i++){
+        hits[i] = gui_hit_test((int16_t)rnd(GUI_SCREEN_WIDTH), (int16_t)rnd(GUI_SCREEN_HEIGHT));
+    }
+    gui_refresh();
+    gui_stats_reset();
+    fill_hash = 2166136261U;
+    for(i = 0; i < TREE_DAMAGES; i++){
+        random_query(&r);
+        gui_invalidate_rect(&r);
+        gui_refresh();
+    }
+    *stats = *gui_stats_get();
+    *hash = fill_hash;
+    seed = saved;
+}
+
+static void test_tree(void)
+{
+    static gui_widget_struct root;
+    static gui_widget_struct *walk_hits[TREE_POINTS], *grid_hits[TREE_POINTS];
+    gui_stats_struct walk_stats, grid_stats;
+    uint32_t round, i, walk_hash, grid_hash;
+    gui_widget_struct *w;
+
+    for(round = 0; round < TREE_ROUNDS; round++){
+        gui_set_grid(NULL);
+        tree_build(&root);
+        if(round & 1U){
+            /* index built with the tree rather than after it */
+            gui_set_grid(&grid);
+            tree_build(&root);
+        }
+
+        /* move, resize, hide and remove some widgets to exercise the updates */
+        gui_set_grid(&grid);
+        for(i = 0; i < TREE_WIDGETS / 4U; i++){
+            w = &widgets[rnd(TREE_WIDGETS)];
+            switch(rnd(4)){
+            case 0:
+                gui_widget_set_pos(w, (int16_t)(w->x + (int16_t)rnd(101) - 50), (int16_t)(w->y + (int16_t)rnd(101) - 50));
+                break;
+            case 1:
+                gui_widget_set_size(w, (int16_t)(1 + rnd(200)), (int16_t)(1 + rnd(200)));
+                break;
+            case 2:
+                gui_widget_set_hidden(w, (int)rnd(2));
+                break;
+            default:
+                if((NULL != w->parent) && (NULL == w->child)){
+                    gui_widget_remove(w);
+                }
+                break;
+            }
+        }
+
+        tree_sample(grid_hits, &grid_stats, &grid_hash, round);
+        gui_set_grid(NULL);
+        tree_sample(walk_hits, &walk_stats, &walk_hash, round);
+
+        for(i = 0; i < TREE_POINTS; i++){
+            CHECK(walk_hits[i] == grid_hits[i]);
+        }
+        CHECK_EQ(grid_stats.rects, walk_stats.rects);
+        CHECK_EQ(grid_stats.drawn, walk_stats.drawn);
+        CHECK_EQ(grid_stats.culled, walk_stats.culled);
+        CHECK_EQ(grid_stats.pixels, walk_stats.pixels);
+        CHECK_EQ(grid_hash, walk_hash);
+    }
+}
+
+int main(void)
+{
+    test_index();
+    test_tree();
+    return test_result();
+}
@@ -0,0 +1,385 @@
+/*!
+    \file    test_gui_widget.c
+    \brief   host test of the widget tree: layout, damage and redraw counts
+
+    A fake display keeps a frame buffer and checks that every fill lies
+    in the damaged rectangle flushed after it. Each case builds a small
+    screen, refreshes it once, then changes one thing and checks what
+    gui_refresh() redrew through gui_stats_get(). The cases run once
+    with tree walks and once with the spatial index.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "test.h"
+#include "gui_widget.h"
+#include "gui_grid.h"
+
+#define ROOT_COLOR                  GUI_RGB565(0, 0, 64)
+#define PANEL_COLOR                 GUI_RGB565(64, 64, 0)
+
+static uint16_t fb[GUI_SCREEN_HEIGHT][GUI_SCREEN_WIDTH];
+static gui_rect_struct fills[4096];
+static uint32_t fill_count;
+static uint32_t flush_count;
+static gui_grid_struct grid;
+
+static gui_widget_struct root, bar, button, label, panel, inner, cover;
+
+static void fake_fill_rect(const gui_rect_struct *rect, uint16_t color, uint8_t alpha)
+{
+    int16_t x, y;
+
+    CHECK((rect->x0 >= 0) && (rect->y0 >= 0) && (rect->x1 <= GUI_SCREEN_WIDTH) && (rect->y1 <= GUI_SCREEN_HEIGHT));
+    CHECK(!gui_rect_is_empty(rect));
+    if(fill_count < sizeof(fills) / sizeof(fills[0])){
+        fills[fill_count++] = *rect;
+    }
+    if(GUI_ALPHA_OPAQUE != alpha){
+        return;
+    }
+    for(y = rect->y0; y < rect->y1; y++){
+        for(x = rect->x0; x < rect->x1; x++){
+            fb[y][x] = color;
+        }
+    }
+}
+
+static void fake_flush(const gui_rect_struct *rect)
+{
+    uint32_t i;
+
+    /* nothing is drawn outside the damage */
+    for(i = 0; i < fill_count; i++){
+        CHECK(gui_rect_contains(rect, &fills[i]));
+    }
+    fill_count = 0;
+    flush_count++;
+}
+
+static const gui_disp_struct disp = {
+    fake_fill_rect,
+    NULL,
+    fake_flush
+};
+
+/* root, a bar, a button, a transparent label and a panel with a bar inside */
+static void screen_build(int use_grid)
+{
+    memset(fb, 0, sizeof(fb));
+    fill_count = 0;
+    flush_count = 0;
+
+    gui_container_init(&root, 0, 0, GUI_SCREEN_WIDTH, GUI_SCREEN_HEIGHT, ROOT_COLOR);
+    gui_set_grid(use_grid ? &grid : NULL);
+    gui_init(&disp, &root);
+    gui_bar_init(&bar, 10, 10, 200, 20, 0, 100);
+    gui_button_init(&button, 300, 10, 100, 40, "ok");
+    gui_label_init(&label, 10, 100, 200, 16, "label");
+    gui_container_init(&panel, 500, 200, 200, 200, PANEL_COLOR);
+    gui_bar_init(&inner, 20, 20, 100, 10, 0, 10);
+    gui_widget_add(&root, &bar);
+    gui_widget_add(&root, &button);
+    gui_widget_add(&root, &label);
+    gui_widget_add(&root, &panel);
+    gui_widget_add(&panel, &inner);
+}
+
+/* the first refresh draws every widget once into the whole screen */
+static void test_first_refresh(int use_grid)
+{
+    const gui_stats_struct *stats = gui_stats_get();
+
+    screen_build(use_grid);
+    CHECK(gui_is_dirty());
+    CHECK_EQ(gui_refresh(), 1);
+    CHECK_EQ(stats->refreshes, 1);
+    CHECK_EQ(stats->rects, 1);
+    CHECK_EQ(stats->drawn, 6);
+    CHECK_EQ(stats->culled, 0);
+    CHECK_EQ(stats->pixels, GUI_SCREEN_WIDTH * GUI_SCREEN_HEIGHT + 200 * 20 + 100 * 40 + 2 * (100 + 40) + 200 * 200 + 100 * 10);
+    CHECK_EQ(flush_count, 1);
+    CHECK_EQ(fb[0][0], ROOT_COLOR);
+    CHECK_EQ(fb[300][600], PANEL_COLOR);
+
+    /* nothing changed, nothing drawn */
+    gui_stats_reset();
+    CHECK(!gui_is_dirty());
+    CHECK_EQ(gui_refresh(), 0);
+    CHECK_EQ(stats->refreshes, 0);
+    CHECK_EQ(stats->drawn, 0);
+}
+
+/* a new value redraws the bar alone, the root below it is culled */
+static void test_value_change(int use_grid)
+{
+    const gui_stats_struct *stats = gui_stats_get();
+
+    screen_build(use_grid);
+    gui_refresh();
+    gui_stats_reset();
+
+    gui_widget_set_value(&bar, 50);
+    CHECK_EQ(gui_refresh(), 1);
+    CHECK_EQ(stats->drawn, 1);
+    CHECK_EQ(stats->culled, 1);
+    CHECK_EQ(stats->pixels, 200 * 20 + 100 * 20);
+    CHECK_EQ(fb[15][10 + 99], bar.fg_color);
+    CHECK_EQ(fb[15][10 + 100], bar.bg_color);
+
+    /* the same value and an out of range one that clamps to it do nothing */
+    gui_stats_reset();
+    gui_widget_set_value(&bar, 50);
+    CHECK(!gui_is_dirty());
+    gui_widget_set_value(&bar, 1000);
+    gui_widget_set_value(&bar, 100);
+    CHECK_EQ(gui_refresh(), 1);
+    CHECK_EQ(stats->drawn, 1);
+    CHECK_EQ(fb[15][10 + 199], bar.fg_color);
+
+    /* the bar inside the panel: root and panel are both culled */
+    gui_stats_reset();
+    gui_widget_set_value(&inner, 5);
+    CHECK_EQ(gui_refresh(), 1);
+    CHECK_EQ(stats->drawn, 1);
+    CHECK_EQ(stats->culled, 2);
+    CHECK_EQ(fb[225][520 + 49], inner.fg_color);
+    CHECK_EQ(fb[225][520 + 50], inner.bg_color);
+}
+
+/* hiding a widget redraws what is below it, a transparent label keeps what is below drawn */
+static void test_hidden_and_transparent(int use_grid)
+{
+    const gui_stats_struct *stats = gui_stats_get();
+
+    screen_build(use_grid);
+    gui_refresh();
+    gui_stats_reset();
+
+    gui_widget_set_hidden(&button, 1);
+    CHECK_EQ(gui_refresh(), 1);
+    CHECK_EQ(stats->drawn, 1);
+    CHECK_EQ(stats->culled, 0);
+    CHECK_EQ(stats->pixels, 100 * 40);
+    CHECK_EQ(fb[30][350], ROOT_COLOR);
+    CHECK(gui_hit_test(350, 30) == &root);
+
+    /* hiding twice damages nothing, showing draws it again over the root */
+    gui_stats_reset();
+    gui_widget_set_hidden(&button, 1);
+    CHECK(!gui_is_dirty());
+    gui_widget_set_hidden(&button, 0);
+    gui_refresh();
+    CHECK_EQ(stats->drawn, 1);
+    CHECK_EQ(stats->culled, 1);
+    CHECK(gui_hit_test(350, 30) == &button);
+
+    /* the label is not opaque, the root below it is drawn as well */
+    gui_stats_reset();
+    gui_widget_set_text(&label, "other");
+    gui_refresh();
+    CHECK_EQ(stats->drawn, 2);
+    CHECK_EQ(stats->culled, 0);
+    CHECK_EQ(stats->pixels, 200 * 16);
+}
+
+/* an opaque sibling on top culls the widget it covers, until it turns translucent */
+static void test_cover(int use_grid)
+{
+    const gui_stats_struct *stats = gui_stats_get();
+    gui_rect_struct around;
+
+    screen_build(use_grid);
+    gui_container_init(&cover, 10, 10, 200, 20, PANEL_COLOR);
+    gui_widget_add(&root, &cover);
+    gui_refresh();
+    CHECK_EQ(fb[15][20], PANEL_COLOR);
+
+    /* damage larger than both: root drawn, bar culled, cover drawn */
+    gui_stats_reset();
+    gui_rect_set(&around, 0, 0, 250, 40);
+    gui_invalidate_rect(&around);
+    gui_refresh();
+    CHECK_EQ(stats->drawn, 2);
+    CHECK_EQ(stats->culled, 1);
+
+    /* translucent, the bar below shows through and hides the root in turn */
+    gui_stats_reset();
+    gui_widget_set_alpha(&cover, 128);
+    gui_refresh();
+    CHECK_EQ(stats->drawn, 2);
+    CHECK_EQ(stats->culled, 1);
+    CHECK(gui_hit_test(20, 15) == &cover);
+
+    gui_widget_remove(&cover);
+    gui_refresh();
+    CHECK(gui_hit_test(20, 15) == &bar);
+    CHECK_EQ(fb[15][10 + 1], bar.bg_color);
+}
+
+/* overlapping damage merges into one rectangle, apart it stays two */
+static void test_damage_merge(int use_grid)
+{
+    const gui_stats_struct *stats = gui_stats_get();
+    gui_rect_struct a, b, off;
+
+    screen_build(use_grid);
+    gui_refresh();
+    gui_stats_reset();
+
+    gui_rect_set(&a, 100, 300, 50, 50);
+    gui_rect_set(&b, 120, 320, 50, 50);
+    gui_invalidate_rect(&a);
+    gui_invalidate_rect(&b);
+    CHECK_EQ(gui_refresh(), 1);
+    CHECK_EQ(stats->pixels, 70 * 70);
+
+    gui_stats_reset();
+    gui_rect_set(&b, 300, 300, 10, 10);
+    gui_invalidate_rect(&a);
+    gui_invalidate_rect(&b);
+    /* inside a, adds nothing */
+    gui_rect_set(&off, 110, 310, 5, 5);
+    gui_invalidate_rect(&off);
+    /* off the screen, ignored */
+    gui_rect_set(&off, -100, -100, 50, 50);
+    gui_invalidate_rect(&off);
+    CHECK_EQ(gui_refresh(), 2);
+    CHECK_EQ(stats->rects, 2);
+    CHECK_EQ(stats->pixels, 50 * 50 + 10 * 10);
+    CHECK_EQ(flush_count, 1 + 1 + 2);
+
+    /* more rectangles than the list holds grow the cheapest one instead */
+    gui_stats_reset();
+    for(int i = 0; i < GUI_DIRTY_MAX + 4; i++){
+        gui_rect_set(&off, (int16_t)(i * 30), 440, 10, 10);
+        gui_invalidate_rect(&off);
+    }
+    CHECK_EQ(gui_refresh(), GUI_DIRTY_MAX);
+}
+
+/* row and column layouts place the children, moves follow the parent */
+static void test_layout(int use_grid)
+{
+    static gui_widget_struct box, a, b, c;
+    const gui_stats_struct *stats = gui_stats_get();
+
+    screen_build(use_grid);
+    gui_container_init(&box, 100, 250, 300, 100, PANEL_COLOR);
+    gui_widget_add(&root, &box);
+    gui_bar_init(&a, 0, 0, 50, 20, 0, 1);
+    gui_bar_init(&b, 0, 0, 60, 20, 0, 1);
+    gui_bar_init(&c, 0, 0, 70, 30, 0, 1);
+    gui_container_set_layout(&box, GUI_LAYOUT_ROW, 4);
+    gui_widget_add(&box, &a);
+    gui_widget_add(&box, &b);
+    gui_widget_add(&box, &c);
+    CHECK_EQ(a.area.x0, 104);
+    CHECK_EQ(b.area.x0, 104 + 50 + 4);
+    CHECK_EQ(c.area.x0, 104 + 50 + 4 + 60 + 4);
+    CHECK_EQ(c.area.y0, 254);
+
+    /* growing one child pushes the next one along */
+    gui_widget_set_size(&a, 80, 20);
+    CHECK_EQ(b.area.x0, 104 + 80 + 4);
+    CHECK_EQ(c.area.x0, 104 + 80 + 4 + 60 + 4);
+
+    gui_container_set_layout(&box, GUI_LAYOUT_COLUMN, 2);
+    CHECK_EQ(a.area.x0, 102);
+    CHECK_EQ(a.area.y0, 252);
+    CHECK_EQ(b.area.y0, 252 + 20 + 2);
+    CHECK_EQ(c.area.y0, 252 + 20 + 2 + 20 + 2);
+
+    /* moving the box moves the children, and the old and new places are redrawn */
+    gui_refresh();
+    gui_stats_reset();
+    gui_widget_set_pos(&box, 120, 250);
+    CHECK_EQ(a.area.x0, 122);
+    CHECK(gui_hit_test(125, 255) == &a);
+    CHECK(gui_hit_test(101, 255) == &root);
+    CHECK_EQ(gui_refresh(), 1);
+    CHECK_EQ(stats->pixels, 320 * 100 + 300 * 100 + (80 + 60 + 70) * 20 + 70 * 10);
+    CHECK_EQ(fb[260][101], ROOT_COLOR);
+}
+
+/* int32_t limits, the range and the products do not fit in 32 bits */
+static void test_large_range(int use_grid)
+{
+    static gui_widget_struct wide, half, gauge;
+    const int16_t needle_y = 20 + 100 - 4;
+
+    screen_build(use_grid);
+    gui_bar_init(&wide, 10, 300, 200, 20, INT32_MIN, INT32_MAX);
+    gui_bar_init(&half, 10, 340, 200, 20, 0, INT32_MAX);
+    gui_gauge_init(&gauge, 580, 20, 200, 100, INT32_MIN, INT32_MAX);
+    gui_widget_add(&root, &wide);
+    gui_widget_add(&root, &half);
+    gui_widget_add(&root, &gauge);
+
+    /* at the minimum the bars are empty and the needle points left */
+    gui_refresh();
+    CHECK_EQ(fb[310][10], wide.bg_color);
+    CHECK_EQ(fb[350][10], half.bg_color);
+    CHECK_EQ(fb[needle_y][640], gauge.fg_color);
+    CHECK_EQ(fb[needle_y][720], gauge.bg_color);
+
+    gui_widget_set_value(&wide, 0);
+    gui_widget_set_value(&half, INT32_MAX / 2);
+    gui_widget_set_value(&gauge, 0);
+    gui_refresh();
+    CHECK_EQ(fb[310][10 + 99], wide.fg_color);
+    CHECK_EQ(fb[310][10 + 100], wide.bg_color);
+    CHECK_EQ(fb[350][10 + 98], half.fg_color);
+    CHECK_EQ(fb[350][10 + 99], half.bg_color);
+    /* upright, the needle leaves the tips at both ends */
+    CHECK_EQ(fb[60][680], gauge.fg_color);
+    CHECK_EQ(fb[needle_y][640], gauge.bg_color);
+    CHECK_EQ(fb[needle_y][720], gauge.bg_color);
+
+    gui_widget_set_value(&wide, INT32_MAX);
+    gui_widget_set_value(&half, INT32_MAX);
+    gui_widget_set_value(&gauge, INT32_MAX);
+    gui_refresh();
+    CHECK_EQ(fb[310][10 + 199], wide.fg_color);
+    CHECK_EQ(fb[350][10 + 199], half.fg_color);
+    CHECK_EQ(fb[needle_y][720], gauge.fg_color);
+    CHECK_EQ(fb[needle_y][640], gauge.bg_color);
+
+    /* a value written past either end of the range draws as that end, not at a wrapped coordinate */
+    wide.u.bar.min = -1;
+    wide.u.bar.max = 0;
+    half.u.bar.max = 200;
+    half.u.bar.value = -65536 + 100;
+    gauge.u.gauge.max = 0;
+    gui_widget_invalidate(&root);
+    gui_refresh();
+    CHECK_EQ(fb[310][10], wide.fg_color);
+    CHECK_EQ(fb[310][10 + 199], wide.fg_color);
+    CHECK_EQ(fb[350][10], half.bg_color);
+    CHECK_EQ(fb[needle_y][720], gauge.fg_color);
+    CHECK_EQ(fb[needle_y][640], gauge.bg_color);
+    gauge.u.gauge.value = INT32_MIN;
+    gauge.u.gauge.min = 0;
+    gauge.u.gauge.max = INT32_MAX;
+    gui_widget_invalidate(&gauge);
+    gui_refresh();
+    CHECK_EQ(fb[needle_y][640], gauge.fg_color);
+    CHECK_EQ(fb[needle_y][720], gauge.bg_color);
+}
+
+int main(void)
+{
+    int use_grid;
+
+    for(use_grid = 0; use_grid < 2; use_grid++){
+        test_first_refresh(use_grid);
+        test_value_change(use_grid);
+        test_hidden_and_transparent(use_grid);
+        test_cover(use_grid);
+        test_damage_merge(use_grid);
+        test_layout(use_grid);
+        test_large_range(use_grid);
+    }
+    return test_result();
+}
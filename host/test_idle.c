@@ -0,0 +1,292 @@
+/*!
+    \file    test_idle.c
+    \brief   host test of the tickless idle deadlines and the CPU load
+
+    The sleep must be the shortest of the kernel, timer and counter
+    limits, and no sleep below IDLE_TICKLESS_MIN. The load is checked
+    on worked figures, with a sleep split across a window end, windows
+    without a sleep, a sleep over several windows and the counter
+    wrapping, and then against a 64-bit reference over random busy and
+    sleep runs that wrap the counter many times: after every sleep the
+    closed windows and the last load must match, and at the end the
+    histogram and the peak.
+
+    soft_timer_next() is checked on random wheels: no timer may fire
+    before the tick it returns, and that tick must fire one or be the
+    wrap of level 0. kernel_idle_ticks() is checked on the host kernel
+    port for no sleeper, a sleeper as ticks go by and a sliced priority.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <signal.h>
+#include <stdlib.h>
+#include "test.h"
+#include "idle.h"
+#include "soft_timer.h"
+#include "kernel.h"
+#include "kernel_host.h"
+
+#define COUNTER_START               0xFFFFFE00U
+#define RANDOM_WINDOW               100000U
+#define RANDOM_WINDOWS              300000U
+#define WHEELS                      200U
+#define WHEEL_TIMERS                40U
+#define WHEEL_TICKS                 3000U
+#define STACK_WORDS                 (KERNEL_HOST_STACK_MIN / sizeof(uint32_t))
+
+static uint32_t seed = 1U;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+static void test_ticks(void)
+{
+    CHECK_EQ(idle_ticks(KERNEL_WAIT_FOREVER, SOFT_TIMER_SLOTS, 69U), 64);
+    CHECK_EQ(idle_ticks(KERNEL_WAIT_FOREVER, SOFT_TIMER_SLOTS, 30U), 30);
+    CHECK_EQ(idle_ticks(12U, 20U, 69U), 12);
+    CHECK_EQ(idle_ticks(20U, 12U, 69U), 12);
+    CHECK_EQ(idle_ticks(IDLE_TICKLESS_MIN, 20U, 69U), IDLE_TICKLESS_MIN);
+    /* shorter waits keep the tick */
+    CHECK_EQ(idle_ticks(IDLE_TICKLESS_MIN - 1U, 20U, 69U), 0);
+    CHECK_EQ(idle_ticks(20U, 0U, 69U), 0);
+    CHECK_EQ(idle_ticks(1U, 1U, 69U), 0);
+    CHECK_EQ(idle_ticks(20U, 20U, 1U), 0);
+}
+
+/* windows of 1000 cycles from just short of the counter wrap */
+static void test_windows(void)
+{
+    idle_struct idle;
+    uint32_t i;
+
+    idle_init(&idle, COUNTER_START, 1000U);
+    /* slept 300..500 */
+    idle_account(&idle, COUNTER_START + 500U, 200U);
+    CHECK_EQ(idle.windows, 0);
+    CHECK_EQ(idle.idle, 200);
+    /* slept 800..1300, 200 of it in the first window */
+    idle_account(&idle, COUNTER_START + 1300U, 500U);
+    CHECK_EQ(idle.windows, 1);
+    CHECK_EQ(idle.load, 600);
+    CHECK_EQ(idle.idle, 300);
+    CHECK_EQ(idle.histogram[6], 1);
+    /* closed without a sleep: 300 slept, then two windows awake */
+    idle_account(&idle, COUNTER_START + 4500U, 0U);
+    CHECK_EQ(idle.windows, 4);
+    CHECK_EQ(idle.load, 1000);
+    CHECK_EQ(idle.load_max, 1000);
+    CHECK_EQ(idle.histogram[7], 1);
+    CHECK_EQ(idle.histogram[9], 2);
+    /* slept 4200..7000, ending right on a window end */
+    idle_account(&idle, COUNTER_START + 7000U, 2800U);
+    CHECK_EQ(idle.windows, 7);
+    CHECK_EQ(idle.load, 0);
+    CHECK_EQ(idle.histogram[2], 1);
+    CHECK_EQ(idle.histogram[0], 2);
+    CHECK_EQ(idle.idle, 0);
+    CHECK_EQ(idle.window_start, COUNTER_START + 7000U);
+    /* 99 per mille is still the first bin */
+    idle_account(&idle, COUNTER_START + 8000U, 901U);
+    CHECK_EQ(idle.load, 99);
+    CHECK_EQ(idle.histogram[0], 3);
+    CHECK_EQ(idle.load_max, 1000);
+
+    idle_init(&idle, 0U, 1000U);
+    CHECK_EQ(idle.windows, 0);
+    for(i = 0; i < IDLE_LOAD_BINS; i++){
+        CHECK_EQ(idle.histogram[i], 0);
+    }
+}
+
+/* the load of a window from the cycles slept in it */
+static uint32_t load_of(uint32_t slept)
+{
+    return 1000U - (uint32_t)((uint64_t)slept * 1000U / RANDOM_WINDOW);
+}
+
+/* random busy and sleep runs against the cycles slept in every window, kept on 64 bits */
+static void test_random(void)
+{
+    static uint32_t slept_in[RANDOM_WINDOWS + 4U];
+    uint32_t histogram[IDLE_LOAD_BINS] = {0};
+    uint64_t t = 0, start, end, w, from, to;
+    uint32_t windows, load, load_max = 0, errors = 0, slept, i, bin;
+    idle_struct idle;
+
+    idle_init(&idle, COUNTER_START, RANDOM_WINDOW);
+    while(t / RANDOM_WINDOW < RANDOM_WINDOWS){
+        /* mostly short busy runs, now and then one over several windows */
+        t += (0U == rnd(50)) ? rnd(4U * RANDOM_WINDOW) : rnd(RANDOM_WINDOW / 2U);
+        slept = (0U == rnd(8)) ? 0U : rnd(3U * RANDOM_WINDOW);
+        start = t;
+        t += slept;
+        end = t;
+        for(w = start / RANDOM_WINDOW; (w * RANDOM_WINDOW < end) && (w < RANDOM_WINDOWS + 4U); w++){
+            from = (start > w * RANDOM_WINDOW) ? start : w * RANDOM_WINDOW;
+            to = (end < (w + 1U) * RANDOM_WINDOW) ? end : (w + 1U) * RANDOM_WINDOW;
+            slept_in[w] += (uint32_t)(to - from);
+        }
+        idle_account(&idle, (uint32_t)(COUNTER_START + t), slept);
+
+        windows = (uint32_t)(t / RANDOM_WINDOW);
+        if((idle.windows != windows) || ((0U != windows) && (idle.load != load_of(slept_in[windows - 1U])))){
+            if(errors < 5U){
+                printf("at %llu: %u windows load %u, expected %u load %u\n", (unsigned long long)t, idle.windows,
+                       idle.load, windows, (0U != windows) ? load_of(slept_in[windows - 1U]) : 0U);
+            }
+            errors++;
+        }
+    }
+    CHECK_EQ(errors, 0);
+
+    for(i = 0; i < idle.windows; i++){
+        load = load_of(slept_in[i]);
+        bin = load * IDLE_LOAD_BINS / 1000U;
+        histogram[(bin < IDLE_LOAD_BINS) ? bin : IDLE_LOAD_BINS - 1U]++;
+        if(load > load_max){
+            load_max = load;
+        }
+    }
+    for(i = 0; i < IDLE_LOAD_BINS; i++){
+        CHECK_EQ(idle.histogram[i], histogram[i]);
+    }
+    CHECK_EQ(idle.load_max, load_max);
+    /* the counter wrapped many times */
+    CHECK((t >> 32) > 5U);
+}
+
+static soft_timer_wheel_struct wheel;
+static uint32_t fired;
+
+static void count_fire(soft_timer_struct *timer, void *arg)
+{
+    (void)timer;
+    (void)arg;
+    fired++;
+}
+
+/* the ticks returned pass without a firing, the last one fires or wraps level 0 */
+static void test_timer_next(void)
+{
+    static soft_timer_struct timers[WHEEL_TIMERS];
+    uint32_t n, i, k, ticks, errors = 0;
+
+    for(n = 0; n < WHEELS; n++){
+        wheel.ticks = rnd(0x1000000U) << 8;
+        soft_timer_wheel_init(&wheel);
+        for(i = 0; i < WHEEL_TIMERS; i++){
+            soft_timer_init(&timers[i], count_fire, NULL);
+            soft_timer_start(&wheel, &timers[i], 1U + rnd((0U == (i & 1U)) ? 100U : 5000U),
+                             (0U == rnd(3)) ? 1U + rnd(300) : 0U);
+        }
+        for(ticks = 0; ticks < WHEEL_TICKS; ){
+            /* a tick counted but not run yet, the wheel cannot say */
+            soft_timer_tick(&wheel);
+            if(0U != soft_timer_next(&wheel)){
+                errors++;
+            }
+            soft_timer_run(&wheel);
+            ticks++;
+
+            k = soft_timer_next(&wheel);
+            if((0U == k) || (k > SOFT_TIMER_SLOTS)){
+                errors++;
+                break;
+            }
+            fired = 0;
+            for(i = 1U; i < k; i++){
+                soft_timer_tick(&wheel);
+                soft_timer_run(&wheel);
+            }
+            if(0U != fired){
+                errors++;
+            }
+            soft_timer_tick(&wheel);
+            soft_timer_run(&wheel);
+            if((0U == fired) && (0U != (wheel.now & (SOFT_TIMER_SLOTS - 1U)))){
+                errors++;
+            }
+            ticks += k;
+
+            /* now and then restart or stop a timer */
+            i = rnd(WHEEL_TIMERS);
+            if(0U == rnd(4)){
+                soft_timer_stop(&timers[i]);
+            }else if(0U == rnd(2)){
+                soft_timer_start(&wheel, &timers[i], 1U + rnd(200), 0U);
+            }
+        }
+    }
+    CHECK_EQ(errors, 0);
+}
+
+static uint32_t stacks[3][STACK_WORDS];
+static kernel_thread_struct threads[3];
+static kernel_sem_struct slept;
+
+static void sleeper_entry(void *arg)
+{
+    kernel_sleep((uint32_t)(uintptr_t)arg);
+    kernel_sem_give(&slept);
+}
+
+static void peer_entry(void *arg)
+{
+    (void)arg;
+}
+
+/* the runner asks as the idle thread would, lowest in the system */
+static void runner_entry(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    CHECK_EQ(kernel_idle_ticks(), KERNEL_WAIT_FOREVER);
+
+    /* a sleeper above the runner: the ticks to its wake-up, then 0 once they passed unseen */
+    CHECK_EQ(kernel_thread_create(&threads[1], "sleeper", sleeper_entry, (void *)7U, 1U, stacks[1],
+                                  sizeof(stacks[1])), KERNEL_OK);
+    CHECK_EQ(kernel_idle_ticks(), 7);
+    for(i = 0; i < 3U; i++){
+        raise(SIGALRM);
+    }
+    CHECK_EQ(kernel_idle_ticks(), 4);
+    kernel.ticks += 4U;
+    CHECK_EQ(kernel_idle_ticks(), 0);
+    kernel.ticks += 5U;
+    CHECK_EQ(kernel_idle_ticks(), 0);
+    kernel.ticks -= 9U;
+    while(KERNEL_OK != kernel_sem_take(&slept, KERNEL_NO_WAIT)){
+        raise(SIGALRM);
+    }
+    CHECK_EQ(kernel_idle_ticks(), KERNEL_WAIT_FOREVER);
+
+    /* another thread of its priority ready, the time is sliced */
+    CHECK_EQ(kernel_thread_create(&threads[2], "peer", peer_entry, NULL, KERNEL_PRIORITIES - 1U, stacks[2],
+                                  sizeof(stacks[2])), KERNEL_OK);
+    CHECK_EQ(kernel_idle_ticks(), 1);
+    kernel_yield();
+    CHECK_EQ(threads[2].state, KERNEL_THREAD_DONE);
+    CHECK_EQ(kernel_idle_ticks(), KERNEL_WAIT_FOREVER);
+    exit(test_result());
+}
+
+int main(void)
+{
+    test_ticks();
+    test_windows();
+    test_random();
+    test_timer_next();
+
+    kernel_init();
+    kernel_sem_init(&slept, 0U, 1U);
+    CHECK_EQ(kernel_idle_ticks(), KERNEL_WAIT_FOREVER);
+    CHECK_EQ(kernel_thread_create(&threads[0], "runner", runner_entry, NULL, KERNEL_PRIORITIES - 1U, stacks[0],
+                                  sizeof(stacks[0])), KERNEL_OK);
+    kernel_start();
+    return 1;
+}
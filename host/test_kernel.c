@@ -0,0 +1,475 @@
+/*!
+    \file    test_kernel.c
+    \brief   host test of the kernel scheduling on the ucontext port
+
+    The kernel runs on host/kernel_port_host.c, threads as ucontexts and
+    SIGALRM as the tick. A runner thread sets up one case after the
+    other and waits for its threads on a semaphore. Ticks come from
+    raise(SIGALRM) at known points, so the cases check the exact order
+    things happen in: a higher priority thread preempts its creator,
+    yields take turns, a time slice ends after KERNEL_SLICE_TICKS ticks,
+    a sleep and a timeout end on their tick and preempt there, a mutex
+    owner inherits the priority of its waiters along a chain and drops
+    it when they time out, and a queue keeps the order of its messages
+    whichever side waits. The runner is below every thread of a case,
+    so a case is over when it runs again. Then threads lock, sleep and
+    pass messages under a periodic tick, preempted anywhere, and the
+    counts must add up. Before the kernel starts a tick must not ask for a switch.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "kernel.h"
+#include "kernel_host.h"
+
+#define STACK_WORDS                 (KERNEL_HOST_STACK_MIN / sizeof(uint32_t))
+#define THREADS                     5U
+/* below every thread of the cases, so a case is over once the runner gets the core back */
+#define RUNNER_PRIORITY             (KERNEL_PRIORITIES - 1U)
+#define QUEUE_MESSAGES              20U
+#define STRESS_ROUNDS               3000U
+#define STRESS_TICK_US              200U
+
+/* the threads of the cases, then the runner and the first thread, later the one starting a case */
+#define RUNNER                      THREADS
+#define FIRST                       (THREADS + 1U)
+#define STARTER                     FIRST
+
+static uint32_t stacks[THREADS + 2U][STACK_WORDS];
+static kernel_thread_struct threads[THREADS + 2U];
+static kernel_sem_struct done;
+static char log_text[64];
+static uint32_t log_len;
+
+/* note an event, in order */
+static void note(char c)
+{
+    uint32_t key = kernel_port_lock();
+
+    if(log_len < sizeof(log_text) - 1U){
+        log_text[log_len++] = c;
+        log_text[log_len] = '\0';
+    }
+    kernel_port_unlock(key);
+}
+
+static void log_clear(void)
+{
+    log_len = 0;
+    log_text[0] = '\0';
+}
+
+#define CHECK_LOG(expected)         do{ \
+                                        if(0 != strcmp(log_text, (expected))){ \
+                                            printf("%s:%d: log \"%s\", expected \"%s\"\n", __FILE__, __LINE__, \
+                                                   log_text, (expected)); \
+                                            test_failed++; \
+                                        } \
+                                    }while(0)
+
+/* start thread n of the case */
+static void spawn(uint32_t n, void (*entry)(void *arg), void *arg, uint32_t priority)
+{
+    CHECK_EQ(kernel_thread_create(&threads[n], "case", entry, arg, priority, stacks[n], sizeof(stacks[n])),
+             KERNEL_OK);
+}
+
+/* run fn in a thread above all others, so the threads it starts wait until it is done */
+static void (*start_fn)(void);
+
+static void starter_entry(void *arg)
+{
+    (void)arg;
+    start_fn();
+}
+
+static void start(void (*fn)(void))
+{
+    start_fn = fn;
+    CHECK_EQ(kernel_thread_create(&threads[STARTER], "starter", starter_entry, NULL, 0U, stacks[STARTER],
+                                  sizeof(stacks[STARTER])), KERNEL_OK);
+}
+
+/* wait for the threads of a case */
+static void join(uint32_t count)
+{
+    while(count-- > 0U){
+        CHECK_EQ(kernel_sem_take(&done, KERNEL_WAIT_FOREVER), KERNEL_OK);
+    }
+}
+
+/* one tick, handled before raise() returns */
+static void tick(void)
+{
+    raise(SIGALRM);
+}
+
+static void note_entry(void *arg)
+{
+    note((char)(uintptr_t)arg);
+    kernel_sem_give(&done);
+}
+
+/* a thread of higher priority runs before its creation returns, one of lower priority after */
+static void preempt_entry(void *arg)
+{
+    (void)arg;
+    note('p');
+    spawn(1, note_entry, (void *)'h', 1U);
+    note('P');
+    spawn(2, note_entry, (void *)'l', 5U);
+    note('Q');
+    kernel_sem_give(&done);
+}
+
+static void test_preempt(void)
+{
+    log_clear();
+    spawn(0, preempt_entry, NULL, 3U);
+    join(3);
+    CHECK_LOG("phPQl");
+}
+
+static void yield_entry(void *arg)
+{
+    uint32_t i;
+
+    for(i = 0; i < 3U; i++){
+        note((char)(uintptr_t)arg);
+        kernel_yield();
+    }
+    kernel_sem_give(&done);
+}
+
+static void yield_start(void)
+{
+    spawn(0, yield_entry, (void *)'a', 5U);
+    spawn(1, yield_entry, (void *)'b', 5U);
+}
+
+static void test_yield(void)
+{
+    log_clear();
+    start(yield_start);
+    join(2);
+    CHECK_LOG("ababab");
+}
+
+/* A ticks until B gets the core, B notes the tick it did */
+static volatile int slice_b_ran;
+static uint32_t slice_start;
+static uint32_t slice_b_tick;
+
+static void slice_a(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    slice_start = kernel_ticks_get();
+    for(i = 0; (i < 100U) && !slice_b_ran; i++){
+        tick();
+    }
+    kernel_sem_give(&done);
+}
+
+static void slice_b(void *arg)
+{
+    (void)arg;
+    slice_b_tick = kernel_ticks_get();
+    slice_b_ran = 1;
+    kernel_sem_give(&done);
+}
+
+static void slice_start_threads(void)
+{
+    spawn(0, slice_a, NULL, 5U);
+    spawn(1, slice_b, NULL, 5U);
+}
+
+static void test_slice(void)
+{
+    start(slice_start_threads);
+    join(2);
+    CHECK(slice_b_ran);
+    CHECK_EQ(slice_b_tick - slice_start, KERNEL_SLICE_TICKS);
+}
+
+static kernel_sem_struct never;
+static int timeout_result;
+
+static void sleep_entry(void *arg)
+{
+    uint32_t start = kernel_ticks_get();
+
+    (void)arg;
+    kernel_sleep(5U);
+    note('0' + (char)(kernel_ticks_get() - start));
+    start = kernel_ticks_get();
+    timeout_result = kernel_sem_take(&never, 3U);
+    note('0' + (char)(kernel_ticks_get() - start));
+    kernel_sem_give(&done);
+}
+
+/* a sleep and a timeout end on their tick and preempt the ticking thread there */
+static void test_sleep(void)
+{
+    uint32_t i;
+
+    log_clear();
+    kernel_sem_init(&never, 0U, 1U);
+    spawn(0, sleep_entry, NULL, 1U);
+    for(i = 0; i < 8U; i++){
+        note('.');
+        tick();
+    }
+    join(1);
+    CHECK_LOG(".....5...3");
+    CHECK_EQ(timeout_result, KERNEL_TIMEOUT);
+    CHECK_EQ(kernel_sem_take(&done, KERNEL_NO_WAIT), KERNEL_TIMEOUT);
+}
+
+/* priority inheritance: L owns m1, M owns m2 and waits for m1, H waits for m2 */
+static kernel_mutex_struct m1, m2;
+static uint32_t l_priority[4];
+static int h_result;
+
+static void inherit_h(void *arg)
+{
+    (void)arg;
+    note('h');
+    h_result = kernel_mutex_lock(&m2, 3U);
+    note('H');
+    kernel_sem_give(&done);
+}
+
+static void inherit_m(void *arg)
+{
+    (void)arg;
+    CHECK_EQ(kernel_mutex_lock(&m2, KERNEL_NO_WAIT), KERNEL_OK);
+    note('m');
+    CHECK_EQ(kernel_mutex_lock(&m1, KERNEL_WAIT_FOREVER), KERNEL_OK);
+    note('M');
+    kernel_mutex_unlock(&m1);
+    kernel_mutex_unlock(&m2);
+    kernel_sem_give(&done);
+}
+
+static void note_low_entry(void *arg)
+{
+    (void)arg;
+    note('x');
+    kernel_sem_give(&done);
+}
+
+static void inherit_l(void *arg)
+{
+    kernel_thread_struct *self = kernel.current;
+    uint32_t i;
+
+    (void)arg;
+    CHECK_EQ(kernel_mutex_lock(&m1, KERNEL_NO_WAIT), KERNEL_OK);
+    CHECK_EQ(kernel_mutex_lock(&m1, KERNEL_NO_WAIT), KERNEL_ERROR);
+    note('l');
+    spawn(1, inherit_m, NULL, 5U);
+    l_priority[0] = self->priority;
+    spawn(2, inherit_h, NULL, 2U);
+    l_priority[1] = self->priority;
+    /* a thread between H and L does not get in while L holds what H waits for */
+    spawn(3, note_low_entry, NULL, 3U);
+    note('L');
+    /* H gives up, L owes only M now */
+    for(i = 0; i < 3U; i++){
+        tick();
+    }
+    l_priority[2] = self->priority;
+    CHECK_EQ(kernel_mutex_unlock(&m2), KERNEL_ERROR);
+    kernel_mutex_unlock(&m1);
+    l_priority[3] = self->priority;
+    note('E');
+    kernel_sem_give(&done);
+}
+
+static void test_inherit(void)
+{
+    log_clear();
+    kernel_mutex_init(&m1);
+    kernel_mutex_init(&m2);
+    spawn(0, inherit_l, NULL, 6U);
+    join(4);
+    /* m and h preempt L and wait, x waits behind L, H times out and x gets in, L unlocks to M */
+    CHECK_LOG("lmhLHxME");
+    CHECK_EQ(l_priority[0], 5);
+    CHECK_EQ(l_priority[1], 2);
+    CHECK_EQ(l_priority[2], 5);
+    CHECK_EQ(l_priority[3], 6);
+    CHECK_EQ(h_result, KERNEL_TIMEOUT);
+    CHECK(NULL == m1.owner);
+    CHECK(NULL == m2.owner);
+}
+
+/* a queue keeps the order whichever side waits */
+static kernel_queue_struct queue;
+static uint32_t queue_buffer[2];
+static uint32_t received[QUEUE_MESSAGES];
+
+static void queue_sender(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for(i = 0; i < QUEUE_MESSAGES; i++){
+        CHECK_EQ(kernel_queue_send(&queue, &i, KERNEL_WAIT_FOREVER), KERNEL_OK);
+    }
+    kernel_sem_give(&done);
+}
+
+static void queue_receiver(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for(i = 0; i < QUEUE_MESSAGES; i++){
+        CHECK_EQ(kernel_queue_receive(&queue, &received[i], KERNEL_WAIT_FOREVER), KERNEL_OK);
+        if(0U == i % 3U){
+            kernel_yield();
+        }
+    }
+    kernel_sem_give(&done);
+}
+
+static void test_queue(void)
+{
+    uint32_t order, i, message = 0;
+
+    for(order = 0; order < 2U; order++){
+        kernel_queue_init(&queue, queue_buffer, sizeof(uint32_t), 2U);
+        memset(received, 0xFF, sizeof(received));
+        /* the receiver above the sender waits on an empty queue, below it the sender on a full one */
+        spawn(0, queue_receiver, NULL, (0U == order) ? 2U : 5U);
+        spawn(1, queue_sender, NULL, (0U == order) ? 5U : 2U);
+        join(2);
+        for(i = 0; i < QUEUE_MESSAGES; i++){
+            CHECK_EQ(received[i], i);
+        }
+    }
+    CHECK_EQ(kernel_queue_receive(&queue, &message, KERNEL_NO_WAIT), KERNEL_TIMEOUT);
+    CHECK_EQ(kernel_queue_send(&queue, &message, KERNEL_NO_WAIT), KERNEL_OK);
+    CHECK_EQ(kernel_queue_send(&queue, &message, KERNEL_NO_WAIT), KERNEL_OK);
+    CHECK_EQ(kernel_queue_send(&queue, &message, KERNEL_NO_WAIT), KERNEL_TIMEOUT);
+}
+
+/* preempted anywhere by a periodic tick */
+static kernel_mutex_struct stress_mutex;
+static kernel_queue_struct stress_queue;
+static uint32_t stress_buffer[4];
+static volatile uint32_t stress_owner;
+static uint32_t stress_count;
+static uint32_t stress_overlaps;
+static uint32_t stress_sum;
+
+static void stress_worker(void *arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg, i, count;
+    volatile uint32_t spin;
+
+    for(i = 0; i < STRESS_ROUNDS; i++){
+        CHECK_EQ(kernel_mutex_lock(&stress_mutex, KERNEL_WAIT_FOREVER), KERNEL_OK);
+        if(0U != stress_owner){
+            stress_overlaps++;
+        }
+        stress_owner = id;
+        count = stress_count;
+        for(spin = 0; spin < 200U; spin++){
+        }
+        stress_count = count + 1U;
+        stress_owner = 0;
+        kernel_mutex_unlock(&stress_mutex);
+        CHECK_EQ(kernel_queue_send(&stress_queue, &i, KERNEL_WAIT_FOREVER), KERNEL_OK);
+        if(0U == i % 500U){
+            kernel_sleep(1U);
+        }
+    }
+    kernel_sem_give(&done);
+}
+
+static void stress_consumer(void *arg)
+{
+    uint32_t i, message;
+
+    (void)arg;
+    for(i = 0; i < 3U * STRESS_ROUNDS; i++){
+        CHECK_EQ(kernel_queue_receive(&stress_queue, &message, KERNEL_WAIT_FOREVER), KERNEL_OK);
+        stress_sum += message;
+    }
+    kernel_sem_give(&done);
+}
+
+static void test_stress(void)
+{
+    uint32_t switches = kernel.switches;
+
+    kernel_mutex_init(&stress_mutex);
+    kernel_queue_init(&stress_queue, stress_buffer, sizeof(uint32_t), 4U);
+    spawn(0, stress_worker, (void *)1, 4U);
+    spawn(1, stress_worker, (void *)2, 4U);
+    spawn(2, stress_worker, (void *)3, 5U);
+    spawn(3, stress_consumer, NULL, 6U);
+    kernel_host_tick_start(STRESS_TICK_US);
+    join(4);
+    kernel_host_tick_start(0U);
+    CHECK_EQ(stress_overlaps, 0);
+    CHECK_EQ(stress_count, 3U * STRESS_ROUNDS);
+    CHECK_EQ(stress_sum, 3U * (STRESS_ROUNDS * (STRESS_ROUNDS - 1U) / 2U));
+    CHECK(kernel.switches - switches > 3U * STRESS_ROUNDS);
+}
+
+static void runner_entry(void *arg)
+{
+    (void)arg;
+    CHECK(kernel.current == &threads[RUNNER]);
+    CHECK_EQ(threads[FIRST].state, KERNEL_THREAD_DONE);
+    test_preempt();
+    test_yield();
+    test_slice();
+    test_sleep();
+    test_inherit();
+    test_queue();
+    test_stress();
+    exit(test_result());
+}
+
+/* created after the runner but above it, it runs first */
+static void first_entry(void *arg)
+{
+    (void)arg;
+    /* started is only set as the first thread is entered */
+    CHECK_EQ(kernel.started, 1);
+    CHECK(kernel.current == &threads[FIRST]);
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    kernel_init();
+    kernel_sem_init(&done, 0U, THREADS);
+    CHECK_EQ(kernel_thread_create(&threads[RUNNER], "runner", runner_entry, NULL, RUNNER_PRIORITY, stacks[RUNNER],
+                                  sizeof(stacks[RUNNER])), KERNEL_OK);
+    CHECK_EQ(kernel_thread_create(&threads[FIRST], "first", first_entry, NULL, 0U, stacks[FIRST],
+                                  sizeof(stacks[FIRST])), KERNEL_OK);
+    CHECK_EQ(kernel_thread_create(&threads[0], "bad", runner_entry, NULL, KERNEL_PRIORITIES, stacks[0],
+                                  sizeof(stacks[0])), KERNEL_ERROR);
+    /* ticks before the start, as from SysTick between kernel_start() and the first thread, switch nothing */
+    for(i = 0; i < 2U * KERNEL_SLICE_TICKS; i++){
+        kernel_tick();
+    }
+    CHECK_EQ(kernel.switches, 0);
+    CHECK_EQ(kernel.started, 0);
+    CHECK_EQ(kernel_idle_ticks(), KERNEL_WAIT_FOREVER);
+    kernel_start();
+    return 1;
+}
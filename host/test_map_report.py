@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""Test of tools/map_report.py on a GNU ld map excerpt.
+
+The excerpt has the shapes the parser must cope with: the *default*
+region, output and input section names long enough to push their
+address to the next line, fill and script lines, archive members,
+zero sized sections, symbols set by the script and global symbols. The
+report, the --expect checks of sections and symbols and the exit code
+of the command line are checked as well.
+"""
+
+import io
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+sys.dont_write_bytecode = True
+TOOLS = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, "tools")
+sys.path.insert(0, TOOLS)
+import map_report  # noqa: E402
+
+MAP = """\
+Archive member included to satisfy reference by file (symbol)
+
+/opt/gcc/arm-none-eabi/lib/thumb/v7e-m+fp/hard/libc_nano.a(lib_a-memcpy-stub.o)
+                              CMakeFiles/gd32f470BaseProject.dir/user/main.c.obj (memcpy)
+
+Memory Configuration
+
+Name             Origin             Length             Attributes
+CODE             0x08000000         0x00100000         xr
+DATA             0x20000000         0x00070000         rw
+SDRAM            0xc0000000         0x02000000         xrw
+TCM              0x10000000         0x00010000         rw
+*default*        0x00000000         0xffffffff
+
+Linker script and memory map
+
+                0x00000200                _system_stack_size = 0x200
+                0x08000000                _stext = .
+
+.isr_vector     0x08000000      0x1ac
+                0x08000000                . = ALIGN (0x4)
+ *(.isr_vector)
+ .isr_vector    0x08000000      0x1ac CMakeFiles/gd32f470BaseProject.dir/Firmware/CMSIS/GD/GD32F4xx/Source/GNU/startup_gd32f450_470.S.obj
+
+.text           0x080001b0     0x2400
+ *(.text)
+ .text          0x080001b0       0x80 /opt/gcc/arm-none-eabi/lib/thumb/v7e-m+fp/hard/libc_nano.a(lib_a-memcpy-stub.o)
+ *(.text*)
+ .text.main     0x08000230      0x120 CMakeFiles/gd32f470BaseProject.dir/user/main.c.obj
+                0x08000230                main
+ .text.gui_3d_draw_mesh_textured_with_depth
+                0x08000350     0x1000 CMakeFiles/gd32f470BaseProject.dir/GUI/gui_3d.c.obj
+ .text.gui_refresh
+                0x08001350      0x800 CMakeFiles/gd32f470BaseProject.dir/GUI/gui_widget.c.obj
+ *fill*         0x08001b50        0x0
+ .text.gui_3d_clear_depth
+                0x08001b50      0xa60 CMakeFiles/gd32f470BaseProject.dir/GUI/gui_3d.c.obj
+
+.ARM.exidx.text.a_function_with_a_really_long_name_for_the_column
+                0x080025b0        0x8
+ .ARM.exidx.text.a_function_with_a_really_long_name_for_the_column
+                0x080025b0        0x8 CMakeFiles/gd32f470BaseProject.dir/System/kernel.c.obj
+
+.data           0x20000000       0x40 load address 0x080025b8
+ .data.ticks    0x20000000       0x40 CMakeFiles/gd32f470BaseProject.dir/user/systick.c.obj
+
+.bss            0x20000040      0x200
+                0x20000040                _sbss = .
+                0x20000040                __bss_start = .
+ .bss.grid      0x20000040      0x200 CMakeFiles/gd32f470BaseProject.dir/GUI/gui_grid.c.obj
+                0x20000240                __bss_end = .
+
+.tcm_data       0x10000000        0x0 load address 0x080025f8
+
+.tcm_bss        0x10000000      0x100
+ .tcm_bss       0x10000000      0x100 CMakeFiles/gd32f470BaseProject.dir/System/kernel.c.obj
+                0x10000100                _etcm_bss = .
+
+.stack          0x20000240      0x400
+                0x20000640                . = (. + _system_stack_size)
+ *fill*         0x20000240      0x400
+
+.sdram          0xc0000000   0x3fc00
+ *(.sdram)
+ .sdram         0xc0000000   0x3fc00 CMakeFiles/gd32f470BaseProject.dir/Hardware/LCD/lcd.c.obj
+"""
+
+
+# __bss_start set after the TCM sections, where the location counter is in the TCM
+BAD_MAP = MAP.replace("                0x20000040                __bss_start = .\n", "") \
+    .replace("                0x10000100                _etcm_bss = .\n",
+             "                0x10000100                _etcm_bss = .\n"
+             "                0x10000100                __bss_start = .\n")
+
+
+def parse(text=MAP):
+    return map_report.parse_map(io.StringIO(text))
+
+
+class ParseTest(unittest.TestCase):
+    def setUp(self):
+        self.regions, self.sections, self.symbols = parse()
+        self.by_name = {s["name"]: s for s in self.sections}
+
+    def test_regions(self):
+        self.assertEqual(self.regions, [
+            ("CODE", 0x08000000, 0x100000),
+            ("DATA", 0x20000000, 0x70000),
+            ("SDRAM", 0xC0000000, 0x2000000),
+            ("TCM", 0x10000000, 0x10000),
+        ])
+
+    def test_sections(self):
+        self.assertEqual([s["name"] for s in self.sections], [
+            ".isr_vector", ".text", ".ARM.exidx.text.a_function_with_a_really_long_name_for_the_column",
+            ".data", ".bss", ".tcm_data", ".tcm_bss", ".stack", ".sdram"])
+        text = self.by_name[".text"]
+        self.assertEqual((text["address"], text["size"]), (0x080001B0, 0x2400))
+        self.assertEqual(self.by_name[".tcm_data"]["size"], 0)
+
+    def test_inputs(self):
+        inputs = self.by_name[".text"]["inputs"]
+        self.assertEqual([i[0] for i in inputs], [
+            ".text", ".text.main", ".text.gui_3d_draw_mesh_textured_with_depth", ".text.gui_refresh",
+            ".text.gui_3d_clear_depth"])
+        self.assertEqual(inputs[2][1:3], (0x08000350, 0x1000))
+        self.assertTrue(inputs[2][3].endswith("GUI/gui_3d.c.obj"))
+        # fill and script lines are no inputs
+        self.assertEqual(self.by_name[".stack"]["inputs"], [])
+        long_section = self.sections[2]
+        self.assertEqual((long_section["address"], long_section["size"]), (0x080025B0, 8))
+        self.assertEqual(len(long_section["inputs"]), 1)
+
+    def test_symbols(self):
+        # script assignments and global symbols, no location counter moves
+        self.assertEqual(self.symbols, {
+            "_system_stack_size": 0x200, "_stext": 0x08000000, "main": 0x08000230, "_sbss": 0x20000040,
+            "__bss_start": 0x20000040, "__bss_end": 0x20000240, "_etcm_bss": 0x10000100,
+        })
+        self.assertEqual(parse(BAD_MAP)[2]["__bss_start"], 0x10000100)
+
+    def test_no_memory_configuration(self):
+        regions, sections, symbols = parse("Linker script and memory map\n\n.text 0x0 0x10\n")
+        self.assertEqual((regions, sections, symbols), ([], [], {}))
+
+
+class HelperTest(unittest.TestCase):
+    def test_region_of(self):
+        regions, _, _ = parse()
+        self.assertEqual(map_report.region_of(regions, 0x10000000), "TCM")
+        self.assertEqual(map_report.region_of(regions, 0xC1FFFFFF), "SDRAM")
+        self.assertIsNone(map_report.region_of(regions, 0xC2000000))
+        self.assertIsNone(map_report.region_of(regions, 0x20070000))
+
+    def test_short_object(self):
+        self.assertEqual(map_report.short_object("CMakeFiles/x.dir/GUI/gui_3d.c.obj"), "gui_3d.c")
+        self.assertEqual(map_report.short_object("build/tlsf.o"), "tlsf")
+        self.assertEqual(map_report.short_object("/opt/lib/libc_nano.a(lib_a-memcpy-stub.o)"),
+                         "libc_nano.a(lib_a-memcpy-stub.o)")
+
+
+class ReportTest(unittest.TestCase):
+    def setUp(self):
+        self.regions, self.sections, self.symbols = parse()
+
+    def test_report(self):
+        out = io.StringIO()
+        map_report.report(self.regions, self.sections, 2, out)
+        lines = out.getvalue().splitlines()
+        self.assertIn("CODE     0x08000000      9652 /   1048576 bytes   0.9%", lines)
+        self.assertIn("TCM      0x10000000       256 /     65536 bytes   0.4%", lines)
+        self.assertIn("SDRAM    0xc0000000    261120 /  33554432 bytes   0.8%", lines)
+        # two objects at most, largest first, the two gui_3d inputs summed
+        text = lines.index("  .text            0x080001b0      9216")
+        self.assertEqual(lines[text + 1].split(), ["gui_3d.c", str(0x1000 + 0xA60)])
+        self.assertEqual(lines[text + 2].split(), ["gui_widget.c", str(0x800)])
+        self.assertTrue(lines[text + 3].startswith("  .ARM.exidx"))
+        # empty sections are left out
+        self.assertFalse(any(".tcm_data" in line for line in lines))
+
+    def test_check(self):
+        out = io.StringIO()
+        good = [".tcm_bss=TCM", ".stack=DATA", ".sdram=SDRAM", ".tcm_data=SDRAM"]
+        self.assertEqual(map_report.check(self.regions, self.sections, self.symbols, good, out), 0)
+        self.assertEqual(out.getvalue(), "")
+        bad = [".stack=TCM", ".nothing=TCM"]
+        self.assertEqual(map_report.check(self.regions, self.sections, self.symbols, bad, out), 2)
+        self.assertIn("map: .stack at 0x20000240 is in DATA, expected TCM", out.getvalue())
+        self.assertIn("map: .nothing not found", out.getvalue())
+
+    def test_check_symbols(self):
+        out = io.StringIO()
+        # the end of a section is in it, a symbol can be checked against a region too
+        good = ["__bss_start=.bss", "__bss_end=.bss", "_sbss=DATA", "_etcm_bss=.tcm_bss", "main=CODE"]
+        self.assertEqual(map_report.check(self.regions, self.sections, self.symbols, good, out), 0)
+        self.assertEqual(out.getvalue(), "")
+        bad = ["__bss_end=.tcm_bss", "_etcm_bss=DATA", "__nothing=.bss"]
+        self.assertEqual(map_report.check(self.regions, self.sections, self.symbols, bad, out), 3)
+        self.assertEqual(out.getvalue().splitlines(), [
+            "map: __bss_end at 0x20000240 is outside .tcm_bss at 0x10000000..0x10000100",
+            "map: _etcm_bss at 0x10000100 is in TCM, expected DATA",
+            "map: __nothing not found",
+        ])
+        out = io.StringIO()
+        regions, sections, symbols = parse(BAD_MAP)
+        self.assertEqual(map_report.check(regions, sections, symbols, ["__bss_start=.bss"], out), 1)
+        self.assertIn("__bss_start at 0x10000100 is outside .bss at 0x20000040..0x20000240", out.getvalue())
+
+
+class CommandTest(unittest.TestCase):
+    def run_tool(self, text, *args):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "test.map")
+            with open(path, "w", encoding="utf-8") as f:
+                f.write(text)
+            env = dict(os.environ, PYTHONDONTWRITEBYTECODE="1")
+            return subprocess.run([sys.executable, os.path.join(TOOLS, "map_report.py"), path] + list(args),
+                                  capture_output=True, text=True, env=env)
+
+    def test_exit_codes(self):
+        result = self.run_tool(MAP, "--expect", ".tcm_bss=TCM")
+        self.assertEqual(result.returncode, 0, result.stderr)
+        self.assertIn("TCM", result.stdout)
+        result = self.run_tool(MAP, "--expect", ".tcm_bss=TCM", "--expect", ".stack=TCM")
+        self.assertEqual(result.returncode, 1)
+        self.assertIn(".stack", result.stderr)
+        # the checks of the firmware build catch a zeroing range starting in the TCM
+        args = ["--expect", ".tcm_bss=TCM", "--expect", "__bss_start=.bss", "--expect", "__bss_end=.bss"]
+        self.assertEqual(self.run_tool(MAP, *args).returncode, 0)
+        result = self.run_tool(BAD_MAP, *args)
+        self.assertEqual(result.returncode, 1)
+        self.assertEqual(result.stderr.splitlines(),
+                         ["map: __bss_start at 0x10000100 is outside .bss at 0x20000040..0x20000240"])
+        result = self.run_tool("not a map\n")
+        self.assertEqual(result.returncode, 1)
+        self.assertIn("no memory configuration", result.stderr)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+"""Test of tools/mem_budget.py on a recorded RTT log.
+
+host/samples/mem.log is the RTT channel 0 output of a soak run: the
+boot report, then every 5 s the mem_stat_dump() line among the other
+statistics. The first dump is within budget. Later ones raise a stack
+and a pool above the warning share and the heap peak above the
+critical share, and the last has a stack used to its end, failed
+allocations and an overwritten pool object. The capture stops inside
+a fourth dump. The dumps are checked against the lines the format
+strings of mem_stat_port.c print, then parsed, budgeted at several
+thresholds and run through the command line.
+"""
+
+import os
+import re
+import subprocess
+import sys
+import unittest
+
+sys.dont_write_bytecode = True
+HOST = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.join(HOST, os.pardir)
+TOOLS = os.path.join(REPO, "tools")
+LOG = os.path.join(HOST, "samples", "mem.log")
+sys.path.insert(0, TOOLS)
+import mem_budget  # noqa: E402
+
+STACKS = [("main", 512), ("control", 1024), ("events", 4096), ("work", 1024), ("bench", 512)]
+POOLS = [(32, 128), (64, 64), (128, 32), (256, 16)]
+HEAP = 33293304
+
+
+def firmware_formats():
+    """The SEGGER_RTT_printf() formats of mem_stat_dump() in the order they print."""
+    with open(os.path.join(REPO, "System", "mem_stat_port.c"), encoding="utf-8") as f:
+        source = f.read()
+    body = source[source.index("void mem_stat_dump(void)"):]
+    formats = re.findall(r'SEGGER_RTT_printf\(0,\s*"((?:[^"\\]|\\.)*)"', body)
+    return [text.replace("\\n", "\n").replace("%u", "%d") for text in formats]
+
+
+def dump(t, stacks, heap, pools):
+    """The line mem_stat_dump() prints for these values."""
+    head, stack, regions, sections, heap_format, pool, end = firmware_formats()
+    line = head % t
+    for (name, size), peak in zip(STACKS, stacks):
+        line += stack % (name, peak, size)
+    line += regions % (211680, 458752, 9760, 65536, 261120, 33554432)
+    line += sections % (1240, 210440, 0, 9216, 261120)
+    line += heap_format % heap
+    for (size, count), (used, peak, fail, bad) in zip(POOLS, pools):
+        line += pool % (size, used, count, size, peak, size, fail, size, bad)
+    return line + end
+
+
+def read_log():
+    with open(LOG, encoding="utf-8") as f:
+        return f.readlines()
+
+
+def samples():
+    return mem_budget.read_samples(read_log())
+
+
+class FormatTest(unittest.TestCase):
+    def test_formats(self):
+        self.assertEqual(len(firmware_formats()), 7)
+
+    def test_recorded_lines(self):
+        # the log holds exactly what the firmware prints
+        lines = [line for line in read_log() if line.startswith("mem ")]
+        self.assertEqual(lines[0], dump(5002, [312, 388, 2260, 296, 180],
+                                        (1048576, HEAP, 2097152, 31195000, 12, 0),
+                                        [(40, 52, 0, 0), (10, 12, 0, 0), (3, 5, 0, 0), (1, 2, 0, 0)]))
+        self.assertEqual(lines[2], dump(15003, [312, 412, 3400, 300, 512],
+                                        (3145728, HEAP, 31700000, 2600000, 520, 3),
+                                        [(60, 110, 0, 0), (12, 14, 2, 0), (3, 5, 0, 0), (0, 2, 0, 1)]))
+        self.assertFalse(lines[3].endswith("\n"))
+
+
+class ParseTest(unittest.TestCase):
+    def test_line(self):
+        sample = mem_budget.parse_line("t=7 stack.main=12/512 heap.frag=640 bad=x/y odd=")
+        self.assertEqual(list(sample.items()), [("t", 7), ("stack.main", (12, 512)), ("heap.frag", 640)])
+
+    def test_samples(self):
+        found = samples()
+        # the cut dump at the end is left out
+        self.assertEqual([s["t"] for s in found], [5002, 10002, 15003])
+        last = found[-1]
+        self.assertEqual(list(last)[:6], ["t", "stack.main", "stack.control", "stack.events", "stack.work",
+                                          "stack.bench"])
+        self.assertEqual(last["stack.bench"], (512, 512))
+        self.assertEqual(last["heap"], (3145728, HEAP))
+        self.assertEqual(last["heap.peak"], 31700000)
+        self.assertEqual(last["pool.256.bad"], 1)
+        self.assertEqual(last["sec.tcm_bss"], 9216)
+        self.assertEqual(len(last), 1 + 5 + 3 + 5 + 5 + 4 * 4)
+
+    def test_prefixed(self):
+        # a viewer putting the channel or a time in front of the line
+        found = mem_budget.read_samples(["00> mem t=1 stack.main=8/512\n", "12:00:01 mem t=2 heap=1/2\n",
+                                         "summem t=3 heap=1/2\n", "mem t=4 heap=1/2"])
+        self.assertEqual([s["t"] for s in found], [1, 2])
+
+
+class BudgetTest(unittest.TestCase):
+    def setUp(self):
+        self.samples = samples()
+
+    def test_rows(self):
+        rows, _ = mem_budget.budget(self.samples, 80.0, 95.0, {})
+        by_key = {row[0]: row[1:] for row in rows}
+        self.assertEqual([row[0] for row in rows], [
+            "stack.main", "stack.control", "stack.events", "stack.work", "stack.bench", "sram", "tcm", "sdram",
+            "heap", "pool.32", "pool.64", "pool.128", "pool.256"])
+        # the heap and pool peaks come from their peak keys, not from the used values dumped
+        self.assertEqual(by_key["heap"][:3], (3145728, 31700000, HEAP))
+        self.assertEqual(by_key["pool.32"][:3], (60, 110, 128))
+        self.assertEqual(by_key["pool.256"][:3], (0, 2, 16))
+        self.assertAlmostEqual(by_key["stack.events"][3], 100.0 * 3400 / 4096)
+
+    def test_within_budget(self):
+        _, alerts = mem_budget.budget(self.samples[:1], 80.0, 95.0, {})
+        self.assertEqual(alerts, [])
+        # a limit of one value crosses there alone
+        _, alerts = mem_budget.budget(self.samples[:1], 80.0, 95.0, {"stack.main": 60.0})
+        self.assertEqual(alerts, [("WARN", "stack.main", "60.9% used, limit 60%")])
+
+    def test_alerts(self):
+        _, alerts = mem_budget.budget(self.samples, 80.0, 95.0, {})
+        self.assertEqual(alerts, [
+            ("WARN", "stack.events", "83.0% used, limit 80%"),
+            ("CRIT", "stack.bench", "stack used up to its end, it has likely overflowed"),
+            ("CRIT", "heap", "95.2% used, limit 95%"),
+            ("WARN", "pool.32", "85.9% used, limit 80%"),
+            ("WARN", "heap.fail", "3 allocations failed"),
+            ("WARN", "pool.64.fail", "2 allocations failed"),
+            ("CRIT", "pool.256.bad", "1 free objects were overwritten"),
+        ])
+
+    def test_thresholds(self):
+        # the peak share against the warning share, on both sides of it
+        _, alerts = mem_budget.budget(self.samples[:2], 83.0, 96.0, {})
+        self.assertEqual([(a[0], a[1]) for a in alerts], [("WARN", "stack.events"), ("WARN", "heap"),
+                                                          ("WARN", "pool.32")])
+        _, alerts = mem_budget.budget(self.samples[:2], 83.1, 96.0, {})
+        self.assertEqual([(a[0], a[1]) for a in alerts], [("WARN", "heap"), ("WARN", "pool.32")])
+        # a limit above the critical share moves the critical share up with it
+        _, alerts = mem_budget.budget(self.samples[:2], 80.0, 90.0, {"pool.32": 86.0, "heap": 99.0})
+        self.assertEqual([(a[0], a[1]) for a in alerts], [("WARN", "stack.events")])
+        _, alerts = mem_budget.budget(self.samples[:2], 80.0, 90.0, {"pool.32": 85.0})
+        self.assertEqual([(a[0], a[1]) for a in alerts], [("WARN", "stack.events"), ("CRIT", "heap"),
+                                                          ("WARN", "pool.32")])
+        # a share right on the limit crosses it, 312/512 is 60.9375%
+        _, alerts = mem_budget.budget(self.samples[:1], 80.0, 95.0, {"stack.main": 60.9375})
+        self.assertEqual([(a[0], a[1]) for a in alerts], [("WARN", "stack.main")])
+        _, alerts = mem_budget.budget(self.samples[:1], 50.0, 60.9375, {})
+        self.assertEqual([(a[0], a[1]) for a in alerts], [("CRIT", "stack.main"), ("WARN", "stack.events")])
+
+    def test_no_peak_key(self):
+        # a pool dumped without its peak takes the peak of the used values
+        rows, _ = mem_budget.budget([{"t": 1, "pool.32": (10, 128)}, {"t": 2, "pool.32": (4, 128)}], 80.0, 95.0, {})
+        self.assertEqual(rows, [("pool.32", 4, 10, 128, 100.0 * 10 / 128)])
+
+
+class CommandTest(unittest.TestCase):
+    def run_tool(self, *args, **kwargs):
+        env = dict(os.environ, PYTHONDONTWRITEBYTECODE="1")
+        return subprocess.run([sys.executable, os.path.join(TOOLS, "mem_budget.py")] + list(args),
+                              capture_output=True, text=True, env=env, **kwargs)
+
+    def test_report(self):
+        result = self.run_tool(LOG)
+        self.assertEqual(result.returncode, 1)
+        lines = result.stdout.splitlines()
+        self.assertEqual(lines[0], "3 dumps, last at 15003 ms")
+        self.assertIn("heap                3145728   31700000   33293304   95.2%", lines)
+        self.assertIn("sec.tcm_bss            9216", lines)
+        self.assertEqual(lines[-1], "CRIT pool.256.bad: 1 free objects were overwritten")
+        self.assertEqual(len(lines), 2 + 13 + 5 + 7)
+
+    def test_stdin_within_budget(self):
+        with open(LOG, encoding="utf-8") as f:
+            first = "".join(f.readlines()[:8])
+        result = self.run_tool("--limit", "stack.main=61", input=first)
+        self.assertEqual(result.returncode, 0, result.stdout)
+        self.assertFalse(any(line.startswith(("WARN", "CRIT")) for line in result.stdout.splitlines()))
+        result = self.run_tool("--limit", "stack.main=60", input=first)
+        self.assertEqual(result.returncode, 1)
+        self.assertEqual(result.stdout.splitlines()[-1], "WARN stack.main: 60.9% used, limit 60%")
+
+    def test_no_dump(self):
+        result = self.run_tool(input="boot: first pixel after 22472 us, 0 steps not done\n")
+        self.assertEqual(result.returncode, 1)
+        self.assertIn("no mem_stat dump", result.stderr)
+
+
+if __name__ == "__main__":
+    unittest.main()
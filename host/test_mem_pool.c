@@ -0,0 +1,245 @@
+/*!
+    \file    test_mem_pool.c
+    \brief   host test of the fixed-size object pools under threads
+
+    Several threads allocate random sizes, hold the objects for a while
+    with their own pattern in them and free them again, often running
+    the classes dry. An owner table catches an object handed out twice,
+    the pattern catches two threads sharing one, and afterwards every
+    class must have all its objects back on a free list that is still
+    intact. Built with MEM_POOL_POISON, which must count a write to a
+    freed object as a corruption.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "test.h"
+#include "mem_pool.h"
+
+#define THREADS                     4U
+#define ROUNDS                      200000U
+#define HELD_MAX                    48U
+#define MAX_OBJECTS                 128U
+
+/* objects of a class, to find the class and index of an object */
+#define CLASS_INFO(name, size, count) { (size), (count) },
+static const struct {
+    uint32_t size;
+    uint32_t count;
+} classes[MEM_POOL_CLASS_COUNT] = {
+    MEM_POOL_CLASSES(CLASS_INFO)
+};
+#undef CLASS_INFO
+
+/* base of each class, from its first allocation after mem_pool_init() */
+static uint8_t *class_base[MEM_POOL_CLASS_COUNT];
+static _Atomic uint32_t owner[MEM_POOL_CLASS_COUNT][MAX_OBJECTS];
+static _Atomic uint32_t errors;
+static _Atomic uint32_t successes;
+
+typedef struct {
+    uint8_t *ptr;
+    uint32_t size;
+    uint32_t c;
+    uint32_t index;
+} held_struct;
+
+static uint32_t rnd(uint32_t *seed, uint32_t range)
+{
+    *seed = *seed * 1103515245U + 12345U;
+    return ((*seed >> 8) & 0xFFFFFFU) % range;
+}
+
+/* find the class and index of an object, return 0 when it is no pool object */
+static int object_find(const uint8_t *ptr, uint32_t *c, uint32_t *index)
+{
+    uint32_t i;
+
+    for(i = 0; i < MEM_POOL_CLASS_COUNT; i++){
+        if((ptr >= class_base[i]) && (ptr < class_base[i] + classes[i].size * classes[i].count)){
+            if(0U != (uint32_t)(ptr - class_base[i]) % classes[i].size){
+                return 0;
+            }
+            *c = i;
+            *index = (uint32_t)(ptr - class_base[i]) / classes[i].size;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void held_release(held_struct *h, uint32_t id)
+{
+    uint32_t i;
+
+    for(i = 0; i < h->size; i++){
+        if(h->ptr[i] != (uint8_t)id){
+            atomic_fetch_add(&errors, 1U);
+            break;
+        }
+    }
+    atomic_store(&owner[h->c][h->index], 0U);
+    mem_pool_free(h->ptr);
+}
+
+static void *worker(void *arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg, seed = id * 7919U, held_count = 0, i, expected;
+    held_struct held[HELD_MAX], *h;
+    uint32_t size;
+    uint8_t *ptr;
+
+    for(i = 0; i < ROUNDS; i++){
+        if((held_count < HELD_MAX) && (rnd(&seed, 100) < 55U)){
+            size = 1U + rnd(&seed, 256);
+            ptr = mem_pool_alloc(size);
+            if(NULL == ptr){
+                continue;
+            }
+            h = &held[held_count];
+            if(!object_find(ptr, &h->c, &h->index) || (classes[h->c].size < size)){
+                atomic_fetch_add(&errors, 1U);
+                continue;
+            }
+            expected = 0;
+            if(!atomic_compare_exchange_strong(&owner[h->c][h->index], &expected, id)){
+                /* handed out twice */
+                atomic_fetch_add(&errors, 1U);
+                continue;
+            }
+            h->ptr = ptr;
+            h->size = size;
+            memset(ptr, (uint8_t)id, size);
+            held_count++;
+            atomic_fetch_add(&successes, 1U);
+        }else if(0U != held_count){
+            h = &held[rnd(&seed, held_count)];
+            held_release(h, id);
+            *h = held[--held_count];
+        }
+    }
+    while(0U != held_count){
+        held_release(&held[--held_count], id);
+    }
+    return NULL;
+}
+
+/* every object of every class can be taken once and only once */
+static void check_free_lists(void)
+{
+    static uint8_t *objects[MAX_OBJECTS];
+    uint32_t c, i, j;
+
+    for(c = 0; c < MEM_POOL_CLASS_COUNT; c++){
+        for(i = 0; i < classes[c].count; i++){
+            objects[i] = mem_pool_alloc_class((mem_pool_class_enum)c);
+            CHECK(NULL != objects[i]);
+            for(j = 0; (NULL != objects[i]) && (j < i); j++){
+                CHECK(objects[i] != objects[j]);
+            }
+        }
+        CHECK(NULL == mem_pool_alloc_class((mem_pool_class_enum)c));
+        for(i = 0; i < classes[c].count; i++){
+            mem_pool_free(objects[i]);
+        }
+    }
+}
+
+static void test_threads(void)
+{
+    pthread_t threads[THREADS];
+    mem_pool_stats_struct stats;
+    uint32_t c, i, allocs = 0;
+    void *obj;
+
+    mem_pool_init();
+    for(c = 0; c < MEM_POOL_CLASS_COUNT; c++){
+        CHECK(classes[c].count <= MAX_OBJECTS);
+        obj = mem_pool_alloc_class((mem_pool_class_enum)c);
+        class_base[c] = obj;
+        mem_pool_free(obj);
+    }
+    mem_pool_init();
+
+    for(i = 0; i < THREADS; i++){
+        pthread_create(&threads[i], NULL, worker, (void *)(uintptr_t)(i + 1U));
+    }
+    for(i = 0; i < THREADS; i++){
+        pthread_join(threads[i], NULL);
+    }
+    CHECK_EQ(atomic_load(&errors), 0);
+
+    for(c = 0; c < MEM_POOL_CLASS_COUNT; c++){
+        mem_pool_stats_get((mem_pool_class_enum)c, &stats);
+        CHECK_EQ(stats.size, classes[c].size);
+        CHECK_EQ(stats.count, classes[c].count);
+        CHECK_EQ(stats.used, 0);
+        CHECK(stats.peak <= stats.count);
+        CHECK_EQ(stats.corruptions, 0);
+        allocs += stats.allocs;
+    }
+    CHECK_EQ(allocs, atomic_load(&successes));
+    /* the threads held more than the small classes have */
+    mem_pool_stats_get(MEM_POOL_256, &stats);
+    CHECK_EQ(stats.peak, stats.count);
+    CHECK(stats.failures > 0U);
+
+    check_free_lists();
+}
+
+/* a write to a freed object is found when it is handed out again */
+static void test_poison(void)
+{
+    mem_pool_stats_struct stats;
+    uint8_t *obj, *again;
+
+    mem_pool_init();
+    obj = mem_pool_alloc_class(MEM_POOL_64);
+    CHECK(NULL != obj);
+    if(NULL == obj){
+        return;
+    }
+    CHECK_EQ(obj[10], MEM_POOL_ALLOC_BYTE);
+    mem_pool_free(obj);
+    CHECK_EQ(obj[10], MEM_POOL_FREE_BYTE);
+    obj[10] = 0;
+    again = mem_pool_alloc_class(MEM_POOL_64);
+    CHECK(again == obj);
+    mem_pool_stats_get(MEM_POOL_64, &stats);
+    CHECK_EQ(stats.corruptions, 1);
+    mem_pool_free(again);
+
+    CHECK(NULL == mem_pool_alloc(257));
+    mem_pool_free(NULL);
+}
+
+/* the smallest class that fits, the next one when it is empty */
+static void test_fallback(void)
+{
+    static uint8_t *small[MAX_OBJECTS];
+    uint8_t *obj;
+    uint32_t c, index, i;
+
+    mem_pool_init();
+    for(i = 0; i < classes[MEM_POOL_32].count; i++){
+        small[i] = mem_pool_alloc(1U + i % 32U);
+        CHECK(object_find(small[i], &c, &index) && (MEM_POOL_32 == c));
+    }
+    obj = mem_pool_alloc(8);
+    CHECK(object_find(obj, &c, &index) && (MEM_POOL_64 == c));
+    mem_pool_free(obj);
+    for(i = 0; i < classes[MEM_POOL_32].count; i++){
+        mem_pool_free(small[i]);
+    }
+}
+
+int main(void)
+{
+    test_threads();
+    test_poison();
+    test_fallback();
+    return test_result();
+}
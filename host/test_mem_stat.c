@@ -0,0 +1,130 @@
+/*!
+    \file    test_mem_stat.c
+    \brief   host test of the stack painting and the stack table
+
+    The paint must cover its range exactly, the words around it are
+    left as they were. A painted stack is then used down from its top
+    as a thread would, to random depths and with words that happen to
+    hold the paint pattern, and the peak must be the deepest word
+    written. The table of watched stacks takes MEM_STAT_STACKS entries
+    and refuses the next.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "test.h"
+#include "mem_stat.h"
+
+#define STACK_WORDS                 256U
+#define FILL                        0x12345678UL
+#define ROUNDS                      10000U
+
+static uint32_t seed = 1U;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+/* the stack with one word of other data on either side */
+static uint32_t memory[STACK_WORDS + 2U];
+static uint32_t *const stack = &memory[1];
+
+static void fill(uint32_t *start, uint32_t words, uint32_t value)
+{
+    uint32_t i;
+
+    for(i = 0; i < words; i++){
+        start[i] = value;
+    }
+}
+
+static void test_paint(void)
+{
+    uint32_t i;
+
+    fill(memory, STACK_WORDS + 2U, FILL);
+    mem_stat_paint(stack, stack + STACK_WORDS);
+    CHECK_EQ(memory[0], FILL);
+    CHECK_EQ(memory[STACK_WORDS + 1U], FILL);
+    for(i = 0; i < STACK_WORDS; i++){
+        CHECK_EQ(stack[i], MEM_STAT_PAINT);
+    }
+
+    /* an empty range and a reversed one paint nothing */
+    fill(memory, STACK_WORDS + 2U, FILL);
+    mem_stat_paint(stack, stack);
+    mem_stat_paint(stack + 4, stack);
+    CHECK_EQ(stack[0], FILL);
+
+    /* painted below a stack pointer, the words above it are in use */
+    mem_stat_paint(stack, stack + 100);
+    CHECK_EQ(stack[99], MEM_STAT_PAINT);
+    CHECK_EQ(stack[100], FILL);
+    CHECK_EQ(mem_stat_stack_peak(stack, STACK_WORDS * 4U), (STACK_WORDS - 100U) * 4U);
+}
+
+static void test_peak(void)
+{
+    uint32_t i, depth, errors = 0;
+
+    fill(memory, STACK_WORDS + 2U, FILL);
+    mem_stat_paint(stack, stack + STACK_WORDS);
+    /* never used, the word above the top holding the paint is not read */
+    memory[STACK_WORDS + 1U] = MEM_STAT_PAINT;
+    CHECK_EQ(mem_stat_stack_peak(stack, STACK_WORDS * 4U), 0);
+    stack[STACK_WORDS - 1U] = 0U;
+    CHECK_EQ(mem_stat_stack_peak(stack, STACK_WORDS * 4U), 4);
+    /* the whole stack used */
+    stack[0] = 0U;
+    CHECK_EQ(mem_stat_stack_peak(stack, STACK_WORDS * 4U), STACK_WORDS * 4U);
+    CHECK_EQ(mem_stat_stack_peak(stack, 0U), 0);
+
+    /* random depths, pushed words equal to the paint above the deepest one do not matter */
+    for(i = 0; i < ROUNDS; i++){
+        depth = rnd(STACK_WORDS + 1U);
+        mem_stat_paint(stack, stack + STACK_WORDS);
+        fill(stack + STACK_WORDS - depth, depth, (0U == rnd(2)) ? MEM_STAT_PAINT : rnd(0x1000000U));
+        if(0U != depth){
+            stack[STACK_WORDS - depth] = (uint32_t)i;
+        }
+        if(depth > 1U){
+            stack[STACK_WORDS - 1U - rnd(depth - 1U)] = MEM_STAT_PAINT;
+        }
+        if(mem_stat_stack_peak(stack, STACK_WORDS * 4U) != depth * 4U){
+            errors++;
+        }
+    }
+    CHECK_EQ(errors, 0);
+}
+
+static void test_table(void)
+{
+    static uint32_t stacks[MEM_STAT_STACKS + 1U][8];
+    const mem_stat_stack_struct *entry;
+    uint32_t i;
+
+    CHECK_EQ(mem_stat_stack_count(), 0);
+    CHECK(NULL == mem_stat_stack_get(0));
+    for(i = 0; i < MEM_STAT_STACKS; i++){
+        CHECK_EQ(mem_stat_stack_add("thread", stacks[i], sizeof(stacks[i])), 0);
+    }
+    CHECK_EQ(mem_stat_stack_add("full", stacks[i], sizeof(stacks[i])), -1);
+    CHECK_EQ(mem_stat_stack_count(), MEM_STAT_STACKS);
+    entry = mem_stat_stack_get(MEM_STAT_STACKS - 1U);
+    CHECK(NULL != entry);
+    if(NULL != entry){
+        CHECK(stacks[MEM_STAT_STACKS - 1U] == entry->base);
+        CHECK_EQ(entry->size, sizeof(stacks[0]));
+    }
+    CHECK(NULL == mem_stat_stack_get(MEM_STAT_STACKS));
+}
+
+int main(void)
+{
+    test_paint();
+    test_peak();
+    test_table();
+    return test_result();
+}
@@ -0,0 +1,294 @@
+/*!
+    \file    test_mpu.c
+    \brief   host test of the MPU region planner against a brute force model
+
+    Random sets of overlapping areas are planned and the regions are
+    matched the way an ARMv7-M MPU does: a region covers an address when
+    it lies in the size aligned block and its subregion is enabled, and
+    the highest numbered region that covers it wins. Every address must
+    then get the attributes of the last area listed over it and nothing
+    outside the areas may be covered. In a 64 KB window every 32 byte
+    block is checked, over the whole address space the edges of every
+    area and region and random addresses are. An area that one region
+    can cover must cost one region, and the planner must refuse
+    unaligned areas and tables that are too small.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "test.h"
+#include "mpu.h"
+
+#define WINDOW_BASE                 0x20000000UL
+#define WINDOW_SIZE                 (64U * 1024U)
+#define MAX_AREAS                   3U
+#define PLANS                       3000U
+#define SAMPLES                     2000U
+
+/* RASR bits that come from the area, not the size, subregions or enable */
+#define RASR_ATTRIBUTES             0xFFFF0000UL
+#define RASR_SRD_GET(rasr)          (((rasr) >> 8) & 0xFFU)
+#define RASR_LOG2_GET(rasr)         ((((rasr) >> 1) & 0x1FU) + 1U)
+
+#define NO_REGION                   (-1)
+
+static uint32_t seed = 1U;
+static uint32_t planned;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+static uint32_t rnd32(void)
+{
+    return (rnd(0x10000U) << 16) | rnd(0x10000U);
+}
+
+static void random_attributes(mpu_area_struct *area)
+{
+    area->mem = (mpu_mem_enum)rnd(5);
+    area->access = (mpu_access_enum)rnd(4);
+    area->execute = (uint8_t)rnd(2);
+}
+
+/* attributes the planner gives an area, from planning it alone */
+static uint32_t area_rasr(const mpu_area_struct *area)
+{
+    mpu_area_struct one = *area;
+    mpu_region_struct region;
+
+    one.base = 0;
+    one.size = MPU_REGION_MIN;
+    mpu_plan(&one, 1, &region, 1);
+    return region.rasr & RASR_ATTRIBUTES;
+}
+
+/* the region an MPU would use for an address, NO_REGION for the background map */
+static int mpu_match(const mpu_region_struct *regions, int count, uint32_t address)
+{
+    uint64_t size, base;
+    uint32_t log2;
+    int i;
+
+    for(i = count - 1; i >= 0; i--){
+        log2 = RASR_LOG2_GET(regions[i].rasr);
+        size = (uint64_t)1U << log2;
+        base = regions[i].rbar & ~(uint64_t)0x1FU & ~(size - 1U);
+        if((0U == (regions[i].rasr & 1U)) || ((address & ~(size - 1U)) != base)){
+            continue;
+        }
+        if((log2 >= 8U) && (0U != (RASR_SRD_GET(regions[i].rasr) & (1U << ((address - base) / (size / 8U)))))){
+            continue;
+        }
+        return i;
+    }
+    return NO_REGION;
+}
+
+/* the last area listed over an address, -1 for none */
+static int area_match(const mpu_area_struct *areas, uint32_t area_count, uint32_t address)
+{
+    int i;
+
+    for(i = (int)area_count - 1; i >= 0; i--){
+        if((address >= areas[i].base) && ((uint64_t)address < (uint64_t)areas[i].base + areas[i].size)){
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* the register fields are well formed and mpu_region_range() agrees with them */
+static int regions_valid(const mpu_region_struct *regions, int count)
+{
+    uint32_t log2, first, last;
+    int i;
+
+    for(i = 0; i < count; i++){
+        log2 = RASR_LOG2_GET(regions[i].rasr);
+        if((log2 < 5U) || ((regions[i].rbar & 0x1FU) != (0x10U | (uint32_t)i)) ||
+           (0U != ((regions[i].rbar & ~0x1FUL) & (((uint64_t)1U << log2) - 1U))) ||
+           ((log2 < 8U) && (0U != RASR_SRD_GET(regions[i].rasr))) ||
+           (0xFFU == RASR_SRD_GET(regions[i].rasr))){
+            return 0;
+        }
+        mpu_region_range(&regions[i], &first, &last);
+        if((mpu_match(&regions[i], 1, first) != 0) || (mpu_match(&regions[i], 1, last) != 0)){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* check one address against the model */
+static int address_ok(const mpu_area_struct *areas, uint32_t area_count, const uint32_t *rasr,
+                      const mpu_region_struct *regions, int count, uint32_t address)
+{
+    int area = area_match(areas, area_count, address);
+    int region = mpu_match(regions, count, address);
+
+    if(area < 0){
+        return NO_REGION == region;
+    }
+    return (NO_REGION != region) && ((regions[region].rasr & RASR_ATTRIBUTES) == rasr[area]);
+}
+
+/* plan a set of areas and check the mapping of the whole window or of sampled addresses */
+static void check_plan(const mpu_area_struct *areas, uint32_t area_count, int exhaustive)
+{
+    mpu_region_struct regions[MPU_REGIONS];
+    uint32_t rasr[MAX_AREAS], address, i, bad = 0, bad_address = 0;
+    int count, r;
+
+    count = mpu_plan(areas, area_count, regions, MPU_REGIONS);
+    if(count < 0){
+        /* aligned areas only fail for want of regions */
+        return;
+    }
+    planned++;
+    if(!regions_valid(regions, count)){
+        printf("malformed regions for %u areas\n", area_count);
+        test_failed++;
+        return;
+    }
+    for(i = 0; i < area_count; i++){
+        rasr[i] = area_rasr(&areas[i]);
+    }
+
+    if(exhaustive){
+        for(address = WINDOW_BASE - 64U; address < WINDOW_BASE + WINDOW_SIZE + 64U; address += MPU_REGION_MIN){
+            if(!address_ok(areas, area_count, rasr, regions, count, address)){
+                bad++;
+                bad_address = address;
+            }
+        }
+    }else{
+        /* edges of areas and regions, then random addresses */
+        for(i = 0; i < area_count; i++){
+            for(r = -1; r <= 0; r++){
+                address = areas[i].base + (uint32_t)r * MPU_REGION_MIN;
+                bad += !address_ok(areas, area_count, rasr, regions, count, address);
+                address = areas[i].base + areas[i].size + (uint32_t)r * MPU_REGION_MIN;
+                bad += !address_ok(areas, area_count, rasr, regions, count, address);
+            }
+        }
+        for(r = 0; r < count; r++){
+            mpu_region_range(&regions[r], &address, &i);
+            bad += !address_ok(areas, area_count, rasr, regions, count, address);
+            bad += !address_ok(areas, area_count, rasr, regions, count, address - 1U);
+            bad += !address_ok(areas, area_count, rasr, regions, count, i);
+            bad += !address_ok(areas, area_count, rasr, regions, count, i + 1U);
+        }
+        for(i = 0; i < SAMPLES; i++){
+            address = areas[rnd(area_count)].base + rnd32() % (areas[0].size + 1U);
+            bad += !address_ok(areas, area_count, rasr, regions, count, address);
+        }
+    }
+    if(0U != bad){
+        printf("%u addresses mapped wrong with %u areas, e.g. 0x%08x\n", bad, area_count, bad_address);
+        test_failed++;
+    }
+}
+
+/* random overlapping areas in the window, every block checked */
+static void test_window(void)
+{
+    mpu_area_struct areas[MAX_AREAS];
+    uint32_t plan, count, i, units, first;
+
+    planned = 0;
+    for(plan = 0; plan < PLANS; plan++){
+        count = 1U + rnd(MAX_AREAS);
+        for(i = 0; i < count; i++){
+            units = WINDOW_SIZE / MPU_REGION_MIN;
+            first = rnd(units);
+            areas[i].base = WINDOW_BASE + first * MPU_REGION_MIN;
+            areas[i].size = (1U + rnd(units - first)) * MPU_REGION_MIN;
+            random_attributes(&areas[i]);
+        }
+        check_plan(areas, count, 1);
+    }
+    /* about half fit in eight regions */
+    CHECK(planned > PLANS / 4U);
+}
+
+/* large areas anywhere in the address space, edges and samples checked */
+static void test_address_space(void)
+{
+    mpu_area_struct areas[MAX_AREAS];
+    uint32_t plan, count, i, size;
+
+    planned = 0;
+    for(plan = 0; plan < PLANS; plan++){
+        count = 1U + rnd(2);
+        /* big areas on coarse boundaries, a small one inside the first */
+        size = MPU_REGION_MIN << (rnd(22) + 1U);
+        areas[0].base = (rnd32() & ~(size - 1U)) & 0x7FFFFFFFU;
+        areas[0].size = size * (1U + rnd(3)) / 2U;
+        random_attributes(&areas[0]);
+        for(i = 1; i < count; i++){
+            areas[i].base = areas[0].base + (rnd(areas[0].size / MPU_REGION_MIN)) * MPU_REGION_MIN;
+            areas[i].size = MPU_REGION_MIN << rnd(4);
+            random_attributes(&areas[i]);
+        }
+        check_plan(areas, count, 0);
+    }
+    CHECK(planned > PLANS / 4U);
+}
+
+/* an area a single region covers with contiguous subregions gets one region */
+static void test_single_region(void)
+{
+    mpu_region_struct regions[MPU_REGIONS];
+    mpu_area_struct area;
+    uint32_t log2, lo, hi, size;
+
+    memset(&area, 0, sizeof(area));
+    for(log2 = 5U; log2 <= 31U; log2++){
+        size = 1U << log2;
+        if(log2 < 8U){
+            area.base = 0x40000000U - size * 3U;
+            area.size = size;
+            CHECK_EQ(mpu_plan(&area, 1, regions, MPU_REGIONS), 1);
+            continue;
+        }
+        for(lo = 0; lo < 8U; lo++){
+            for(hi = lo + 1U; hi <= 8U; hi++){
+                area.base = (uint32_t)(((uint64_t)0x80000000U & ~((uint64_t)size - 1U)) + (size / 8U) * lo);
+                area.size = (size / 8U) * (hi - lo);
+                CHECK_EQ(mpu_plan(&area, 1, regions, MPU_REGIONS), 1);
+            }
+        }
+    }
+}
+
+static void test_refusals(void)
+{
+    mpu_region_struct regions[MPU_REGIONS];
+    mpu_area_struct area;
+
+    memset(&area, 0, sizeof(area));
+    area.base = WINDOW_BASE + 16U;
+    area.size = 64U;
+    CHECK_EQ(mpu_plan(&area, 1, regions, MPU_REGIONS), -1);
+    area.base = WINDOW_BASE;
+    area.size = 48U;
+    CHECK_EQ(mpu_plan(&area, 1, regions, MPU_REGIONS), -1);
+    /* 32 bytes, then 64, 128, 256 and 512 up to the next 1 KB boundary, then the rest */
+    area.base = WINDOW_BASE + 32U;
+    area.size = 1024U + 3U * 32U;
+    CHECK(mpu_plan(&area, 1, regions, MPU_REGIONS) > 1);
+    CHECK_EQ(mpu_plan(&area, 1, regions, 1), -1);
+}
+
+int main(void)
+{
+    test_window();
+    test_address_space();
+    test_single_region();
+    test_refusals();
+    return test_result();
+}
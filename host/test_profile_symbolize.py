@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""Test of tools/profile_symbolize.py on recorded samples.
+
+host/samples holds the captures test_profiler records from the batches
+of profiler.c, one with the lr of each sample, leading garbage and a
+cut copy of a batch, one with the pc alone, and profile.elf, whose
+symbol table stands in for the firmware: Thumb functions at odd
+addresses, one without a size and a data object. The symbols, the
+batches read back, the profile, the folded stacks and the command line
+are checked against the samples that were taken.
+"""
+
+import io
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+sys.dont_write_bytecode = True
+HOST = os.path.dirname(os.path.abspath(__file__))
+TOOLS = os.path.join(HOST, os.pardir, "tools")
+SAMPLES = os.path.join(HOST, "samples")
+sys.path.insert(0, TOOLS)
+import profile_symbolize  # noqa: E402
+
+
+def read(name):
+    with open(os.path.join(SAMPLES, name), "rb") as f:
+        return f.read()
+
+
+ELF = os.path.join(SAMPLES, "profile.elf")
+CAPTURES = [os.path.join(SAMPLES, "profile_lr.bin"), os.path.join(SAMPLES, "profile_pc.bin")]
+
+FLAT = [("gui_refresh", 243), ("gui_fill", 65), ("SysTick_Handler", 40), ("main", 2), ("memcpy", 1),
+        ("[unknown]", 1)]
+FOLDED = """\
+SysTick_Handler 40
+[exception];main 2
+gui_fill 60
+gui_refresh;gui_fill 5
+main;[unknown] 1
+main;gui_refresh 243
+memcpy 1
+"""
+
+
+class SymbolTest(unittest.TestCase):
+    def setUp(self):
+        self.functions = profile_symbolize.read_symbols(read("profile.elf"))
+
+    def test_functions(self):
+        # Thumb bit cleared, the one without a size reaching the next, the data object left out
+        self.assertEqual(self.functions, [
+            (0x08000200, 0x08000240, "main"),
+            (0x08000240, 0x080002C0, "gui_refresh"),
+            (0x080002C0, 0x080002E0, "gui_fill"),
+            (0x080002E0, 0x08000300, "memcpy"),
+            (0x08000300, 0x08000310, "SysTick_Handler"),
+        ])
+
+    def test_not_elf(self):
+        with self.assertRaises(ValueError):
+            profile_symbolize.read_symbols(read("profile_pc.bin"))
+
+    def test_symbolizer(self):
+        symbolizer = profile_symbolize.Symbolizer(self.functions)
+        self.assertEqual(symbolizer.name(0x08000200), "main")
+        self.assertEqual(symbolizer.name(0x0800023F), "main")
+        self.assertEqual(symbolizer.name(0x08000240), "gui_refresh")
+        self.assertEqual(symbolizer.name(0x080002FE), "memcpy")
+        self.assertEqual(symbolizer.name(0x08000310), "[unknown]")
+        self.assertEqual(symbolizer.name(0x080001FE), "[unknown]")
+        # lr follows the call, the call is in the function before a return address at its end
+        self.assertEqual(symbolizer.caller(0x08000241), "main")
+        self.assertEqual(symbolizer.caller(0x08000261), "gui_refresh")
+        self.assertEqual(symbolizer.caller(0xFFFFFFF9), "[exception]")
+        self.assertIsNone(symbolizer.caller(None))
+
+
+class BatchTest(unittest.TestCase):
+    def test_with_lr(self):
+        samples, lost = profile_symbolize.read_batches(read("profile_lr.bin"))
+        # 12 in the first batch, 240 after the refused one, the cut copy dropped
+        self.assertEqual(len(samples), 12 + 240)
+        self.assertEqual(lost, 26)
+        self.assertEqual(samples[0], (0x080002C4, 0x08000261))
+        self.assertEqual(samples[11], (0x00000100, 0x08000221))
+        self.assertEqual(set(samples[12:]), {(0x08000250, 0x08000221)})
+
+    def test_pc_only(self):
+        samples, lost = profile_symbolize.read_batches(read("profile_pc.bin"))
+        self.assertEqual(lost, 0)
+        self.assertEqual([pc for pc, _ in samples[:9]], [0x080002C4 + (i & 7) * 2 for i in range(9)])
+        self.assertEqual(samples[-1], (0x08000304, None))
+        self.assertEqual(len(samples), 100)
+
+    def test_cut(self):
+        data = read("profile_lr.bin")
+        # a capture starting inside the first batch reads from the next
+        samples, lost = profile_symbolize.read_batches(data[20:])
+        self.assertEqual((len(samples), lost), (240, 26))
+        # a capture ending inside a batch drops it
+        samples, _ = profile_symbolize.read_batches(data[:-1])
+        self.assertEqual(len(samples), 12 + 240 - 16)
+        self.assertEqual(profile_symbolize.read_batches(b"PRF1" * 3), ([], 0))
+
+
+class ProfileTest(unittest.TestCase):
+    def setUp(self):
+        symbolizer = profile_symbolize.Symbolizer(profile_symbolize.read_symbols(read("profile.elf")))
+        samples = []
+        for path in CAPTURES:
+            with open(path, "rb") as f:
+                samples.extend(profile_symbolize.read_batches(f.read())[0])
+        self.flat, self.stacks = profile_symbolize.profile(samples, symbolizer)
+
+    def test_flat(self):
+        self.assertEqual(self.flat.most_common(), FLAT)
+
+    def test_report(self):
+        out = io.StringIO()
+        profile_symbolize.report(self.flat, 26, 2, out)
+        self.assertEqual(out.getvalue().splitlines(), [
+            "352 samples, 26 lost",
+            " samples   share  function",
+            "     243  69.03%  gui_refresh",
+            "      65  18.47%  gui_fill",
+        ])
+
+    def test_folded(self):
+        out = io.StringIO()
+        profile_symbolize.write_folded(self.stacks, out)
+        self.assertEqual(out.getvalue(), FOLDED)
+
+
+class CommandTest(unittest.TestCase):
+    def run_tool(self, *args):
+        env = dict(os.environ, PYTHONDONTWRITEBYTECODE="1")
+        return subprocess.run([sys.executable, os.path.join(TOOLS, "profile_symbolize.py")] + list(args),
+                              capture_output=True, text=True, env=env)
+
+    def test_folded_file(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            folded = os.path.join(tmp, "profile.folded")
+            result = self.run_tool(ELF, *CAPTURES, "--top", "0", "--folded", folded)
+            self.assertEqual(result.returncode, 0, result.stderr)
+            with open(folded, encoding="utf-8") as f:
+                self.assertEqual(f.read(), FOLDED)
+        lines = result.stdout.splitlines()
+        self.assertEqual(lines[0], "352 samples, 26 lost")
+        self.assertEqual(len(lines), 2 + len(FLAT))
+
+    def test_no_samples(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            empty = os.path.join(tmp, "empty.bin")
+            with open(empty, "wb") as f:
+                f.write(b"junk")
+            result = self.run_tool(ELF, empty)
+        self.assertEqual(result.returncode, 1)
+        self.assertIn("no samples", result.stderr)
+
+
+if __name__ == "__main__":
+    unittest.main()
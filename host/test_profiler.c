@@ -0,0 +1,181 @@
+/*!
+    \file    test_profiler.c
+    \brief   host test of the sampling profiler batches
+
+    Samples go through the ring into batches as the drain would cut
+    them, and the batch headers are checked: sample count, flags and
+    the samples lost since the last batch, with a ring that overflows,
+    a batch the channel refuses and a ring that wraps under a batch.
+
+    The batches make up the two captures in host/samples, one with the
+    lr of each sample and leading garbage and a cut copy of a batch,
+    one with the pc alone. They must match the recorded files byte for
+    byte, which test_profile_symbolize.py reads back with the tool.
+    Run with --record to write them again after a change of the format.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "profiler.h"
+
+/* addresses in the functions of host/samples/profile.elf */
+#define PC_MAIN                     0x08000210U
+#define PC_REFRESH                  0x08000250U
+#define PC_FILL                     0x080002C4U
+#define PC_MEMCPY                   0x080002F0U
+#define PC_SYSTICK                  0x08000304U
+#define PC_UNKNOWN                  0x00000100U
+/* return addresses after a call, Thumb bit set */
+#define LR_IN_MAIN                  0x08000221U
+#define LR_IN_REFRESH               0x08000261U
+#define LR_IN_MEMCPY                0x080002F5U
+#define LR_EXC_RETURN               0xFFFFFFF9U
+
+#define BATCH_SAMPLES               16U
+
+typedef struct {
+    const char *name;
+    uint8_t data[8192];
+    uint32_t len;
+} capture_struct;
+
+static profiler_struct p;
+static capture_struct capture_lr = {"profile_lr.bin", {0}, 0};
+static capture_struct capture_pc = {"profile_pc.bin", {0}, 0};
+
+static uint32_t get32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static void append(capture_struct *capture, const void *data, uint32_t len)
+{
+    memcpy(&capture->data[capture->len], data, len);
+    capture->len += len;
+}
+
+/* check the header of a batch of n bytes */
+static void check_batch(const uint8_t *batch, uint32_t n, uint32_t count, uint32_t flags, uint32_t lost)
+{
+    CHECK_EQ(n, PROFILER_HEADER_SIZE + count * ((0U != flags) ? 8U : 4U));
+    CHECK_EQ(get32(batch), PROFILER_MAGIC);
+    CHECK_EQ(batch[4] | (batch[5] << 8), count);
+    CHECK_EQ(batch[6] | (batch[7] << 8), flags);
+    CHECK_EQ(get32(&batch[8]), lost);
+}
+
+static void record_lr(void)
+{
+    uint8_t batch[PROFILER_HEADER_SIZE + BATCH_SAMPLES * 8U];
+    uint32_t i, n, batches = 0;
+
+    /* the capture started in the middle of something, with a false start of a magic */
+    append(&capture_lr, "junkPRF", 7U);
+    profiler_init(&p, 1);
+    CHECK_EQ(profiler_batch(&p, batch, sizeof(batch)), 0);
+    for(i = 0; i < 5U; i++){
+        profiler_sample(&p, PC_FILL, LR_IN_REFRESH);
+    }
+    for(i = 0; i < 3U; i++){
+        profiler_sample(&p, PC_REFRESH, LR_IN_MAIN);
+    }
+    profiler_sample(&p, PC_MAIN, LR_EXC_RETURN);
+    profiler_sample(&p, PC_MAIN + 2U, LR_EXC_RETURN);
+    profiler_sample(&p, PC_MEMCPY, LR_IN_MEMCPY);
+    profiler_sample(&p, PC_UNKNOWN, LR_IN_MAIN);
+    n = profiler_batch(&p, batch, sizeof(batch));
+    check_batch(batch, n, 12U, PROFILER_FLAG_LR, 0U);
+    CHECK_EQ(get32(&batch[PROFILER_HEADER_SIZE]), PC_FILL);
+    CHECK_EQ(get32(&batch[PROFILER_HEADER_SIZE + 4U]), LR_IN_REFRESH);
+    append(&capture_lr, batch, n);
+    CHECK_EQ(profiler_batch(&p, batch, sizeof(batch)), 0);
+
+    /* the ring overflows by 10, the first batch is refused by the channel */
+    for(i = 0; i < PROFILER_RING_SIZE + 10U; i++){
+        profiler_sample(&p, PC_REFRESH, LR_IN_MAIN);
+    }
+    CHECK_EQ(p.lost, 10);
+    CHECK_EQ(p.taken, 12U + PROFILER_RING_SIZE);
+    n = profiler_batch(&p, batch, sizeof(batch));
+    check_batch(batch, n, BATCH_SAMPLES, PROFILER_FLAG_LR, 10U);
+    profiler_skip(&p, batch);
+    CHECK_EQ(p.skipped, BATCH_SAMPLES);
+    /* the next batch through reports both, and is followed by a cut copy of itself */
+    n = profiler_batch(&p, batch, sizeof(batch));
+    check_batch(batch, n, BATCH_SAMPLES, PROFILER_FLAG_LR, 10U + BATCH_SAMPLES);
+    append(&capture_lr, batch, n);
+    append(&capture_lr, batch, 20U);
+    while(0U != (n = profiler_batch(&p, batch, sizeof(batch)))){
+        check_batch(batch, n, BATCH_SAMPLES, PROFILER_FLAG_LR, 0U);
+        append(&capture_lr, batch, n);
+        batches++;
+    }
+    CHECK_EQ(batches, (PROFILER_RING_SIZE - 2U * BATCH_SAMPLES) / BATCH_SAMPLES);
+}
+
+static void record_pc(void)
+{
+    static uint8_t batch[PROFILER_HEADER_SIZE + PROFILER_RING_SIZE * 4U];
+    uint32_t i, n, pc;
+
+    /* move the ring on so the next samples wrap it */
+    profiler_init(&p, 0);
+    for(i = 0; i < 200U; i++){
+        profiler_sample(&p, PC_MAIN, 0U);
+    }
+    while(0U != profiler_batch(&p, batch, sizeof(batch))){
+    }
+    for(i = 0; i < 100U; i++){
+        profiler_sample(&p, (i < 60U) ? PC_FILL + (i & 7U) * 2U : PC_SYSTICK, 0U);
+    }
+    n = profiler_batch(&p, batch, sizeof(batch));
+    check_batch(batch, n, 100U, 0U, 0U);
+    for(i = 0; i < 100U; i++){
+        pc = (i < 60U) ? PC_FILL + (i & 7U) * 2U : PC_SYSTICK;
+        CHECK_EQ(get32(&batch[PROFILER_HEADER_SIZE + i * 4U]), pc);
+    }
+    append(&capture_pc, batch, n);
+}
+
+/* the capture must be the recorded file, or is written as it with record */
+static void check_file(const capture_struct *capture, int record)
+{
+    static uint8_t data[sizeof(capture->data) + 1U];
+    char path[512];
+    FILE *f;
+    size_t len;
+
+    snprintf(path, sizeof(path), "%s/%s", PROFILE_SAMPLES, capture->name);
+    f = fopen(path, record ? "wb" : "rb");
+    if(NULL == f){
+        printf("%s: cannot open\n", path);
+        test_failed++;
+        return;
+    }
+    if(record){
+        fwrite(capture->data, 1U, capture->len, f);
+        fclose(f);
+        return;
+    }
+    len = fread(data, 1U, sizeof(data), f);
+    fclose(f);
+    if((len != capture->len) || (0 != memcmp(data, capture->data, len))){
+        printf("%s: %u bytes differ from the %u recorded, record them again with --record\n", path,
+               capture->len, (uint32_t)len);
+        test_failed++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int record = (argc > 1) && (0 == strcmp(argv[1], "--record"));
+
+    record_lr();
+    record_pc();
+    check_file(&capture_lr, record);
+    check_file(&capture_pc, record);
+    return test_result();
+}
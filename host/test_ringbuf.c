@@ -0,0 +1,316 @@
+/*!
+    \file    test_ringbuf.c
+    \brief   host test of the lock-free ring buffers with threads
+
+    First the rules on one thread: counts and space, a full ring taking
+    only what fits, reserve stopping at the end of the buffer, and a
+    claimed but unpublished MPSC cell holding back the ones behind it
+    until it is published.
+
+    Then a producer and a consumer thread on small rings, so they wrap
+    all the time: a byte ring written in random bulk runs and read in
+    place, and a ring of larger elements written in place and read in
+    bulk. Every byte must come out once and in order. Last, producers
+    on an MPSC ring, half of them filling cells in place, and the
+    consumer checks that each producer's elements arrive complete,
+    once and in the order it put them.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include "test.h"
+#include "ringbuf.h"
+
+#define SPSC_BYTES                  20000000U
+#define SPSC_ELEMENTS               5000000U
+#define MPSC_PRODUCERS              4U
+#define MPSC_ITEMS                  2000000U
+
+/* the n-th byte of the stream, not a plain counter so a run copied from the wrong place shows */
+#define STREAM_BYTE(n)              ((uint8_t)((n) * 7U + ((n) >> 8)))
+
+/* element of the element ring, the fields check each other */
+typedef struct {
+    uint32_t seq;
+    uint32_t inverse;
+    uint32_t triple;
+} element_struct;
+
+/* element of the MPSC ring */
+typedef struct {
+    uint32_t producer;
+    uint32_t seq;
+} item_struct;
+
+static uint8_t byte_buffer[64];
+static element_struct element_buffer[16];
+static item_struct item_buffer[64];
+static ringbuf_atomic_t item_seq[64];
+static ringbuf_struct bytes, elements;
+static ringbuf_mpsc_struct items;
+
+static uint32_t rnd(uint32_t *seed, uint32_t range)
+{
+    *seed = *seed * 1103515245U + 12345U;
+    return ((*seed >> 8) & 0xFFFFFFU) % range;
+}
+
+static void test_rules(void)
+{
+    static const uint8_t data[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    uint8_t out[10];
+    const void *read_at;
+    void *write_at;
+    item_struct item = {1U, 0U}, got;
+    uint32_t pos, i;
+
+    ringbuf_init(&bytes, byte_buffer, 8U, 1U);
+    CHECK_EQ(ringbuf_count(&bytes), 0);
+    CHECK_EQ(ringbuf_space(&bytes), 8);
+    CHECK_EQ(ringbuf_read(&bytes, out, 4U), 0);
+    CHECK_EQ(ringbuf_write(&bytes, data, 5U), 5);
+    CHECK_EQ(ringbuf_write(&bytes, data, 10U), 3);
+    CHECK_EQ(ringbuf_count(&bytes), 8);
+    CHECK_EQ(ringbuf_space(&bytes), 0);
+    CHECK_EQ(ringbuf_write_reserve(&bytes, &write_at), 0);
+    CHECK_EQ(ringbuf_read(&bytes, out, 6U), 6);
+    CHECK_EQ(out[4], 4);
+    CHECK_EQ(out[5], 0);
+
+    /* free space 0..5, but reserve only hands out up to the end */
+    CHECK_EQ(ringbuf_write_reserve(&bytes, &write_at), 6);
+    CHECK(write_at == &byte_buffer[0]);
+    CHECK_EQ(ringbuf_write(&bytes, data, 4U), 4);
+    /* filled 6..7 then 0..3, reserve stops at the end and then goes on from the start */
+    CHECK_EQ(ringbuf_read_reserve(&bytes, &read_at), 2);
+    CHECK(read_at == &byte_buffer[6]);
+    ringbuf_read_commit(&bytes, 2U);
+    CHECK_EQ(ringbuf_read_reserve(&bytes, &read_at), 4);
+    CHECK(read_at == &byte_buffer[0]);
+    CHECK_EQ(memcmp(read_at, data, 4U), 0);
+    ringbuf_read_commit(&bytes, 4U);
+    CHECK_EQ(ringbuf_count(&bytes), 0);
+
+    /* a bulk copy across the end in two runs */
+    CHECK_EQ(ringbuf_write(&bytes, data, 7U), 7);
+    CHECK_EQ(ringbuf_read(&bytes, out, 10U), 7);
+    CHECK_EQ(memcmp(out, data, 7U), 0);
+    /* empty at 3, all free but reserve stops at the end */
+    CHECK_EQ(ringbuf_write_reserve(&bytes, &write_at), 5);
+    CHECK(write_at == &byte_buffer[3]);
+
+    ringbuf_mpsc_init(&items, item_seq, item_buffer, 4U, sizeof(item_struct));
+    CHECK(!ringbuf_mpsc_ready(&items));
+    CHECK_EQ(ringbuf_mpsc_get(&items, &got), -1);
+    for(i = 0; i < 4U; i++){
+        item.seq = i;
+        CHECK_EQ(ringbuf_mpsc_put(&items, &item), 0);
+    }
+    CHECK_EQ(ringbuf_mpsc_put(&items, &item), -1);
+    CHECK(NULL == ringbuf_mpsc_reserve(&items, &pos));
+    for(i = 0; i < 4U; i++){
+        CHECK_EQ(ringbuf_mpsc_get(&items, &got), 0);
+        CHECK_EQ(got.seq, i);
+    }
+
+    /* a claimed cell holds back the one published behind it */
+    CHECK(NULL != ringbuf_mpsc_reserve(&items, &pos));
+    item.seq = 11U;
+    CHECK_EQ(ringbuf_mpsc_put(&items, &item), 0);
+    CHECK(!ringbuf_mpsc_ready(&items));
+    CHECK_EQ(ringbuf_mpsc_get(&items, &got), -1);
+    ((item_struct *)&item_buffer[pos & 3U])->seq = 10U;
+    ringbuf_mpsc_publish(&items, pos);
+    CHECK(ringbuf_mpsc_ready(&items));
+    CHECK_EQ(ringbuf_mpsc_get(&items, &got), 0);
+    CHECK_EQ(got.seq, 10);
+    CHECK_EQ(ringbuf_mpsc_get(&items, &got), 0);
+    CHECK_EQ(got.seq, 11);
+    CHECK_EQ(ringbuf_mpsc_get(&items, &got), -1);
+}
+
+/* bulk runs of random length */
+static void *bytes_producer(void *arg)
+{
+    uint8_t run[48];
+    uint32_t n = 0, seed = 3U, len, i;
+
+    (void)arg;
+    while(n < SPSC_BYTES){
+        len = 1U + rnd(&seed, sizeof(run));
+        if(len > SPSC_BYTES - n){
+            len = SPSC_BYTES - n;
+        }
+        for(i = 0; i < len; i++){
+            run[i] = STREAM_BYTE(n + i);
+        }
+        i = 0;
+        while(i < len){
+            i += ringbuf_write(&bytes, &run[i], len - i);
+            if(i < len){
+                sched_yield();
+            }
+        }
+        n += len;
+    }
+    return NULL;
+}
+
+/* read in place, part of what is there at a time */
+static void test_spsc_bytes(void)
+{
+    pthread_t producer;
+    const void *data;
+    uint32_t n = 0, seed = 5U, errors = 0, count, i;
+
+    ringbuf_init(&bytes, byte_buffer, sizeof(byte_buffer), 1U);
+    pthread_create(&producer, NULL, bytes_producer, NULL);
+    while(n < SPSC_BYTES){
+        count = ringbuf_read_reserve(&bytes, &data);
+        if(0U == count){
+            sched_yield();
+            continue;
+        }
+        count = 1U + rnd(&seed, count);
+        for(i = 0; i < count; i++){
+            if(((const uint8_t *)data)[i] != STREAM_BYTE(n + i)){
+                errors++;
+            }
+        }
+        ringbuf_read_commit(&bytes, count);
+        n += count;
+    }
+    pthread_join(producer, NULL);
+    CHECK_EQ(errors, 0);
+    CHECK_EQ(ringbuf_count(&bytes), 0);
+    CHECK_EQ(bytes.head, SPSC_BYTES);
+}
+
+/* written in place, part of the reserved span at a time */
+static void *elements_producer(void *arg)
+{
+    element_struct *cell;
+    void *data;
+    uint32_t n = 0, seed = 7U, count, i;
+
+    (void)arg;
+    while(n < SPSC_ELEMENTS){
+        count = ringbuf_write_reserve(&elements, &data);
+        if(0U == count){
+            sched_yield();
+            continue;
+        }
+        count = 1U + rnd(&seed, count);
+        if(count > SPSC_ELEMENTS - n){
+            count = SPSC_ELEMENTS - n;
+        }
+        cell = (element_struct *)data;
+        for(i = 0; i < count; i++){
+            cell[i].seq = n + i;
+            cell[i].inverse = ~(n + i);
+            cell[i].triple = (n + i) * 3U;
+        }
+        ringbuf_write_commit(&elements, count);
+        n += count;
+    }
+    return NULL;
+}
+
+/* read in bulk */
+static void test_spsc_elements(void)
+{
+    element_struct out[24];
+    pthread_t producer;
+    uint32_t n = 0, seed = 9U, errors = 0, count, i;
+
+    ringbuf_init(&elements, element_buffer, sizeof(element_buffer) / sizeof(element_buffer[0]),
+                 sizeof(element_struct));
+    pthread_create(&producer, NULL, elements_producer, NULL);
+    while(n < SPSC_ELEMENTS){
+        count = ringbuf_read(&elements, out, 1U + rnd(&seed, sizeof(out) / sizeof(out[0])));
+        if(0U == count){
+            sched_yield();
+            continue;
+        }
+        for(i = 0; i < count; i++){
+            if((out[i].seq != n + i) || (out[i].inverse != ~(n + i)) || (out[i].triple != (n + i) * 3U)){
+                errors++;
+            }
+        }
+        n += count;
+    }
+    pthread_join(producer, NULL);
+    CHECK_EQ(errors, 0);
+    CHECK_EQ(ringbuf_count(&elements), 0);
+}
+
+/* odd producers copy with put, even ones fill the cell in place */
+static void *items_producer(void *arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg, i, pos;
+    item_struct item = {id, 0U}, *cell;
+
+    for(i = 0; i < MPSC_ITEMS; i++){
+        item.seq = i;
+        if(0U != (id & 1U)){
+            while(0 != ringbuf_mpsc_put(&items, &item)){
+                sched_yield();
+            }
+        }else{
+            while(NULL == (cell = (item_struct *)ringbuf_mpsc_reserve(&items, &pos))){
+                sched_yield();
+            }
+            cell->producer = id;
+            cell->seq = i;
+            ringbuf_mpsc_publish(&items, pos);
+        }
+    }
+    return NULL;
+}
+
+static void test_mpsc(void)
+{
+    pthread_t producers[MPSC_PRODUCERS];
+    uint32_t next[MPSC_PRODUCERS] = {0};
+    uint32_t taken = 0, errors = 0, p;
+    item_struct item;
+
+    ringbuf_mpsc_init(&items, item_seq, item_buffer, sizeof(item_buffer) / sizeof(item_buffer[0]),
+                      sizeof(item_struct));
+    for(p = 0; p < MPSC_PRODUCERS; p++){
+        pthread_create(&producers[p], NULL, items_producer, (void *)(uintptr_t)p);
+    }
+    while(taken < MPSC_PRODUCERS * MPSC_ITEMS){
+        if(0 != ringbuf_mpsc_get(&items, &item)){
+            sched_yield();
+            continue;
+        }
+        taken++;
+        if((item.producer >= MPSC_PRODUCERS) || (item.seq != next[item.producer])){
+            if(errors < 5U){
+                printf("item %u of producer %u, expected %u\n", item.seq, item.producer,
+                       (item.producer < MPSC_PRODUCERS) ? next[item.producer] : 0U);
+            }
+            errors++;
+            continue;
+        }
+        next[item.producer]++;
+    }
+    for(p = 0; p < MPSC_PRODUCERS; p++){
+        pthread_join(producers[p], NULL);
+        CHECK_EQ(next[p], MPSC_ITEMS);
+    }
+    CHECK_EQ(errors, 0);
+    CHECK_EQ(ringbuf_mpsc_get(&items, &item), -1);
+}
+
+int main(void)
+{
+    test_rules();
+    test_spsc_bytes();
+    test_spsc_elements();
+    test_mpsc();
+    return test_result();
+}
@@ -0,0 +1,215 @@
+/*!
+    \file    test_sdram_diag.c
+    \brief   host test of the SDRAM diagnostics against injected faults
+
+    Runs each test of sdram_diag.c on the simulated memory of
+    sdram_sim.c. A fault free part must pass everything. Every data line
+    stuck at either level must be named by walking ones, every address
+    line stuck or shorted by the address test, and random cell stuck-at
+    and coupling faults between and within words must make March C-
+    fail at the victim word. A whole sdram_diag_run() must report each
+    kind of fault.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <string.h>
+#include "test.h"
+#include "sdram_sim.h"
+
+#define SIM_SIZE                    (64U * 1024U)
+#define SIM_LINES                   16U                 /* offset bits of SIM_SIZE */
+#define MARCH_LENGTH                4096U
+#define CELL_FAULTS                 300U
+#define BW_LENGTH                   1024U
+
+static uint32_t words[SIM_SIZE / 4U];
+static uint8_t bw_area[BW_LENGTH] __attribute__((aligned(4)));
+static sdram_sim_struct sim;
+static sdram_diag_mem_struct mem;
+static uint32_t seed = 1U;
+static uint32_t fake_cycles;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+/* free running counter for sdram_diag_run() */
+static uint32_t cycles(void)
+{
+    return fake_cycles += 100U;
+}
+
+/* a word offset inside the March window */
+static uint32_t random_word(void)
+{
+    return rnd(MARCH_LENGTH / 4U) * 4U;
+}
+
+/* run March C- and check it fails at the victim word */
+static void check_march(uint32_t backgrounds, uint32_t victim, const char *what)
+{
+    sdram_diag_fault_struct fault;
+    uint32_t errors = sdram_diag_march_c(&mem, 0, MARCH_LENGTH, backgrounds, &fault);
+
+    if((0U == errors) || (fault.offset != victim)){
+        printf("march missed %s at 0x%x: %u errors, first at 0x%x\n", what, victim, errors, fault.offset);
+        test_failed++;
+    }
+}
+
+static void test_fault_free(void)
+{
+    sdram_diag_fault_struct fault;
+
+    sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+    CHECK_EQ(sdram_diag_data_bus(&mem, 0), 0);
+    CHECK_EQ(sdram_diag_data_bus(&mem, SIM_SIZE - 4U), 0);
+    CHECK_EQ(sdram_diag_address_bus(&mem, 0, SIM_SIZE), 0);
+    CHECK_EQ(sdram_diag_address_bus(&mem, SIM_SIZE / 2U, SIM_SIZE / 2U), 0);
+    CHECK_EQ(sdram_diag_march_c(&mem, 0, SIM_SIZE, SDRAM_DIAG_BACKGROUNDS, &fault), 0);
+}
+
+/* every data line stuck at 0 and at 1 */
+static void test_data_lines(void)
+{
+    uint32_t bit, value;
+
+    for(bit = 0; bit < 32U; bit++){
+        for(value = 0; value < 2U; value++){
+            sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+            sdram_sim_stuck_at(&sim, SDRAM_SIM_ALL_WORDS, bit, value);
+            CHECK_EQ(sdram_diag_data_bus(&mem, 0), 1U << bit);
+        }
+    }
+}
+
+/* every address line stuck at 0 and at 1, and every pair shorted */
+static void test_address_lines(void)
+{
+    uint32_t line, other, value, failed;
+
+    for(line = 2; line < SIM_LINES; line++){
+        for(value = 0; value < 2U; value++){
+            sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+            sdram_sim_address_stuck(&sim, line, value);
+            failed = sdram_diag_address_bus(&mem, 0, SIM_SIZE);
+            CHECK_EQ(failed, 1U << line);
+        }
+    }
+    for(line = 2; line < SIM_LINES; line++){
+        for(other = line + 1U; other < SIM_LINES; other++){
+            sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+            sdram_sim_address_short(&sim, line, other);
+            failed = sdram_diag_address_bus(&mem, 0, SIM_SIZE);
+            if(0U == (failed & ((1U << line) | (1U << other)))){
+                printf("address lines %u and %u shorted, reported 0x%x\n", line, other, failed);
+                test_failed++;
+            }
+        }
+    }
+}
+
+/* random cells stuck, one background is enough */
+static void test_cell_stuck(void)
+{
+    uint32_t i, victim;
+
+    for(i = 0; i < CELL_FAULTS; i++){
+        sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+        victim = random_word();
+        sdram_sim_stuck_at(&sim, victim, rnd(32), rnd(2));
+        check_march(1, victim, "stuck-at");
+    }
+}
+
+/* random coupling between two words, both kinds and both directions */
+static void test_coupling_words(void)
+{
+    uint32_t i, victim, aggressor;
+    sdram_sim_fault_enum type;
+
+    for(i = 0; i < CELL_FAULTS; i++){
+        sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+        victim = random_word();
+        do{
+            aggressor = random_word();
+        }while(aggressor == victim);
+        type = (0U != rnd(2)) ? SDRAM_SIM_COUPLING_INVERSION : SDRAM_SIM_COUPLING_IDEMPOTENT;
+        sdram_sim_coupling(&sim, type, aggressor, rnd(32), victim, rnd(32), rnd(2));
+        check_march(1, victim, (SDRAM_SIM_COUPLING_INVERSION == type) ? "inversion coupling" : "idempotent coupling");
+    }
+}
+
+/* coupling between two bits of one word, only the extra backgrounds separate them */
+static void test_coupling_bits(void)
+{
+    uint32_t i, victim, bit, aggressor_bit;
+    sdram_sim_fault_enum type;
+
+    for(i = 0; i < CELL_FAULTS; i++){
+        sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+        victim = random_word();
+        bit = rnd(32);
+        do{
+            aggressor_bit = rnd(32);
+        }while(aggressor_bit == bit);
+        type = (0U != rnd(2)) ? SDRAM_SIM_COUPLING_INVERSION : SDRAM_SIM_COUPLING_IDEMPOTENT;
+        sdram_sim_coupling(&sim, type, victim, aggressor_bit, victim, bit, rnd(2));
+        check_march(SDRAM_DIAG_BACKGROUNDS, victim, "coupling within a word");
+    }
+}
+
+/* a whole run reports each kind of fault and passes a good part */
+static void test_run(void)
+{
+    sdram_diag_config_struct config;
+    sdram_diag_report_struct report;
+
+    memset(&config, 0, sizeof(config));
+    config.mem = &mem;
+    config.length = SIM_SIZE;
+    config.march_length = MARCH_LENGTH;
+    config.backgrounds = SDRAM_DIAG_BACKGROUNDS;
+    config.bw_area = bw_area;
+    config.bw_length = BW_LENGTH;
+    config.cycles = cycles;
+    config.cycle_hz = 1000000U;
+
+    sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+    CHECK_EQ(sdram_diag_run(&config, &report), 0);
+    CHECK(report.cycles > 0U);
+    CHECK(report.bw[2].read > 0U);
+
+    sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+    sdram_sim_stuck_at(&sim, SDRAM_SIM_ALL_WORDS, 7, 1);
+    CHECK_EQ(sdram_diag_run(&config, &report), 1);
+    CHECK_EQ(report.data_bits, 1U << 7);
+
+    sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+    sdram_sim_address_stuck(&sim, 12, 0);
+    CHECK_EQ(sdram_diag_run(&config, &report), 1);
+    CHECK_EQ(report.address_bits, 1U << 12);
+
+    sdram_sim_init(&sim, words, SIM_SIZE, &mem);
+    sdram_sim_coupling(&sim, SDRAM_SIM_COUPLING_INVERSION, 0x100, 3, 0x200, 9, 0);
+    CHECK_EQ(sdram_diag_run(&config, &report), 1);
+    CHECK_EQ(report.data_bits, 0);
+    CHECK_EQ(report.address_bits, 0);
+    CHECK(report.march.errors > 0U);
+    CHECK_EQ(report.march.offset, 0x200);
+}
+
+int main(void)
+{
+    test_fault_free();
+    test_data_lines();
+    test_address_lines();
+    test_cell_stuck();
+    test_coupling_words();
+    test_coupling_bits();
+    test_run();
+    return test_result();
+}
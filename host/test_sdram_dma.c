@@ -0,0 +1,227 @@
+/*!
+    \file    test_sdram_dma.c
+    \brief   host test of the asynchronous SDRAM copy service order and completion
+
+    Runs the copy service on the host port, where a worker thread plays
+    the DMA controller. Random batches of short and long copies at every
+    alignment must finish in the order they were queued, each callback
+    must see its own bytes and those of every earlier copy in place, and
+    the byte counters must add up. Also checks that a short copy into an
+    empty queue reports at once on the calling thread, that a full queue
+    refuses a copy, and that a callback can queue the next copy.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "test.h"
+#include "sdram_dma.h"
+
+#define BATCHES                     50U
+#define BATCH_COPIES                SDRAM_DMA_QUEUE_LEN
+#define MAX_COPY                    3000U
+#define SLOT_SIZE                   (MAX_COPY + 8U)
+#define CHAIN_COPIES                5U
+/* a copy that has not finished by then never will */
+#define WAIT_NS                     5000000000ULL
+
+static uint8_t src_buf[BATCH_COPIES * SLOT_SIZE];
+static uint8_t dst_buf[BATCH_COPIES * SLOT_SIZE];
+static uint32_t seed = 1U;
+
+/* one queued copy and what its callback saw */
+typedef struct {
+    uint8_t *dst;
+    const uint8_t *src;
+    uint32_t length;
+    uint32_t token;
+    uint32_t order;                                     /*!< place among the callbacks */
+    int intact;                                         /*!< its bytes and those of all earlier copies were in place */
+    int error;
+} copy_struct;
+
+static copy_struct copies[BATCH_COPIES];
+static uint32_t copy_count;
+static _Atomic uint32_t callbacks;
+static pthread_t caller;
+static int caller_thread;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+/* check a copy and every one queued before it */
+static void copy_finished(uint32_t token, void *arg, int error)
+{
+    copy_struct *c = (copy_struct *)arg;
+    uint32_t i;
+
+    (void)token;
+    c->order = atomic_fetch_add(&callbacks, 1U);
+    c->error = error;
+    c->intact = 1;
+    for(i = 0; (i < copy_count) && (&copies[i] <= c); i++){
+        if((0 != memcmp(copies[i].dst, copies[i].src, copies[i].length)) || !sdram_dma_done(copies[i].token)){
+            c->intact = 0;
+        }
+    }
+}
+
+/* note whether the callback runs on the thread that queued the copy */
+static void thread_noted(uint32_t token, void *arg, int error)
+{
+    (void)token;
+    (void)arg;
+    (void)error;
+    caller_thread = pthread_equal(pthread_self(), caller);
+    atomic_fetch_add(&callbacks, 1U);
+}
+
+/* queue one more copy from inside the callback until the chain is done */
+static void chain_next(uint32_t token, void *arg, int error)
+{
+    uint32_t n = (uint32_t)(uintptr_t)arg;
+
+    (void)token;
+    (void)error;
+    atomic_fetch_add(&callbacks, 1U);
+    if(n + 1U < CHAIN_COPIES){
+        sdram_dma_copy(dst_buf + (n + 1U) * SLOT_SIZE, src_buf + (n + 1U) * SLOT_SIZE, MAX_COPY, chain_next,
+                       (void *)(uintptr_t)(n + 1U));
+    }
+}
+
+/* wait for a number of callbacks, fail instead of hanging */
+static void wait_callbacks(uint32_t count)
+{
+    uint64_t start = test_now_ns();
+
+    while(atomic_load(&callbacks) < count){
+        if(test_now_ns() - start > WAIT_NS){
+            CHECK_EQ(atomic_load(&callbacks), count);
+            return;
+        }
+    }
+}
+
+/* sdram_dma_wait() with a time limit */
+static void wait_done(uint32_t token)
+{
+    uint64_t start = test_now_ns();
+
+    while(!sdram_dma_done(token)){
+        if(test_now_ns() - start > WAIT_NS){
+            CHECK(sdram_dma_done(token));
+            return;
+        }
+    }
+}
+
+/* queue random copies, wait for the last, check the order and the bytes */
+static void test_batch(void)
+{
+    const sdram_dma_stats_struct *stats = sdram_dma_stats_get();
+    uint32_t i, cpu_bytes = stats->cpu_bytes, dma_bytes = stats->dma_bytes, bytes = 0;
+    copy_struct *c;
+
+    memset(dst_buf, 0, sizeof(dst_buf));
+    copy_count = BATCH_COPIES;
+    for(i = 0; i < BATCH_COPIES; i++){
+        c = &copies[i];
+        c->src = src_buf + i * SLOT_SIZE + rnd(4);
+        c->dst = dst_buf + i * SLOT_SIZE + rnd(4);
+        c->length = (rnd(3) == 0U) ? rnd(SDRAM_DMA_CPU_THRESHOLD) : rnd(MAX_COPY + 1U);
+        c->order = 0xFFFFFFFFU;
+        bytes += c->length;
+    }
+    atomic_store(&callbacks, 0U);
+    for(i = 0; i < BATCH_COPIES; i++){
+        copies[i].token = sdram_dma_copy(copies[i].dst, copies[i].src, copies[i].length, copy_finished, &copies[i]);
+        CHECK(SDRAM_DMA_TOKEN_NONE != copies[i].token);
+    }
+    wait_done(copies[BATCH_COPIES - 1U].token);
+    wait_callbacks(BATCH_COPIES);
+
+    for(i = 0; i < BATCH_COPIES; i++){
+        CHECK_EQ(copies[i].order, i);
+        CHECK(copies[i].intact);
+        CHECK_EQ(copies[i].error, 0);
+        CHECK(sdram_dma_done(copies[i].token));
+        if(i > 0U){
+            CHECK(copies[i].token != copies[i - 1U].token);
+        }
+    }
+    CHECK_EQ(sdram_dma_pending(), 0);
+    CHECK_EQ((stats->cpu_bytes - cpu_bytes) + (stats->dma_bytes - dma_bytes), bytes);
+    copy_count = 0;
+}
+
+/* a short copy into an empty queue is done before sdram_dma_copy() returns */
+static void test_immediate(void)
+{
+    uint32_t token;
+
+    caller = pthread_self();
+    caller_thread = 0;
+    atomic_store(&callbacks, 0U);
+    token = sdram_dma_copy(dst_buf + 1, src_buf + 3, SDRAM_DMA_CPU_THRESHOLD - 1U, thread_noted, NULL);
+    CHECK(sdram_dma_done(token));
+    CHECK_EQ(atomic_load(&callbacks), 1);
+    CHECK(caller_thread);
+    CHECK(0 == memcmp(dst_buf + 1, src_buf + 3, SDRAM_DMA_CPU_THRESHOLD - 1U));
+}
+
+/* with the transfers held back the queue fills up and refuses the next copy */
+static void test_full(void)
+{
+    uint32_t i, state, token = SDRAM_DMA_TOKEN_NONE, rejected = sdram_dma_stats_get()->rejected;
+
+    state = sdram_dma_port_lock();
+    for(i = 0; i < SDRAM_DMA_QUEUE_LEN; i++){
+        token = sdram_dma_copy(dst_buf + i * SLOT_SIZE, src_buf + i * SLOT_SIZE, MAX_COPY, NULL, NULL);
+        CHECK(SDRAM_DMA_TOKEN_NONE != token);
+    }
+    CHECK(!sdram_dma_done(token));
+    CHECK_EQ(sdram_dma_copy(dst_buf, src_buf, MAX_COPY, NULL, NULL), SDRAM_DMA_TOKEN_NONE);
+    CHECK_EQ(sdram_dma_copy(dst_buf, src_buf, 1, NULL, NULL), SDRAM_DMA_TOKEN_NONE);
+    CHECK_EQ(sdram_dma_stats_get()->rejected - rejected, 2);
+    sdram_dma_port_unlock(state);
+    wait_done(token);
+    CHECK_EQ(sdram_dma_pending(), 0);
+}
+
+/* each callback queues the next copy from the "interrupt" */
+static void test_chain(void)
+{
+    uint32_t i;
+
+    memset(dst_buf, 0, sizeof(dst_buf));
+    atomic_store(&callbacks, 0U);
+    CHECK(SDRAM_DMA_TOKEN_NONE != sdram_dma_copy(dst_buf, src_buf, MAX_COPY, chain_next, (void *)0));
+    wait_callbacks(CHAIN_COPIES);
+    for(i = 0; i < CHAIN_COPIES; i++){
+        CHECK(0 == memcmp(dst_buf + i * SLOT_SIZE, src_buf + i * SLOT_SIZE, MAX_COPY));
+    }
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    for(i = 0; i < sizeof(src_buf); i++){
+        src_buf[i] = (uint8_t)(i * 31U + (i >> 8));
+    }
+    sdram_dma_init();
+
+    test_immediate();
+    for(i = 0; i < BATCHES; i++){
+        test_batch();
+    }
+    test_full();
+    test_chain();
+    return test_result();
+}
@@ -0,0 +1,209 @@
+/*!
+    \file    test_sdram_timing.c
+    \brief   host test of the SDRAM timing calculator
+
+    Checks the board part at the board clock against values worked out
+    by hand from the datasheet, then sweeps every part over HCLK from
+    10 to 300 MHz at both dividers. Whenever a timing is returned, each
+    delay must cover its datasheet time and be no cycle longer than
+    that, except where the write recovery is raised for tRAS and tRC,
+    which it then must satisfy. The CAS latency must be the lowest the
+    part allows at that clock and every refresh row must come round
+    within the refresh period. Whenever no timing is returned, one of
+    those must be impossible. sdram_timing_calc() must pick the first
+    divider that works under the SDCLK limit.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "test.h"
+#include "sdram_timing.h"
+
+#define HCLK_MIN                    10000000U
+#define HCLK_MAX                    300000000U
+#define HCLK_STEP                   250000U
+
+/* picoseconds of a number of SDCLK cycles */
+static uint64_t cycles_ps(uint32_t cycles, uint32_t sdclk_hz)
+{
+    return (uint64_t)cycles * 1000000000000ULL / sdclk_hz;
+}
+
+/* a delay covers ps plus clk cycles and is the shortest that does */
+static int delay_tight(uint32_t cycles, uint32_t ps, uint32_t clk, uint32_t sdclk_hz)
+{
+    uint64_t need = ps + cycles_ps(clk, sdclk_hz);
+
+    if((cycles < SDRAM_TIMING_CYCLES_MIN) || (cycles > SDRAM_TIMING_CYCLES_MAX)){
+        return 0;
+    }
+    if((uint64_t)cycles * 1000000000000ULL < need * sdclk_hz){
+        return 0;
+    }
+    return (cycles == SDRAM_TIMING_CYCLES_MIN) ||
+           ((uint64_t)(cycles - 1U) * 1000000000000ULL < need * sdclk_hz);
+}
+
+/* shortest delay for a time, no upper limit */
+static uint32_t delay_min(uint32_t ps, uint32_t clk, uint32_t sdclk_hz)
+{
+    uint32_t n = SDRAM_TIMING_CYCLES(ps, sdclk_hz) + clk;
+
+    return (n < SDRAM_TIMING_CYCLES_MIN) ? SDRAM_TIMING_CYCLES_MIN : n;
+}
+
+/* check a timing the calculator returned */
+static int timing_valid(const sdram_part_struct *part, uint32_t hclk_hz, uint32_t div, const sdram_timing_struct *t)
+{
+    uint32_t sdclk_hz = hclk_hz / div, wr_min;
+    uint64_t refresh_ps;
+
+    if((t->sdclk_hz != sdclk_hz) || (t->sdclk_div != div)){
+        return 0;
+    }
+    /* the lowest latency the part takes at this clock */
+    if(((0U != part->cl2_hz) && (sdclk_hz <= part->cl2_hz)) ? (2U != t->cas_latency) :
+       ((3U != t->cas_latency) || (sdclk_hz > part->cl3_hz))){
+        return 0;
+    }
+    if(!delay_tight(t->load_mode_register_delay, 0U, part->t_mrd_clk, sdclk_hz) ||
+       !delay_tight(t->exit_selfrefresh_delay, part->t_xsr_ps, 0U, sdclk_hz) ||
+       !delay_tight(t->row_address_select_delay, part->t_ras_ps, 0U, sdclk_hz) ||
+       !delay_tight(t->auto_refresh_delay, part->t_rc_ps, 0U, sdclk_hz) ||
+       !delay_tight(t->row_precharge_delay, part->t_rp_ps, 0U, sdclk_hz) ||
+       !delay_tight(t->row_to_column_delay, part->t_rcd_ps, 0U, sdclk_hz)){
+        return 0;
+    }
+    /* write recovery covers tWR, and with tRCD tRAS, and with tRCD and tRP tRC, and is no longer */
+    wr_min = delay_min(part->t_wr_ps, part->t_wr_clk, sdclk_hz);
+    if(wr_min + t->row_to_column_delay < t->row_address_select_delay){
+        wr_min = t->row_address_select_delay - t->row_to_column_delay;
+    }
+    if(wr_min + t->row_to_column_delay + t->row_precharge_delay < t->auto_refresh_delay){
+        wr_min = t->auto_refresh_delay - t->row_to_column_delay - t->row_precharge_delay;
+    }
+    if(t->write_recovery_delay != wr_min){
+        return 0;
+    }
+    /* every row refreshed in time, with room for a refresh held back by an access */
+    if((0U == t->refresh_count) || (t->refresh_count > SDRAM_TIMING_REFRESH_MAX)){
+        return 0;
+    }
+    refresh_ps = cycles_ps(t->refresh_count + SDRAM_TIMING_REFRESH_MARGIN, sdclk_hz);
+    if(refresh_ps * part->refresh_rows > (uint64_t)part->refresh_ms * 1000000000ULL){
+        return 0;
+    }
+    return refresh_ps * part->refresh_rows + cycles_ps(part->refresh_rows, sdclk_hz) >
+           (uint64_t)part->refresh_ms * 1000000000ULL;
+}
+
+/* a refusal has a reason */
+static int refusal_valid(const sdram_part_struct *part, uint32_t hclk_hz, uint32_t div)
+{
+    uint32_t sdclk_hz = hclk_hz / div;
+    uint64_t refresh = ((uint64_t)part->refresh_ms * sdclk_hz) / (1000U * (uint64_t)part->refresh_rows);
+
+    if(sdclk_hz > part->cl3_hz){
+        return 1;
+    }
+    if((delay_min(part->t_xsr_ps, 0U, sdclk_hz) > SDRAM_TIMING_CYCLES_MAX) ||
+       (delay_min(part->t_ras_ps, 0U, sdclk_hz) > SDRAM_TIMING_CYCLES_MAX) ||
+       (delay_min(part->t_rc_ps, 0U, sdclk_hz) > SDRAM_TIMING_CYCLES_MAX) ||
+       (delay_min(part->t_wr_ps, part->t_wr_clk, sdclk_hz) > SDRAM_TIMING_CYCLES_MAX) ||
+       (delay_min(part->t_rp_ps, 0U, sdclk_hz) > SDRAM_TIMING_CYCLES_MAX) ||
+       (delay_min(part->t_rcd_ps, 0U, sdclk_hz) > SDRAM_TIMING_CYCLES_MAX)){
+        return 1;
+    }
+    return (refresh <= SDRAM_TIMING_REFRESH_MARGIN + delay_min(part->t_rc_ps, 0U, sdclk_hz)) ||
+           (refresh - SDRAM_TIMING_REFRESH_MARGIN > SDRAM_TIMING_REFRESH_MAX);
+}
+
+/* the board: MT48LC16M16A2-75 at 200 MHz HCLK, SDCLK at most 100 MHz */
+static void test_board(void)
+{
+    sdram_timing_struct t;
+
+    CHECK_EQ(sdram_timing_calc(&sdram_parts[SDRAM_PART_MT48LC16M16A2_75], 200000000U, 100000000U, &t), 0);
+    CHECK_EQ(t.sdclk_hz, 100000000U);
+    CHECK_EQ(t.sdclk_div, 2);
+    CHECK_EQ(t.cas_latency, 2);
+    CHECK_EQ(t.load_mode_register_delay, 2);                /* 2 clocks */
+    CHECK_EQ(t.exit_selfrefresh_delay, 8);                  /* 75 ns */
+    CHECK_EQ(t.row_address_select_delay, 5);                /* 44 ns */
+    CHECK_EQ(t.auto_refresh_delay, 7);                      /* 66 ns */
+    CHECK_EQ(t.write_recovery_delay, 3);                    /* 1 clock + 7.5 ns is 2, tRAS - tRCD is 3 */
+    CHECK_EQ(t.row_precharge_delay, 2);                     /* 20 ns */
+    CHECK_EQ(t.row_to_column_delay, 2);                     /* 20 ns */
+    CHECK_EQ(t.refresh_count, 761);                         /* 64 ms / 8192 rows is 781 cycles, less 20 */
+
+    /* SDCLK limited to 80 MHz: divider 3, 66.67 MHz */
+    CHECK_EQ(sdram_timing_calc(&sdram_parts[SDRAM_PART_MT48LC16M16A2_75], 200000000U, 80000000U, &t), 0);
+    CHECK_EQ(t.sdclk_div, 3);
+    CHECK_EQ(t.sdclk_hz, 66666666U);
+    CHECK_EQ(t.exit_selfrefresh_delay, 5);
+    CHECK_EQ(t.refresh_count, 500);
+}
+
+static void test_macro(void)
+{
+    CHECK_EQ(SDRAM_TIMING_CYCLES(10000U, 100000000U), 1);
+    CHECK_EQ(SDRAM_TIMING_CYCLES(10001U, 100000000U), 2);
+    CHECK_EQ(SDRAM_TIMING_CYCLES(0U, 100000000U), 0);
+    CHECK_EQ(SDRAM_TIMING_CYCLES(75000U, 133000000U), 10);
+}
+
+/* every part, every clock, both dividers */
+static void test_sweep(void)
+{
+    const sdram_part_struct *part;
+    sdram_timing_struct t, calc;
+    uint32_t p, hclk, div, max_hz, found, bad = 0, good = 0;
+
+    for(p = 0; p < SDRAM_PART_COUNT; p++){
+        part = &sdram_parts[p];
+        for(hclk = HCLK_MIN; hclk <= HCLK_MAX; hclk += HCLK_STEP){
+            found = 0;
+            for(div = 2U; div <= 3U; div++){
+                if(0 == sdram_timing_at(part, hclk, div, &t)){
+                    good++;
+                    if(!timing_valid(part, hclk, div, &t)){
+                        printf("%s at %u Hz / %u: bad timing\n", part->name, hclk, div);
+                        bad++;
+                    }
+                    if(0U == found){
+                        found = div;
+                    }
+                }else if(!refusal_valid(part, hclk, div)){
+                    printf("%s at %u Hz / %u: refused without a reason\n", part->name, hclk, div);
+                    bad++;
+                }
+            }
+            /* without a limit calc() takes the first divider that works */
+            max_hz = HCLK_MAX;
+            if(0U != found){
+                CHECK_EQ(sdram_timing_calc(part, hclk, max_hz, &calc), 0);
+                CHECK_EQ(calc.sdclk_div, found);
+            }else{
+                CHECK_EQ(sdram_timing_calc(part, hclk, max_hz, &calc), -1);
+            }
+            /* a limit below hclk / 2 rules divider 2 out */
+            max_hz = hclk / 2U - 1U;
+            if(0 == sdram_timing_calc(part, hclk, max_hz, &calc)){
+                CHECK_EQ(calc.sdclk_div, 3);
+                CHECK(calc.sdclk_hz <= max_hz);
+            }
+        }
+    }
+    CHECK_EQ(bad, 0);
+    CHECK(good > 0U);
+    CHECK_EQ(sdram_timing_at(&sdram_parts[0], 200000000U, 4U, &t), -1);
+    CHECK_EQ(sdram_timing_at(&sdram_parts[0], 200000000U, 1U, &t), -1);
+}
+
+int main(void)
+{
+    test_macro();
+    test_board();
+    test_sweep();
+    return test_result();
+}
@@ -0,0 +1,226 @@
+/*!
+    \file    test_soft_timer.c
+    \brief   host test of the timing wheel software timers against a model
+
+    Timers with delays on every level of the wheel, and past its range,
+    are started, stopped and restarted at random, from the test and
+    from the callbacks, while simulated ticks are counted in bursts and
+    processed. A model keeps the tick each timer is due at: every
+    callback must come exactly on that tick, no due timer may be left
+    behind, soft_timer_active() must agree with the model and
+    soft_timer_next() must never sleep past a firing. The tick count
+    starts just short of its wrap so the wheel crosses it.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include "test.h"
+#include "soft_timer.h"
+
+#define TIMERS                      500U
+#define RUNS                        100000U
+#define TICKS_START                 0xFFFF0000UL
+
+/* model of a timer */
+typedef struct {
+    uint32_t due;
+    uint32_t period;
+    int active;
+    uint32_t fired;
+} model_struct;
+
+static soft_timer_wheel_struct wheel;
+static soft_timer_struct timers[TIMERS];
+static model_struct model[TIMERS];
+static uint32_t seed = 1U;
+static uint32_t errors;
+static uint32_t model_fired;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+/* a delay on a random level of the wheel, now and then past its range */
+static uint32_t random_delay(void)
+{
+    switch(rnd(8)){
+    case 0:
+        return rnd(3);
+    case 1:
+    case 2:
+        return rnd(SOFT_TIMER_SLOTS * 2U);
+    case 3:
+    case 4:
+        return rnd(SOFT_TIMER_SLOTS * SOFT_TIMER_SLOTS * 2U);
+    case 5:
+        return rnd(SOFT_TIMER_SLOTS * SOFT_TIMER_SLOTS * SOFT_TIMER_SLOTS * 2U);
+    case 6:
+        return SOFT_TIMER_SLOTS * (1U + rnd(4)) - 1U + rnd(3);
+    default:
+        return SOFT_TIMER_RANGE - 2U + rnd(5);
+    }
+}
+
+static void timer_start(uint32_t i, uint32_t delay, uint32_t period)
+{
+    soft_timer_start(&wheel, &timers[i], delay, period);
+    model[i].due = wheel.now + ((0U == delay) ? 1U : delay);
+    model[i].period = period;
+    model[i].active = 1;
+}
+
+static void timer_stop(uint32_t i)
+{
+    soft_timer_stop(&timers[i]);
+    model[i].active = 0;
+}
+
+/* a start, a stop or nothing on a random timer */
+static void random_op(void)
+{
+    uint32_t i = rnd(TIMERS);
+
+    switch(rnd(4)){
+    case 0:
+        timer_start(i, random_delay(), 0U);
+        break;
+    case 1:
+        timer_start(i, random_delay(), (0U == rnd(2)) ? 1U + rnd(SOFT_TIMER_SLOTS * 4U) : 0U);
+        break;
+    case 2:
+        timer_stop(i);
+        break;
+    default:
+        break;
+    }
+}
+
+static void timer_fired(soft_timer_struct *timer, void *arg)
+{
+    uint32_t i = (uint32_t)(uintptr_t)arg;
+
+    if((timer != &timers[i]) || !model[i].active || (model[i].due != wheel.now)){
+        if(errors < 10U){
+            printf("timer %u fired at %u, due %u, active %d\n", i, wheel.now, model[i].due, model[i].active);
+        }
+        errors++;
+    }
+    model[i].fired++;
+    model_fired++;
+    if(0U != model[i].period){
+        model[i].due += model[i].period;
+    }else{
+        model[i].active = 0;
+    }
+    /* callbacks change timers too, this one included */
+    if(0U == rnd(4)){
+        random_op();
+    }
+    if(0U == rnd(16)){
+        timer_start(i, rnd(SOFT_TIMER_SLOTS), 0U);
+    }
+}
+
+/* nothing due left behind, active agrees, next does not sleep past a firing */
+static void model_check(void)
+{
+    uint32_t i, next, soonest = UINT32_MAX, ahead;
+
+    next = soft_timer_next(&wheel);
+    for(i = 0; i < TIMERS; i++){
+        if(soft_timer_active(&timers[i]) != model[i].active){
+            errors++;
+        }
+        if(!model[i].active){
+            continue;
+        }
+        ahead = model[i].due - wheel.now;
+        if((0U == ahead) || (ahead > 0x80000000UL)){
+            if(errors < 10U){
+                printf("timer %u due %u left behind at %u\n", i, model[i].due, wheel.now);
+            }
+            errors++;
+        }
+        if(ahead < soonest){
+            soonest = ahead;
+        }
+    }
+    if((next < 1U) || (next > SOFT_TIMER_SLOTS) || (soonest < next)){
+        errors++;
+    }
+    /* short of a level 0 wrap it stops exactly at the next firing */
+    if((next < SOFT_TIMER_SLOTS) && (0U != ((wheel.now + next) & (SOFT_TIMER_SLOTS - 1U))) && (soonest != next)){
+        errors++;
+    }
+}
+
+static void test_model(void)
+{
+    uint32_t run, i, burst, fired;
+
+    wheel.ticks = TICKS_START;
+    soft_timer_wheel_init(&wheel);
+    CHECK_EQ(wheel.now, TICKS_START);
+    CHECK_EQ(soft_timer_next(&wheel), SOFT_TIMER_SLOTS);
+    for(i = 0; i < TIMERS; i++){
+        soft_timer_init(&timers[i], timer_fired, (void *)(uintptr_t)i);
+        CHECK(!soft_timer_active(&timers[i]));
+        timer_start(i, random_delay(), 0U);
+    }
+    for(run = 0; run < RUNS; run++){
+        for(i = rnd(4); i > 0U; i--){
+            random_op();
+        }
+        /* mostly a few ticks, now and then a long stretch */
+        burst = (0U == rnd(100)) ? rnd(SOFT_TIMER_SLOTS * SOFT_TIMER_SLOTS * 8U) : rnd(SOFT_TIMER_SLOTS);
+        for(i = 0; i < burst; i++){
+            soft_timer_tick(&wheel);
+        }
+        CHECK(((0U == burst) ? 1U : 0U) == ((0U != soft_timer_next(&wheel)) ? 1U : 0U));
+        fired = model_fired;
+        CHECK_EQ(soft_timer_run(&wheel), model_fired - fired);
+        CHECK_EQ(wheel.now, wheel.ticks);
+        model_check();
+    }
+    CHECK_EQ(errors, 0);
+    CHECK_EQ(wheel.fired, model_fired);
+    /* the tick count wrapped and long delays came due */
+    CHECK(wheel.now < TICKS_START);
+    CHECK(model_fired > RUNS);
+}
+
+static void long_fired(soft_timer_struct *timer, void *arg)
+{
+    (void)timer;
+    *(uint32_t *)arg = wheel.now;
+}
+
+/* a delay past the range is parked and comes down again in time, sleeping as long as next() allows */
+static void test_long_delay(void)
+{
+    static const uint32_t delays[] = {SOFT_TIMER_RANGE, SOFT_TIMER_RANGE + 1U, SOFT_TIMER_RANGE * 3U + 77U};
+    uint32_t d, start, fired_at;
+
+    for(d = 0; d < sizeof(delays) / sizeof(delays[0]); d++){
+        wheel.ticks = TICKS_START;
+        soft_timer_wheel_init(&wheel);
+        soft_timer_init(&timers[0], long_fired, &fired_at);
+        soft_timer_start(&wheel, &timers[0], delays[d], 0U);
+        start = wheel.now;
+        while(soft_timer_active(&timers[0]) && (wheel.now - start <= delays[d])){
+            wheel.ticks += soft_timer_next(&wheel);
+            soft_timer_run(&wheel);
+        }
+        CHECK_EQ(wheel.fired, 1);
+        CHECK_EQ(fired_at - start, delays[d]);
+    }
+}
+
+int main(void)
+{
+    test_model();
+    test_long_delay();
+    return test_result();
+}
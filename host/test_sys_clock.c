@@ -0,0 +1,217 @@
+/*!
+    \file    test_sys_clock.c
+    \brief   host test of the 64-bit monotonic clock with an injected counter
+
+    The counter is a 64-bit true count cut to 32 bits, advanced by a
+    random step on every read. It starts just short of a wrap and runs
+    through many more. Now and then the tick runs right inside a
+    counter read, as the SysTick interrupt would between the reads of
+    the epoch and of the counter, and now and then from the reading
+    context between reads. Every read must be no less than the one
+    before it and lie within the true count before and after the read.
+    Ticks almost a whole wrap apart must still count every cycle. Then
+    a second thread ticks back to back while the test reads, so a read
+    can see two epochs written under it and must retry. The
+    conversions must match exact 128-bit arithmetic for any count,
+    including frequencies that do not divide a second evenly.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "test.h"
+#include "sys_clock.h"
+
+#define READS                       20000000U
+#define THREAD_READS                20000000U
+#define CONVERSIONS                 1000000U
+#define COUNTER_START               (0x100000000ULL - 1000000U)
+/* the counter advances by less than this on a read */
+#define STEP                        5000U
+
+static uint64_t real;
+static int ticking;
+static int interrupts;
+/* the threaded test: the tick thread alone advances the counter */
+static _Atomic uint64_t shared_real;
+static _Atomic int threaded;
+static _Atomic int reading;
+static uint32_t seed = 1U;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+static uint64_t rnd64(void)
+{
+    uint64_t r = rnd(0x1000000U);
+
+    r = (r << 24) | rnd(0x1000000U);
+    return (r << 16) | rnd(0x10000U);
+}
+
+/* the tick, not nested in itself */
+static void tick(void)
+{
+    ticking = 1;
+    sys_clock_tick();
+    ticking = 0;
+}
+
+uint32_t sys_clock_host_counter(void)
+{
+    if(atomic_load_explicit(&threaded, memory_order_relaxed)){
+        return (uint32_t)atomic_load(&shared_real);
+    }
+    real += rnd(STEP);
+    /* the interrupt right between the read of the epoch and of the counter */
+    if(interrupts && !ticking && (0U == rnd(8))){
+        tick();
+        real += rnd(100);
+    }
+    return (uint32_t)real;
+}
+
+static void test_wrap(void)
+{
+    uint64_t base, prev = 0, now, low, high;
+    uint32_t i, errors = 0;
+
+    real = COUNTER_START;
+    sys_clock_init(240000000U);
+    base = real;
+    CHECK(sys_clock_cycles() <= real - base);
+    interrupts = 1;
+    for(i = 0; i < READS; i++){
+        if(0U == rnd(64)){
+            tick();
+        }
+        low = real - base;
+        now = sys_clock_cycles();
+        high = real - base;
+        if((now < prev) || (now < low) || (now > high)){
+            if(errors < 5U){
+                printf("read %u: %llu not in %llu..%llu, previous %llu\n", i, (unsigned long long)now,
+                       (unsigned long long)low, (unsigned long long)high, (unsigned long long)prev);
+            }
+            errors++;
+        }
+        prev = now;
+    }
+    interrupts = 0;
+    CHECK_EQ(errors, 0);
+    /* crossed the wrap at the start and many after it */
+    CHECK((real >> 32) > 10U);
+}
+
+/* ticks just under a wrap apart lose nothing */
+static void test_late_tick(void)
+{
+    uint64_t base, now;
+    uint32_t i;
+
+    real = COUNTER_START;
+    sys_clock_init(240000000U);
+    base = real;
+    for(i = 0; i < 100U; i++){
+        /* less than a wrap with the steps of the read and of the tick */
+        real += 0xFFFFFFFFULL - 2U * STEP - rnd(0x10000U);
+        tick();
+        /* the read returns the count at the counter read it does */
+        now = sys_clock_cycles();
+        CHECK(now == real - base);
+    }
+}
+
+/* ticks back to back on another core, so a read can see two epochs go by */
+static void *tick_thread(void *arg)
+{
+    uint32_t step = 1U;
+
+    (void)arg;
+    while(atomic_load(&reading)){
+        step = step * 1103515245U + 12345U;
+        atomic_fetch_add(&shared_real, 1U + (step >> 20));
+        sys_clock_tick();
+    }
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    pthread_t thread;
+    uint64_t base, prev = 0, now, low, high;
+    uint32_t i, errors = 0;
+
+    atomic_store(&shared_real, COUNTER_START);
+    atomic_store(&threaded, 1);
+    sys_clock_init(240000000U);
+    base = COUNTER_START;
+    atomic_store(&reading, 1);
+    pthread_create(&thread, NULL, tick_thread, NULL);
+    for(i = 0; i < THREAD_READS; i++){
+        low = atomic_load(&shared_real) - base;
+        now = sys_clock_cycles();
+        high = atomic_load(&shared_real) - base;
+        if((now < prev) || (now < low) || (now > high)){
+            if(errors < 5U){
+                printf("threaded read %u: %llu not in %llu..%llu, previous %llu\n", i, (unsigned long long)now,
+                       (unsigned long long)low, (unsigned long long)high, (unsigned long long)prev);
+            }
+            errors++;
+        }
+        prev = now;
+    }
+    atomic_store(&reading, 0);
+    pthread_join(thread, NULL);
+    atomic_store(&threaded, 0);
+    CHECK_EQ(errors, 0);
+    CHECK(atomic_load(&shared_real) - base > 0x100000000ULL);
+}
+
+static void test_convert(void)
+{
+    static const uint32_t hzs[] = {1U, 1000000U, 168000001U, 240000000U, 0xFFFFFFFFU};
+    unsigned __int128 cycles;
+    uint64_t c;
+    uint32_t h, i, errors = 0;
+
+    sys_clock.hz = 240000000U;
+    CHECK_EQ(sys_clock_cycles_to_us(239U), 0);
+    CHECK_EQ(sys_clock_cycles_to_us(240U), 1);
+    CHECK_EQ(sys_clock_cycles_to_ms(240000U), 1);
+    CHECK_EQ(sys_clock_us_to_cycles(1U), 240);
+    CHECK(sys_clock_cycles_to_us(0xFFFFFFFFFFFFULL * 240U) == 0xFFFFFFFFFFFFULL);
+    CHECK(sys_clock_us_to_cycles(0xFFFFFFFFFFFFULL) == 0xFFFFFFFFFFFFULL * 240U);
+
+    for(h = 0; h < sizeof(hzs) / sizeof(hzs[0]); h++){
+        sys_clock.hz = hzs[h];
+        for(i = 0; i < CONVERSIONS; i++){
+            c = rnd64() >> rnd(40);
+            if(sys_clock_cycles_to_us(c) != (uint64_t)((unsigned __int128)c * 1000000U / hzs[h])){
+                errors++;
+            }
+            if(sys_clock_cycles_to_ms(c) != (uint64_t)((unsigned __int128)c * 1000U / hzs[h])){
+                errors++;
+            }
+            /* microseconds whose cycles fit in 64 bits */
+            cycles = (unsigned __int128)(c >> 32) * hzs[h] / 1000000U;
+            if(sys_clock_us_to_cycles(c >> 32) != (uint64_t)cycles){
+                errors++;
+            }
+        }
+    }
+    CHECK_EQ(errors, 0);
+}
+
+int main(void)
+{
+    test_wrap();
+    test_late_tick();
+    test_threads();
+    test_convert();
+    return test_result();
+}
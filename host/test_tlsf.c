@@ -0,0 +1,267 @@
+/*!
+    \file    test_tlsf.c
+    \brief   host test of the TLSF allocator against a reference model
+
+    Random mallocs, aligned allocations and frees run against a model
+    that keeps every live block with its size, alignment and fill byte.
+    Each block must be aligned, inside the region, as large as asked and
+    apart from every other live block, and must keep its bytes until it
+    is freed. A failed allocation must be one no free block can serve
+    after the good fit round up. The statistics must match the model,
+    tlsf_check() must pass after every step, and once everything is
+    freed the region must be one block again.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "tlsf.h"
+
+#define REGION_SIZE                 (2U * 1024U * 1024U)
+#define MAX_LIVE                    500U
+#define ROUNDS                      100000U
+/* smallest block, as in tlsf.c */
+#define BLOCK_SIZE_MIN              (sizeof(tlsf_block_struct) - sizeof(tlsf_block_struct *))
+
+typedef struct {
+    uint8_t *ptr;
+    size_t size;
+    uint8_t fill;
+} live_struct;
+
+static tlsf_struct tlsf;
+static uint8_t *region;
+static live_struct live[MAX_LIVE];
+static uint32_t live_count;
+static uint32_t seed = 1U;
+
+/* the model's counters */
+static struct {
+    size_t used;
+    size_t high_water;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failures;
+} model;
+
+static uint32_t rnd(uint32_t range)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFFFFU) % range;
+}
+
+/* mostly small requests, some medium and a few large ones */
+static size_t random_size(void)
+{
+    uint32_t kind = rnd(100);
+
+    if(kind < 70U){
+        return 1U + rnd(256);
+    }
+    if(kind < 97U){
+        return 1U + rnd(8192);
+    }
+    return 1U + rnd(256U * 1024U);
+}
+
+/* block size the allocator asks for, as adjust_request_size() rounds */
+static size_t block_request(size_t size, size_t align)
+{
+    size = (size + (align - 1U)) & ~(align - 1U);
+    return (size < BLOCK_SIZE_MIN) ? BLOCK_SIZE_MIN : size;
+}
+
+/* smallest free block the allocator is sure to take for a block size, as mapping_search() rounds */
+static size_t good_fit(size_t size)
+{
+    uint32_t fls = 31U - (uint32_t)__builtin_clz((uint32_t)size);
+
+    if(size >= TLSF_SMALL_BLOCK){
+        size += ((size_t)1U << (fls - TLSF_SL_LOG2)) - 1U;
+        size &= ~(((size_t)1U << (fls - TLSF_SL_LOG2)) - 1U);
+    }
+    return size;
+}
+
+/* check a new block against the region and every live block */
+static int block_valid(const uint8_t *ptr, size_t size, size_t align)
+{
+    size_t bytes = tlsf_block_size(ptr);
+    uint32_t i;
+
+    if((0U != ((uintptr_t)ptr & (align - 1U))) || (bytes < size) ||
+       (ptr < region) || (ptr + bytes > region + REGION_SIZE)){
+        return 0;
+    }
+    for(i = 0; i < live_count; i++){
+        if((ptr < live[i].ptr + tlsf_block_size(live[i].ptr)) && (live[i].ptr < ptr + bytes)){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void do_alloc(void)
+{
+    tlsf_stats_struct stats;
+    size_t size = random_size(), align = TLSF_ALIGN, need;
+    uint8_t *ptr;
+    live_struct *l;
+
+    if(MAX_LIVE == live_count){
+        return;
+    }
+    tlsf_stats_get(&tlsf, &stats);
+    if(0U == rnd(4)){
+        align = (size_t)1U << (2U + rnd(11));
+        ptr = tlsf_memalign(&tlsf, align, size);
+    }else{
+        ptr = tlsf_malloc(&tlsf, size);
+    }
+    if(align < TLSF_ALIGN){
+        align = TLSF_ALIGN;
+    }
+
+    if(NULL == ptr){
+        model.failures++;
+        /* an aligned request looks for room to free the gap in front, as tlsf_memalign() does */
+        need = block_request(size, TLSF_ALIGN);
+        if(TLSF_ALIGN != align){
+            need = block_request(need + align + sizeof(tlsf_block_struct), align);
+        }
+        need = good_fit(need);
+        if(need <= stats.largest){
+            printf("%zu bytes aligned to %zu refused with a free block of %zu\n", size, align, stats.largest);
+            test_failed++;
+        }
+        return;
+    }
+    if(!block_valid(ptr, size, align)){
+        printf("bad block %p of %zu bytes aligned to %zu\n", (void *)ptr, size, align);
+        test_failed++;
+        return;
+    }
+    l = &live[live_count++];
+    l->ptr = ptr;
+    l->size = size;
+    l->fill = (uint8_t)rnd(256);
+    memset(ptr, l->fill, size);
+    model.allocs++;
+    model.used += tlsf_block_size(ptr);
+    if(model.used > model.high_water){
+        model.high_water = model.used;
+    }
+}
+
+static void do_free(void)
+{
+    uint32_t i, j;
+
+    if(0U == live_count){
+        return;
+    }
+    i = rnd(live_count);
+    for(j = 0; j < live[i].size; j++){
+        if(live[i].ptr[j] != live[i].fill){
+            printf("block %p changed at byte %u\n", (void *)live[i].ptr, j);
+            test_failed++;
+            break;
+        }
+    }
+    model.used -= tlsf_block_size(live[i].ptr);
+    model.frees++;
+    tlsf_free(&tlsf, live[i].ptr);
+    live[i] = live[--live_count];
+}
+
+static void check_stats(void)
+{
+    tlsf_stats_struct stats;
+
+    tlsf_stats_get(&tlsf, &stats);
+    CHECK_EQ(stats.used, model.used);
+    CHECK_EQ(stats.high_water, model.high_water);
+    CHECK_EQ(stats.allocs, model.allocs);
+    CHECK_EQ(stats.frees, model.frees);
+    CHECK_EQ(stats.failures, model.failures);
+    CHECK(stats.largest <= stats.free);
+    CHECK(stats.fragmentation <= 1000U);
+}
+
+/* random steps, alloc_percent of them allocations */
+static void run(uint32_t rounds, uint32_t alloc_percent)
+{
+    uint32_t i;
+
+    for(i = 0; i < rounds; i++){
+        if(rnd(100) < alloc_percent){
+            do_alloc();
+        }else{
+            do_free();
+        }
+        if(0 != tlsf_check(&tlsf)){
+            printf("tlsf_check failed after step %u\n", i);
+            test_failed++;
+            return;
+        }
+        if(0U == (i & 1023U)){
+            check_stats();
+        }
+    }
+}
+
+static void test_edges(void)
+{
+    uint8_t small[16];
+    tlsf_stats_struct stats;
+
+    CHECK_EQ(tlsf_init(&tlsf, small, sizeof(small)), -1);
+    CHECK_EQ(tlsf_init(&tlsf, region, REGION_SIZE), 0);
+    CHECK(NULL == tlsf_malloc(&tlsf, 0));
+    CHECK(NULL == tlsf_malloc(&tlsf, REGION_SIZE));
+    CHECK(NULL == tlsf_memalign(&tlsf, 64, 0));
+    tlsf_free(&tlsf, NULL);
+    tlsf_stats_get(&tlsf, &stats);
+    CHECK_EQ(stats.failures, 3);
+    CHECK_EQ(stats.frees, 0);
+    CHECK_EQ(stats.largest, stats.free);
+    CHECK_EQ(stats.fragmentation, 0);
+    CHECK_EQ(tlsf_check(&tlsf), 0);
+}
+
+int main(void)
+{
+    tlsf_stats_struct start, stats;
+
+    region = aligned_alloc(64, REGION_SIZE);
+    CHECK(NULL != region);
+    if(NULL == region){
+        return test_result();
+    }
+    test_edges();
+
+    CHECK_EQ(tlsf_init(&tlsf, region, REGION_SIZE), 0);
+    tlsf_stats_get(&tlsf, &start);
+    /* grow until allocations fail, churn, then drain */
+    run(ROUNDS / 4U, 80);
+    run(ROUNDS, 50);
+    run(ROUNDS / 4U, 20);
+    while(0U != live_count){
+        do_free();
+    }
+    CHECK_EQ(tlsf_check(&tlsf), 0);
+    check_stats();
+    CHECK(model.failures > 0U);
+
+    /* everything merged back into the one block */
+    tlsf_stats_get(&tlsf, &stats);
+    CHECK_EQ(stats.used, 0);
+    CHECK_EQ(stats.free, start.free);
+    CHECK_EQ(stats.largest, start.free);
+    CHECK_EQ(stats.fragmentation, 0);
+
+    free(region);
+    return test_result();
+}
@@ -0,0 +1,214 @@
+/*!
+    \file    test_trace.c
+    \brief   host test of the event tracer batches
+
+    Records of every kind from threads, handlers and main go through
+    the ring into batches as the drain would cut them, with a fake
+    counter that wraps during the trace, and the batch headers are
+    checked: record count, the records lost since the last batch, the
+    frequency and the counter at the batch. A record whose writer was
+    interrupted between the claim and the counter read comes before an
+    older one, the ring overflows, a batch is refused by the channel,
+    and records come most of a wrap after the batch before them, the
+    counter wrapping between two batches.
+
+    The batches make up host/samples/trace.bin with garbage and a batch
+    of flags the host does not know ahead of them, a cut copy of a
+    batch between two others and a cut batch at the end. It must match
+    the recorded file byte for byte, which test_trace2chrome.py turns
+    into a Chrome trace with the tool. Run with --record to write it
+    again after a change of the format.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "trace.h"
+
+/* the names and threads in host/samples/trace.elf, and a name and a thread it does not have */
+#define NAME_FRAME                  0x08000400U
+#define NAME_MARK                   0x08000410U
+#define NAME_LOAD                   0x08000420U
+#define NAME_MISSING                0x08000800U
+#define CONTROL_THREAD              0x20000000U
+#define EVENTS_THREAD               0x20000040U
+#define MISSING_THREAD              0x20001000U
+/* handler contexts, the exception number times 4 */
+#define CONTEXT_HARDFAULT           (3U << 2)
+#define CONTEXT_SYSTICK             (15U << 2)
+#define CONTEXT_TIMER6              (71U << 2)
+
+#define TIME_START                  0xFFFFF000U
+#define TRACE_HZ                    240000000U
+#define BATCH_RECORDS               8U
+#define OVERFLOW_RECORDS            300U
+
+static uint8_t capture[16384];
+static uint32_t capture_len;
+static uint32_t now_cycles;
+static uint32_t now_context;
+
+static uint32_t fake_cycles(void)
+{
+    return now_cycles;
+}
+
+static uint32_t fake_context(void)
+{
+    return now_context;
+}
+
+static uint8_t *put32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+    return out + 4;
+}
+
+static uint32_t get32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static void append(const void *data, uint32_t len)
+{
+    memcpy(&capture[capture_len], data, len);
+    capture_len += len;
+}
+
+/* a record at time after TIME_START */
+static void event(uint64_t time, uint32_t context, trace_type_enum type, uint32_t name, int32_t value)
+{
+    now_cycles = (uint32_t)(TIME_START + time);
+    now_context = context;
+    trace_event(&tracer, type, (const char *)(uintptr_t)name, value);
+}
+
+/* check the header of a batch of n bytes cut at time */
+static void check_batch(const uint8_t *batch, uint32_t n, uint32_t count, uint32_t lost, uint64_t time)
+{
+    CHECK_EQ(n, TRACE_HEADER_SIZE + count * TRACE_RECORD_SIZE);
+    CHECK_EQ(get32(batch), TRACE_MAGIC);
+    CHECK_EQ(batch[4] | (batch[5] << 8), count);
+    CHECK_EQ(batch[6] | (batch[7] << 8), 0);
+    CHECK_EQ(get32(&batch[8]), lost);
+    CHECK_EQ(get32(&batch[12]), TRACE_HZ);
+    CHECK_EQ(get32(&batch[16]), (uint32_t)(TIME_START + time));
+}
+
+static void record(void)
+{
+    uint8_t batch[TRACE_HEADER_SIZE + BATCH_RECORDS * TRACE_RECORD_SIZE];
+    uint8_t *pos;
+    uint32_t i, n, batches = 0;
+
+    /* garbage, then a batch of a later format with flags the host must not read */
+    append("\x01\x02TRC", 5U);
+    memset(batch, 0x5A, sizeof(batch));
+    pos = put32(batch, TRACE_MAGIC);
+    pos = put32(pos, 1U | (0x8000U << 16));
+    pos = put32(pos, 99U);
+    pos = put32(pos, TRACE_HZ);
+    (void)put32(pos, TIME_START);
+    append(batch, TRACE_HEADER_SIZE + TRACE_RECORD_SIZE);
+
+    trace_init(&tracer, fake_cycles, fake_context, TRACE_HZ);
+    now_cycles = TIME_START;
+    CHECK_EQ(trace_batch(&tracer, batch, sizeof(batch)), 0);
+
+    /* one of each kind and context, the counter wraps after the first 4096 cycles */
+    event(100U, EVENTS_THREAD, TRACE_BEGIN, NAME_FRAME, 0);
+    event(150U, CONTEXT_SYSTICK, TRACE_INSTANT, NAME_MARK, 7);
+    event(2500U, EVENTS_THREAD, TRACE_END, NAME_FRAME, 0);
+    event(5000U, CONTROL_THREAD, TRACE_COUNTER, NAME_LOAD, 123);
+    /* main claimed its cell, TIMER6 wrote in between, then main read the counter */
+    event(6100U, 0U, TRACE_INSTANT, NAME_MARK, 1);
+    event(6000U, CONTEXT_TIMER6, TRACE_INSTANT, NAME_MARK, -5);
+    event(6200U, MISSING_THREAD, TRACE_INSTANT, NAME_MISSING, 2);
+    event(6300U, CONTEXT_HARDFAULT, TRACE_INSTANT, NAME_MARK, 3);
+    now_cycles = TIME_START + 7000U;
+    n = trace_batch(&tracer, batch, sizeof(batch));
+    check_batch(batch, n, BATCH_RECORDS, 0U, 7000U);
+    CHECK_EQ(get32(&batch[TRACE_HEADER_SIZE]), TIME_START + 100U);
+    CHECK_EQ(get32(&batch[TRACE_HEADER_SIZE + 4U]), NAME_FRAME);
+    CHECK_EQ(get32(&batch[TRACE_HEADER_SIZE + 8U]), EVENTS_THREAD | TRACE_BEGIN);
+    CHECK_EQ(get32(&batch[TRACE_HEADER_SIZE + 5U * TRACE_RECORD_SIZE + 12U]), (uint32_t)-5);
+    append(batch, n);
+    CHECK_EQ(trace_batch(&tracer, batch, sizeof(batch)), 0);
+
+    /* the ring overflows, the first batch is refused, the next reports both */
+    for(i = 0; i < OVERFLOW_RECORDS; i++){
+        event(10000U + i, CONTROL_THREAD, TRACE_INSTANT, NAME_MARK, (int32_t)i);
+    }
+    CHECK_EQ(tracer.lost, OVERFLOW_RECORDS - TRACE_RING_SIZE);
+    now_cycles = TIME_START + 20000U;
+    n = trace_batch(&tracer, batch, sizeof(batch));
+    check_batch(batch, n, BATCH_RECORDS, OVERFLOW_RECORDS - TRACE_RING_SIZE, 20000U);
+    trace_skip(&tracer, batch);
+    CHECK_EQ(tracer.skipped, BATCH_RECORDS);
+    n = trace_batch(&tracer, batch, sizeof(batch));
+    check_batch(batch, n, BATCH_RECORDS, OVERFLOW_RECORDS - TRACE_RING_SIZE + BATCH_RECORDS, 20000U);
+    CHECK_EQ(get32(&batch[TRACE_HEADER_SIZE + 12U]), BATCH_RECORDS);
+    append(batch, n);
+    /* a cut copy the next batch follows, the host must not read into it */
+    append(batch, 40U);
+    while(0U != (n = trace_batch(&tracer, batch, sizeof(batch)))){
+        check_batch(batch, n, BATCH_RECORDS, 0U, 20000U);
+        append(batch, n);
+        batches++;
+    }
+    CHECK_EQ(batches, TRACE_RING_SIZE / BATCH_RECORDS - 2U);
+
+    /* most of a wrap later twice, the batches still come within one, the counter wraps between them */
+    event(3000000000U, EVENTS_THREAD, TRACE_COUNTER, NAME_LOAD, 999);
+    now_cycles = TIME_START + 3000000100U;
+    n = trace_batch(&tracer, batch, sizeof(batch));
+    check_batch(batch, n, 1U, 0U, 3000000100U);
+    append(batch, n);
+    event(5000000000ULL, EVENTS_THREAD, TRACE_COUNTER, NAME_LOAD, 1000);
+    now_cycles = (uint32_t)(TIME_START + 5000000100ULL);
+    CHECK(now_cycles < TIME_START + 3000000100U);
+    n = trace_batch(&tracer, batch, sizeof(batch));
+    check_batch(batch, n, 1U, 0U, 5000000100ULL);
+    append(batch, n);
+    /* the capture stopped inside a batch */
+    append(batch, 30U);
+}
+
+/* the capture must be the recorded file, or is written as it with record */
+static void check_file(int record_it)
+{
+    static uint8_t data[sizeof(capture) + 1U];
+    const char *path = TRACE_SAMPLES "/trace.bin";
+    FILE *f = fopen(path, record_it ? "wb" : "rb");
+    size_t len;
+
+    if(NULL == f){
+        printf("%s: cannot open\n", path);
+        test_failed++;
+        return;
+    }
+    if(record_it){
+        fwrite(capture, 1U, capture_len, f);
+        fclose(f);
+        return;
+    }
+    len = fread(data, 1U, sizeof(data), f);
+    fclose(f);
+    if((len != capture_len) || (0 != memcmp(data, capture, len))){
+        printf("%s: %u bytes differ from the %u recorded, record them again with --record\n", path, capture_len,
+               (uint32_t)len);
+        test_failed++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    record();
+    check_file((argc > 1) && (0 == strcmp(argv[1], "--record")));
+    return test_result();
+}
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""Test of tools/trace2chrome.py on a recorded trace.
+
+host/samples/trace.bin is the capture test_trace records from the
+batches of trace.c: records of every kind from threads, handlers and
+main across a wrap of the counter, one written out of time order, an
+overflow of the ring reported after a refused batch, records most of a
+wrap after the batch before them with the counter wrapping between the
+batches, garbage and a batch of unknown flags ahead, a cut copy of a
+batch between two others and a cut batch at the end. trace.elf stands
+in for the firmware with a vector table, handlers with the Thumb bit in
+their symbols, name strings and thread structures. The records read
+back, the names of the tracks, the Chrome trace and the command line
+are checked against the records that were written.
+"""
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+sys.dont_write_bytecode = True
+HOST = os.path.dirname(os.path.abspath(__file__))
+TOOLS = os.path.join(HOST, os.pardir, "tools")
+SAMPLES = os.path.join(HOST, "samples")
+sys.path.insert(0, TOOLS)
+import trace2chrome  # noqa: E402
+
+ELF = os.path.join(SAMPLES, "trace.elf")
+TRACE = os.path.join(SAMPLES, "trace.bin")
+HZ = 240000000
+LOST = 300 - 256 + 8
+# the records of the overflow that got through, after the refused batch
+OVERFLOW = range(8, 256)
+
+MAGIC = b"TRC1"
+NAME_FRAME, NAME_MARK, NAME_LOAD, NAME_MISSING = 0x08000400, 0x08000410, 0x08000420, 0x08000800
+CONTROL, EVENTS, MISSING = 0x20000000, 0x20000040, 0x20001000
+HARDFAULT, SYSTICK, TIMER6 = 3 << 2, 15 << 2, 71 << 2
+
+
+def read(path):
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def us(cycles):
+    return cycles * 1e6 / HZ
+
+
+class ElfTest(unittest.TestCase):
+    def setUp(self):
+        self.elf = trace2chrome.Elf(read(ELF))
+
+    def test_strings(self):
+        self.assertEqual(self.elf.string(NAME_FRAME), "gui frame")
+        self.assertEqual(self.elf.string(NAME_LOAD), "cpu load")
+        self.assertEqual(self.elf.string(NAME_FRAME + 4), "frame")
+        self.assertIsNone(self.elf.string(NAME_MISSING))
+        # the threads are in .bss, there is nothing to read, nor past the end of a section
+        self.assertIsNone(self.elf.read(CONTROL, 4))
+        self.assertIsNone(self.elf.read(NAME_LOAD + 8, 4))
+        self.assertEqual(self.elf.read(NAME_LOAD + 5, 4), b"oad\0")
+
+    def test_tracks(self):
+        self.assertEqual(trace2chrome.track_name(self.elf, 0), "main")
+        self.assertEqual(trace2chrome.track_name(self.elf, SYSTICK), "SysTick_Handler")
+        self.assertEqual(trace2chrome.track_name(self.elf, TIMER6), "TIMER6_IRQHandler")
+        # an empty vector table entry, and one past the end of the table
+        self.assertEqual(trace2chrome.track_name(self.elf, HARDFAULT), "exception 3")
+        self.assertEqual(trace2chrome.track_name(self.elf, 100 << 2), "exception 100")
+        self.assertEqual(trace2chrome.track_name(self.elf, EVENTS), "events_thread")
+        self.assertEqual(trace2chrome.track_name(self.elf, MISSING), "thread 0x20001000")
+
+    def test_not_elf(self):
+        with self.assertRaises(ValueError):
+            trace2chrome.Elf(read(TRACE))
+
+
+class BatchTest(unittest.TestCase):
+    def setUp(self):
+        self.records, self.hz, self.lost = trace2chrome.read_batches(read(TRACE))
+
+    def test_counts(self):
+        self.assertEqual(len(self.records), 8 + len(OVERFLOW) + 2)
+        self.assertEqual((self.hz, self.lost), (HZ, LOST))
+
+    def test_records(self):
+        start = self.records[0][0]
+        times = [cycles - start for cycles, _, _, _, _ in self.records]
+        # the counter wrapped between the first records and later, the times still count up
+        # main was interrupted by TIMER6 between the claim of its record and the counter read
+        self.assertEqual(times[:8], [0, 50, 2400, 4900, 6000, 5900, 6100, 6200])
+        self.assertEqual(times[8:-2], [10000 + i - 100 for i in OVERFLOW])
+        self.assertEqual(times[-2:], [3000000000 - 100, 5000000000 - 100])
+        self.assertEqual(self.records[0][1:], (NAME_FRAME, EVENTS, trace2chrome.BEGIN, 0))
+        self.assertEqual(self.records[2][1:], (NAME_FRAME, EVENTS, trace2chrome.END, 0))
+        self.assertEqual(self.records[3][1:], (NAME_LOAD, CONTROL, trace2chrome.COUNTER, 123))
+        self.assertEqual(self.records[4][1:], (NAME_MARK, 0, trace2chrome.INSTANT, 1))
+        self.assertEqual(self.records[5][1:], (NAME_MARK, TIMER6, trace2chrome.INSTANT, -5))
+        self.assertEqual([r[4] for r in self.records[8:-2]], list(OVERFLOW))
+
+    def test_cut(self):
+        data = read(TRACE)
+        # a capture starting inside the first batch reads from the next, which reports the loss
+        first = data.find(MAGIC, data.find(MAGIC) + 1)
+        records, _, lost = trace2chrome.read_batches(data[first + 10:])
+        self.assertEqual((len(records), lost), (len(OVERFLOW) + 2, LOST))
+        # the batch the capture ends in is dropped
+        records, _, _ = trace2chrome.read_batches(data[:-31])
+        self.assertEqual(len(records), 8 + len(OVERFLOW) + 1)
+        self.assertEqual(trace2chrome.read_batches(b"TRC1" * 5), ([], None, 0))
+
+
+class ChromeTest(unittest.TestCase):
+    def setUp(self):
+        records, hz, lost = trace2chrome.read_batches(read(TRACE))
+        self.trace = trace2chrome.chrome_trace(records, hz, lost, trace2chrome.Elf(read(ELF)))
+        self.events = self.trace["traceEvents"]
+
+    def test_events(self):
+        self.assertEqual(self.events[:8], [
+            {"name": "gui frame", "pid": 1, "tid": EVENTS, "ts": 0.0, "ph": "B"},
+            {"name": "mark", "pid": 1, "tid": SYSTICK, "ts": us(50), "ph": "i", "s": "t", "args": {"arg": 7}},
+            {"name": "gui frame", "pid": 1, "tid": EVENTS, "ts": 10.0, "ph": "E"},
+            {"name": "cpu load", "pid": 1, "tid": CONTROL, "ts": us(4900), "ph": "C", "args": {"cpu load": 123}},
+            {"name": "mark", "pid": 1, "tid": TIMER6, "ts": us(5900), "ph": "i", "s": "t", "args": {"arg": -5}},
+            {"name": "mark", "pid": 1, "tid": 0, "ts": 25.0, "ph": "i", "s": "t", "args": {"arg": 1}},
+            {"name": "0x08000800", "pid": 1, "tid": MISSING, "ts": us(6100), "ph": "i", "s": "t",
+             "args": {"arg": 2}},
+            {"name": "mark", "pid": 1, "tid": HARDFAULT, "ts": us(6200), "ph": "i", "s": "t", "args": {"arg": 3}},
+        ])
+        for event, value, cycles in zip(self.events[8 + len(OVERFLOW):], (999, 1000), (3000000000, 5000000000)):
+            self.assertEqual((event["ph"], event["tid"], event["args"]), ("C", EVENTS, {"cpu load": value}))
+            self.assertAlmostEqual(event["ts"], us(cycles - 100))
+
+    def test_tracks(self):
+        tracks = {e["tid"]: e["args"]["name"] for e in self.events if e["name"] == "thread_name"}
+        self.assertEqual(tracks, {
+            0: "main", HARDFAULT: "exception 3", SYSTICK: "SysTick_Handler", TIMER6: "TIMER6_IRQHandler",
+            CONTROL: "control_thread", EVENTS: "events_thread", MISSING: "thread 0x20001000",
+        })
+        self.assertEqual(self.events[-1]["name"], "process_name")
+        self.assertEqual(self.trace["otherData"], {"hz": HZ, "lost": LOST})
+
+    def test_spans(self):
+        # every span ends on the track it began on, after it began
+        open_spans = {}
+        for event in self.events:
+            if event["ph"] == "B":
+                open_spans[event["tid"]] = event["ts"]
+            elif event["ph"] == "E":
+                self.assertLess(open_spans.pop(event["tid"]), event["ts"])
+        self.assertEqual(open_spans, {})
+
+
+class CommandTest(unittest.TestCase):
+    def run_tool(self, *args):
+        env = dict(os.environ, PYTHONDONTWRITEBYTECODE="1")
+        return subprocess.run([sys.executable, os.path.join(TOOLS, "trace2chrome.py")] + list(args),
+                              capture_output=True, text=True, env=env)
+
+    def test_output_file(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            output = os.path.join(tmp, "trace.json")
+            result = self.run_tool(ELF, TRACE, "-o", output)
+            self.assertEqual(result.returncode, 0, result.stderr)
+            with open(output, encoding="utf-8") as f:
+                trace = json.load(f)
+        self.assertIn("52 records lost", result.stderr)
+        self.assertEqual(len(trace["traceEvents"]), 8 + len(OVERFLOW) + 2 + 7 + 1)
+
+    def test_no_records(self):
+        result = self.run_tool(ELF, ELF)
+        self.assertEqual(result.returncode, 1)
+        self.assertIn("no records", result.stderr)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,224 @@
+/*!
+    \file    test_work.c
+    \brief   host test of the deferred interrupt work queue
+
+    On one thread with a fake cycle counter: items run highest priority
+    first and in order within a priority, every post calls the notify
+    hook, a work of a priority out of range is refused without touching
+    any queue, a full queue refuses and counts the drop, and the
+    latency from post to run and the run time come out exact, across a
+    wrap of the counter too.
+
+    Then producer threads post at every priority, as interrupts would,
+    while one thread drains, and each producer's items must run once
+    and in the order it posted them within a priority.
+
+    \version 2026-10-19, V1.0.0, firmware for GD32F4xx
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "test.h"
+#include "work.h"
+
+#define PRODUCERS                   3U
+#define PRODUCER_POSTS              300000U
+
+static work_queue_struct queue;
+static uint32_t fake_cycles;
+static uint32_t notifies;
+static uint32_t order[64];
+static uint32_t order_count;
+
+static uint32_t count_cycles(void)
+{
+    return fake_cycles;
+}
+
+static void count_notify(void)
+{
+    notifies++;
+}
+
+/* note the order, spend arg cycles */
+static void note_fn(uint32_t arg)
+{
+    order[order_count++] = arg;
+    fake_cycles += arg;
+}
+
+static work_struct note[WORK_PRIORITIES] = {
+    WORK_INIT(note_fn, 0U), WORK_INIT(note_fn, 1U), WORK_INIT(note_fn, 2U)
+};
+static work_struct bad = WORK_INIT(note_fn, WORK_PRIORITIES);
+
+static void test_rules(void)
+{
+    uint32_t p, i;
+
+    work_queue_init(&queue, count_cycles, count_notify);
+    CHECK(!work_pending(&queue));
+    CHECK_EQ(work_run_once(&queue), 0);
+
+    /* posted from the lowest priority up, run from the highest down, each in order */
+    for(p = WORK_PRIORITIES; p > 0U; p--){
+        for(i = 0; i < 3U; i++){
+            CHECK_EQ(work_post(&queue, &note[p - 1U], (p - 1U) * 10U + i), 0);
+        }
+    }
+    CHECK_EQ(notifies, WORK_PRIORITIES * 3U);
+    CHECK(work_pending(&queue));
+    order_count = 0;
+    CHECK_EQ(work_run(&queue), WORK_PRIORITIES * 3U);
+    CHECK(!work_pending(&queue));
+    for(i = 0; i < order_count; i++){
+        CHECK_EQ(order[i], (i / 3U) * 10U + i % 3U);
+    }
+    for(p = 0; p < WORK_PRIORITIES; p++){
+        CHECK_EQ(note[p].runs, 3);
+    }
+
+    /* out of range, refused before any queue is touched */
+    notifies = 0;
+    CHECK_EQ(work_post(&queue, &bad, 1U), -1);
+    CHECK_EQ(notifies, 0);
+    CHECK_EQ(bad.dropped, 0);
+    CHECK(!work_pending(&queue));
+
+    /* a full queue refuses and counts, the others still take items */
+    for(i = 0; i < WORK_QUEUE_SIZE; i++){
+        CHECK_EQ(work_post(&queue, &note[2], i), 0);
+    }
+    CHECK_EQ(work_post(&queue, &note[2], 99U), -1);
+    CHECK_EQ(note[2].dropped, 1);
+    CHECK_EQ(notifies, WORK_QUEUE_SIZE);
+    CHECK_EQ(work_post(&queue, &note[1], 7U), 0);
+    order_count = 0;
+    work_run(&queue);
+    CHECK_EQ(order_count, WORK_QUEUE_SIZE + 1U);
+    CHECK_EQ(order[0], 7);
+    for(i = 0; i < WORK_QUEUE_SIZE; i++){
+        CHECK_EQ(order[1U + i], i);
+    }
+}
+
+/* latency and run time from the fake counter, across its wrap */
+static void test_latency(void)
+{
+    work_struct *w = &note[1];
+
+    work_queue_init(&queue, count_cycles, NULL);
+    w->runs = 0;
+    w->latency = 0;
+    w->latency_max = 0;
+    w->cycles_max = 0;
+    fake_cycles = 0xFFFFFF00U;
+    work_post(&queue, w, 40U);
+    fake_cycles += 0x200U;
+    work_post(&queue, w, 5U);
+    fake_cycles += 0x10U;
+    /* the first waited 0x210 and ran 40, the second waited 0x10 + 40 and ran 5 */
+    CHECK_EQ(work_run(&queue), 2);
+    CHECK_EQ(w->runs, 2);
+    CHECK_EQ(w->latency, 0x210U + 0x10U + 40U);
+    CHECK_EQ(w->latency_max, 0x210);
+    CHECK_EQ(w->cycles_max, 40);
+    CHECK_EQ(queue.latency_max[1], 0x210);
+    CHECK_EQ(queue.latency_max[0], 0);
+    CHECK_EQ(queue.latency_max[2], 0);
+
+    /* no counter, no accounting */
+    work_queue_init(&queue, NULL, NULL);
+    work_post(&queue, w, 1U);
+    CHECK_EQ(work_run(&queue), 1);
+    CHECK_EQ(w->runs, 3);
+    CHECK_EQ(w->latency_max, 0x210);
+}
+
+/* items of the threaded test carry their producer and sequence number */
+#define ITEM_ARG(producer, n)       (((producer) << 24) | ((n) & 0xFFFFFFU))
+
+static uint32_t ran[PRODUCERS][WORK_PRIORITIES];
+static uint32_t misorders;
+static _Atomic uint32_t producers_done;
+
+static void check_item(uint32_t priority, uint32_t arg)
+{
+    uint32_t producer = arg >> 24;
+
+    if((producer >= PRODUCERS) || ((arg & 0xFFFFFFU) != ran[producer][priority])){
+        misorders++;
+        return;
+    }
+    ran[producer][priority]++;
+}
+
+static void check0_fn(uint32_t arg)
+{
+    check_item(0U, arg);
+}
+
+static void check1_fn(uint32_t arg)
+{
+    check_item(1U, arg);
+}
+
+static void check2_fn(uint32_t arg)
+{
+    check_item(2U, arg);
+}
+
+static work_struct check[WORK_PRIORITIES] = {
+    WORK_INIT(check0_fn, 0U), WORK_INIT(check1_fn, 1U), WORK_INIT(check2_fn, 2U)
+};
+
+static void *producer_thread(void *arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg, i, p;
+
+    for(i = 0; i < PRODUCER_POSTS; i++){
+        p = i % WORK_PRIORITIES;
+        while(0 != work_post(&queue, &check[p], ITEM_ARG(id, i / WORK_PRIORITIES))){
+            sched_yield();
+        }
+    }
+    atomic_fetch_add(&producers_done, 1U);
+    return NULL;
+}
+
+/* producers post at every priority while this thread drains */
+static void test_threads(void)
+{
+    pthread_t threads[PRODUCERS];
+    uint32_t i, p;
+
+    work_queue_init(&queue, NULL, NULL);
+    for(i = 0; i < PRODUCERS; i++){
+        pthread_create(&threads[i], NULL, producer_thread, (void *)(uintptr_t)i);
+    }
+    while((atomic_load(&producers_done) < PRODUCERS) || work_pending(&queue)){
+        if(0U == work_run(&queue)){
+            sched_yield();
+        }
+    }
+    for(i = 0; i < PRODUCERS; i++){
+        pthread_join(threads[i], NULL);
+    }
+    work_run(&queue);
+    CHECK_EQ(misorders, 0);
+    for(i = 0; i < PRODUCERS; i++){
+        for(p = 0; p < WORK_PRIORITIES; p++){
+            CHECK_EQ(ran[i][p], (PRODUCER_POSTS + WORK_PRIORITIES - 1U - p) / WORK_PRIORITIES);
+        }
+    }
+    CHECK_EQ(check[0].runs + check[1].runs + check[2].runs, PRODUCERS * PRODUCER_POSTS);
+}
+
+int main(void)
+{
+    test_rules();
+    test_latency();
+    test_threads();
+    return test_result();
+}
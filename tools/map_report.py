@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Report what the linker placed in each memory region.
+
+Reads the GNU ld map file written with -Wl,-Map and prints, for every
+region of the MEMORY command, how full it is and which output sections
+and object files take the space. With --expect SECTION=REGION it also
+checks that output sections landed where they should and exits with 1
+when one did not, so the build stops on a misplaced section. A symbol
+the linker script sets can be checked the same way, against a region or
+an output section it must lie in or end.
+
+    map_report.py gd32f470BaseProject.map --expect .stack=TCM --expect __bss_start=.bss
+"""
+
+import argparse
+import collections
+import os
+import re
+import sys
+
+HEX = r"0x[0-9a-fA-F]+"
+REGION_RE = re.compile(r"^(\S+)\s+(%s)\s+(%s)(?:\s+(\S+))?\s*$" % (HEX, HEX))
+OUTPUT_RE = re.compile(r"^(\.\S+)\s+(%s)\s+(%s)" % (HEX, HEX))
+OUTPUT_NAME_RE = re.compile(r"^(\.\S+)\s*$")
+INPUT_RE = re.compile(r"^ (\S+)\s+(%s)\s+(%s)\s+(\S.*)$" % (HEX, HEX))
+INPUT_NAME_RE = re.compile(r"^ (\S+)\s*$")
+CONT_RE = re.compile(r"^\s+(%s)\s+(%s)(?:\s+(\S.*))?$" % (HEX, HEX))
+SYMBOL_RE = re.compile(r"^\s+(%s)\s+([A-Za-z_$][\w.$]*)(?:\s+=.*)?$" % HEX)
+
+
+def parse_map(lines):
+    """Return the memory regions, output sections and symbols of a map file.
+
+    regions:  list of (name, origin, length)
+    sections: list of dicts with name, address, size and inputs, a list of
+              (input section, address, size, object file)
+    symbols:  dict of name to value, the script assignments and the global
+              symbols of the input sections
+    """
+    regions = []
+    sections = []
+    symbols = {}
+    state = "start"
+    current = None
+    pending_output = None
+    pending_input = None
+
+    for raw in lines:
+        line = raw.rstrip("\n")
+        if state == "start":
+            if line.startswith("Memory Configuration"):
+                state = "memory"
+            continue
+        if state == "memory":
+            if line.startswith("Linker script and memory map"):
+                state = "map"
+                continue
+            m = REGION_RE.match(line)
+            if m and m.group(1) != "Name" and m.group(1) != "*default*":
+                regions.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+            continue
+
+        # long names push the address to the next line
+        if pending_output is not None:
+            m = CONT_RE.match(line)
+            pending_name, pending_output = pending_output, None
+            if m:
+                current = {"name": pending_name, "address": int(m.group(1), 16),
+                           "size": int(m.group(2), 16), "inputs": []}
+                sections.append(current)
+                continue
+        if pending_input is not None:
+            m = CONT_RE.match(line)
+            pending_name, pending_input = pending_input, None
+            if m and current is not None and m.group(3):
+                current["inputs"].append((pending_name, int(m.group(1), 16),
+                                          int(m.group(2), 16), m.group(3).strip()))
+                continue
+
+        m = SYMBOL_RE.match(line)
+        if m:
+            symbols[m.group(2)] = int(m.group(1), 16)
+            continue
+        m = OUTPUT_RE.match(line)
+        if m:
+            current = {"name": m.group(1), "address": int(m.group(2), 16),
+                       "size": int(m.group(3), 16), "inputs": []}
+            sections.append(current)
+            continue
+        m = OUTPUT_NAME_RE.match(line)
+        if m:
+            pending_output = m.group(1)
+            continue
+        if current is None:
+            continue
+        m = INPUT_RE.match(line)
+        if m:
+            current["inputs"].append((m.group(1), int(m.group(2), 16),
+                                      int(m.group(3), 16), m.group(4).strip()))
+            continue
+        m = INPUT_NAME_RE.match(line)
+        if m and not m.group(1).startswith("*"):
+            pending_input = m.group(1)
+
+    return regions, sections, symbols
+
+
+def region_of(regions, address):
+    """Name of the region holding address, None when there is none."""
+    for name, origin, length in regions:
+        if origin <= address < origin + length:
+            return name
+    return None
+
+
+def short_object(path):
+    """Object name without the CMake directories, archive members kept."""
+    m = re.match(r"^(.*\.a)\((.*)\)$", path)
+    if m:
+        return "%s(%s)" % (os.path.basename(m.group(1)), m.group(2))
+    name = os.path.basename(path)
+    for suffix in (".obj", ".o"):
+        if name.endswith(suffix):
+            name = name[:-len(suffix)]
+    return name
+
+
+def report(regions, sections, top, out):
+    """Print usage per region, then the largest objects per section."""
+    placed = collections.OrderedDict((name, []) for name, _, _ in regions)
+    for section in sections:
+        if section["size"] == 0:
+            continue
+        name = region_of(regions, section["address"])
+        if name is not None:
+            placed[name].append(section)
+
+    for name, origin, length in regions:
+        used = sum(s["size"] for s in placed[name])
+        percent = 100.0 * used / length if length else 0.0
+        out.write("%-8s 0x%08x %9d / %9d bytes %5.1f%%\n" % (name, origin, used, length, percent))
+        for section in placed[name]:
+            out.write("  %-16s 0x%08x %9d\n" % (section["name"], section["address"], section["size"]))
+            objects = collections.Counter()
+            for _, _, size, obj in section["inputs"]:
+                objects[short_object(obj)] += size
+            for obj, size in objects.most_common(top):
+                if size:
+                    out.write("      %-40s %9d\n" % (obj, size))
+
+
+def check_symbol(regions, by_name, name, address, where, out):
+    """Check a symbol is in a region, or in or at the end of a section."""
+    section = by_name.get(where)
+    if section is not None:
+        if section["address"] <= address <= section["address"] + section["size"]:
+            return 0
+        out.write("map: %s at 0x%08x is outside %s at 0x%08x..0x%08x\n"
+                  % (name, address, where, section["address"], section["address"] + section["size"]))
+        return 1
+    actual = region_of(regions, address)
+    if actual == where:
+        return 0
+    out.write("map: %s at 0x%08x is in %s, expected %s\n" % (name, address, actual, where))
+    return 1
+
+
+def check(regions, sections, symbols, expects, out):
+    """Check SECTION=REGION and SYMBOL=REGION|SECTION rules, return the number of failures."""
+    failures = 0
+    by_name = {s["name"]: s for s in sections}
+    for rule in expects:
+        section_name, _, region_name = rule.partition("=")
+        section = by_name.get(section_name)
+        if section is None and section_name in symbols:
+            failures += check_symbol(regions, by_name, section_name, symbols[section_name], region_name, out)
+            continue
+        if section is None:
+            out.write("map: %s not found\n" % section_name)
+            failures += 1
+            continue
+        actual = region_of(regions, section["address"])
+        if section["size"] and actual != region_name:
+            out.write("map: %s at 0x%08x is in %s, expected %s\n"
+                      % (section_name, section["address"], actual, region_name))
+            failures += 1
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", help="map file written by the linker")
+    parser.add_argument("--expect", action="append", default=[], metavar="NAME=WHERE",
+                        help="fail unless the output section is in the region, or the symbol in the "
+                             "region or output section")
+    parser.add_argument("--top", type=int, default=5, help="objects listed per section")
+    args = parser.parse_args()
+
+    with open(args.map, encoding="utf-8", errors="replace") as f:
+        regions, sections, symbols = parse_map(f)
+    if not regions:
+        sys.stderr.write("map: no memory configuration in %s\n" % args.map)
+        return 1
+
+    report(regions, sections, args.top, sys.stdout)
+    return 1 if check(regions, sections, symbols, args.expect, sys.stderr) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
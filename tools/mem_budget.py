@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""Turn the memory dumps of mem_stat_dump() into a budget report.
+
+Reads an RTT log, picks the lines starting with "mem t=" and prints, for
+every used/capacity value, the last and the highest use seen with the
+share of the capacity. A value at or above the warning or critical
+share raises an alert, as do heap or pool allocation failures and
+corrupted pool objects. The exit status is 1 when there is an alert,
+so a soak test run can fail on it.
+
+    mem_budget.py rtt.log --warn 75 --limit stack.main=60
+"""
+
+import argparse
+import collections
+import re
+import sys
+
+LINE_RE = re.compile(r"\bmem (t=\d+(?: \S+=\S+)*)")
+RATIO_RE = re.compile(r"^(\d+)/(\d+)$")
+
+# counters that must stay at zero, and how bad it is when they do not
+COUNTERS = (
+    (re.compile(r"^heap\.fail$"), "WARN", "allocations failed"),
+    (re.compile(r"^pool\.\d+\.fail$"), "WARN", "allocations failed"),
+    (re.compile(r"^pool\.\d+\.bad$"), "CRIT", "free objects were overwritten"),
+)
+# peaks reported next to a used/capacity value
+PEAKS = {
+    "heap": "heap.peak",
+}
+
+
+def parse_line(text):
+    """Return the tokens of one dump as a dict of int or (used, capacity)."""
+    sample = collections.OrderedDict()
+    for token in text.split():
+        key, _, value = token.partition("=")
+        m = RATIO_RE.match(value)
+        if m:
+            sample[key] = (int(m.group(1)), int(m.group(2)))
+        elif value.isdigit():
+            sample[key] = int(value)
+    return sample
+
+
+def read_samples(lines):
+    """Return the dumps found in a log, oldest first.
+
+    A line without its newline is where the capture stopped, a dump on
+    it is cut and left out.
+    """
+    samples = []
+    for line in lines:
+        if not line.endswith("\n"):
+            continue
+        m = LINE_RE.search(line)
+        if m:
+            samples.append(parse_line(m.group(1)))
+    return samples
+
+
+def pool_peak_key(key):
+    """Key of the peak of a pool value, None when it is not a pool."""
+    m = re.match(r"^(pool\.\d+)$", key)
+    return m.group(1) + ".peak" if m else None
+
+
+def budget(samples, warn, crit, limits):
+    """Return the rows of the report and the alerts.
+
+    rows:   (key, last used, peak used, capacity, peak share in percent)
+    alerts: (level, key, message)
+    """
+    rows = []
+    alerts = []
+    last = samples[-1]
+
+    for key, value in last.items():
+        if not isinstance(value, tuple):
+            continue
+        capacity = value[1]
+        peak = max(s[key][0] for s in samples if isinstance(s.get(key), tuple))
+        peak_key = PEAKS.get(key) or pool_peak_key(key)
+        if peak_key is not None:
+            peak = max([peak] + [s[peak_key] for s in samples if isinstance(s.get(peak_key), int)])
+        share = 100.0 * peak / capacity if capacity else 0.0
+        rows.append((key, value[0], peak, capacity, share))
+
+        key_warn = limits.get(key, warn)
+        key_crit = max(key_warn, crit)
+        if key.startswith("stack.") and peak >= capacity:
+            alerts.append(("CRIT", key, "stack used up to its end, it has likely overflowed"))
+        elif share >= key_crit:
+            alerts.append(("CRIT", key, "%.1f%% used, limit %.0f%%" % (share, key_crit)))
+        elif share >= key_warn:
+            alerts.append(("WARN", key, "%.1f%% used, limit %.0f%%" % (share, key_warn)))
+
+    for key, value in last.items():
+        for pattern, level, message in COUNTERS:
+            if pattern.match(key) and isinstance(value, int) and value > 0:
+                alerts.append((level, key, "%d %s" % (value, message)))
+    return rows, alerts
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="?", help="RTT log, standard input when left out")
+    parser.add_argument("--warn", type=float, default=80.0, help="warning share in percent")
+    parser.add_argument("--crit", type=float, default=95.0, help="critical share in percent")
+    parser.add_argument("--limit", action="append", default=[], metavar="KEY=PERCENT",
+                        help="warning share of one value, e.g. stack.main=60")
+    args = parser.parse_args()
+
+    limits = {}
+    for rule in args.limit:
+        key, _, percent = rule.partition("=")
+        limits[key] = float(percent)
+
+    if args.log:
+        with open(args.log, encoding="utf-8", errors="replace") as f:
+            samples = read_samples(f)
+    else:
+        samples = read_samples(sys.stdin)
+    if not samples:
+        sys.stderr.write("mem: no mem_stat dump in the log\n")
+        return 1
+
+    rows, alerts = budget(samples, args.warn, args.crit, limits)
+    out = sys.stdout
+    out.write("%d dumps, last at %d ms\n" % (len(samples), samples[-1].get("t", 0)))
+    out.write("%-16s %10s %10s %10s %7s\n" % ("", "last", "peak", "capacity", "peak%"))
+    for key, used, peak, capacity, share in rows:
+        out.write("%-16s %10d %10d %10d %6.1f%%\n" % (key, used, peak, capacity, share))
+    for key, value in samples[-1].items():
+        if key.startswith("sec."):
+            out.write("%-16s %10d\n" % (key, value))
+    for level, key, message in alerts:
+        out.write("%s %s: %s\n" % (level, key, message))
+    return 1 if alerts else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Turn the samples of the sampling profiler into per-function profiles.
+
+Reads the raw bytes of the profile RTT channel, the batches written by
+profiler_batch(), and the symbol table of the ELF file, and prints the
+share of the samples falling in each function. With --folded it also
+writes one "caller;function count" line per pair seen, the input of
+flamegraph.pl, speedscope or Perfetto. The caller is the function the
+stacked lr points into, which is only right while the sampled function
+has not reused lr: a leaf, or code before its first call. An lr inside
+the sampled function itself says nothing and is left out.
+
+    profile_symbolize.py gd32f470BaseProject.elf profile.bin --top 30 --folded profile.folded
+"""
+
+import argparse
+import bisect
+import collections
+import struct
+import sys
+
+MAGIC = 0x31465250
+HEADER = struct.Struct("<IHHI")
+FLAG_LR = 0x0001
+# samples in a batch, the drain never sends more
+MAX_BATCH = 4096
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+SHN_UNDEF = 0
+# lr values from 0xffffffe0 up are EXC_RETURN, the sampled code is a handler
+EXC_RETURN = 0xFFFFFFE0
+
+UNKNOWN = "[unknown]"
+HANDLER = "[exception]"
+
+
+def read_symbols(data):
+    """Return the functions of a 32-bit little-endian ELF as a sorted list of (start, end, name)."""
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise ValueError("not a 32-bit little-endian ELF file")
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+    sections = [struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+
+    functions = []
+    for section in sections:
+        if section[1] != SHT_SYMTAB:
+            continue
+        offset, size, link, entsize = section[4], section[5], section[6], section[9]
+        strtab = sections[link][4]
+        for pos in range(offset, offset + size, entsize):
+            name, value, sym_size, info, _, shndx = struct.unpack_from("<IIIBBH", data, pos)
+            if info & 0xF != STT_FUNC or shndx == SHN_UNDEF:
+                continue
+            end = data.index(b"\0", strtab + name)
+            # Thumb functions have bit 0 set
+            start = value & ~1
+            functions.append((start, start + sym_size, data[strtab + name:end].decode("utf-8", "replace")))
+
+    functions.sort()
+    # a function without a size reaches the next one
+    for i, (start, end, name) in enumerate(functions):
+        if end == start and i + 1 < len(functions):
+            functions[i] = (start, functions[i + 1][0], name)
+    return functions
+
+
+def read_batches(data):
+    """Return the samples of a channel capture as (list of (pc, lr or None), samples lost).
+
+    Bytes that are not a batch are skipped up to the next magic, so a
+    capture that starts in the middle of a batch is read from the next.
+    A batch cut short by garbage is dropped as a whole.
+    """
+    samples = []
+    lost = 0
+    magic = struct.pack("<I", MAGIC)
+    pos = data.find(magic)
+    while pos >= 0 and pos + HEADER.size <= len(data):
+        _, count, flags, missed = HEADER.unpack_from(data, pos)
+        each = 8 if flags & FLAG_LR else 4
+        end = pos + HEADER.size + count * each
+        # a batch is followed by the next one or the end of the capture
+        if (count == 0 or count > MAX_BATCH or flags & ~FLAG_LR or end > len(data)
+                or (end < len(data) and not data.startswith(magic, end))):
+            pos = data.find(magic, pos + 1)
+            continue
+        words = struct.unpack_from("<%dI" % (count * each // 4), data, pos + HEADER.size)
+        if flags & FLAG_LR:
+            samples.extend(zip(words[0::2], words[1::2]))
+        else:
+            samples.extend((pc, None) for pc in words)
+        lost += missed
+        pos = data.find(magic, end)
+    return samples, lost
+
+
+class Symbolizer:
+    """Find the function of an address."""
+
+    def __init__(self, functions):
+        self.functions = functions
+        self.starts = [start for start, _, _ in functions]
+
+    def name(self, address):
+        i = bisect.bisect_right(self.starts, address) - 1
+        if i >= 0:
+            start, end, name = self.functions[i]
+            if start <= address < end:
+                return name
+        return UNKNOWN
+
+    def caller(self, lr):
+        """Name the function lr returns into, None when it has none."""
+        if lr is None:
+            return None
+        if lr >= EXC_RETURN:
+            return HANDLER
+        # lr follows the call, step back into it
+        return self.name((lr & ~1) - 1)
+
+
+def profile(samples, symbolizer):
+    """Return the samples per function and per (caller, function), in Counters."""
+    flat = collections.Counter()
+    stacks = collections.Counter()
+    for pc, lr in samples:
+        function = symbolizer.name(pc & ~1)
+        caller = symbolizer.caller(lr)
+        flat[function] += 1
+        if caller is None or caller == function:
+            stacks[(function,)] += 1
+        else:
+            stacks[(caller, function)] += 1
+    return flat, stacks
+
+
+def report(flat, lost, top, out):
+    total = sum(flat.values())
+    out.write("%d samples, %d lost\n" % (total, lost))
+    if total == 0:
+        return
+    out.write("%8s %7s  %s\n" % ("samples", "share", "function"))
+    for function, count in flat.most_common(top):
+        out.write("%8d %6.2f%%  %s\n" % (count, 100.0 * count / total, function))
+
+
+def write_folded(stacks, out):
+    for stack, count in sorted(stacks.items()):
+        out.write("%s %d\n" % (";".join(stack), count))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="ELF file of the firmware that was sampled")
+    parser.add_argument("samples", nargs="+", help="raw captures of the profile RTT channel")
+    parser.add_argument("--top", type=int, default=20, help="functions listed, 0 for all")
+    parser.add_argument("--folded", metavar="FILE", help="write folded stacks, - for stdout")
+    args = parser.parse_args()
+
+    with open(args.elf, "rb") as f:
+        symbolizer = Symbolizer(read_symbols(f.read()))
+    samples = []
+    lost = 0
+    for path in args.samples:
+        with open(path, "rb") as f:
+            batch_samples, batch_lost = read_batches(f.read())
+        samples.extend(batch_samples)
+        lost += batch_lost
+    if not samples:
+        sys.stderr.write("profile: no samples in %s\n" % " ".join(args.samples))
+        return 1
+
+    flat, stacks = profile(samples, symbolizer)
+    report(flat, lost, args.top or None, sys.stdout)
+    if args.folded == "-":
+        write_folded(stacks, sys.stdout)
+    elif args.folded:
+        with open(args.folded, "w", encoding="utf-8") as f:
+            write_folded(stacks, f)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
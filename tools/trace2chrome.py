@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""Turn the records of the event tracer into a Chrome trace.
+
+Reads the raw bytes of the trace RTT channel, the batches written by
+trace_batch(), and the ELF file of the firmware, and writes the JSON
+trace format of chrome://tracing, which Perfetto and speedscope open
+too. Record names are the string constants the firmware passed, read
+from the ELF file. Each context gets a track: a kernel thread is named
+by the symbol of its thread structure, a handler by the symbol in its
+vector table entry, and code before the kernel started is "main".
+
+Timestamps are rebuilt from the counter at each batch, in microseconds
+from the first record. Records lost on the board are reported on
+stderr and in the otherData of the trace.
+
+    trace2chrome.py gd32f470BaseProject.elf trace.bin -o trace.json
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = 0x31435254
+HEADER = struct.Struct("<IHHIII")
+RECORD = struct.Struct("<IIIi")
+# records in a batch, the drain never sends more
+MAX_BATCH = 4096
+
+BEGIN, END, INSTANT, COUNTER = range(4)
+TYPE_MASK = 0x3
+# contexts below are exception numbers times 4
+EXCEPTION_LIMIT = 256 * 4
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+STT_OBJECT = 1
+STT_FUNC = 2
+VECTORS = "g_pfnVectors"
+
+
+class Elf:
+    """Symbols and read-only bytes of a 32-bit little-endian ELF file."""
+
+    def __init__(self, data):
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError("not a 32-bit little-endian ELF file")
+        self.data = data
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+        sections = [struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+        # (address, size, file offset) of the sections with contents
+        self.loaded = [(s[3], s[5], s[4]) for s in sections if s[3] and s[1] != SHT_NOBITS]
+        self.objects = {}
+        self.addresses = {}
+        self.functions = {}
+        for section in sections:
+            if section[1] != SHT_SYMTAB:
+                continue
+            offset, size, link, entsize = section[4], section[5], section[6], section[9]
+            strtab = sections[link][4]
+            for pos in range(offset, offset + size, entsize):
+                name, value, _, info, _, shndx = struct.unpack_from("<IIIBBH", data, pos)
+                kind = info & 0xF
+                if shndx == 0 or kind not in (STT_OBJECT, STT_FUNC):
+                    continue
+                text = self.cstring(strtab + name)
+                if kind == STT_FUNC:
+                    # Thumb functions have bit 0 set
+                    self.functions.setdefault(value & ~1, text)
+                else:
+                    self.objects.setdefault(value, text)
+                    self.addresses.setdefault(text, value)
+
+    def cstring(self, offset):
+        end = self.data.index(b"\0", offset)
+        return self.data[offset:end].decode("utf-8", "replace")
+
+    def read(self, address, size):
+        """Return the bytes at an address, None when no section holds them."""
+        for start, length, offset in self.loaded:
+            if start <= address and address + size <= start + length:
+                return self.data[offset + address - start:offset + address - start + size]
+        return None
+
+    def string(self, address):
+        """Return the string constant at an address, None when it is not in the file."""
+        for start, length, offset in self.loaded:
+            if start <= address < start + length:
+                end = self.data.find(b"\0", offset + address - start, offset + length)
+                if end >= 0:
+                    return self.data[offset + address - start:end].decode("utf-8", "replace")
+        return None
+
+
+def read_batches(data):
+    """Return the records of a channel capture as (list of (cycles, name, context, type, value), hz, lost).
+
+    cycles counts from the first batch without wrapping. Bytes that are
+    not a batch are skipped up to the next magic, a batch cut short by
+    garbage is dropped as a whole.
+    """
+    records = []
+    lost = 0
+    hz = None
+    base = None
+    last_now = 0
+    magic = struct.pack("<I", MAGIC)
+    pos = data.find(magic)
+    while pos >= 0 and pos + HEADER.size <= len(data):
+        _, count, flags, missed, batch_hz, now = HEADER.unpack_from(data, pos)
+        end = pos + HEADER.size + count * RECORD.size
+        # a batch is followed by the next one or the end of the capture
+        if (count == 0 or count > MAX_BATCH or flags or batch_hz == 0 or end > len(data)
+                or (end < len(data) and not data.startswith(magic, end))):
+            pos = data.find(magic, pos + 1)
+            continue
+        # batches are closer than a counter wrap
+        if base is None:
+            base = now
+        else:
+            base += (now - last_now) & 0xFFFFFFFF
+        last_now = now
+        hz = batch_hz
+        for i in range(count):
+            time, name, context, value = RECORD.unpack_from(data, pos + HEADER.size + i * RECORD.size)
+            cycles = base - ((now - time) & 0xFFFFFFFF)
+            records.append((cycles, name, context & ~TYPE_MASK, context & TYPE_MASK, value))
+        lost += missed
+        pos = data.find(magic, end)
+    return records, hz, lost
+
+
+def track_name(elf, context):
+    """Name the context that wrote a record."""
+    if context == 0:
+        return "main"
+    if context < EXCEPTION_LIMIT:
+        number = context >> 2
+        vectors = elf.addresses.get(VECTORS)
+        if vectors is not None:
+            entry = elf.read(vectors + 4 * number, 4)
+            if entry is not None:
+                handler = elf.functions.get(struct.unpack("<I", entry)[0] & ~1)
+                if handler:
+                    return handler
+        return "exception %d" % number
+    return elf.objects.get(context, "thread 0x%08x" % context)
+
+
+def chrome_trace(records, hz, lost, elf):
+    """Return the Chrome trace of the records as a dict."""
+    events = []
+    tracks = {}
+    names = {}
+    records = sorted(records, key=lambda record: record[0])
+    start = records[0][0] if records else 0
+    for cycles, name, context, kind, value in records:
+        if name not in names:
+            names[name] = elf.string(name) or "0x%08x" % name
+        if context not in tracks:
+            tracks[context] = track_name(elf, context)
+        event = {
+            "name": names[name],
+            "pid": 1,
+            "tid": context,
+            "ts": (cycles - start) * 1e6 / hz,
+        }
+        if kind == BEGIN:
+            event["ph"] = "B"
+        elif kind == END:
+            event["ph"] = "E"
+        elif kind == INSTANT:
+            event["ph"] = "i"
+            event["s"] = "t"
+            event["args"] = {"arg": value}
+        else:
+            event["ph"] = "C"
+            event["args"] = {names[name]: value}
+        events.append(event)
+
+    for context, track in sorted(tracks.items()):
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": context, "args": {"name": track}})
+    events.append({"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "gd32f470"}})
+    return {"traceEvents": events, "displayTimeUnit": "ns", "otherData": {"hz": hz, "lost": lost}}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="ELF file of the firmware that was traced")
+    parser.add_argument("trace", help="raw capture of the trace RTT channel")
+    parser.add_argument("-o", "--output", default="-", help="JSON file to write, - for stdout")
+    args = parser.parse_args()
+
+    with open(args.elf, "rb") as f:
+        elf = Elf(f.read())
+    with open(args.trace, "rb") as f:
+        records, hz, lost = read_batches(f.read())
+    if not records:
+        sys.stderr.write("trace: no records in %s\n" % args.trace)
+        return 1
+    if lost:
+        sys.stderr.write("trace: %d records lost on the board\n" % lost)
+
+    trace = chrome_trace(records, hz, lost, elf)
+    if args.output == "-":
+        json.dump(trace, sys.stdout)
+        sys.stdout.write("\n")
+    else:
+        with open(args.output, "w", encoding="utf-8") as f:
+            json.dump(trace, f)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -35,6 +35,10 @@ OF SUCH DAMAGE.
 #include "gd32f4xx_it.h"
 #include "main.h"
 #include "systick.h"
+#include "sdram_dma.h"
+#include "work.h"
+#include "kernel.h"
+#include "sys_clock.h"
 
 /*!
     \brief      this function handles NMI exception
@@ -102,51 +106,53 @@ void UsageFault_Handler(void)
 }
 
 /*!
-    \brief      this function handles SVC exception
+    \brief      this function handles DebugMon exception
     \param[in]  none
     \param[out] none
     \retval     none
 */
-void SVC_Handler(void)
+void DebugMon_Handler(void)
 {
-    /* if SVC exception occurs, go to infinite loop */
+    /* if DebugMon exception occurs, go to infinite loop */
     while(1) {
     }
 }
 
 /*!
-    \brief      this function handles DebugMon exception
-    \param[in]  none
+    \brief      the work of SysTick periods, called by idle_port_sleep() for the ticks it skipped
+    \param[in]  ticks: periods passed
     \param[out] none
     \retval     none
 */
-void DebugMon_Handler(void)
+void systick_ticks(uint32_t ticks)
 {
-    /* if DebugMon exception occurs, go to infinite loop */
-    while(1) {
+    sys_clock_tick();
+    while(0U != ticks--){
+        systick_increment();
+        delay_decrement();
+        work_port_tick();
+        kernel_tick();
     }
 }
 
 /*!
-    \brief      this function handles PendSV exception
+    \brief    this function handles SysTick exception
     \param[in]  none
     \param[out] none
     \retval     none
 */
-void PendSV_Handler(void)
+void SysTick_Handler(void)
 {
-    /* if PendSV exception occurs, go to infinite loop */
-    while(1) {
-    }
+    systick_ticks(1U);
 }
 
 /*!
-    \brief    this function handles SysTick exception
+    \brief      this function handles DMA1 channel 0 interrupt
     \param[in]  none
     \param[out] none
     \retval     none
 */
-void SysTick_Handler(void)
+void DMA1_Channel0_IRQHandler(void)
 {
-    delay_decrement();
+    sdram_dma_port_irq();
 }
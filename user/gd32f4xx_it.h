@@ -54,7 +54,11 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 /* this function handles PendSV exception */
 void PendSV_Handler(void);
+/* the work of ticks SysTick periods, more than 1 after a tickless idle */
+void systick_ticks(uint32_t ticks);
 /* this function handles SysTick exception */
 void SysTick_Handler(void);
+/* this function handles DMA1 channel 0 interrupt */
+void DMA1_Channel0_IRQHandler(void);
 
 #endif /* GD32F4XX_IT_H */
@@ -9,8 +9,19 @@
 #include <stdio.h>
 #include "main.h"
 #include "SEGGER_RTT.h"
-#include "exmc_sdram.h"
+#include "boot.h"
+#include "mem_stat.h"
+#include "soft_timer.h"
+#include "event_loop.h"
+#include "kernel.h"
+#include "work.h"
+#include "idle.h"
+#include "profiler.h"
+#include "trace.h"
+#include "mem_section.h"
 #include "lcd.h"
+#include "gui_port.h"
+#include "gui_anim.h"
 
 /**********************************************************
  * 函 数 名 称：tli_draw_point
@@ -106,28 +117,141 @@ void tli_draw_Rectangle(uint16_t sx,uint16_t sy,uint16_t ex,uint16_t ey,uint16_t
 
 int8_t a = 0;
 
+/* 线程优先级, 0最高 */
+#define CONTROL_PRIORITY            0U
+/* 中断下半部, 在控制线程之后、事件循环之前执行 */
+#define WORK_PRIORITY               1U
+#define EVENTS_PRIORITY             4U
+/* LED翻转周期, 单位tick(1ms) */
+#define LED_PERIOD_TICKS            100U
+/* 测量上下文切换的往返次数 */
+#define SWITCH_BENCH_ROUNDS         1000U
+/* 采样分析每秒采样次数 */
+#define PROFILE_HZ                  1000U
+/* 采样(RTT通道1)和跟踪记录(RTT通道2)发往主机的周期(ms) */
+#define TELEMETRY_DRAIN_MS          10U
+
+static gui_widget_struct screen;
+static gui_widget_struct left_panel;
+static gui_widget_struct right_panel;
+static soft_timer_struct gui_timer;
+static soft_timer_struct stats_timer;
+static soft_timer_struct drain_timer;
+
+static void gui_event(uint32_t arg);
+static void stats_event(uint32_t arg);
+static void drain_event(uint32_t arg);
+static event_handler_struct gui_handler = EVENT_HANDLER(gui_event, EVENT_PRIO_GUI);
+static event_handler_struct stats_handler = EVENT_HANDLER(stats_event, EVENT_PRIO_IDLE);
+static event_handler_struct drain_handler = EVENT_HANDLER(drain_event, EVENT_PRIO_IDLE);
+
+/* 画一帧, 由gui_timer投递 */
+static void gui_event(uint32_t arg)
+{
+    (void)arg;
+    trace_begin(&tracer, "gui_frame");
+    gui_frame_task();
+    trace_end(&tracer, "gui_frame");
+}
+
+/* 打印内存和各事件处理的耗时 */
+static void stats_event(uint32_t arg)
+{
+    (void)arg;
+    /* 负载(千分比)作为计数器画在时间线上 */
+    trace_counter(&tracer, "cpu_load", (int32_t)cpu_idle.load);
+    mem_stat_dump();
+    work_port_print(&work_timer);
+    event_loop_port_print(&gui_handler);
+    event_loop_port_print(&stats_handler);
+    work_port_print_queues();
+    idle_port_print();
+    profiler_port_print();
+    trace_port_print();
+}
+
+/* 把采样和跟踪记录批量发给主机, 主机用tools/profile_symbolize.py和tools/trace2chrome.py解析 */
+static void drain_event(uint32_t arg)
+{
+    (void)arg;
+    profiler_port_drain();
+    trace_port_drain();
+}
+
+/* 定时器回调只投递事件, 处理在事件循环中按优先级执行 */
+static void post_event(soft_timer_struct *timer, void *arg)
+{
+    (void)timer;
+    event_post(&events, (event_handler_struct *)arg, 0U);
+}
+
+static kernel_thread_struct control_thread;
+static kernel_thread_struct events_thread;
+static kernel_thread_struct bench_thread;
+static uint32_t control_stack[256] TCM_BSS;
+static uint32_t events_stack[1024] TCM_BSS;
+static uint32_t bench_stack[128] TCM_BSS;
+
+/* 控制线程: 优先级最高, 渲染再长也按时翻转LED */
+static void control_entry(void *arg)
+{
+    uint32_t next;
+
+    (void)arg;
+    SEGGER_RTT_printf(0, "kernel: context switch %u cycles\n",
+                      kernel_switch_bench(&bench_thread, bench_stack, sizeof(bench_stack), SWITCH_BENCH_ROUNDS,
+                                          event_loop_port_cycles));
+
+    next = kernel_ticks_get();
+    for(;;){
+        if(RESET == gpio_output_bit_get(GPIOD, GPIO_PIN_7)){
+            gpio_bit_write(GPIOD, GPIO_PIN_7, SET);
+        }else{
+            gpio_bit_write(GPIOD, GPIO_PIN_7, RESET);
+            a++;
+        }
+        /* 按绝对时间睡眠, 周期不随处理时间漂移 */
+        next += LED_PERIOD_TICKS;
+        kernel_sleep(next - kernel_ticks_get());
+    }
+}
+
+/* 事件线程: 跑原来的主循环, 可被控制线程抢占 */
+static void events_entry(void *arg)
+{
+    (void)arg;
+    event_loop_run(&events);
+}
+
 int main(void)
 {
-    ErrStatus init_state;
+    mem_stat_init();
     nvic_priority_group_set(NVIC_PRIGROUP_PRE2_SUB2);
-    systick_config();
-    led_gpio_config();
-    init_state = exmc_synchronous_dynamic_ram_init(EXMC_SDRAM_DEVICE0);
-    if(init_state == ERROR)
-    {
-        SEGGER_RTT_printf(0, "a = %d\n", init_state);
-    }
-    lcd_disp_config();
-
-    tli_draw_Rectangle(0,0,400,480,0x8800,1);
-    tli_draw_Rectangle(400,0,800,480,0x001F,1);
-    
-   while(1)
-   {
-        gpio_bit_write(GPIOD, GPIO_PIN_7, SET); 
-        delay_1ms(100);
-        gpio_bit_write(GPIOD, GPIO_PIN_7, RESET); 
-        delay_1ms(100);
-        a++;    
-   }
+    boot_start();
+
+    gui_container_init(&screen, 0, 0, LCD_WIDTH, LCD_HEIGHT, 0xFFFF);
+    gui_container_init(&left_panel, 0, 0, 400, 480, 0x8800);
+    gui_container_init(&right_panel, 400, 0, 400, 480, 0x001F);
+    gui_widget_add(&screen, &left_panel);
+    gui_widget_add(&screen, &right_panel);
+    gui_port_init(&screen);
+    gui_refresh();
+
+    soft_timer_init(&gui_timer, post_event, &gui_handler);
+    soft_timer_start(&soft_timers, &gui_timer, GUI_FRAME_PERIOD_MS, GUI_FRAME_PERIOD_MS);
+    soft_timer_init(&stats_timer, post_event, &stats_handler);
+    soft_timer_start(&soft_timers, &stats_timer, MEM_STAT_PERIOD_MS, MEM_STAT_PERIOD_MS);
+    soft_timer_init(&drain_timer, post_event, &drain_handler);
+    soft_timer_start(&soft_timers, &drain_timer, TELEMETRY_DRAIN_MS, TELEMETRY_DRAIN_MS);
+    /* 带LR采样, 火焰图多一层调用者 */
+    profiler_port_start(PROFILE_HZ, 1);
+
+    kernel_init();
+    work_port_init(WORK_PRIORITY);
+    trace_port_init();
+    kernel_thread_create(&control_thread, "control", control_entry, NULL, CONTROL_PRIORITY,
+                         control_stack, sizeof(control_stack));
+    kernel_thread_create(&events_thread, "events", events_entry, NULL, EVENTS_PRIORITY,
+                         events_stack, sizeof(events_stack));
+    kernel_start();
 }
@@ -36,6 +36,7 @@ OF SUCH DAMAGE.
 #include "systick.h"
 
 static volatile uint32_t delay;
+static volatile uint32_t tick_ms;
 
 /*!
     \brief    configure systick
@@ -81,3 +82,25 @@ void delay_decrement(void)
         delay--;
     }
 }
+
+/*!
+    \brief    advance the millisecond tick counter
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void systick_increment(void)
+{
+    tick_ms++;
+}
+
+/*!
+    \brief    get the milliseconds elapsed since systick_config(), wraps after 49 days
+    \param[in]  none
+    \param[out] none
+    \retval     millisecond tick counter
+*/
+uint32_t systick_ms_get(void)
+{
+    return tick_ms;
+}
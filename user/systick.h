@@ -43,5 +43,9 @@ void systick_config(void);
 void delay_1ms(uint32_t count);
 /* delay decrement */
 void delay_decrement(void);
+/* advance the millisecond tick counter */
+void systick_increment(void);
+/* get the milliseconds elapsed since systick_config() */
+uint32_t systick_ms_get(void);
 
 #endif /* SYS_TICK_H */